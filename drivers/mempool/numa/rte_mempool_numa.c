@@ -0,0 +1,445 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <rte_atomic.h>
+#include <rte_eal.h>
+#include <rte_errno.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_memory.h>
+#include <rte_memzone.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+#include "rte_mempool_numa.h"
+
+#define NUMA_OPS_NAME "numa"
+
+/* number of memory ranges allocated at once */
+#define NUMA_RANGES_STEP 8
+
+/* free objects and statistics of one NUMA node */
+struct numa_node {
+	struct rte_ring *r;    /**< Free objects of the node, NULL if none. */
+	rte_atomic64_t hit;    /**< Gets served by the node of the lcore. */
+	rte_atomic64_t miss;   /**< Gets needing objects of other nodes. */
+	rte_atomic64_t stolen; /**< Objects got by lcores of other nodes. */
+	uint32_t nb_objs;      /**< Objects populated on the node. */
+} __rte_cache_aligned;
+
+/* a virtually contiguous memory range of the pool, on one node */
+struct numa_range {
+	uintptr_t start;
+	uintptr_t end;
+	unsigned int node;
+};
+
+struct numa_pool {
+	struct numa_node nodes[RTE_MAX_NUMA_NODES];
+	unsigned int nb_ranges;
+	unsigned int max_ranges;
+	struct numa_range *ranges;
+};
+
+/* get the node of an object, trying the range of the previous one first */
+static __rte_always_inline unsigned int
+numa_obj_node(const struct numa_pool *p, const void *obj, unsigned int *hint)
+{
+	uintptr_t addr = (uintptr_t)obj;
+	const struct numa_range *rg = &p->ranges[*hint];
+	unsigned int i;
+
+	if (likely(addr - rg->start < rg->end - rg->start))
+		return rg->node;
+
+	for (i = 0; i < p->nb_ranges; i++) {
+		rg = &p->ranges[i];
+		if (addr - rg->start < rg->end - rg->start) {
+			*hint = i;
+			return rg->node;
+		}
+	}
+
+	/* not an object of this pool */
+	RTE_ASSERT(0);
+	return p->ranges[0].node;
+}
+
+static int
+numa_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		unsigned int n)
+{
+	struct numa_pool *p = mp->pool_data;
+	unsigned int hint = 0;
+	unsigned int i, j, node;
+
+	/* enqueue the objects of the same node by batches */
+	for (i = 0; i < n; i = j) {
+		node = numa_obj_node(p, obj_table[i], &hint);
+		for (j = i + 1; j < n; j++) {
+			if (numa_obj_node(p, obj_table[j], &hint) != node)
+				break;
+		}
+		if (rte_ring_enqueue_bulk(p->nodes[node].r, &obj_table[i],
+				j - i, NULL) == 0)
+			return -ENOBUFS;
+	}
+
+	return 0;
+}
+
+static int
+numa_dequeue(struct rte_mempool *mp, void **obj_table, unsigned int n)
+{
+	struct numa_pool *p = mp->pool_data;
+	unsigned int local = rte_socket_id();
+	unsigned int got = 0;
+	unsigned int i, node, taken;
+
+	/* local node first */
+	if (likely(local < RTE_MAX_NUMA_NODES && p->nodes[local].r != NULL)) {
+		got = rte_ring_dequeue_burst(p->nodes[local].r, obj_table, n,
+				NULL);
+		if (likely(got == n)) {
+			rte_atomic64_inc(&p->nodes[local].hit);
+			return 0;
+		}
+	}
+
+	/* steal the missing objects from the other nodes */
+	for (i = 0; i < RTE_MAX_NUMA_NODES && got < n; i++) {
+		node = (local + 1 + i) % RTE_MAX_NUMA_NODES;
+		if (node == local || p->nodes[node].r == NULL)
+			continue;
+		taken = rte_ring_dequeue_burst(p->nodes[node].r,
+				&obj_table[got], n - got, NULL);
+		if (taken != 0) {
+			rte_atomic64_add(&p->nodes[node].stolen, taken);
+			got += taken;
+		}
+	}
+
+	if (unlikely(got < n)) {
+		/* not enough objects: give back the ones we got */
+		if (got != 0)
+			numa_enqueue(mp, obj_table, got);
+		return -ENOBUFS;
+	}
+
+	/* gets from non-EAL threads are not accounted */
+	if (local < RTE_MAX_NUMA_NODES)
+		rte_atomic64_inc(&p->nodes[local].miss);
+	return 0;
+}
+
+static unsigned int
+numa_get_count(const struct rte_mempool *mp)
+{
+	const struct numa_pool *p = mp->pool_data;
+	unsigned int node, count = 0;
+
+	for (node = 0; node < RTE_MAX_NUMA_NODES; node++) {
+		if (p->nodes[node].r != NULL)
+			count += rte_ring_count(p->nodes[node].r);
+	}
+
+	return count;
+}
+
+static int
+numa_alloc(struct rte_mempool *mp)
+{
+	struct numa_pool *p;
+
+	p = rte_zmalloc_socket("mempool-numa", sizeof(*p),
+			RTE_CACHE_LINE_SIZE, mp->socket_id);
+	if (p == NULL) {
+		RTE_LOG(ERR, MEMPOOL, "Cannot allocate numa pool!\n");
+		return -ENOMEM;
+	}
+
+	mp->pool_data = p;
+
+	return 0;
+}
+
+static void
+numa_free(struct rte_mempool *mp)
+{
+	struct numa_pool *p = mp->pool_data;
+	unsigned int node;
+
+	for (node = 0; node < RTE_MAX_NUMA_NODES; node++)
+		rte_ring_free(p->nodes[node].r);
+	rte_free(p->ranges);
+	rte_free(p);
+}
+
+/* create the ring storing the free objects of a node */
+static int
+numa_node_init(struct rte_mempool *mp, unsigned int node)
+{
+	struct numa_pool *p = mp->pool_data;
+	char rg_name[RTE_RING_NAMESIZE];
+	int rg_flags = 0, ret;
+	struct rte_ring *r;
+
+	if (p->nodes[node].r != NULL)
+		return 0;
+
+	ret = snprintf(rg_name, sizeof(rg_name),
+		RTE_MEMPOOL_MZ_FORMAT "_%u", mp->name, node);
+	if (ret < 0 || ret >= (int)sizeof(rg_name))
+		return -ENAMETOOLONG;
+
+	if (mp->flags & MEMPOOL_F_SP_PUT)
+		rg_flags |= RING_F_SP_ENQ;
+	if (mp->flags & MEMPOOL_F_SC_GET)
+		rg_flags |= RING_F_SC_DEQ;
+
+	/* any number of objects may be populated on a node */
+	r = rte_ring_create(rg_name, rte_align32pow2(mp->size + 1),
+		node, rg_flags);
+	if (r == NULL)
+		return -rte_errno;
+
+	p->nodes[node].r = r;
+	return 0;
+}
+
+/* record the node of a memory range, merging it with the previous one */
+static int
+numa_add_range(struct rte_mempool *mp, void *vaddr, size_t len,
+	unsigned int node)
+{
+	struct numa_pool *p = mp->pool_data;
+	struct numa_range *rg;
+
+	if (p->nb_ranges != 0) {
+		rg = &p->ranges[p->nb_ranges - 1];
+		if (rg->node == node && rg->end == (uintptr_t)vaddr) {
+			rg->end += len;
+			return 0;
+		}
+	}
+
+	if (p->nb_ranges == p->max_ranges) {
+		rg = rte_realloc(p->ranges, (p->max_ranges + NUMA_RANGES_STEP) *
+			sizeof(*rg), 0);
+		if (rg == NULL)
+			return -ENOMEM;
+		p->ranges = rg;
+		p->max_ranges += NUMA_RANGES_STEP;
+	}
+
+	rg = &p->ranges[p->nb_ranges++];
+	rg->start = (uintptr_t)vaddr;
+	rg->end = (uintptr_t)vaddr + len;
+	rg->node = node;
+
+	return 0;
+}
+
+static int
+numa_populate(struct rte_mempool *mp, unsigned int max_objs,
+	void *vaddr, rte_iova_t iova, size_t len,
+	rte_mempool_populate_obj_cb_t *obj_cb, void *obj_cb_arg)
+{
+	struct numa_pool *p = mp->pool_data;
+	const struct rte_memseg *ms;
+	unsigned int node = 0;
+	int ret;
+
+	ms = rte_mem_virt2memseg(vaddr, NULL);
+	if (ms != NULL && ms->socket_id >= 0 &&
+			ms->socket_id < RTE_MAX_NUMA_NODES)
+		node = ms->socket_id;
+
+	ret = numa_node_init(mp, node);
+	if (ret < 0)
+		return ret;
+
+	/* the objects are enqueued by obj_cb, their range must be known */
+	ret = numa_add_range(mp, vaddr, len, node);
+	if (ret < 0)
+		return ret;
+
+	ret = rte_mempool_op_populate_default(mp, max_objs, vaddr, iova, len,
+		obj_cb, obj_cb_arg);
+	if (ret > 0)
+		p->nodes[node].nb_objs += ret;
+
+	return ret;
+}
+
+static void
+numa_dump(FILE *f, const struct rte_mempool *mp)
+{
+	struct numa_pool *p = mp->pool_data;
+	struct numa_node *nd;
+	unsigned int node;
+
+	for (node = 0; node < RTE_MAX_NUMA_NODES; node++) {
+		nd = &p->nodes[node];
+		if (nd->r == NULL && rte_atomic64_read(&nd->hit) == 0 &&
+				rte_atomic64_read(&nd->miss) == 0)
+			continue;
+		fprintf(f, "  numa_node[%u]:\n", node);
+		fprintf(f, "    objs=%"PRIu32"\n", nd->nb_objs);
+		fprintf(f, "    free=%u\n",
+			nd->r != NULL ? rte_ring_count(nd->r) : 0);
+		fprintf(f, "    hit=%"PRIu64"\n",
+			(uint64_t)rte_atomic64_read(&nd->hit));
+		fprintf(f, "    miss=%"PRIu64"\n",
+			(uint64_t)rte_atomic64_read(&nd->miss));
+		fprintf(f, "    stolen=%"PRIu64"\n",
+			(uint64_t)rte_atomic64_read(&nd->stolen));
+	}
+}
+
+static void
+numa_memzone_free(__rte_unused struct rte_mempool_memhdr *memhdr,
+	void *opaque)
+{
+	rte_memzone_free(opaque);
+}
+
+/*
+ * Add about n objects on a socket, falling back to any socket if there is
+ * not enough memory on it. Same logic as rte_mempool_populate_default(),
+ * without the search of the biggest free zone.
+ */
+static int
+numa_populate_socket(struct rte_mempool *mp, unsigned int n, int socket_id)
+{
+	unsigned int mz_flags = RTE_MEMZONE_1GB | RTE_MEMZONE_SIZE_HINT_ONLY;
+	char mz_name[RTE_MEMZONE_NAMESIZE];
+	const struct rte_memzone *mz;
+	size_t min_chunk_size, align, pg_sz;
+	unsigned int flags, pg_shift, added = 0;
+	bool no_contig, no_pageshift, try_contig;
+	ssize_t mem_size;
+	rte_iova_t iova;
+	int ret;
+
+	no_contig = mp->flags & MEMPOOL_F_NO_IOVA_CONTIG;
+	no_pageshift = no_contig || rte_eal_iova_mode() == RTE_IOVA_VA;
+
+	while (added < n && mp->populated_size < mp->size) {
+		try_contig = !no_pageshift && rte_eal_has_hugepages();
+		pg_sz = no_pageshift ? 0 : (size_t)getpagesize();
+		pg_shift = no_pageshift ? 0 : rte_bsf32(pg_sz);
+
+		mem_size = rte_mempool_ops_calc_mem_size(mp, n - added,
+			try_contig ? 0 : pg_shift, &min_chunk_size, &align);
+		if (mem_size < 0)
+			return mem_size;
+
+		ret = snprintf(mz_name, sizeof(mz_name),
+			RTE_MEMPOOL_MZ_FORMAT "_%u", mp->name, mp->nb_mem_chunks);
+		if (ret < 0 || ret >= (int)sizeof(mz_name))
+			return -ENAMETOOLONG;
+
+		flags = mz_flags;
+		if (try_contig)
+			flags |= RTE_MEMZONE_IOVA_CONTIG;
+
+		mz = rte_memzone_reserve_aligned(mz_name, mem_size, socket_id,
+			flags, align);
+		if (mz == NULL && try_contig) {
+			try_contig = false;
+			flags &= ~RTE_MEMZONE_IOVA_CONTIG;
+			mem_size = rte_mempool_ops_calc_mem_size(mp, n - added,
+				pg_shift, &min_chunk_size, &align);
+			if (mem_size < 0)
+				return mem_size;
+			mz = rte_memzone_reserve_aligned(mz_name, mem_size,
+				socket_id, flags, align);
+		}
+		if (mz == NULL && socket_id != SOCKET_ID_ANY) {
+			RTE_LOG(DEBUG, MEMPOOL,
+				"%s: no memory on socket %d, using any socket\n",
+				mp->name, socket_id);
+			socket_id = SOCKET_ID_ANY;
+			continue;
+		}
+		if (mz == NULL)
+			return -rte_errno;
+
+		iova = no_contig ? RTE_BAD_IOVA : mz->iova;
+		if (no_pageshift || try_contig)
+			ret = rte_mempool_populate_iova(mp, mz->addr, iova,
+				mz->len, numa_memzone_free,
+				(void *)(uintptr_t)mz);
+		else
+			ret = rte_mempool_populate_virt(mp, mz->addr,
+				RTE_ALIGN_FLOOR(mz->len, pg_sz), pg_sz,
+				numa_memzone_free, (void *)(uintptr_t)mz);
+		if (ret <= 0) {
+			rte_memzone_free(mz);
+			return ret < 0 ? ret : -ENOMEM;
+		}
+		added += ret;
+	}
+
+	return added;
+}
+
+int __rte_experimental
+rte_mempool_numa_populate(struct rte_mempool *mp)
+{
+	bool has_lcore[RTE_MAX_NUMA_NODES] = { false };
+	unsigned int lcore_id, socket_id, nb_nodes = 0, share;
+	int ret;
+
+	if (strcmp(rte_mempool_get_ops(mp->ops_index)->name,
+			NUMA_OPS_NAME) != 0)
+		return -EINVAL;
+
+	/* mempool must not be populated */
+	if (mp->nb_mem_chunks != 0)
+		return -EEXIST;
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		socket_id = rte_lcore_to_socket_id(lcore_id);
+		if (socket_id < RTE_MAX_NUMA_NODES && !has_lcore[socket_id]) {
+			has_lcore[socket_id] = true;
+			nb_nodes++;
+		}
+	}
+	if (nb_nodes == 0)
+		return -ENODEV;
+
+	share = mp->size / nb_nodes;
+	for (socket_id = 0; socket_id < RTE_MAX_NUMA_NODES; socket_id++) {
+		if (!has_lcore[socket_id])
+			continue;
+		/* the last node gets the remaining objects */
+		if (--nb_nodes == 0)
+			share = mp->size - mp->populated_size;
+		ret = numa_populate_socket(mp, share, socket_id);
+		if (ret < 0)
+			return ret;
+	}
+
+	return mp->size;
+}
+
+static const struct rte_mempool_ops ops_numa = {
+	.name = NUMA_OPS_NAME,
+	.alloc = numa_alloc,
+	.free = numa_free,
+	.enqueue = numa_enqueue,
+	.dequeue = numa_dequeue,
+	.get_count = numa_get_count,
+	.populate = numa_populate,
+	.dump = numa_dump,
+};
+
+MEMPOOL_REGISTER_OPS(ops_numa);
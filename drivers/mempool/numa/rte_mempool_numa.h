@@ -0,0 +1,57 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#ifndef _RTE_MEMPOOL_NUMA_H_
+#define _RTE_MEMPOOL_NUMA_H_
+
+/**
+ * @file
+ * RTE NUMA-aware mempool driver
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * The "numa" mempool ops keep the free objects of a mempool in one ring
+ * per NUMA node, the node of an object being the one of its memory.
+ * Objects are got from the node of the calling lcore first, and from the
+ * other nodes only when it has not enough free objects. The number of
+ * local (hit) and remote (miss) gets of each node is printed by
+ * rte_mempool_dump().
+ *
+ * Such a mempool is created with rte_mempool_create_empty(), then
+ * rte_mempool_set_ops_byname(mp, "numa", NULL), and populated with
+ * rte_mempool_numa_populate() to spread its objects on the NUMA nodes.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_compat.h>
+#include <rte_mempool.h>
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Populate a mempool with objects spread on the NUMA nodes of the enabled
+ * lcores, in equal shares. A node share is taken on any other node if the
+ * memory of the node is exhausted.
+ *
+ * The mempool must use the "numa" ops and must not be populated yet.
+ *
+ * @param mp
+ *   A pointer to the mempool structure.
+ * @return
+ *   The number of objects added on success, a negative errno otherwise.
+ *   On error, the mempool may be partially populated and should be freed.
+ */
+int __rte_experimental
+rte_mempool_numa_populate(struct rte_mempool *mp);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_MEMPOOL_NUMA_H_ */
@@ -3,8 +3,10 @@
  */
 
 #include <stdio.h>
+#include <rte_atomic.h>
 #include <rte_mempool.h>
 #include <rte_malloc.h>
+#include <rte_prefetch.h>
 
 struct rte_mempool_stack {
 	rte_spinlock_t sl;
@@ -116,3 +118,230 @@ static struct rte_mempool_ops ops_stack = {
 };
 
 MEMPOOL_REGISTER_OPS(ops_stack);
+
+#ifdef RTE_ARCH_X86_64
+/*
+ * Lock-free stack, based on a linked list of elements whose head is
+ * updated with a 128-bit compare-and-swap of the top pointer and of a
+ * modification counter, so that a head which was popped and pushed back
+ * in between (ABA) is not mistaken for an unmodified one.
+ *
+ * The objects are stored in elements of a "used" list. The elements not
+ * holding an object are in a "free" list. An enqueue moves elements from
+ * the free list to the used list, a dequeue the opposite. The elements
+ * are never freed while the pool exists, so a thread can always read the
+ * next pointer of an element it found in a list, even if the element was
+ * popped in the meantime: the counter makes its compare-and-swap fail.
+ */
+struct lf_stack_elem {
+	void *data;
+	struct lf_stack_elem *next;
+};
+
+struct lf_stack_head {
+	struct lf_stack_elem *top; /* Stack top */
+	uint64_t cnt;              /* Modification counter, avoids ABA */
+};
+
+struct lf_stack_list {
+	/* Stack head, updated with a 128-bit compare-and-swap */
+	RTE_STD_C11
+	union {
+		rte_int128_t raw;
+		struct lf_stack_head head;
+	};
+	/* Number of elements in the list, never more than the actual ones */
+	uint64_t len;
+};
+
+struct rte_mempool_lf_stack {
+	struct lf_stack_list used __rte_cache_aligned;
+	struct lf_stack_list free __rte_cache_aligned;
+	uint32_t size;
+	struct lf_stack_elem elems[] __rte_cache_aligned;
+};
+
+/* push a chain of num elements, first being the new top */
+static __rte_always_inline void
+lf_stack_push(struct lf_stack_list *list, struct lf_stack_elem *first,
+		struct lf_stack_elem *last, unsigned int num)
+{
+	struct lf_stack_head old_head, new_head;
+	int success;
+
+	old_head = list->head;
+
+	do {
+		new_head.top = first;
+		new_head.cnt = old_head.cnt + 1;
+
+		last->next = old_head.top;
+
+		/* release: the pushed elements are visible before the head */
+		success = rte_atomic128_cmp_exchange(&list->raw,
+				(rte_int128_t *)&old_head,
+				(rte_int128_t *)&new_head,
+				1, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	} while (success == 0);
+
+	/* the elements can be popped once they are accounted */
+	__atomic_add_fetch(&list->len, num, __ATOMIC_RELEASE);
+}
+
+/*
+ * Pop num elements, storing their objects in obj_table if not NULL.
+ * Return the first popped element, the last one in *last, or NULL if the
+ * list has less than num elements.
+ */
+static __rte_always_inline struct lf_stack_elem *
+lf_stack_pop(struct lf_stack_list *list, unsigned int num,
+		void **obj_table, struct lf_stack_elem **last)
+{
+	struct lf_stack_head old_head, new_head;
+	struct lf_stack_elem *tmp;
+	uint64_t len;
+	unsigned int i;
+	int success;
+
+	/* reserve num elements, so that the list cannot run out of them */
+	len = __atomic_load_n(&list->len, __ATOMIC_ACQUIRE);
+	do {
+		if (unlikely(len < num))
+			return NULL;
+	} while (__atomic_compare_exchange_n(&list->len, &len, len - num,
+			1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE) == 0);
+
+	old_head = list->head;
+
+	do {
+		/*
+		 * Walk the num first elements. The list may be modified at
+		 * the same time, in which case the walk result is discarded
+		 * by the failure of the compare-and-swap.
+		 */
+		tmp = old_head.top;
+		for (i = 0; i < num && tmp != NULL; i++) {
+			rte_prefetch0(tmp->next);
+			if (obj_table != NULL)
+				obj_table[i] = tmp->data;
+			if (last != NULL)
+				*last = tmp;
+			tmp = tmp->next;
+		}
+
+		/* the list was modified during the walk, read it again */
+		if (i != num) {
+			rte_smp_rmb();
+			old_head = list->head;
+			success = 0;
+			continue;
+		}
+
+		new_head.top = tmp;
+		new_head.cnt = old_head.cnt + 1;
+
+		success = rte_atomic128_cmp_exchange(&list->raw,
+				(rte_int128_t *)&old_head,
+				(rte_int128_t *)&new_head,
+				1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE);
+	} while (success == 0);
+
+	return old_head.top;
+}
+
+static int
+lf_stack_alloc(struct rte_mempool *mp)
+{
+	struct rte_mempool_lf_stack *s;
+	unsigned int n = mp->size;
+	size_t size = sizeof(*s) + n * sizeof(struct lf_stack_elem);
+	unsigned int i;
+
+	/* Allocate our local memory structure */
+	s = rte_zmalloc_socket("mempool-lf-stack",
+			size,
+			RTE_CACHE_LINE_SIZE,
+			mp->socket_id);
+	if (s == NULL) {
+		RTE_LOG(ERR, MEMPOOL, "Cannot allocate lock-free stack!\n");
+		return -ENOMEM;
+	}
+
+	s->size = n;
+
+	/* all the elements are free */
+	if (n != 0) {
+		for (i = 0; i < n - 1; i++)
+			s->elems[i].next = &s->elems[i + 1];
+		s->free.head.top = &s->elems[0];
+		s->free.len = n;
+	}
+
+	mp->pool_data = s;
+
+	return 0;
+}
+
+static int
+lf_stack_enqueue(struct rte_mempool *mp, void * const *obj_table,
+		unsigned int n)
+{
+	struct rte_mempool_lf_stack *s = mp->pool_data;
+	struct lf_stack_elem *first, *last = NULL, *tmp;
+	unsigned int i;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	/* get free elements to store the objects */
+	first = lf_stack_pop(&s->free, n, NULL, &last);
+	if (unlikely(first == NULL))
+		return -ENOBUFS;
+
+	/* the last object put is the first one got back (LIFO) */
+	for (tmp = first, i = 0; i < n; i++, tmp = tmp->next)
+		tmp->data = obj_table[n - i - 1];
+
+	lf_stack_push(&s->used, first, last, n);
+
+	return 0;
+}
+
+static int
+lf_stack_dequeue(struct rte_mempool *mp, void **obj_table,
+		unsigned int n)
+{
+	struct rte_mempool_lf_stack *s = mp->pool_data;
+	struct lf_stack_elem *first, *last = NULL;
+
+	if (unlikely(n == 0))
+		return 0;
+
+	first = lf_stack_pop(&s->used, n, obj_table, &last);
+	if (unlikely(first == NULL))
+		return -ENOENT;
+
+	lf_stack_push(&s->free, first, last, n);
+
+	return 0;
+}
+
+static unsigned
+lf_stack_get_count(const struct rte_mempool *mp)
+{
+	struct rte_mempool_lf_stack *s = mp->pool_data;
+
+	return __atomic_load_n(&s->used.len, __ATOMIC_RELAXED);
+}
+
+static struct rte_mempool_ops ops_lf_stack = {
+	.name = "lf_stack",
+	.alloc = lf_stack_alloc,
+	.free = stack_free,
+	.enqueue = lf_stack_enqueue,
+	.dequeue = lf_stack_dequeue,
+	.get_count = lf_stack_get_count
+};
+
+MEMPOOL_REGISTER_OPS(ops_lf_stack);
+#endif /* RTE_ARCH_X86_64 */
@@ -5,6 +5,9 @@
 #ifndef	_ACL_H_
 #define	_ACL_H_
 
+#include <pthread.h>
+#include <rte_launch.h>
+
 #ifdef __cplusplus
 extern"C" {
 #endif /* __cplusplus */
@@ -166,6 +169,11 @@ struct rte_acl_ctx {
 	uint32_t            max_rules;
 	uint32_t            rule_sz;
 	uint32_t            num_rules;
+	struct rte_acl_ctx *delta;
+	/** Rules added or shadowed by deletions since the last build. */
+	struct acl_rule_prio *rule_prio;
+	/** Priorities of the built rules, sorted by userdata. */
+	uint32_t            num_rule_prio;
 	uint32_t            num_categories;
 	uint32_t            num_tries;
 	uint32_t            match_index;
@@ -179,13 +187,47 @@ struct rte_acl_ctx {
 	struct rte_acl_config config; /* copy of build config. */
 };
 
+/* Worker threads of a parallel build, one job per trie at most. */
+struct acl_workers {
+	uint32_t            num;
+	const unsigned int *lcore_id; /* NULL to use threads of our own. */
+	int32_t             rc;       /* first error returned by the jobs. */
+	struct acl_worker {
+		lcore_function_t *fn;
+		void             *arg;
+		int32_t           rc;
+		uint32_t          busy;
+		pthread_t         thread;
+	} worker[RTE_ACL_MAX_TRIES];
+};
+
+int acl_workers_init(struct acl_workers *wrk, uint32_t num,
+	const unsigned int *lcore_id);
+
+void acl_workers_launch(struct acl_workers *wrk, uint32_t idx,
+	lcore_function_t *fn, void *arg);
+
+int acl_workers_wait(struct acl_workers *wrk);
+
+int acl_workers_run(struct acl_workers *wrk, lcore_function_t *fn, void *arg,
+	size_t size, uint32_t num);
+
 int rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint32_t num_categories, uint32_t data_index_sz, size_t max_size);
+	uint32_t num_categories, uint32_t data_index_sz, size_t max_size,
+	struct acl_workers *workers);
 
 typedef int (*rte_acl_classify_t)
 (const struct rte_acl_ctx *, const uint8_t **, uint32_t *, uint32_t, uint32_t);
 
+void acl_build_reset(struct rte_acl_ctx *ctx);
+
+void acl_update_reset(struct rte_acl_ctx *ctx);
+
+int acl_classify_update(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t classify);
+
 /*
  * Different implementations of ACL classify.
  */
@@ -201,6 +243,10 @@ int
 rte_acl_classify_avx2(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories);
 
+int
+rte_acl_classify_avx512(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories);
+
 int
 rte_acl_classify_neon(const struct rte_acl_ctx *ctx, const uint8_t **data,
 	uint32_t *results, uint32_t num, uint32_t categories);
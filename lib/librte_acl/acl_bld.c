@@ -85,6 +85,23 @@ struct acl_build_context {
 	/* memory free lists for nodes and blocks used for node ptrs */
 	struct acl_mem_block      blocks[MEM_BLOCK_NUM];
 	struct rte_acl_node       *node_free_list;
+
+	/* rules of each trie, shared with the workers. */
+	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+
+	/* workers of a parallel build, and the tries they rebuild. */
+	struct acl_workers        *workers;
+	struct acl_trie_job       *jobs[RTE_ACL_MAX_TRIES];
+};
+
+/*
+ * Rebuild of a trie by a worker, with a build context of its own,
+ * so that it doesn't share the memory pool and free lists.
+ */
+struct acl_trie_job {
+	struct acl_build_context  bcx;
+	struct rte_acl_build_rule **rule_sets;
+	uint32_t                  n;
 };
 
 static int acl_merge_trie(struct acl_build_context *context,
@@ -769,7 +786,7 @@ acl_merge_trie(struct acl_build_context *context,
  *  - free allocated RT memory.
  *  - reset all RT related fields to zero.
  */
-static void
+void
 acl_build_reset(struct rte_acl_ctx *ctx)
 {
 	rte_free(ctx->mem);
@@ -1271,15 +1288,109 @@ build_one_trie(struct acl_build_context *context,
 	return last;
 }
 
+static int
+acl_trie_job_run(void *arg)
+{
+	int32_t rc;
+	struct acl_trie_job *job;
+	struct rte_acl_build_rule *last;
+
+	job = arg;
+
+	rc = sigsetjmp(job->bcx.pool.fail, 0);
+
+	/* rebuild runs out of memory. */
+	if (rc != 0)
+		return rc;
+
+	last = build_one_trie(&job->bcx, job->rule_sets, job->n, INT32_MAX);
+	if (job->bcx.bld_tries[job->n].trie == NULL || last != NULL) {
+		RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", job->n);
+		return -ENOMEM;
+	}
+	return 0;
+}
+
+/*
+ * Let a worker rebuild the n-th trie, while the caller goes on with
+ * the split of the remaining rules.
+ */
+static void
+acl_trie_job_launch(struct acl_build_context *context, uint32_t n)
+{
+	struct acl_trie_job *job;
+
+	job = acl_build_alloc(context, 1, sizeof(*job));
+
+	job->bcx.acx = context->acx;
+	/* rules of the first trie change the fields of context->cfg. */
+	job->bcx.cfg.num_categories = context->cfg.num_categories;
+	job->bcx.category_mask = context->category_mask;
+	job->bcx.node_max = context->node_max;
+	job->bcx.pool.alignment = ACL_POOL_ALIGN;
+	job->bcx.pool.min_alloc = ACL_POOL_ALLOC_MIN;
+	job->rule_sets = context->rule_sets;
+	job->n = n;
+
+	context->jobs[n] = job;
+	acl_workers_launch(context->workers, n % context->workers->num,
+		acl_trie_job_run, job);
+}
+
+/*
+ * Wait for the workers, and get the tries they rebuilt.
+ */
+static int
+acl_trie_jobs_wait(struct acl_build_context *context)
+{
+	int32_t rc;
+	uint32_t n;
+	struct acl_trie_job *job;
+
+	if (context->workers == NULL)
+		return 0;
+
+	rc = acl_workers_wait(context->workers);
+
+	for (n = 0; n != RTE_DIM(context->jobs); n++) {
+		job = context->jobs[n];
+		if (job == NULL)
+			continue;
+		context->tries[n] = job->bcx.tries[n];
+		context->bld_tries[n] = job->bcx.bld_tries[n];
+		memcpy(context->data_indexes[n], job->bcx.data_indexes[n],
+			sizeof(context->data_indexes[n]));
+		context->tries[n].data_index = context->data_indexes[n];
+		context->num_nodes += job->bcx.num_nodes;
+	}
+
+	return rc;
+}
+
+static void
+acl_free_pools(struct acl_build_context *context)
+{
+	uint32_t n;
+
+	for (n = 0; n != RTE_DIM(context->jobs); n++) {
+		if (context->jobs[n] != NULL)
+			tb_free_pool(&context->jobs[n]->bcx.pool);
+	}
+	tb_free_pool(&context->pool);
+}
+
 static int
 acl_build_tries(struct acl_build_context *context,
 	struct rte_acl_build_rule *head)
 {
+	int32_t k, rc;
 	uint32_t n, num_tries;
 	struct rte_acl_config *config;
 	struct rte_acl_build_rule *last;
-	struct rte_acl_build_rule *rule_sets[RTE_ACL_MAX_TRIES];
+	struct rte_acl_build_rule **rule_sets;
 
+	rc = 0;
+	rule_sets = context->rule_sets;
 	config = head->config;
 	rule_sets[0] = head;
 
@@ -1302,7 +1413,8 @@ acl_build_tries(struct acl_build_context *context,
 		last = build_one_trie(context, rule_sets, n, context->node_max);
 		if (context->bld_tries[n].trie == NULL) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
-			return -ENOMEM;
+			rc = -ENOMEM;
+			break;
 		}
 
 		/* Build of the last trie completed. */
@@ -1313,7 +1425,8 @@ acl_build_tries(struct acl_build_context *context,
 			RTE_LOG(ERR, ACL,
 				"Exceeded max number of tries: %u\n",
 				num_tries);
-			return -ENOMEM;
+			rc = -ENOMEM;
+			break;
 		}
 
 		/* Trie is getting too big, split remaining rule set. */
@@ -1334,22 +1447,40 @@ acl_build_tries(struct acl_build_context *context,
 		 * Rebuild the trie for the reduced rule-set.
 		 * Don't try to split it any further.
 		 */
+		if (context->workers != NULL) {
+			acl_trie_job_launch(context, n);
+			continue;
+		}
+
 		last = build_one_trie(context, rule_sets, n, INT32_MAX);
 		if (context->bld_tries[n].trie == NULL || last != NULL) {
 			RTE_LOG(ERR, ACL, "Build of %u-th trie failed\n", n);
-			return -ENOMEM;
+			rc = -ENOMEM;
+			break;
 		}
 
 	}
 
+	/* the rebuilt tries are only usable once all the workers are done. */
+	k = acl_trie_jobs_wait(context);
+	if (rc == 0)
+		rc = k;
+
 	context->num_tries = num_tries;
-	return 0;
+	return rc;
 }
 
 static void
 acl_build_log(const struct acl_build_context *ctx)
 {
 	uint32_t n;
+	size_t alloc;
+
+	alloc = ctx->pool.alloc;
+	for (n = 0; n != RTE_DIM(ctx->jobs); n++) {
+		if (ctx->jobs[n] != NULL)
+			alloc += ctx->jobs[n]->bcx.pool.alloc;
+	}
 
 	RTE_LOG(DEBUG, ACL, "Build phase for ACL \"%s\":\n"
 		"node limit for tree split: %u\n"
@@ -1358,7 +1489,7 @@ acl_build_log(const struct acl_build_context *ctx)
 		ctx->acx->name,
 		ctx->node_max,
 		ctx->num_nodes,
-		ctx->pool.alloc);
+		alloc);
 
 	for (n = 0; n < RTE_DIM(ctx->tries); n++) {
 		if (ctx->tries[n].count != 0)
@@ -1435,7 +1566,8 @@ acl_set_data_indexes(struct rte_acl_ctx *ctx)
  */
 static int
 acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
-	const struct rte_acl_config *cfg, uint32_t node_max)
+	const struct rte_acl_config *cfg, uint32_t node_max,
+	struct acl_workers *workers)
 {
 	int32_t rc;
 
@@ -1448,11 +1580,13 @@ acl_bld(struct acl_build_context *bcx, struct rte_acl_ctx *ctx,
 	bcx->category_mask = RTE_LEN2MASK(bcx->cfg.num_categories,
 		typeof(bcx->category_mask));
 	bcx->node_max = node_max;
+	bcx->workers = workers;
 
 	rc = sigsetjmp(bcx->pool.fail, 0);
 
 	/* build phase runs out of memory. */
 	if (rc != 0) {
+		acl_trie_jobs_wait(bcx);
 		RTE_LOG(ERR, ACL,
 			"ACL context: %s, %s() failed with error code: %d\n",
 			bcx->acx->name, __func__, rc);
@@ -1517,18 +1651,16 @@ acl_check_bld_param(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 	return 0;
 }
 
-int
-rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+static int
+acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg,
+	struct acl_workers *workers)
 {
 	int32_t rc;
 	uint32_t n;
 	size_t max_size;
 	struct acl_build_context bcx;
 
-	rc = acl_check_bld_param(ctx, cfg);
-	if (rc != 0)
-		return rc;
-
+	acl_update_reset(ctx);
 	acl_build_reset(ctx);
 
 	if (cfg->max_size == 0) {
@@ -1542,14 +1674,15 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 	for (rc = -ERANGE; n >= NODE_MIN && rc == -ERANGE; n /= 2) {
 
 		/* perform build phase. */
-		rc = acl_bld(&bcx, ctx, cfg, n);
+		rc = acl_bld(&bcx, ctx, cfg, n, workers);
 
 		if (rc == 0) {
 			/* allocate and fill run-time  structures. */
 			rc = rte_acl_gen(ctx, bcx.tries, bcx.bld_tries,
 				bcx.num_tries, bcx.cfg.num_categories,
 				RTE_ACL_MAX_FIELDS * RTE_DIM(bcx.tries) *
-				sizeof(ctx->data_indexes[0]), max_size);
+				sizeof(ctx->data_indexes[0]), max_size,
+				workers);
 			if (rc == 0) {
 				/* set data indexes. */
 				acl_set_data_indexes(ctx);
@@ -1562,8 +1695,42 @@ rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
 		acl_build_log(&bcx);
 
 		/* cleanup after build. */
-		tb_free_pool(&bcx.pool);
+		acl_free_pools(&bcx);
 	}
 
 	return rc;
 }
+
+int
+rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg)
+{
+	int32_t rc;
+
+	rc = acl_check_bld_param(ctx, cfg);
+	if (rc != 0)
+		return rc;
+
+	return acl_build(ctx, cfg, NULL);
+}
+
+int __rte_experimental
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg,
+	const struct rte_acl_build_workers *workers)
+{
+	int32_t rc;
+	struct acl_workers wrk;
+
+	rc = acl_check_bld_param(ctx, cfg);
+	if (rc != 0)
+		return rc;
+
+	if (workers == NULL)
+		return -EINVAL;
+
+	rc = acl_workers_init(&wrk, workers->num_workers, workers->lcore_id);
+	if (rc != 0)
+		return rc;
+
+	return acl_build(ctx, cfg, (wrk.num != 0) ? &wrk : NULL);
+}
@@ -414,21 +414,62 @@ acl_gen_node(struct rte_acl_node *node, uint64_t *node_array,
 	}
 }
 
+/* Per trie state of the generation, each trie is done by its own job. */
+struct acl_gen_trie {
+	struct rte_acl_node       *root;
+	uint64_t                  *node_array;
+	uint64_t                   no_match;
+	int32_t                    num_categories;
+	struct acl_node_counters   counts;
+	struct rte_acl_indices     indices;
+};
+
+static int
+acl_gen_count_job(void *arg)
+{
+	struct acl_gen_trie *gt;
+
+	gt = arg;
+	acl_count_trie_types(&gt->counts, gt->root, gt->no_match, 1);
+	return 0;
+}
+
+static int
+acl_gen_node_job(void *arg)
+{
+	struct acl_gen_trie *gt;
+
+	gt = arg;
+	acl_gen_node(gt->root, gt->node_array, gt->no_match, &gt->indices,
+		gt->num_categories);
+	return 0;
+}
+
+/*
+ * Each trie gets its own slice of every region of the runtime structure,
+ * in the order of the tries, which is the layout a walk of all the tries
+ * one after the other would give.
+ */
 static void
 acl_calc_counts_indices(struct acl_node_counters *counts,
 	struct rte_acl_indices *indices,
-	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint64_t no_match)
+	struct acl_gen_trie *gen_trie, uint32_t num_tries)
 {
 	uint32_t n;
+	const struct acl_node_counters *c;
 
 	memset(indices, 0, sizeof(*indices));
 	memset(counts, 0, sizeof(*counts));
 
 	/* Get stats on nodes */
 	for (n = 0; n < num_tries; n++) {
-		acl_count_trie_types(counts, node_bld_trie[n].trie,
-			no_match, 1);
+		c = &gen_trie[n].counts;
+		counts->match += c->match;
+		counts->single += c->single;
+		counts->quad += c->quad;
+		counts->quad_vectors += c->quad_vectors;
+		counts->dfa += c->dfa;
+		counts->dfa_gr64 += c->dfa_gr64;
 	}
 
 	indices->dfa_index = RTE_ACL_DFA_SIZE + 1;
@@ -439,6 +480,15 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 	indices->match_start = RTE_ALIGN(indices->match_start,
 		(XMM_SIZE / sizeof(uint64_t)));
 	indices->match_index = 1;
+
+	for (n = 0; n < num_tries; n++) {
+		c = &gen_trie[n].counts;
+		gen_trie[n].indices = *indices;
+		indices->dfa_index += c->dfa_gr64 * RTE_ACL_DFA_GR64_SIZE;
+		indices->quad_index += c->quad_vectors;
+		indices->single_index += c->single;
+		indices->match_index += c->match;
+	}
 }
 
 /*
@@ -447,7 +497,8 @@ acl_calc_counts_indices(struct acl_node_counters *counts,
 int
 rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_bld_trie *node_bld_trie, uint32_t num_tries,
-	uint32_t num_categories, uint32_t data_index_sz, size_t max_size)
+	uint32_t num_categories, uint32_t data_index_sz, size_t max_size,
+	struct acl_workers *workers)
 {
 	void *mem;
 	size_t total_size;
@@ -456,12 +507,21 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	struct rte_acl_match_results *match;
 	struct acl_node_counters counts;
 	struct rte_acl_indices indices;
+	struct acl_gen_trie gen_trie[RTE_ACL_MAX_TRIES];
 
 	no_match = RTE_ACL_NODE_MATCH;
 
+	memset(gen_trie, 0, sizeof(gen_trie));
+	for (n = 0; n < num_tries; n++) {
+		gen_trie[n].root = node_bld_trie[n].trie;
+		gen_trie[n].no_match = no_match;
+		gen_trie[n].num_categories = num_categories;
+	}
+
 	/* Fill counts and indices arrays from the nodes. */
-	acl_calc_counts_indices(&counts, &indices,
-		node_bld_trie, num_tries, no_match);
+	acl_workers_run(workers, acl_gen_count_job, gen_trie,
+		sizeof(gen_trie[0]), num_tries);
+	acl_calc_counts_indices(&counts, &indices, gen_trie, num_tries);
 
 	/* Allocate runtime memory (align to cache boundary) */
 	total_size = RTE_ALIGN(data_index_sz, RTE_CACHE_LINE_SIZE) +
@@ -505,11 +565,13 @@ rte_acl_gen(struct rte_acl_ctx *ctx, struct rte_acl_trie *trie,
 	match = ((struct rte_acl_match_results *)(node_array + match_index));
 	memset(match, 0, sizeof(*match));
 
-	for (n = 0; n < num_tries; n++) {
+	for (n = 0; n < num_tries; n++)
+		gen_trie[n].node_array = node_array;
 
-		acl_gen_node(node_bld_trie[n].trie, node_array, no_match,
-			&indices, num_categories);
+	acl_workers_run(workers, acl_gen_node_job, gen_trie,
+		sizeof(gen_trie[0]), num_tries);
 
+	for (n = 0; n < num_tries; n++) {
 		if (node_bld_trie[n].trie->node_index == no_match)
 			trie[n].root_index = 0;
 		else
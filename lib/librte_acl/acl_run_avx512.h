@@ -0,0 +1,338 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include "acl_run_sse.h"
+
+#define MAX_SEARCHES_AVX512X16	16
+#define MAX_SEARCHES_AVX512X32	32
+
+/* Positions of the low and high 32 bits of 16 transitions in 2 registers. */
+static __rte_always_inline __m512i
+zmm_tr_lo_idx(void)
+{
+	return _mm512_set_epi32(30, 28, 26, 24, 22, 20, 18, 16,
+		14, 12, 10, 8, 6, 4, 2, 0);
+}
+
+static __rte_always_inline __m512i
+zmm_tr_hi_idx(void)
+{
+	return _mm512_set_epi32(31, 29, 27, 25, 23, 21, 19, 17,
+		15, 13, 11, 9, 7, 5, 3, 1);
+}
+
+/*
+ * Calculate the address of the next transition for 16 flows,
+ * see ACL_TR_CALC_ADDR() for the details.
+ * AVX512 has no byte blend and sign, the comparisons return masks instead.
+ */
+static __rte_always_inline __m512i
+acl_calc_addr_avx512x16(__m512i next_input, __m512i tr_lo, __m512i tr_hi)
+{
+	__m512i addr, in, node_type, r, t, dfa_ofs, quad_ofs;
+	__mmask16 dfa_msk;
+	__mmask64 quad_msk;
+
+	in = _mm512_shuffle_epi8(next_input,
+		_mm512_broadcast_i32x4(xmm_shuffle_input.x));
+
+	/* Calc node type and node addr */
+	node_type = _mm512_andnot_si512(
+		_mm512_set1_epi32(RTE_ACL_NODE_INDEX), tr_lo);
+	addr = _mm512_and_si512(_mm512_set1_epi32(RTE_ACL_NODE_INDEX), tr_lo);
+
+	/* mask for DFA type(0) nodes */
+	dfa_msk = _mm512_cmpeq_epi32_mask(node_type, _mm512_setzero_si512());
+
+	/* DFA calculations. */
+	r = _mm512_srli_epi32(in, 30);
+	r = _mm512_add_epi8(r, _mm512_broadcast_i32x4(xmm_range_base.x));
+	t = _mm512_srli_epi32(in, 24);
+	r = _mm512_shuffle_epi8(tr_hi, r);
+
+	dfa_ofs = _mm512_sub_epi32(t, r);
+
+	/* QUAD/SINGLE calculations. */
+	quad_msk = _mm512_cmpgt_epi8_mask(in, tr_hi);
+	t = _mm512_maskz_mov_epi8(quad_msk, _mm512_set1_epi8(1));
+	t = _mm512_maddubs_epi16(t, t);
+	quad_ofs = _mm512_madd_epi16(t, _mm512_set1_epi16(1));
+
+	/* blend DFA and QUAD/SINGLE. */
+	t = _mm512_mask_mov_epi32(quad_ofs, dfa_msk, dfa_ofs);
+
+	/* calculate address for next transitions. */
+	return _mm512_add_epi32(addr, t);
+}
+
+/*
+ * Process 16 transitions in parallel.
+ * tr_lo contains low 32 bits for 16 transitions.
+ * tr_hi contains high 32 bits for 16 transitions.
+ * next_input contains up to 4 input bytes for 16 flows.
+ * Unlike AVX2, the transitions are gathered whole, 8 at a time, which
+ * takes half of the loads of gathering their low and high 32 bits apart.
+ */
+static __rte_always_inline __m512i
+transition16(__m512i next_input, const uint64_t *trans, __m512i *tr_lo,
+	__m512i *tr_hi)
+{
+	__m512i addr, t0, t1;
+
+	/* Calculate the address (array index) for all 16 transitions. */
+	addr = acl_calc_addr_avx512x16(next_input, *tr_lo, *tr_hi);
+
+	/* load 16 transitions, 8 at once. */
+	t0 = _mm512_i32gather_epi64(_mm512_castsi512_si256(addr), trans,
+		sizeof(trans[0]));
+	t1 = _mm512_i32gather_epi64(_mm512_extracti64x4_epi64(addr, 1), trans,
+		sizeof(trans[0]));
+
+	next_input = _mm512_srli_epi32(next_input, CHAR_BIT);
+
+	/* put low 32 into tr_lo and high 32 into tr_hi */
+	*tr_lo = _mm512_permutex2var_epi32(t0, zmm_tr_lo_idx(), t1);
+	*tr_hi = _mm512_permutex2var_epi32(t0, zmm_tr_hi_idx(), t1);
+
+	return next_input;
+}
+
+/*
+ * Resolve priority for multiple results (avx512 version).
+ * All the categories fit in one register, so they are compared at once.
+ */
+static inline void
+resolve_priority_avx512(uint64_t transition, int n,
+	const struct rte_acl_ctx *ctx, struct parms *parms,
+	const struct rte_acl_match_results *p, uint32_t categories)
+{
+	__m512i results, priority, results1, priority1;
+	__mmask16 msk, selector;
+
+	msk = RTE_LEN2MASK(categories, __mmask16);
+
+	/* get results and priorities for completed trie */
+	results = _mm512_maskz_loadu_epi32(msk, p[transition].results);
+	priority = _mm512_maskz_loadu_epi32(msk, p[transition].priority);
+
+	/* if this is not the first completed trie */
+	if (parms[n].cmplt->count != ctx->num_tries) {
+
+		/* get running best results and their priorities */
+		results1 = _mm512_maskz_loadu_epi32(msk,
+			parms[n].cmplt->results);
+		priority1 = _mm512_maskz_loadu_epi32(msk,
+			parms[n].cmplt->priority);
+
+		/* select results that are highest priority */
+		selector = _mm512_cmpgt_epi32_mask(priority1, priority);
+		results = _mm512_mask_mov_epi32(results, selector, results1);
+		priority = _mm512_mask_mov_epi32(priority, selector, priority1);
+	}
+
+	/* save running best results and their priorities */
+	_mm512_mask_storeu_epi32(parms[n].cmplt->results, msk, results);
+	_mm512_mask_storeu_epi32(parms[n].cmplt->priority, msk, priority);
+}
+
+/*
+ * Process matches for 16 flows.
+ * Only the flows that reached a match node are extracted.
+ */
+static inline void
+acl_process_matches_avx512x16(const struct rte_acl_ctx *ctx,
+	struct parms *parms, struct acl_flow_data *flows, uint32_t slot,
+	__mmask16 matches, __m512i *tr_lo, __m512i *tr_hi)
+{
+	uint32_t i, msk;
+	uint64_t tr;
+	uint32_t lo[MAX_SEARCHES_AVX512X16], hi[MAX_SEARCHES_AVX512X16];
+
+	_mm512_storeu_si512(lo, *tr_lo);
+	_mm512_storeu_si512(hi, *tr_hi);
+
+	for (msk = matches; msk != 0; msk &= msk - 1) {
+		i = __builtin_ctz(msk);
+		tr = (uint64_t)hi[i] << 32 | lo[i];
+		tr = acl_match_check(tr, slot + i, ctx, parms, flows,
+			resolve_priority_avx512);
+
+		/* put the new transition back in its lane. */
+		*tr_lo = _mm512_mask_set1_epi32(*tr_lo, 1 << i, tr);
+		*tr_hi = _mm512_mask_set1_epi32(*tr_hi, 1 << i, tr >> 32);
+	}
+}
+
+static inline void
+acl_match_check_avx512x16(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot,
+	__m512i *tr_lo, __m512i *tr_hi)
+{
+	__mmask16 matches;
+
+	/* test for match node */
+	matches = _mm512_test_epi32_mask(*tr_lo,
+		_mm512_set1_epi32(RTE_ACL_NODE_MATCH));
+
+	while (matches != 0) {
+		acl_process_matches_avx512x16(ctx, parms, flows, slot,
+			matches, tr_lo, tr_hi);
+		matches = _mm512_test_epi32_mask(*tr_lo,
+			_mm512_set1_epi32(RTE_ACL_NODE_MATCH));
+	}
+}
+
+/*
+ * Start the traversals of the first 16 flows from a slot.
+ */
+static inline void
+acl_start_avx512x16(const struct rte_acl_ctx *ctx, struct parms *parms,
+	struct acl_flow_data *flows, uint32_t slot,
+	__m512i *tr_lo, __m512i *tr_hi)
+{
+	uint32_t i;
+	uint64_t tr;
+	uint32_t lo[MAX_SEARCHES_AVX512X16], hi[MAX_SEARCHES_AVX512X16];
+
+	for (i = 0; i != MAX_SEARCHES_AVX512X16; i++) {
+		tr = acl_start_next_trie(flows, parms, slot + i, ctx);
+		lo[i] = (uint32_t)tr;
+		hi[i] = tr >> 32;
+	}
+
+	*tr_lo = _mm512_loadu_si512(lo);
+	*tr_hi = _mm512_loadu_si512(hi);
+
+	 /* Check for any matches. */
+	acl_match_check_avx512x16(ctx, parms, flows, slot, tr_lo, tr_hi);
+}
+
+/*
+ * Gather 4 bytes of input data for 16 flows.
+ */
+static __rte_always_inline __m512i
+acl_get_input_avx512x16(struct parms *parms, uint32_t slot)
+{
+	uint32_t in[MAX_SEARCHES_AVX512X16];
+
+	in[0] = GET_NEXT_4BYTES(parms, slot + 0);
+	in[1] = GET_NEXT_4BYTES(parms, slot + 1);
+	in[2] = GET_NEXT_4BYTES(parms, slot + 2);
+	in[3] = GET_NEXT_4BYTES(parms, slot + 3);
+	in[4] = GET_NEXT_4BYTES(parms, slot + 4);
+	in[5] = GET_NEXT_4BYTES(parms, slot + 5);
+	in[6] = GET_NEXT_4BYTES(parms, slot + 6);
+	in[7] = GET_NEXT_4BYTES(parms, slot + 7);
+	in[8] = GET_NEXT_4BYTES(parms, slot + 8);
+	in[9] = GET_NEXT_4BYTES(parms, slot + 9);
+	in[10] = GET_NEXT_4BYTES(parms, slot + 10);
+	in[11] = GET_NEXT_4BYTES(parms, slot + 11);
+	in[12] = GET_NEXT_4BYTES(parms, slot + 12);
+	in[13] = GET_NEXT_4BYTES(parms, slot + 13);
+	in[14] = GET_NEXT_4BYTES(parms, slot + 14);
+	in[15] = GET_NEXT_4BYTES(parms, slot + 15);
+
+	/* build the vector in registers, not through the stack. */
+	return _mm512_set_epi32(in[15], in[14], in[13], in[12],
+		in[11], in[10], in[9], in[8], in[7], in[6], in[5], in[4],
+		in[3], in[2], in[1], in[0]);
+}
+
+/*
+ * Execute trie traversal for up to 16 flows in parallel.
+ */
+static inline int
+search_avx512x16(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	struct completion cmplt[MAX_SEARCHES_AVX512X16];
+	struct parms parms[MAX_SEARCHES_AVX512X16];
+	__m512i input, tr_lo, tr_hi;
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n < RTE_DIM(cmplt); n++)
+		cmplt[n].count = 0;
+
+	acl_start_avx512x16(ctx, parms, &flows, 0, &tr_lo, &tr_hi);
+
+	while (flows.started > 0) {
+
+		input = acl_get_input_avx512x16(parms, 0);
+
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+		input = transition16(input, flows.trans, &tr_lo, &tr_hi);
+
+		 /* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0,
+			&tr_lo, &tr_hi);
+	}
+
+	return 0;
+}
+
+/*
+ * Execute trie traversal for up to 32 flows in parallel,
+ * interleaving two sets of 16 flows to hide the latency of the gathers.
+ */
+static inline int
+search_avx512x32(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t total_packets, uint32_t categories)
+{
+	uint32_t n;
+	struct acl_flow_data flows;
+	struct completion cmplt[MAX_SEARCHES_AVX512X32];
+	struct parms parms[MAX_SEARCHES_AVX512X32];
+	__m512i input[2], tr_lo[2], tr_hi[2];
+
+	acl_set_flow(&flows, cmplt, RTE_DIM(cmplt), data, results,
+		total_packets, categories, ctx->trans_table);
+
+	for (n = 0; n < RTE_DIM(cmplt); n++)
+		cmplt[n].count = 0;
+
+	acl_start_avx512x16(ctx, parms, &flows, 0, &tr_lo[0], &tr_hi[0]);
+	acl_start_avx512x16(ctx, parms, &flows, MAX_SEARCHES_AVX512X16,
+		&tr_lo[1], &tr_hi[1]);
+
+	while (flows.started > 0) {
+
+		input[0] = acl_get_input_avx512x16(parms, 0);
+		input[1] = acl_get_input_avx512x16(parms,
+			MAX_SEARCHES_AVX512X16);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		input[0] = transition16(input[0], flows.trans,
+			&tr_lo[0], &tr_hi[0]);
+		input[1] = transition16(input[1], flows.trans,
+			&tr_lo[1], &tr_hi[1]);
+
+		 /* Check for any matches. */
+		acl_match_check_avx512x16(ctx, parms, &flows, 0,
+			&tr_lo[0], &tr_hi[0]);
+		acl_match_check_avx512x16(ctx, parms, &flows,
+			MAX_SEARCHES_AVX512X16, &tr_lo[1], &tr_hi[1]);
+	}
+
+	return 0;
+}
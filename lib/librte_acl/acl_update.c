@@ -0,0 +1,523 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <rte_acl.h>
+#include "acl.h"
+
+/*
+ * Incremental updates of a built context.
+ * The rules added since the last build go in a small delta context, that
+ * is built on its own, and classify runs both the main and the delta tries,
+ * keeping for each category the result with the highest priority.
+ * A deleted rule of the main tries is only flagged as such, and the rules
+ * of lower priority that it overlaps are copied in the delta, so that
+ * whenever the main tries return a deleted rule, the delta holds the
+ * right result.
+ * The next rte_acl_build() folds everything back in the main tries.
+ */
+
+/* Number of input buffers classified at once with the delta. */
+#define ACL_UPDATE_BURST	64
+
+struct acl_rule_prio {
+	uint32_t userdata;
+	int32_t  priority;
+	uint32_t deleted;
+};
+
+static inline const struct rte_acl_rule *
+acl_update_rule(const struct rte_acl_ctx *ctx, uint32_t i)
+{
+	return (const struct rte_acl_rule *)
+		((uintptr_t)ctx->rules + ctx->rule_sz * i);
+}
+
+static int
+acl_rule_prio_cmp(const void *a, const void *b)
+{
+	const struct acl_rule_prio *pa = a;
+	const struct acl_rule_prio *pb = b;
+
+	return (pa->userdata > pb->userdata) - (pa->userdata < pb->userdata);
+}
+
+static inline struct acl_rule_prio *
+acl_rule_prio_find(const struct rte_acl_ctx *ctx, uint32_t userdata)
+{
+	uint32_t lo, hi, mid;
+
+	lo = 0;
+	hi = ctx->num_rule_prio;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (ctx->rule_prio[mid].userdata < userdata)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == ctx->num_rule_prio || ctx->rule_prio[lo].userdata != userdata)
+		return NULL;
+	return ctx->rule_prio + lo;
+}
+
+/*
+ * Index the priorities of the rules of a context by userdata,
+ * which also checks that the userdata of the rules are unique.
+ */
+static int
+acl_rule_prio_build(struct rte_acl_ctx *ctx)
+{
+	struct acl_rule_prio *rp;
+	const struct rte_acl_rule *rule;
+	uint32_t i, n;
+
+	rte_free(ctx->rule_prio);
+	ctx->rule_prio = NULL;
+	ctx->num_rule_prio = 0;
+
+	n = ctx->num_rules;
+	if (n == 0)
+		return 0;
+
+	rp = rte_malloc_socket(NULL, n * sizeof(rp[0]), 0, ctx->socket_id);
+	if (rp == NULL)
+		return -ENOMEM;
+
+	for (i = 0; i != n; i++) {
+		rule = acl_update_rule(ctx, i);
+		rp[i].userdata = rule->data.userdata;
+		rp[i].priority = rule->data.priority;
+		rp[i].deleted = 0;
+	}
+
+	qsort(rp, n, sizeof(rp[0]), acl_rule_prio_cmp);
+
+	for (i = 0; i != n; i++) {
+		if (rp[i].userdata == 0 ||
+				(i != 0 && rp[i].userdata == rp[i - 1].userdata)) {
+			RTE_LOG(ERR, ACL,
+				"ACL context: %s, userdata %u is not unique\n",
+				ctx->name, rp[i].userdata);
+			rte_free(rp);
+			return -EINVAL;
+		}
+	}
+
+	ctx->rule_prio = rp;
+	ctx->num_rule_prio = n;
+	return 0;
+}
+
+void
+acl_update_reset(struct rte_acl_ctx *ctx)
+{
+	if (ctx->delta != NULL) {
+		rte_free(ctx->delta->rule_prio);
+		rte_free(ctx->delta->mem);
+		rte_free(ctx->delta);
+		ctx->delta = NULL;
+	}
+
+	rte_free(ctx->rule_prio);
+	ctx->rule_prio = NULL;
+	ctx->num_rule_prio = 0;
+}
+
+/*
+ * Setup the delta context at the first update after a build.
+ */
+static int
+acl_update_init(struct rte_acl_ctx *ctx)
+{
+	struct rte_acl_ctx *delta;
+	size_t sz;
+	int32_t rc;
+
+	if (ctx->delta != NULL)
+		return 0;
+
+	if (ctx->num_tries == 0)
+		return -EINVAL;
+
+	rc = acl_rule_prio_build(ctx);
+	if (rc != 0)
+		return rc;
+
+	sz = sizeof(*delta) + ctx->max_rules * ctx->rule_sz;
+	delta = rte_zmalloc_socket(ctx->name, sz, RTE_CACHE_LINE_SIZE,
+		ctx->socket_id);
+	if (delta == NULL) {
+		RTE_LOG(ERR, ACL,
+			"allocation of %zu bytes on socket %d for %s failed\n",
+			sz, ctx->socket_id, ctx->name);
+		acl_update_reset(ctx);
+		return -ENOMEM;
+	}
+
+	delta->rules = delta + 1;
+	delta->max_rules = ctx->max_rules;
+	delta->rule_sz = ctx->rule_sz;
+	delta->socket_id = ctx->socket_id;
+	delta->alg = ctx->alg;
+	snprintf(delta->name, sizeof(delta->name), "%s", ctx->name);
+
+	ctx->delta = delta;
+	return 0;
+}
+
+/*
+ * Rebuild the delta tries from its rules.
+ */
+static int
+acl_update_build(struct rte_acl_ctx *ctx)
+{
+	struct rte_acl_ctx *delta;
+	uint32_t i, mask;
+	int32_t rc;
+
+	delta = ctx->delta;
+	mask = RTE_LEN2MASK(ctx->config.num_categories, uint32_t);
+
+	for (i = 0; i != delta->num_rules; i++) {
+		if ((acl_update_rule(delta, i)->data.category_mask & mask) != 0)
+			break;
+	}
+
+	/* no rule to search for, only filter out the deleted rules. */
+	if (i == delta->num_rules) {
+		acl_update_reset(delta);
+		acl_build_reset(delta);
+		return 0;
+	}
+
+	rc = rte_acl_build(delta, &ctx->config);
+	if (rc == 0)
+		rc = acl_rule_prio_build(delta);
+	return rc;
+}
+
+static int
+acl_update_find(const struct rte_acl_ctx *ctx, uint32_t userdata)
+{
+	uint32_t i;
+
+	for (i = 0; i != ctx->num_rules; i++) {
+		if (acl_update_rule(ctx, i)->data.userdata == userdata)
+			return i;
+	}
+	return -ENOENT;
+}
+
+static void
+acl_update_remove(struct rte_acl_ctx *ctx, uint32_t i)
+{
+	uint8_t *pos;
+
+	pos = (uint8_t *)ctx->rules + ctx->rule_sz * i;
+	memmove(pos, pos + ctx->rule_sz,
+		ctx->rule_sz * (ctx->num_rules - i - 1));
+	ctx->num_rules--;
+}
+
+static inline uint64_t
+acl_field_value(const union rte_acl_field_types *v, uint8_t size)
+{
+	switch (size) {
+	case sizeof(uint8_t):
+		return v->u8;
+	case sizeof(uint16_t):
+		return v->u16;
+	case sizeof(uint32_t):
+		return v->u32;
+	default:
+		return v->u64;
+	}
+}
+
+/*
+ * Check if there are input buffers that could match both rules,
+ * with the same interpretation of the fields as acl_build_tries().
+ */
+static int
+acl_rules_overlap(const struct rte_acl_rule *r1,
+	const struct rte_acl_rule *r2, const struct rte_acl_config *cfg)
+{
+	const struct rte_acl_field *f1, *f2;
+	uint64_t v1, v2, m1, m2;
+	uint32_t i;
+	uint8_t size;
+
+	if ((r1->data.category_mask & r2->data.category_mask &
+			RTE_LEN2MASK(cfg->num_categories, uint32_t)) == 0)
+		return 0;
+
+	for (i = 0; i != cfg->num_fields; i++) {
+		f1 = r1->field + cfg->defs[i].field_index;
+		f2 = r2->field + cfg->defs[i].field_index;
+		size = cfg->defs[i].size;
+
+		v1 = acl_field_value(&f1->value, size);
+		v2 = acl_field_value(&f2->value, size);
+		m1 = acl_field_value(&f1->mask_range, size);
+		m2 = acl_field_value(&f2->mask_range, size);
+
+		switch (cfg->defs[i].type) {
+		case RTE_ACL_FIELD_TYPE_MASK:
+			m1 = RTE_ACL_MASKLEN_TO_BITMASK(f1->mask_range.u32,
+				size);
+			m2 = RTE_ACL_MASKLEN_TO_BITMASK(f2->mask_range.u32,
+				size);
+			/* fall through */
+		case RTE_ACL_FIELD_TYPE_BITMASK:
+			if (((v1 ^ v2) & m1 & m2) != 0)
+				return 0;
+			break;
+		case RTE_ACL_FIELD_TYPE_RANGE:
+			if (v1 > m2 || v2 > m1)
+				return 0;
+			break;
+		}
+	}
+
+	return 1;
+}
+
+int __rte_experimental
+rte_acl_update_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num)
+{
+	const struct acl_rule_prio *rp;
+	const struct rte_acl_rule *rule;
+	struct rte_acl_ctx *delta;
+	uint32_t i, j;
+	int32_t rc;
+
+	if (ctx == NULL || rules == NULL || ctx->rule_sz == 0)
+		return -EINVAL;
+
+	rc = acl_update_init(ctx);
+	if (rc != 0)
+		return rc;
+
+	delta = ctx->delta;
+	if (num + ctx->num_rules > ctx->max_rules)
+		return -ENOMEM;
+
+	for (i = 0; i != num; i++) {
+		rule = (const struct rte_acl_rule *)
+			((uintptr_t)rules + i * ctx->rule_sz);
+		if (rule->data.userdata == 0)
+			return -EINVAL;
+
+		rp = acl_rule_prio_find(ctx, rule->data.userdata);
+		if ((rp != NULL && rp->deleted == 0) ||
+				acl_update_find(delta,
+					rule->data.userdata) >= 0)
+			return -EEXIST;
+
+		for (j = 0; j != i; j++) {
+			if (rule->data.userdata == ((const struct rte_acl_rule *)
+					((uintptr_t)rules + j * ctx->rule_sz))
+					->data.userdata)
+				return -EEXIST;
+		}
+	}
+
+	/* checks the rules, they can then be added to the context too. */
+	rc = rte_acl_add_rules(delta, rules, num);
+	if (rc != 0)
+		return rc;
+
+	rc = acl_update_build(ctx);
+	if (rc != 0) {
+		delta->num_rules -= num;
+		acl_update_build(ctx);
+		return rc;
+	}
+
+	return rte_acl_add_rules(ctx, rules, num);
+}
+
+/*
+ * Copy in the delta the rules of the context that could match
+ * the input buffers that a deleted rule was hiding.
+ */
+static int
+acl_update_shadow(struct rte_acl_ctx *ctx, const struct rte_acl_rule *del)
+{
+	const struct rte_acl_rule *rule;
+	struct rte_acl_ctx *delta;
+	uint32_t i;
+	int32_t rc;
+
+	delta = ctx->delta;
+
+	for (i = 0; i != ctx->num_rules; i++) {
+		rule = acl_update_rule(ctx, i);
+		if (rule == del || rule->data.priority > del->data.priority ||
+				!acl_rules_overlap(rule, del, &ctx->config) ||
+				acl_update_find(delta,
+					rule->data.userdata) >= 0)
+			continue;
+
+		rc = rte_acl_add_rules(delta, rule, 1);
+		if (rc != 0)
+			return rc;
+	}
+
+	return 0;
+}
+
+/*
+ * Undo the changes of a deletion that failed: restore the rules of the
+ * delta and clear the deleted flags.
+ */
+static void
+acl_update_del_undo(struct rte_acl_ctx *ctx, const uint32_t *userdata,
+	uint32_t num, const void *delta_rules, uint32_t num_delta)
+{
+	struct acl_rule_prio *rp;
+	struct rte_acl_ctx *delta;
+	uint32_t i;
+
+	for (i = 0; i != num; i++) {
+		rp = acl_rule_prio_find(ctx, userdata[i]);
+		if (rp != NULL)
+			rp->deleted = 0;
+	}
+
+	delta = ctx->delta;
+	if (num_delta != 0)
+		memcpy(delta->rules, delta_rules, num_delta * delta->rule_sz);
+	delta->num_rules = num_delta;
+}
+
+int __rte_experimental
+rte_acl_update_del_rules(struct rte_acl_ctx *ctx, const uint32_t *userdata,
+	uint32_t num)
+{
+	struct acl_rule_prio *rp;
+	struct rte_acl_ctx *delta;
+	void *delta_rules;
+	uint32_t i, j, num_delta;
+	int32_t k, rc;
+
+	if (ctx == NULL || userdata == NULL)
+		return -EINVAL;
+
+	rc = acl_update_init(ctx);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i != num; i++) {
+		if (acl_update_find(ctx, userdata[i]) < 0)
+			return -ENOENT;
+
+		for (j = 0; j != i; j++) {
+			if (userdata[i] == userdata[j])
+				return -EINVAL;
+		}
+	}
+
+	/* keep the rules of the delta, to restore them on error. */
+	delta = ctx->delta;
+	num_delta = delta->num_rules;
+	delta_rules = NULL;
+	if (num_delta != 0) {
+		delta_rules = rte_malloc(NULL, num_delta * delta->rule_sz, 0);
+		if (delta_rules == NULL)
+			return -ENOMEM;
+		memcpy(delta_rules, delta->rules, num_delta * delta->rule_sz);
+	}
+
+	/*
+	 * Flag the rules of the main tries as deleted, and copy the rules
+	 * they hide in the delta.
+	 */
+	for (i = 0; i != num && rc == 0; i++) {
+		rp = acl_rule_prio_find(ctx, userdata[i]);
+		if (rp == NULL)
+			continue;
+
+		rp->deleted = 1;
+		k = acl_update_find(ctx, userdata[i]);
+		rc = acl_update_shadow(ctx, acl_update_rule(ctx, k));
+	}
+
+	if (rc == 0) {
+		for (i = 0; i != num; i++) {
+			k = acl_update_find(delta, userdata[i]);
+			if (k >= 0)
+				acl_update_remove(delta, k);
+		}
+		rc = acl_update_build(ctx);
+	}
+
+	/* the rules are only removed from the context once all went well */
+	if (rc != 0) {
+		acl_update_del_undo(ctx, userdata, num, delta_rules, num_delta);
+		acl_update_build(ctx);
+	} else {
+		for (i = 0; i != num; i++) {
+			k = acl_update_find(ctx, userdata[i]);
+			acl_update_remove(ctx, k);
+		}
+	}
+
+	rte_free(delta_rules);
+	return rc;
+}
+
+int
+acl_classify_update(const struct rte_acl_ctx *ctx, const uint8_t **data,
+	uint32_t *results, uint32_t num, uint32_t categories,
+	rte_acl_classify_t classify)
+{
+	uint32_t dres[ACL_UPDATE_BURST * RTE_ACL_MAX_CATEGORIES];
+	const struct rte_acl_ctx *delta;
+	const struct acl_rule_prio *mp, *dp;
+	uint32_t i, k, n, *res;
+	int32_t rc;
+
+	delta = ctx->delta;
+
+	rc = classify(ctx, data, results, num, categories);
+	if (rc != 0)
+		return rc;
+
+	for (i = 0; i < num; i += n) {
+		n = RTE_MIN(num - i, (uint32_t)ACL_UPDATE_BURST);
+		res = results + i * categories;
+
+		if (delta->num_tries != 0) {
+			rc = classify(delta, data + i, dres, n, categories);
+			if (rc != 0)
+				return rc;
+		} else
+			memset(dres, 0, n * categories * sizeof(dres[0]));
+
+		for (k = 0; k != n * categories; k++) {
+
+			mp = NULL;
+			if (res[k] != 0) {
+				mp = acl_rule_prio_find(ctx, res[k]);
+				if (mp == NULL || mp->deleted != 0) {
+					res[k] = 0;
+					mp = NULL;
+				}
+			}
+
+			if (dres[k] == 0)
+				continue;
+
+			dp = acl_rule_prio_find(delta, dres[k]);
+			if (mp == NULL || (dp != NULL &&
+					dp->priority > mp->priority))
+				res[k] = dres[k];
+		}
+	}
+
+	return 0;
+}
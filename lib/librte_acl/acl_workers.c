@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <rte_acl.h>
+#include <rte_lcore.h>
+#include "acl.h"
+
+/*
+ * Worker threads of a parallel build.
+ * Each worker runs at most one job at a time: launching a job on a busy
+ * worker waits for its previous job first. Jobs never depend on which
+ * worker runs them, so the result of the build is the same whatever the
+ * number of workers. If a job cannot be launched, the caller runs it.
+ */
+
+int
+acl_workers_init(struct acl_workers *wrk, uint32_t num,
+	const unsigned int *lcore_id)
+{
+	uint32_t i, j;
+
+	memset(wrk, 0, sizeof(*wrk));
+
+	/* there is nothing to build in parallel beyond one job per trie. */
+	num = RTE_MIN(num, (uint32_t)RTE_ACL_MAX_TRIES);
+
+	for (i = 0; lcore_id != NULL && i != num; i++) {
+		if (lcore_id[i] >= RTE_MAX_LCORE ||
+				lcore_id[i] == rte_lcore_id() ||
+				!rte_lcore_is_enabled(lcore_id[i]) ||
+				rte_eal_get_lcore_state(lcore_id[i]) != WAIT) {
+			RTE_LOG(ERR, ACL, "lcore %u can't run a build worker\n",
+				lcore_id[i]);
+			return -EINVAL;
+		}
+		for (j = 0; j != i; j++) {
+			if (lcore_id[j] == lcore_id[i]) {
+				RTE_LOG(ERR, ACL,
+					"lcore %u given twice as build worker\n",
+					lcore_id[i]);
+				return -EINVAL;
+			}
+		}
+	}
+
+	wrk->num = num;
+	wrk->lcore_id = lcore_id;
+	return 0;
+}
+
+static void *
+acl_worker_thread(void *arg)
+{
+	struct acl_worker *w;
+
+	w = arg;
+	w->rc = w->fn(w->arg);
+	return NULL;
+}
+
+/*
+ * Wait for the job of the worker, and keep the first error returned by
+ * the jobs.
+ */
+static void
+acl_worker_join(struct acl_workers *wrk, uint32_t idx)
+{
+	int32_t rc;
+	struct acl_worker *w;
+
+	w = wrk->worker + idx;
+	if (w->busy == 0)
+		return;
+
+	if (wrk->lcore_id != NULL) {
+		rc = rte_eal_wait_lcore(wrk->lcore_id[idx]);
+	} else {
+		pthread_join(w->thread, NULL);
+		rc = w->rc;
+	}
+
+	w->busy = 0;
+	if (wrk->rc == 0)
+		wrk->rc = rc;
+}
+
+void
+acl_workers_launch(struct acl_workers *wrk, uint32_t idx,
+	lcore_function_t *fn, void *arg)
+{
+	int32_t rc;
+	struct acl_worker *w;
+
+	acl_worker_join(wrk, idx);
+
+	w = wrk->worker + idx;
+	w->fn = fn;
+	w->arg = arg;
+
+	if (wrk->lcore_id != NULL)
+		rc = rte_eal_remote_launch(fn, arg, wrk->lcore_id[idx]);
+	else
+		rc = -pthread_create(&w->thread, NULL, acl_worker_thread, w);
+
+	if (rc == 0) {
+		w->busy = 1;
+	} else {
+		RTE_LOG(DEBUG, ACL, "%s: can't launch worker %u, error code: "
+			"%d, running its job on the caller\n",
+			__func__, idx, rc);
+		rc = fn(arg);
+		if (wrk->rc == 0)
+			wrk->rc = rc;
+	}
+}
+
+int
+acl_workers_wait(struct acl_workers *wrk)
+{
+	int32_t rc;
+	uint32_t i;
+
+	for (i = 0; i != wrk->num; i++)
+		acl_worker_join(wrk, i);
+
+	rc = wrk->rc;
+	wrk->rc = 0;
+	return rc;
+}
+
+int
+acl_workers_run(struct acl_workers *wrk, lcore_function_t *fn, void *arg,
+	size_t size, uint32_t num)
+{
+	int32_t rc;
+	uint32_t i, k;
+	void *p;
+
+	rc = 0;
+	for (i = 0; i != num; i++) {
+
+		p = (void *)((uintptr_t)arg + i * size);
+
+		/* the caller takes its share of the jobs. */
+		k = (wrk == NULL) ? 0 : i % (wrk->num + 1);
+		if (wrk == NULL || k == wrk->num) {
+			rc = fn(p);
+			if (rc != 0)
+				break;
+		} else {
+			acl_workers_launch(wrk, k, fn, p);
+		}
+	}
+
+	if (wrk != NULL) {
+		if (rc == 0)
+			rc = acl_workers_wait(wrk);
+		else
+			acl_workers_wait(wrk);
+	}
+
+	return rc;
+}
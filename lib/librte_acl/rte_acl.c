@@ -26,6 +26,20 @@ rte_acl_classify_avx2(__rte_unused const struct rte_acl_ctx *ctx,
 	return -ENOTSUP;
 }
 
+/*
+ * If the compiler doesn't support AVX512 instructions,
+ * then the dummy one would be used instead for AVX512 classify method.
+ */
+int __attribute__ ((weak))
+rte_acl_classify_avx512(__rte_unused const struct rte_acl_ctx *ctx,
+	__rte_unused const uint8_t **data,
+	__rte_unused uint32_t *results,
+	__rte_unused uint32_t num,
+	__rte_unused uint32_t categories)
+{
+	return -ENOTSUP;
+}
+
 int __attribute__ ((weak))
 rte_acl_classify_sse(__rte_unused const struct rte_acl_ctx *ctx,
 	__rte_unused const uint8_t **data,
@@ -63,6 +77,7 @@ static const rte_acl_classify_t classify_fns[] = {
 	[RTE_ACL_CLASSIFY_AVX2] = rte_acl_classify_avx2,
 	[RTE_ACL_CLASSIFY_NEON] = rte_acl_classify_neon,
 	[RTE_ACL_CLASSIFY_ALTIVEC] = rte_acl_classify_altivec,
+	[RTE_ACL_CLASSIFY_AVX512] = rte_acl_classify_avx512,
 };
 
 /* by default, use always available scalar code path. */
@@ -87,9 +102,9 @@ rte_acl_set_ctx_classify(struct rte_acl_ctx *ctx, enum rte_acl_classify_alg alg)
 
 /*
  * Select highest available classify method as default one.
- * Note that CLASSIFY_AVX2 should be set as a default only
+ * Note that CLASSIFY_AVX2 and CLASSIFY_AVX512 should be set as a default only
  * if both conditions are met:
- * at build time compiler supports AVX2 and target cpu supports AVX2.
+ * at build time compiler supports them and target cpu supports them.
  */
 RTE_INIT(rte_acl_init)
 {
@@ -103,14 +118,17 @@ RTE_INIT(rte_acl_init)
 #elif defined(RTE_ARCH_PPC_64)
 	alg = RTE_ACL_CLASSIFY_ALTIVEC;
 #else
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
+		alg = RTE_ACL_CLASSIFY_SSE;
 #ifdef CC_AVX2_SUPPORT
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
 		alg = RTE_ACL_CLASSIFY_AVX2;
-	else if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
-#else
-	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE4_1))
 #endif
-		alg = RTE_ACL_CLASSIFY_SSE;
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F) &&
+			rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512BW))
+		alg = RTE_ACL_CLASSIFY_AVX512;
+#endif
 
 #endif
 	rte_acl_set_default_classify(alg);
@@ -125,6 +143,10 @@ rte_acl_classify_alg(const struct rte_acl_ctx *ctx, const uint8_t **data,
 			((RTE_ACL_RESULTS_MULTIPLIER - 1) & categories) != 0)
 		return -EINVAL;
 
+	if (unlikely(ctx->delta != NULL))
+		return acl_classify_update(ctx, data, results, num, categories,
+			classify_fns[alg]);
+
 	return classify_fns[alg](ctx, data, results, num, categories);
 }
 
@@ -187,6 +209,7 @@ rte_acl_free(struct rte_acl_ctx *ctx)
 
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
 
+	acl_update_reset(ctx);
 	rte_free(ctx->mem);
 	rte_free(ctx);
 	rte_free(te);
@@ -350,6 +373,9 @@ rte_acl_dump(const struct rte_acl_ctx *ctx)
 	printf("  max_rules=%"PRIu32"\n", ctx->max_rules);
 	printf("  rule_size=%"PRIu32"\n", ctx->rule_sz);
 	printf("  num_rules=%"PRIu32"\n", ctx->num_rules);
+	if (ctx->delta != NULL)
+		printf("  num_delta_rules=%"PRIu32"\n",
+			ctx->delta->num_rules);
 	printf("  num_categories=%"PRIu32"\n", ctx->num_categories);
 	printf("  num_tries=%"PRIu32"\n", ctx->num_tries);
 }
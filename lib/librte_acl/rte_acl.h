@@ -11,6 +11,7 @@
  * RTE Classifier.
  */
 
+#include <rte_compat.h>
 #include <rte_acl_osdep.h>
 
 #ifdef __cplusplus
@@ -220,6 +221,119 @@ rte_acl_reset_rules(struct rte_acl_ctx *ctx);
 int
 rte_acl_build(struct rte_acl_ctx *ctx, const struct rte_acl_config *cfg);
 
+/**
+ * Threads to run the build of an ACL context on.
+ */
+struct rte_acl_build_workers {
+	uint32_t num_workers;
+	/**< Number of worker threads, the build uses one per trie at most. */
+	const unsigned int *lcore_id;
+	/**<
+	 * Array of num_workers lcores in the WAIT state to launch the workers
+	 * on, or NULL to run the workers on threads started by the build.
+	 */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Same as rte_acl_build(), with the tries built in parallel by a set of
+ * worker threads, along with the calling one.
+ * The rules are split in tries as by rte_acl_build(), and the run-time
+ * structures are the same, whatever the number of workers: each trie is
+ * built, and then generated, on its own by one of the threads.
+ * The split of the rules still runs on the calling thread, so the time
+ * taken by the build goes down with the number of tries it ends up with.
+ * When lcores are given, the function must be called on the master lcore,
+ * and the lcores are back in the WAIT state when it returns.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to build.
+ * @param cfg
+ *   Pointer to struct rte_acl_config - defines build parameters.
+ * @param workers
+ *   Threads to run the build on. With zero workers, the build runs
+ *   on the calling thread only, as with rte_acl_build().
+ * @return
+ *   - -ENOMEM if couldn't allocate enough memory.
+ *   - -EINVAL if the parameters are invalid, or an lcore can't run
+ *     a worker.
+ *   - Negative error code if operation failed.
+ *   - Zero if operation completed successfully.
+ */
+int __rte_experimental
+rte_acl_build_parallel(struct rte_acl_ctx *ctx,
+	const struct rte_acl_config *cfg,
+	const struct rte_acl_build_workers *workers);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add rules to an ACL context that is already built, without rebuilding
+ * its run-time structures.
+ * The rules go in a small separate trie, built on its own, that is searched
+ * along with the main ones by rte_acl_classify(), so the update takes
+ * a time that depends on the number of rules changed since the last
+ * rte_acl_build(), not on the size of the context.
+ * The rules are also appended to the rules of the context, so that the next
+ * rte_acl_build() folds them in the main tries.
+ * The userdata of each rule is its identifier for rte_acl_update_del_rules():
+ * it must be non-zero and unique among the rules of the context.
+ * The rules of the context must not have been changed with
+ * rte_acl_add_rules() or rte_acl_reset_rules() since its last build.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to add rules to.
+ * @param rules
+ *   Array of rules to add to the ACL context, in the same format as
+ *   for rte_acl_add_rules().
+ * @param num
+ *   Number of elements in the input array of rules.
+ * @return
+ *   - -ENOMEM if there is no space in the ACL context for these rules,
+ *     or if the separate trie couldn't be built.
+ *   - -EEXIST if the userdata of a rule is already used.
+ *   - -EINVAL if the parameters are invalid or the context is not built.
+ *   - Zero if operation completed successfully.
+ */
+int __rte_experimental
+rte_acl_update_add_rules(struct rte_acl_ctx *ctx,
+	const struct rte_acl_rule *rules, uint32_t num);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete rules from an ACL context that is already built, without
+ * rebuilding its run-time structures.
+ * A rule of the main tries is flagged as deleted, and the rules of lower
+ * priority it overlaps are copied in the separate trie of the updates,
+ * which then gives the result of the packets that matched the deleted rule.
+ * The same restrictions as for rte_acl_update_add_rules() apply.
+ * On failure, none of the rules is deleted.
+ * This function is not multi-thread safe.
+ *
+ * @param ctx
+ *   ACL context to delete rules from.
+ * @param userdata
+ *   Array of the userdata of the rules to delete.
+ * @param num
+ *   Number of elements in the input array.
+ * @return
+ *   - -ENOENT if no rule of the context has one of the userdata.
+ *   - -ENOMEM if the separate trie is full or couldn't be built.
+ *   - -EINVAL if the parameters are invalid, a userdata is given twice,
+ *     or the context is not built.
+ *   - Zero if operation completed successfully.
+ */
+int __rte_experimental
+rte_acl_update_del_rules(struct rte_acl_ctx *ctx, const uint32_t *userdata,
+	uint32_t num);
+
 /**
  * Delete all rules from the ACL context and
  * destroy all internal run-time structures.
@@ -241,6 +355,7 @@ enum rte_acl_classify_alg {
 	RTE_ACL_CLASSIFY_AVX2 = 3,    /**< requires AVX2 support. */
 	RTE_ACL_CLASSIFY_NEON = 4,    /**< requires NEON support. */
 	RTE_ACL_CLASSIFY_ALTIVEC = 5,    /**< requires ALTIVEC support. */
+	RTE_ACL_CLASSIFY_AVX512 = 6,  /**< requires AVX512F, AVX512BW support. */
 	RTE_ACL_CLASSIFY_NUM          /* should always be the last one. */
 };
 
@@ -7,10 +7,15 @@
 
 #include <rte_ip.h>
 #include <rte_tcp.h>
+#include <rte_jhash.h>
+#include <rte_hash_crc.h>
 
 #define INVALID_ARRAY_INDEX 0xffffffffUL
 #define GRO_TCP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
 
+/* Initial value of the flow hash */
+#define GRO_HASH_PRIME_VALUE 0xeaad8405
+
 /*
  * The max length of a IPv4 packet, which includes the length of the L3
  * header, the L4 header and the data payload.
@@ -36,6 +41,11 @@ struct gro_tcp4_flow {
 	 * INVALID_ARRAY_INDEX indicates an empty flow.
 	 */
 	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket, or of the
+	 * next empty flow if the flow is empty.
+	 */
+	uint32_t next_flow_idx;
 };
 
 struct gro_tcp4_item {
@@ -84,6 +94,17 @@ struct gro_tcp4_tbl {
 	uint32_t max_item_num;
 	/* flow array size */
 	uint32_t max_flow_num;
+	/*
+	 * Hash buckets of the flows. Each bucket keeps the index of its
+	 * first flow, the other flows are chained by next_flow_idx.
+	 */
+	uint32_t *buckets;
+	/* the number of buckets minus 1, it's a power of 2 minus 1 */
+	uint32_t bucket_mask;
+	/* the first empty item, empty items are chained by next_pkt_idx */
+	uint32_t free_item_idx;
+	/* the first empty flow */
+	uint32_t free_flow_idx;
 };
 
 /**
@@ -104,6 +125,16 @@ void *gro_tcp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
 		uint16_t max_item_per_flow);
 
+/**
+ * This function empties a TCP/IPv4 reassembly table, whose items, flows
+ * and buckets arrays are already set. It's used for the tables which
+ * aren't created by gro_tcp4_tbl_create().
+ *
+ * @param tbl
+ *  Pointer pointing to the TCP/IPv4 reassembly table.
+ */
+void gro_tcp4_tbl_init(struct gro_tcp4_tbl *tbl);
+
 /**
  * This function destroys a TCP/IPv4 reassembly table.
  *
@@ -191,6 +222,30 @@ is_same_tcp4_flow(struct tcp4_flow_key k1, struct tcp4_flow_key k2)
 			(k1.dst_port == k2.dst_port));
 }
 
+/*
+ * Calculate the hash value of a TCP/IPv4 flow. The MAC addresses aren't
+ * hashed, flows which only differ by them share the same bucket.
+ */
+static inline uint32_t
+tcp4_flow_hash(const struct tcp4_flow_key *key)
+{
+	uint32_t v, ports;
+
+	ports = ((uint32_t)key->src_port << 16) | key->dst_port;
+
+#ifdef RTE_ARCH_X86
+	v = rte_hash_crc_4byte(key->ip_src_addr, GRO_HASH_PRIME_VALUE);
+	v = rte_hash_crc_4byte(key->ip_dst_addr, v);
+	v = rte_hash_crc_4byte(ports, v);
+	v = rte_hash_crc_4byte(key->recv_ack, v);
+#else
+	v = rte_jhash_3words(key->ip_src_addr, key->ip_dst_addr,
+			ports ^ key->recv_ack, GRO_HASH_PRIME_VALUE);
+#endif /* RTE_ARCH_X86 */
+
+	return v;
+}
+
 /*
  * Merge two TCP/IPv4 packets without updating checksums.
  * If cmp is larger than 0, append the new packet to the
@@ -0,0 +1,350 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#ifndef _GRO_UDP4_H_
+#define _GRO_UDP4_H_
+
+#include <rte_ip.h>
+#include <rte_udp.h>
+#include <rte_jhash.h>
+#include <rte_hash_crc.h>
+
+#define INVALID_ARRAY_INDEX 0xffffffffUL
+#define GRO_UDP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
+
+/* Initial value of the flow hash */
+#define GRO_HASH_PRIME_VALUE 0xeaad8405
+
+/*
+ * The max length of a IPv4 packet, which includes the length of the L3
+ * header, the L4 header and the data payload.
+ */
+#define MAX_IPV4_PKT_LENGTH UINT16_MAX
+
+/* Header fields representing the fragments of a UDP/IPv4 datagram */
+struct udp4_flow_key {
+	struct ether_addr eth_saddr;
+	struct ether_addr eth_daddr;
+	uint32_t ip_src_addr;
+	uint32_t ip_dst_addr;
+
+	uint16_t ip_id;
+};
+
+struct gro_udp4_flow {
+	struct udp4_flow_key key;
+	/*
+	 * The index of the first packet in the flow.
+	 * INVALID_ARRAY_INDEX indicates an empty flow.
+	 */
+	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket, or of the
+	 * next empty flow if the flow is empty.
+	 */
+	uint32_t next_flow_idx;
+};
+
+struct gro_udp4_item {
+	/*
+	 * The first MBUF segment of the packet. If the value
+	 * is NULL, it means the item is empty.
+	 */
+	struct rte_mbuf *firstseg;
+	/* The last MBUF segment of the packet */
+	struct rte_mbuf *lastseg;
+	/*
+	 * The time when the first packet is inserted into the table.
+	 * This value won't be updated, even if the packet is merged
+	 * with other packets.
+	 */
+	uint64_t start_time;
+	/*
+	 * next_pkt_idx chains the packets of the flow which can't be
+	 * merged together (e.g. caused by a missing fragment), in the
+	 * ascending order of their fragment offsets.
+	 */
+	uint32_t next_pkt_idx;
+	/* offset of the packet in the datagram, in bytes */
+	uint16_t frag_offset;
+	/* the number of merged packets */
+	uint16_t nb_merged;
+	/* Indicate if the packet ends the datagram (i.e., MF==0) */
+	uint8_t is_last_frag;
+};
+
+/*
+ * UDP/IPv4 reassembly table structure.
+ */
+struct gro_udp4_tbl {
+	/* item array */
+	struct gro_udp4_item *items;
+	/* flow array */
+	struct gro_udp4_flow *flows;
+	/* current item number */
+	uint32_t item_num;
+	/* current flow num */
+	uint32_t flow_num;
+	/* item array size */
+	uint32_t max_item_num;
+	/* flow array size */
+	uint32_t max_flow_num;
+	/*
+	 * Hash buckets of the flows. Each bucket keeps the index of its
+	 * first flow, the other flows are chained by next_flow_idx.
+	 */
+	uint32_t *buckets;
+	/* the number of buckets minus 1, it's a power of 2 minus 1 */
+	uint32_t bucket_mask;
+	/* the first empty item, empty items are chained by next_pkt_idx */
+	uint32_t free_item_idx;
+	/* the first empty flow */
+	uint32_t free_flow_idx;
+};
+
+/**
+ * This function creates a UDP/IPv4 reassembly table.
+ *
+ * @param socket_id
+ *  Socket index for allocating the UDP/IPv4 reassemble table
+ * @param max_flow_num
+ *  The maximum number of flows in the UDP/IPv4 GRO table
+ * @param max_item_per_flow
+ *  The maximum number of packets per flow
+ *
+ * @return
+ *  - Return the table pointer on success.
+ *  - Return NULL on failure.
+ */
+void *gro_udp4_tbl_create(uint16_t socket_id,
+		uint16_t max_flow_num,
+		uint16_t max_item_per_flow);
+
+/**
+ * This function empties a UDP/IPv4 reassembly table, whose items, flows
+ * and buckets arrays are already set. It's used for the tables which
+ * aren't created by gro_udp4_tbl_create().
+ *
+ * @param tbl
+ *  Pointer pointing to the UDP/IPv4 reassembly table.
+ */
+void gro_udp4_tbl_init(struct gro_udp4_tbl *tbl);
+
+/**
+ * This function destroys a UDP/IPv4 reassembly table.
+ *
+ * @param tbl
+ *  Pointer pointing to the UDP/IPv4 reassembly table.
+ */
+void gro_udp4_tbl_destroy(void *tbl);
+
+/**
+ * This function merges a UDP/IPv4 fragment. The fragments of a datagram
+ * form a flow, and a fragment is merged with the fragments which precede
+ * or follow it in the datagram. It doesn't process the packet which
+ * isn't a fragment (i.e., MF==0 && frag_off==0) or has no payload.
+ *
+ * This function doesn't check if the packet has correct checksums and
+ * doesn't re-calculate checksums for the merged packet. It returns the
+ * packet, if the packet has invalid parameters or there is no available
+ * space in the table.
+ *
+ * @param pkt
+ *  Packet to reassemble
+ * @param tbl
+ *  Pointer pointing to the UDP/IPv4 reassembly table
+ * @start_time
+ *  The time when the packet is inserted into the table
+ *
+ * @return
+ *  - Return a positive value if the packet is merged.
+ *  - Return zero if the packet isn't merged but stored in the table.
+ *  - Return a negative value for invalid parameters or no available
+ *    space in the table.
+ */
+int32_t gro_udp4_reassemble(struct rte_mbuf *pkt,
+		struct gro_udp4_tbl *tbl,
+		uint64_t start_time);
+
+/**
+ * This function flushes timeout packets in a UDP/IPv4 reassembly table,
+ * and without updating checksums. The MF bit of a flushed packet is
+ * cleared, if it ends the datagram.
+ *
+ * @param tbl
+ *  UDP/IPv4 reassembly table pointer
+ * @param flush_timestamp
+ *  Flush packets which are inserted into the table before or at the
+ *  flush_timestamp.
+ * @param out
+ *  Pointer array used to keep flushed packets
+ * @param nb_out
+ *  The element number in 'out'. It also determines the maximum number of
+ *  packets that can be flushed finally.
+ *
+ * @return
+ *  The number of flushed packets
+ */
+uint16_t gro_udp4_tbl_timeout_flush(struct gro_udp4_tbl *tbl,
+		uint64_t flush_timestamp,
+		struct rte_mbuf **out,
+		uint16_t nb_out);
+
+/**
+ * This function returns the number of the packets in a UDP/IPv4
+ * reassembly table.
+ *
+ * @param tbl
+ *  UDP/IPv4 reassembly table pointer
+ *
+ * @return
+ *  The number of packets in the table
+ */
+uint32_t gro_udp4_tbl_pkt_count(void *tbl);
+
+/*
+ * Check if two UDP/IPv4 fragments belong to the same datagram.
+ */
+static inline int
+is_same_udp4_flow(struct udp4_flow_key k1, struct udp4_flow_key k2)
+{
+	return (is_same_ether_addr(&k1.eth_saddr, &k2.eth_saddr) &&
+			is_same_ether_addr(&k1.eth_daddr, &k2.eth_daddr) &&
+			(k1.ip_src_addr == k2.ip_src_addr) &&
+			(k1.ip_dst_addr == k2.ip_dst_addr) &&
+			(k1.ip_id == k2.ip_id));
+}
+
+/*
+ * Calculate the hash value of the fragments of a UDP/IPv4 datagram.
+ */
+static inline uint32_t
+udp4_flow_hash(const struct udp4_flow_key *key)
+{
+	uint32_t v;
+
+#ifdef RTE_ARCH_X86
+	v = rte_hash_crc_4byte(key->ip_src_addr, GRO_HASH_PRIME_VALUE);
+	v = rte_hash_crc_4byte(key->ip_dst_addr, v);
+	v = rte_hash_crc_4byte(key->ip_id, v);
+#else
+	v = rte_jhash_3words(key->ip_src_addr, key->ip_dst_addr,
+			key->ip_id, GRO_HASH_PRIME_VALUE);
+#endif /* RTE_ARCH_X86 */
+
+	return v;
+}
+
+/*
+ * Length of the headers before the IPv4 payload of a fragment, including
+ * the outer headers if it is tunneled. The fragments of a datagram may
+ * have different header lengths, as the IPv4 options which are not
+ * copied are only in the first fragment.
+ */
+static inline uint16_t
+udp4_hdr_len(const struct rte_mbuf *pkt, uint8_t is_tunnel)
+{
+	uint16_t len = pkt->l2_len + pkt->l3_len;
+
+	if (is_tunnel)
+		len += pkt->outer_l2_len + pkt->outer_l3_len;
+	return len;
+}
+
+/*
+ * Merge two UDP/IPv4 fragments without updating checksums.
+ * If cmp is larger than 0, append the new packet to the
+ * original packet. Otherwise, pre-pend the new packet to
+ * the original packet.
+ */
+static inline int
+merge_two_udp4_packets(struct gro_udp4_item *item,
+		struct rte_mbuf *pkt,
+		int cmp,
+		uint16_t frag_offset,
+		uint8_t is_last_frag,
+		uint8_t is_tunnel)
+{
+	struct rte_mbuf *pkt_head, *pkt_tail, *lastseg;
+	uint16_t hdr_len, l2_len;
+
+	if (cmp > 0) {
+		pkt_head = item->firstseg;
+		pkt_tail = pkt;
+	} else {
+		pkt_head = pkt;
+		pkt_tail = item->firstseg;
+	}
+
+	/* check if the IPv4 packet length is greater than the max value */
+	hdr_len = udp4_hdr_len(pkt_tail, is_tunnel);
+	l2_len = is_tunnel ? pkt_head->outer_l2_len : pkt_head->l2_len;
+	if (unlikely(pkt_head->pkt_len - l2_len + pkt_tail->pkt_len -
+				hdr_len > MAX_IPV4_PKT_LENGTH))
+		return 0;
+
+	/* remove the packet header for the tail packet */
+	rte_pktmbuf_adj(pkt_tail, hdr_len);
+
+	/* chain two packets together */
+	if (cmp > 0) {
+		item->lastseg->next = pkt;
+		item->lastseg = rte_pktmbuf_lastseg(pkt);
+		item->is_last_frag = is_last_frag;
+	} else {
+		lastseg = rte_pktmbuf_lastseg(pkt);
+		lastseg->next = item->firstseg;
+		item->firstseg = pkt;
+		/* update frag_offset to the smaller value */
+		item->frag_offset = frag_offset;
+	}
+	item->nb_merged++;
+
+	/* update MBUF metadata for the merged packet */
+	pkt_head->nb_segs += pkt_tail->nb_segs;
+	pkt_head->pkt_len += pkt_tail->pkt_len;
+
+	return 1;
+}
+
+/*
+ * Check if two UDP/IPv4 fragments are neighbors, i.e. one of them
+ * starts where the other one ends.
+ */
+static inline int
+udp4_check_neighbor(struct gro_udp4_item *item,
+		uint16_t frag_offset,
+		uint16_t ip_dl,
+		uint8_t is_last_frag,
+		uint8_t is_tunnel)
+{
+	struct rte_mbuf *pkt_orig = item->firstseg;
+	uint16_t len;
+
+	/* check if the two packets are neighbors */
+	len = pkt_orig->pkt_len - udp4_hdr_len(pkt_orig, is_tunnel);
+	if (frag_offset == item->frag_offset + len &&
+			item->is_last_frag == 0)
+		/* append the new packet */
+		return 1;
+	else if (frag_offset + ip_dl == item->frag_offset &&
+			is_last_frag == 0)
+		/* pre-pend the new packet */
+		return -1;
+
+	return 0;
+}
+
+/*
+ * Check if an IPv4 packet is a fragment.
+ */
+static inline int
+is_ipv4_fragment(const struct ipv4_hdr *hdr)
+{
+	uint16_t flag_offset;
+
+	flag_offset = rte_be_to_cpu_16(hdr->fragment_offset);
+	return (flag_offset & (IPV4_HDR_MF_FLAG | IPV4_HDR_OFFSET_MASK)) != 0;
+}
+#endif
@@ -10,6 +10,37 @@
 
 #include "gro_vxlan_tcp4.h"
 
+void
+gro_vxlan_tcp4_tbl_init(struct gro_vxlan_tcp4_tbl *tbl)
+{
+	uint32_t i;
+
+	/*
+	 * Chain all the items and flows, so that they are used in the
+	 * order of their indexes.
+	 */
+	tbl->free_item_idx = INVALID_ARRAY_INDEX;
+	for (i = tbl->max_item_num; i-- != 0; ) {
+		/* NULL indicates an empty item */
+		tbl->items[i].inner_item.firstseg = NULL;
+		tbl->items[i].inner_item.next_pkt_idx = tbl->free_item_idx;
+		tbl->free_item_idx = i;
+	}
+	tbl->item_num = 0;
+
+	tbl->free_flow_idx = INVALID_ARRAY_INDEX;
+	for (i = tbl->max_flow_num; i-- != 0; ) {
+		/* INVALID_ARRAY_INDEX indicates an empty flow */
+		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
+		tbl->flows[i].next_flow_idx = tbl->free_flow_idx;
+		tbl->free_flow_idx = i;
+	}
+	tbl->flow_num = 0;
+
+	for (i = 0; i <= tbl->bucket_mask; i++)
+		tbl->buckets[i] = INVALID_ARRAY_INDEX;
+}
+
 void *
 gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
@@ -17,7 +48,7 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 {
 	struct gro_vxlan_tcp4_tbl *tbl;
 	size_t size;
-	uint32_t entries_num, i;
+	uint32_t entries_num, buckets_num;
 
 	entries_num = max_flow_num * max_item_per_flow;
 	entries_num = RTE_MIN(entries_num, GRO_VXLAN_TCP4_TBL_MAX_ITEM_NUM);
@@ -53,11 +84,25 @@ gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		rte_free(tbl);
 		return NULL;
 	}
-
-	for (i = 0; i < entries_num; i++)
-		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
 	tbl->max_flow_num = entries_num;
 
+	/* Keep the load factor of the buckets below 1. */
+	buckets_num = rte_align32pow2(entries_num);
+	size = sizeof(uint32_t) * buckets_num;
+	tbl->buckets = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->buckets == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->bucket_mask = buckets_num - 1;
+
+	gro_vxlan_tcp4_tbl_init(tbl);
+
 	return tbl;
 }
 
@@ -69,6 +114,7 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 	if (vxlan_tbl) {
 		rte_free(vxlan_tbl->items);
 		rte_free(vxlan_tbl->flows);
+		rte_free(vxlan_tbl->buckets);
 	}
 	rte_free(vxlan_tbl);
 }
@@ -76,23 +122,22 @@ gro_vxlan_tcp4_tbl_destroy(void *tbl)
 static inline uint32_t
 find_an_empty_item(struct gro_vxlan_tcp4_tbl *tbl)
 {
-	uint32_t max_item_num = tbl->max_item_num, i;
+	uint32_t item_idx = tbl->free_item_idx;
 
-	for (i = 0; i < max_item_num; i++)
-		if (tbl->items[i].inner_item.firstseg == NULL)
-			return i;
-	return INVALID_ARRAY_INDEX;
+	if (item_idx != INVALID_ARRAY_INDEX)
+		tbl->free_item_idx =
+			tbl->items[item_idx].inner_item.next_pkt_idx;
+	return item_idx;
 }
 
 static inline uint32_t
 find_an_empty_flow(struct gro_vxlan_tcp4_tbl *tbl)
 {
-	uint32_t max_flow_num = tbl->max_flow_num, i;
+	uint32_t flow_idx = tbl->free_flow_idx;
 
-	for (i = 0; i < max_flow_num; i++)
-		if (tbl->flows[i].start_index == INVALID_ARRAY_INDEX)
-			return i;
-	return INVALID_ARRAY_INDEX;
+	if (flow_idx != INVALID_ARRAY_INDEX)
+		tbl->free_flow_idx = tbl->flows[flow_idx].next_flow_idx;
+	return flow_idx;
 }
 
 static inline uint32_t
@@ -143,6 +188,8 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 
 	/* NULL indicates an empty item. */
 	tbl->items[item_idx].inner_item.firstseg = NULL;
+	tbl->items[item_idx].inner_item.next_pkt_idx = tbl->free_item_idx;
+	tbl->free_item_idx = item_idx;
 	tbl->item_num--;
 	if (prev_item_idx != INVALID_ARRAY_INDEX)
 		tbl->items[prev_item_idx].inner_item.next_pkt_idx = next_idx;
@@ -153,6 +200,7 @@ delete_item(struct gro_vxlan_tcp4_tbl *tbl,
 static inline uint32_t
 insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 		struct vxlan_tcp4_flow_key *src,
+		uint32_t bucket,
 		uint32_t item_idx)
 {
 	struct vxlan_tcp4_flow_key *dst;
@@ -184,11 +232,33 @@ insert_new_flow(struct gro_vxlan_tcp4_tbl *tbl,
 	dst->outer_dst_port = src->outer_dst_port;
 
 	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].next_flow_idx = tbl->buckets[bucket];
+	tbl->buckets[bucket] = flow_idx;
 	tbl->flow_num++;
 
 	return flow_idx;
 }
 
+/*
+ * Remove an empty flow from its hash bucket and put it back to the
+ * empty flows.
+ */
+static inline void
+delete_flow(struct gro_vxlan_tcp4_tbl *tbl, uint32_t flow_idx)
+{
+	uint32_t *prev;
+
+	prev = &tbl->buckets[vxlan_tcp4_flow_hash(&tbl->flows[flow_idx].key) &
+		tbl->bucket_mask];
+	while (*prev != flow_idx)
+		prev = &tbl->flows[*prev].next_flow_idx;
+	*prev = tbl->flows[flow_idx].next_flow_idx;
+
+	tbl->flows[flow_idx].next_flow_idx = tbl->free_flow_idx;
+	tbl->free_flow_idx = flow_idx;
+	tbl->flow_num--;
+}
+
 static inline int
 is_same_vxlan_tcp4_flow(struct vxlan_tcp4_flow_key k1,
 		struct vxlan_tcp4_flow_key k2)
@@ -300,10 +370,9 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 
 	struct vxlan_tcp4_flow_key key;
 	uint32_t cur_idx, prev_idx, item_idx;
-	uint32_t i, max_flow_num, remaining_flow_num;
+	uint32_t i, bucket;
 	int cmp;
 	uint16_t hdr_len;
-	uint8_t find;
 
 	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct ether_hdr *);
 	outer_ipv4_hdr = (struct ipv4_hdr *)((char *)outer_eth_hdr +
@@ -365,31 +434,25 @@ gro_vxlan_tcp4_reassemble(struct rte_mbuf *pkt,
 	key.outer_src_port = udp_hdr->src_port;
 	key.outer_dst_port = udp_hdr->dst_port;
 
-	/* Search for a matched flow. */
-	max_flow_num = tbl->max_flow_num;
-	remaining_flow_num = tbl->flow_num;
-	find = 0;
-	for (i = 0; i < max_flow_num && remaining_flow_num; i++) {
-		if (tbl->flows[i].start_index != INVALID_ARRAY_INDEX) {
-			if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key)) {
-				find = 1;
-				break;
-			}
-			remaining_flow_num--;
-		}
+	/* Search for a matched flow in its hash bucket. */
+	bucket = vxlan_tcp4_flow_hash(&key) & tbl->bucket_mask;
+	for (i = tbl->buckets[bucket]; i != INVALID_ARRAY_INDEX;
+			i = tbl->flows[i].next_flow_idx) {
+		if (is_same_vxlan_tcp4_flow(tbl->flows[i].key, key))
+			break;
 	}
 
 	/*
 	 * Can't find a matched flow. Insert a new flow and store the
 	 * packet into the flow.
 	 */
-	if (find == 0) {
+	if (i == INVALID_ARRAY_INDEX) {
 		item_idx = insert_new_item(tbl, pkt, start_time,
 				INVALID_ARRAY_INDEX, sent_seq, outer_ip_id,
 				ip_id, outer_is_atomic, is_atomic);
 		if (item_idx == INVALID_ARRAY_INDEX)
 			return -1;
-		if (insert_new_flow(tbl, &key, item_idx) ==
+		if (insert_new_flow(tbl, &key, bucket, item_idx) ==
 				INVALID_ARRAY_INDEX) {
 			/*
 			 * Fail to insert a new flow, so
@@ -467,7 +530,7 @@ gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
 				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
 				tbl->flows[i].start_index = j;
 				if (j == INVALID_ARRAY_INDEX)
-					tbl->flow_num--;
+					delete_flow(tbl, i);
 
 				if (unlikely(k == nb_out))
 					return k;
@@ -33,6 +33,11 @@ struct gro_vxlan_tcp4_flow {
 	 * indicates an empty flow.
 	 */
 	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket, or of the
+	 * next empty flow if the flow is empty.
+	 */
+	uint32_t next_flow_idx;
 };
 
 struct gro_vxlan_tcp4_item {
@@ -60,6 +65,17 @@ struct gro_vxlan_tcp4_tbl {
 	uint32_t max_item_num;
 	/* the maximum flow number */
 	uint32_t max_flow_num;
+	/*
+	 * Hash buckets of the flows. Each bucket keeps the index of its
+	 * first flow, the other flows are chained by next_flow_idx.
+	 */
+	uint32_t *buckets;
+	/* the number of buckets minus 1, it's a power of 2 minus 1 */
+	uint32_t bucket_mask;
+	/* the first empty item, empty items are chained by next_pkt_idx */
+	uint32_t free_item_idx;
+	/* the first empty flow */
+	uint32_t free_flow_idx;
 };
 
 /**
@@ -81,6 +97,16 @@ void *gro_vxlan_tcp4_tbl_create(uint16_t socket_id,
 		uint16_t max_flow_num,
 		uint16_t max_item_per_flow);
 
+/**
+ * This function empties a VxLAN reassembly table, whose items, flows and
+ * buckets arrays are already set. It's used for the tables which aren't
+ * created by gro_vxlan_tcp4_tbl_create().
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_tcp4_tbl_init(struct gro_vxlan_tcp4_tbl *tbl);
+
 /**
  * This function destroys a VxLAN reassembly table.
  *
@@ -153,4 +179,27 @@ uint16_t gro_vxlan_tcp4_tbl_timeout_flush(struct gro_vxlan_tcp4_tbl *tbl,
  *  The number of packets in the table
  */
 uint32_t gro_vxlan_tcp4_tbl_pkt_count(void *tbl);
+
+/*
+ * Calculate the hash value of a VxLAN flow from the hash value of its
+ * inner TCP/IPv4 flow, the outer IPv4 addresses and the VNI.
+ */
+static inline uint32_t
+vxlan_tcp4_flow_hash(const struct vxlan_tcp4_flow_key *key)
+{
+	uint32_t v;
+
+	v = tcp4_flow_hash(&key->inner_key);
+
+#ifdef RTE_ARCH_X86
+	v = rte_hash_crc_4byte(key->outer_ip_src_addr, v);
+	v = rte_hash_crc_4byte(key->outer_ip_dst_addr, v);
+	v = rte_hash_crc_4byte(key->vxlan_hdr.vx_vni, v);
+#else
+	v = rte_jhash_3words(key->outer_ip_src_addr, key->outer_ip_dst_addr,
+			key->vxlan_hdr.vx_vni, v);
+#endif /* RTE_ARCH_X86 */
+
+	return v;
+}
 #endif
@@ -0,0 +1,540 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+#include <rte_cycles.h>
+#include <rte_ethdev.h>
+#include <rte_udp.h>
+
+#include "gro_vxlan_udp4.h"
+
+void
+gro_vxlan_udp4_tbl_init(struct gro_vxlan_udp4_tbl *tbl)
+{
+	uint32_t i;
+
+	/*
+	 * Chain all the items and flows, so that they are used in the
+	 * order of their indexes.
+	 */
+	tbl->free_item_idx = INVALID_ARRAY_INDEX;
+	for (i = tbl->max_item_num; i-- != 0; ) {
+		/* NULL indicates an empty item */
+		tbl->items[i].inner_item.firstseg = NULL;
+		tbl->items[i].inner_item.next_pkt_idx = tbl->free_item_idx;
+		tbl->free_item_idx = i;
+	}
+	tbl->item_num = 0;
+
+	tbl->free_flow_idx = INVALID_ARRAY_INDEX;
+	for (i = tbl->max_flow_num; i-- != 0; ) {
+		/* INVALID_ARRAY_INDEX indicates an empty flow */
+		tbl->flows[i].start_index = INVALID_ARRAY_INDEX;
+		tbl->flows[i].next_flow_idx = tbl->free_flow_idx;
+		tbl->free_flow_idx = i;
+	}
+	tbl->flow_num = 0;
+
+	for (i = 0; i <= tbl->bucket_mask; i++)
+		tbl->buckets[i] = INVALID_ARRAY_INDEX;
+}
+
+void *
+gro_vxlan_udp4_tbl_create(uint16_t socket_id,
+		uint16_t max_flow_num,
+		uint16_t max_item_per_flow)
+{
+	struct gro_vxlan_udp4_tbl *tbl;
+	size_t size;
+	uint32_t entries_num, buckets_num;
+
+	entries_num = max_flow_num * max_item_per_flow;
+	entries_num = RTE_MIN(entries_num, GRO_VXLAN_UDP4_TBL_MAX_ITEM_NUM);
+
+	if (entries_num == 0)
+		return NULL;
+
+	tbl = rte_zmalloc_socket(__func__,
+			sizeof(struct gro_vxlan_udp4_tbl),
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl == NULL)
+		return NULL;
+
+	size = sizeof(struct gro_vxlan_udp4_item) * entries_num;
+	tbl->items = rte_zmalloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->items == NULL) {
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->max_item_num = entries_num;
+
+	size = sizeof(struct gro_vxlan_udp4_flow) * entries_num;
+	tbl->flows = rte_zmalloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->flows == NULL) {
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->max_flow_num = entries_num;
+
+	/* Keep the load factor of the buckets below 1. */
+	buckets_num = rte_align32pow2(entries_num);
+	size = sizeof(uint32_t) * buckets_num;
+	tbl->buckets = rte_malloc_socket(__func__,
+			size,
+			RTE_CACHE_LINE_SIZE,
+			socket_id);
+	if (tbl->buckets == NULL) {
+		rte_free(tbl->flows);
+		rte_free(tbl->items);
+		rte_free(tbl);
+		return NULL;
+	}
+	tbl->bucket_mask = buckets_num - 1;
+
+	gro_vxlan_udp4_tbl_init(tbl);
+
+	return tbl;
+}
+
+void
+gro_vxlan_udp4_tbl_destroy(void *tbl)
+{
+	struct gro_vxlan_udp4_tbl *vxlan_tbl = tbl;
+
+	if (vxlan_tbl) {
+		rte_free(vxlan_tbl->items);
+		rte_free(vxlan_tbl->flows);
+		rte_free(vxlan_tbl->buckets);
+	}
+	rte_free(vxlan_tbl);
+}
+
+static inline uint32_t
+find_an_empty_item(struct gro_vxlan_udp4_tbl *tbl)
+{
+	uint32_t item_idx = tbl->free_item_idx;
+
+	if (item_idx != INVALID_ARRAY_INDEX)
+		tbl->free_item_idx =
+			tbl->items[item_idx].inner_item.next_pkt_idx;
+	return item_idx;
+}
+
+static inline uint32_t
+find_an_empty_flow(struct gro_vxlan_udp4_tbl *tbl)
+{
+	uint32_t flow_idx = tbl->free_flow_idx;
+
+	if (flow_idx != INVALID_ARRAY_INDEX)
+		tbl->free_flow_idx = tbl->flows[flow_idx].next_flow_idx;
+	return flow_idx;
+}
+
+/*
+ * Store a packet into the table. If prev_idx is INVALID_ARRAY_INDEX,
+ * the packet becomes the first one of the flow whose first packet is
+ * next_idx; otherwise it's chained after the packet prev_idx.
+ */
+static inline uint32_t
+insert_new_item(struct gro_vxlan_udp4_tbl *tbl,
+		struct rte_mbuf *pkt,
+		uint64_t start_time,
+		uint32_t prev_idx,
+		uint32_t next_idx,
+		uint16_t frag_offset,
+		uint8_t is_last_frag)
+{
+	uint32_t item_idx;
+
+	item_idx = find_an_empty_item(tbl);
+	if (unlikely(item_idx == INVALID_ARRAY_INDEX))
+		return INVALID_ARRAY_INDEX;
+
+	tbl->items[item_idx].inner_item.firstseg = pkt;
+	tbl->items[item_idx].inner_item.lastseg = rte_pktmbuf_lastseg(pkt);
+	tbl->items[item_idx].inner_item.start_time = start_time;
+	tbl->items[item_idx].inner_item.next_pkt_idx = next_idx;
+	tbl->items[item_idx].inner_item.frag_offset = frag_offset;
+	tbl->items[item_idx].inner_item.is_last_frag = is_last_frag;
+	tbl->items[item_idx].inner_item.nb_merged = 1;
+	tbl->item_num++;
+
+	/* If the previous packet exists, chain the new one with it. */
+	if (prev_idx != INVALID_ARRAY_INDEX) {
+		tbl->items[item_idx].inner_item.next_pkt_idx =
+			tbl->items[prev_idx].inner_item.next_pkt_idx;
+		tbl->items[prev_idx].inner_item.next_pkt_idx = item_idx;
+	}
+
+	return item_idx;
+}
+
+static inline uint32_t
+delete_item(struct gro_vxlan_udp4_tbl *tbl,
+		uint32_t item_idx,
+		uint32_t prev_item_idx)
+{
+	uint32_t next_idx = tbl->items[item_idx].inner_item.next_pkt_idx;
+
+	/* NULL indicates an empty item. */
+	tbl->items[item_idx].inner_item.firstseg = NULL;
+	tbl->items[item_idx].inner_item.next_pkt_idx = tbl->free_item_idx;
+	tbl->free_item_idx = item_idx;
+	tbl->item_num--;
+	if (prev_item_idx != INVALID_ARRAY_INDEX)
+		tbl->items[prev_item_idx].inner_item.next_pkt_idx = next_idx;
+
+	return next_idx;
+}
+
+static inline uint32_t
+insert_new_flow(struct gro_vxlan_udp4_tbl *tbl,
+		struct vxlan_udp4_flow_key *src,
+		uint32_t bucket,
+		uint32_t item_idx)
+{
+	struct vxlan_udp4_flow_key *dst;
+	uint32_t flow_idx;
+
+	flow_idx = find_an_empty_flow(tbl);
+	if (unlikely(flow_idx == INVALID_ARRAY_INDEX))
+		return INVALID_ARRAY_INDEX;
+
+	dst = &(tbl->flows[flow_idx].key);
+
+	ether_addr_copy(&(src->inner_key.eth_saddr),
+			&(dst->inner_key.eth_saddr));
+	ether_addr_copy(&(src->inner_key.eth_daddr),
+			&(dst->inner_key.eth_daddr));
+	dst->inner_key.ip_src_addr = src->inner_key.ip_src_addr;
+	dst->inner_key.ip_dst_addr = src->inner_key.ip_dst_addr;
+	dst->inner_key.ip_id = src->inner_key.ip_id;
+
+	dst->vxlan_hdr.vx_flags = src->vxlan_hdr.vx_flags;
+	dst->vxlan_hdr.vx_vni = src->vxlan_hdr.vx_vni;
+	ether_addr_copy(&(src->outer_eth_saddr), &(dst->outer_eth_saddr));
+	ether_addr_copy(&(src->outer_eth_daddr), &(dst->outer_eth_daddr));
+	dst->outer_ip_src_addr = src->outer_ip_src_addr;
+	dst->outer_ip_dst_addr = src->outer_ip_dst_addr;
+	dst->outer_src_port = src->outer_src_port;
+	dst->outer_dst_port = src->outer_dst_port;
+
+	tbl->flows[flow_idx].start_index = item_idx;
+	tbl->flows[flow_idx].next_flow_idx = tbl->buckets[bucket];
+	tbl->buckets[bucket] = flow_idx;
+	tbl->flow_num++;
+
+	return flow_idx;
+}
+
+/*
+ * Remove an empty flow from its hash bucket and put it back to the
+ * empty flows.
+ */
+static inline void
+delete_flow(struct gro_vxlan_udp4_tbl *tbl, uint32_t flow_idx)
+{
+	uint32_t *prev;
+
+	prev = &tbl->buckets[vxlan_udp4_flow_hash(&tbl->flows[flow_idx].key) &
+		tbl->bucket_mask];
+	while (*prev != flow_idx)
+		prev = &tbl->flows[*prev].next_flow_idx;
+	*prev = tbl->flows[flow_idx].next_flow_idx;
+
+	tbl->flows[flow_idx].next_flow_idx = tbl->free_flow_idx;
+	tbl->free_flow_idx = flow_idx;
+	tbl->flow_num--;
+}
+
+static inline int
+is_same_vxlan_udp4_flow(struct vxlan_udp4_flow_key k1,
+		struct vxlan_udp4_flow_key k2)
+{
+	return (is_same_ether_addr(&k1.outer_eth_saddr, &k2.outer_eth_saddr) &&
+			is_same_ether_addr(&k1.outer_eth_daddr,
+				&k2.outer_eth_daddr) &&
+			(k1.outer_ip_src_addr == k2.outer_ip_src_addr) &&
+			(k1.outer_ip_dst_addr == k2.outer_ip_dst_addr) &&
+			(k1.outer_src_port == k2.outer_src_port) &&
+			(k1.outer_dst_port == k2.outer_dst_port) &&
+			(k1.vxlan_hdr.vx_flags == k2.vxlan_hdr.vx_flags) &&
+			(k1.vxlan_hdr.vx_vni == k2.vxlan_hdr.vx_vni) &&
+			is_same_udp4_flow(k1.inner_key, k2.inner_key));
+}
+
+static inline void
+update_vxlan_header(struct gro_vxlan_udp4_item *item)
+{
+	struct ipv4_hdr *ipv4_hdr;
+	struct udp_hdr *udp_hdr;
+	struct rte_mbuf *pkt = item->inner_item.firstseg;
+	uint16_t len, frag_off;
+
+	/* Update the outer IPv4 header. */
+	len = pkt->pkt_len - pkt->outer_l2_len;
+	ipv4_hdr = (struct ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			pkt->outer_l2_len);
+	ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+
+	/* Update the outer UDP header. */
+	len -= pkt->outer_l3_len;
+	udp_hdr = (struct udp_hdr *)((char *)ipv4_hdr + pkt->outer_l3_len);
+	udp_hdr->dgram_len = rte_cpu_to_be_16(len);
+
+	/* Update the inner IPv4 header. */
+	len -= pkt->l2_len;
+	ipv4_hdr = (struct ipv4_hdr *)((char *)udp_hdr + pkt->l2_len);
+	ipv4_hdr->total_length = rte_cpu_to_be_16(len);
+
+	/* The merged packet ends the inner datagram. */
+	if (item->inner_item.is_last_frag) {
+		frag_off = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+		ipv4_hdr->fragment_offset = rte_cpu_to_be_16(frag_off &
+				~IPV4_HDR_MF_FLAG);
+	}
+}
+
+/*
+ * Merge the neighbors of a flow, which were separated by a missing
+ * fragment when they were stored.
+ */
+static inline void
+merge_items(struct gro_vxlan_udp4_tbl *tbl, uint32_t start_idx)
+{
+	struct gro_udp4_item *item, *next;
+	struct rte_mbuf *pkt;
+	uint32_t cur_idx, next_idx;
+	uint16_t ip_dl;
+
+	cur_idx = start_idx;
+	next_idx = tbl->items[cur_idx].inner_item.next_pkt_idx;
+	while (next_idx != INVALID_ARRAY_INDEX) {
+		item = &tbl->items[cur_idx].inner_item;
+		next = &tbl->items[next_idx].inner_item;
+		pkt = next->firstseg;
+		ip_dl = pkt->pkt_len - udp4_hdr_len(pkt, 1);
+
+		if (udp4_check_neighbor(item, next->frag_offset, ip_dl,
+					next->is_last_frag, 1) > 0 &&
+				merge_two_udp4_packets(item, pkt, 1,
+					next->frag_offset,
+					next->is_last_frag, 1)) {
+			item->nb_merged += next->nb_merged - 1;
+			next_idx = delete_item(tbl, next_idx, cur_idx);
+		} else {
+			cur_idx = next_idx;
+			next_idx = next->next_pkt_idx;
+		}
+	}
+}
+
+int32_t
+gro_vxlan_udp4_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_udp4_tbl *tbl,
+		uint64_t start_time)
+{
+	struct ether_hdr *outer_eth_hdr, *eth_hdr;
+	struct ipv4_hdr *outer_ipv4_hdr, *ipv4_hdr;
+	struct udp_hdr *udp_hdr;
+	struct vxlan_hdr *vxlan_hdr;
+	uint32_t pkt_len;
+	uint16_t ip_dl, frag_offset, l2_offset;
+	uint8_t is_last_frag;
+
+	struct vxlan_udp4_flow_key key;
+	uint32_t cur_idx, prev_idx, item_idx;
+	uint32_t i, bucket;
+	int cmp;
+
+	outer_eth_hdr = rte_pktmbuf_mtod(pkt, struct ether_hdr *);
+	outer_ipv4_hdr = (struct ipv4_hdr *)((char *)outer_eth_hdr +
+			pkt->outer_l2_len);
+	udp_hdr = (struct udp_hdr *)((char *)outer_ipv4_hdr +
+			pkt->outer_l3_len);
+	vxlan_hdr = (struct vxlan_hdr *)((char *)udp_hdr +
+			sizeof(struct udp_hdr));
+	eth_hdr = (struct ether_hdr *)((char *)vxlan_hdr +
+			sizeof(struct vxlan_hdr));
+	ipv4_hdr = (struct ipv4_hdr *)((char *)udp_hdr + pkt->l2_len);
+
+	/* Don't process the packet whose inner packet isn't a fragment. */
+	if (ipv4_hdr->next_proto_id != IPPROTO_UDP ||
+			!is_ipv4_fragment(ipv4_hdr))
+		return -1;
+
+	/*
+	 * Don't process the packet whose payload length is less than or
+	 * equal to 0.
+	 */
+	ip_dl = rte_be_to_cpu_16(ipv4_hdr->total_length);
+	if (ip_dl <= pkt->l3_len)
+		return -1;
+
+	/* Remove the Ethernet padding of the outer packet. */
+	l2_offset = pkt->outer_l2_len + pkt->outer_l3_len;
+	pkt_len = l2_offset + pkt->l2_len + ip_dl;
+	if (pkt->pkt_len < pkt_len)
+		return -1;
+	if (pkt->pkt_len > pkt_len)
+		rte_pktmbuf_trim(pkt, pkt->pkt_len - pkt_len);
+	ip_dl -= pkt->l3_len;
+
+	frag_offset = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+	is_last_frag = (frag_offset & IPV4_HDR_MF_FLAG) == 0;
+	frag_offset = (frag_offset & IPV4_HDR_OFFSET_MASK) *
+		IPV4_HDR_OFFSET_UNITS;
+
+	ether_addr_copy(&(eth_hdr->s_addr), &(key.inner_key.eth_saddr));
+	ether_addr_copy(&(eth_hdr->d_addr), &(key.inner_key.eth_daddr));
+	key.inner_key.ip_src_addr = ipv4_hdr->src_addr;
+	key.inner_key.ip_dst_addr = ipv4_hdr->dst_addr;
+	key.inner_key.ip_id = ipv4_hdr->packet_id;
+
+	key.vxlan_hdr.vx_flags = vxlan_hdr->vx_flags;
+	key.vxlan_hdr.vx_vni = vxlan_hdr->vx_vni;
+	ether_addr_copy(&(outer_eth_hdr->s_addr), &(key.outer_eth_saddr));
+	ether_addr_copy(&(outer_eth_hdr->d_addr), &(key.outer_eth_daddr));
+	key.outer_ip_src_addr = outer_ipv4_hdr->src_addr;
+	key.outer_ip_dst_addr = outer_ipv4_hdr->dst_addr;
+	key.outer_src_port = udp_hdr->src_port;
+	key.outer_dst_port = udp_hdr->dst_port;
+
+	/* Search for a matched flow in its hash bucket. */
+	bucket = vxlan_udp4_flow_hash(&key) & tbl->bucket_mask;
+	for (i = tbl->buckets[bucket]; i != INVALID_ARRAY_INDEX;
+			i = tbl->flows[i].next_flow_idx) {
+		if (is_same_vxlan_udp4_flow(tbl->flows[i].key, key))
+			break;
+	}
+
+	/*
+	 * Can't find a matched flow. Insert a new flow and store the
+	 * packet into the flow.
+	 */
+	if (i == INVALID_ARRAY_INDEX) {
+		item_idx = insert_new_item(tbl, pkt, start_time,
+				INVALID_ARRAY_INDEX, INVALID_ARRAY_INDEX,
+				frag_offset, is_last_frag);
+		if (item_idx == INVALID_ARRAY_INDEX)
+			return -1;
+		if (insert_new_flow(tbl, &key, bucket, item_idx) ==
+				INVALID_ARRAY_INDEX) {
+			/*
+			 * Fail to insert a new flow, so
+			 * delete the inserted packet.
+			 */
+			delete_item(tbl, item_idx, INVALID_ARRAY_INDEX);
+			return -1;
+		}
+		return 0;
+	}
+
+	/*
+	 * Check the packets of the flow, which are sorted by their
+	 * fragment offsets, and try to find a neighbor.
+	 */
+	cur_idx = tbl->flows[i].start_index;
+	prev_idx = INVALID_ARRAY_INDEX;
+	do {
+		cmp = udp4_check_neighbor(&(tbl->items[cur_idx].inner_item),
+				frag_offset, ip_dl, is_last_frag, 1);
+		if (cmp) {
+			if (merge_two_udp4_packets(
+						&(tbl->items[cur_idx].inner_item),
+						pkt, cmp, frag_offset,
+						is_last_frag, 1))
+				return 1;
+			/*
+			 * Can't merge two packets, as the packet
+			 * length will be greater than the max value.
+			 * Insert the packet next to its neighbor.
+			 */
+			if (cmp > 0)
+				prev_idx = cur_idx;
+			break;
+		}
+		if (frag_offset < tbl->items[cur_idx].inner_item.frag_offset)
+			break;
+		prev_idx = cur_idx;
+		cur_idx = tbl->items[cur_idx].inner_item.next_pkt_idx;
+	} while (cur_idx != INVALID_ARRAY_INDEX);
+
+	/* Insert the packet into the flow, keeping the packets sorted. */
+	item_idx = insert_new_item(tbl, pkt, start_time, prev_idx,
+			tbl->flows[i].start_index, frag_offset, is_last_frag);
+	if (item_idx == INVALID_ARRAY_INDEX)
+		return -1;
+	if (prev_idx == INVALID_ARRAY_INDEX)
+		tbl->flows[i].start_index = item_idx;
+
+	return 0;
+}
+
+uint16_t
+gro_vxlan_udp4_tbl_timeout_flush(struct gro_vxlan_udp4_tbl *tbl,
+		uint64_t flush_timestamp,
+		struct rte_mbuf **out,
+		uint16_t nb_out)
+{
+	uint16_t k = 0;
+	uint32_t i, j;
+	uint32_t max_flow_num = tbl->max_flow_num;
+
+	for (i = 0; i < max_flow_num; i++) {
+		if (unlikely(tbl->flow_num == 0))
+			return k;
+
+		j = tbl->flows[i].start_index;
+		if (j == INVALID_ARRAY_INDEX)
+			continue;
+
+		merge_items(tbl, j);
+		while (j != INVALID_ARRAY_INDEX) {
+			if (tbl->items[j].inner_item.start_time <=
+					flush_timestamp) {
+				out[k++] = tbl->items[j].inner_item.firstseg;
+				if (tbl->items[j].inner_item.nb_merged > 1)
+					update_vxlan_header(&(tbl->items[j]));
+				/*
+				 * Delete the item and get the next packet
+				 * index.
+				 */
+				j = delete_item(tbl, j, INVALID_ARRAY_INDEX);
+				tbl->flows[i].start_index = j;
+				if (j == INVALID_ARRAY_INDEX)
+					delete_flow(tbl, i);
+
+				if (unlikely(k == nb_out))
+					return k;
+			} else
+				/*
+				 * The left packets in the flow won't be
+				 * timeout. Go to check other flows.
+				 */
+				break;
+		}
+	}
+	return k;
+}
+
+uint32_t
+gro_vxlan_udp4_tbl_pkt_count(void *tbl)
+{
+	struct gro_vxlan_udp4_tbl *gro_tbl = tbl;
+
+	if (gro_tbl)
+		return gro_tbl->item_num;
+
+	return 0;
+}
@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#ifndef _GRO_VXLAN_UDP4_H_
+#define _GRO_VXLAN_UDP4_H_
+
+#include "gro_udp4.h"
+
+#define GRO_VXLAN_UDP4_TBL_MAX_ITEM_NUM (1024UL * 1024UL)
+
+/* Header fields representing the fragments of a VxLAN inner datagram */
+struct vxlan_udp4_flow_key {
+	struct udp4_flow_key inner_key;
+	struct vxlan_hdr vxlan_hdr;
+
+	struct ether_addr outer_eth_saddr;
+	struct ether_addr outer_eth_daddr;
+
+	uint32_t outer_ip_src_addr;
+	uint32_t outer_ip_dst_addr;
+
+	/* Outer UDP ports */
+	uint16_t outer_src_port;
+	uint16_t outer_dst_port;
+};
+
+struct gro_vxlan_udp4_flow {
+	struct vxlan_udp4_flow_key key;
+	/*
+	 * The index of the first packet in the flow. INVALID_ARRAY_INDEX
+	 * indicates an empty flow.
+	 */
+	uint32_t start_index;
+	/*
+	 * The index of the next flow in the same hash bucket, or of the
+	 * next empty flow if the flow is empty.
+	 */
+	uint32_t next_flow_idx;
+};
+
+struct gro_vxlan_udp4_item {
+	struct gro_udp4_item inner_item;
+};
+
+/*
+ * VxLAN (with an outer IPv4 header and an inner UDP/IPv4 fragment)
+ * reassembly table structure
+ */
+struct gro_vxlan_udp4_tbl {
+	/* item array */
+	struct gro_vxlan_udp4_item *items;
+	/* flow array */
+	struct gro_vxlan_udp4_flow *flows;
+	/* current item number */
+	uint32_t item_num;
+	/* current flow number */
+	uint32_t flow_num;
+	/* the maximum item number */
+	uint32_t max_item_num;
+	/* the maximum flow number */
+	uint32_t max_flow_num;
+	/*
+	 * Hash buckets of the flows. Each bucket keeps the index of its
+	 * first flow, the other flows are chained by next_flow_idx.
+	 */
+	uint32_t *buckets;
+	/* the number of buckets minus 1, it's a power of 2 minus 1 */
+	uint32_t bucket_mask;
+	/* the first empty item, empty items are chained by next_pkt_idx */
+	uint32_t free_item_idx;
+	/* the first empty flow */
+	uint32_t free_flow_idx;
+};
+
+/**
+ * This function creates a VxLAN reassembly table for VxLAN packets
+ * which have an outer IPv4 header and an inner UDP/IPv4 fragment.
+ *
+ * @param socket_id
+ *  Socket index for allocating the table
+ * @param max_flow_num
+ *  The maximum number of flows in the table
+ * @param max_item_per_flow
+ *  The maximum number of packets per flow
+ *
+ * @return
+ *  - Return the table pointer on success.
+ *  - Return NULL on failure.
+ */
+void *gro_vxlan_udp4_tbl_create(uint16_t socket_id,
+		uint16_t max_flow_num,
+		uint16_t max_item_per_flow);
+
+/**
+ * This function empties a VxLAN reassembly table, whose items, flows and
+ * buckets arrays are already set. It's used for the tables which aren't
+ * created by gro_vxlan_udp4_tbl_create().
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_udp4_tbl_init(struct gro_vxlan_udp4_tbl *tbl);
+
+/**
+ * This function destroys a VxLAN reassembly table.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ */
+void gro_vxlan_udp4_tbl_destroy(void *tbl);
+
+/**
+ * This function merges a VxLAN packet which has an outer IPv4 header and
+ * an inner UDP/IPv4 fragment. It doesn't process the packet whose inner
+ * IPv4 packet isn't a fragment or has no payload.
+ *
+ * This function doesn't check if the packet has correct checksums and
+ * doesn't re-calculate checksums for the merged packet. The outer IPv4
+ * ID isn't checked. It returns the packet, if the packet has invalid
+ * parameters or there is no available space in the table.
+ *
+ * @param pkt
+ *  Packet to reassemble
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ * @start_time
+ *  The time when the packet is inserted into the table
+ *
+ * @return
+ *  - Return a positive value if the packet is merged.
+ *  - Return zero if the packet isn't merged but stored in the table.
+ *  - Return a negative value for invalid parameters or no available
+ *    space in the table.
+ */
+int32_t gro_vxlan_udp4_reassemble(struct rte_mbuf *pkt,
+		struct gro_vxlan_udp4_tbl *tbl,
+		uint64_t start_time);
+
+/**
+ * This function flushes timeout packets in the VxLAN reassembly table,
+ * and without updating checksums.
+ *
+ * @param tbl
+ *  Pointer pointing to a VxLAN GRO table
+ * @param flush_timestamp
+ *  This function flushes packets which are inserted into the table
+ *  before or at the flush_timestamp.
+ * @param out
+ *  Pointer array used to keep flushed packets
+ * @param nb_out
+ *  The element number in 'out'. It also determines the maximum number of
+ *  packets that can be flushed finally.
+ *
+ * @return
+ *  The number of flushed packets
+ */
+uint16_t gro_vxlan_udp4_tbl_timeout_flush(struct gro_vxlan_udp4_tbl *tbl,
+		uint64_t flush_timestamp,
+		struct rte_mbuf **out,
+		uint16_t nb_out);
+
+/**
+ * This function returns the number of the packets in a VxLAN
+ * reassembly table.
+ *
+ * @param tbl
+ *  Pointer pointing to the VxLAN reassembly table
+ *
+ * @return
+ *  The number of packets in the table
+ */
+uint32_t gro_vxlan_udp4_tbl_pkt_count(void *tbl);
+
+/*
+ * Calculate the hash value of a VxLAN flow from the hash value of its
+ * inner UDP/IPv4 datagram, the outer IPv4 addresses and the VNI.
+ */
+static inline uint32_t
+vxlan_udp4_flow_hash(const struct vxlan_udp4_flow_key *key)
+{
+	uint32_t v;
+
+	v = udp4_flow_hash(&key->inner_key);
+
+#ifdef RTE_ARCH_X86
+	v = rte_hash_crc_4byte(key->outer_ip_src_addr, v);
+	v = rte_hash_crc_4byte(key->outer_ip_dst_addr, v);
+	v = rte_hash_crc_4byte(key->vxlan_hdr.vx_vni, v);
+#else
+	v = rte_jhash_3words(key->outer_ip_src_addr, key->outer_ip_dst_addr,
+			key->vxlan_hdr.vx_vni, v);
+#endif /* RTE_ARCH_X86 */
+
+	return v;
+}
+#endif
@@ -9,7 +9,10 @@
 
 #include "rte_gro.h"
 #include "gro_tcp4.h"
+#include "gro_tcp6.h"
+#include "gro_udp4.h"
 #include "gro_vxlan_tcp4.h"
+#include "gro_vxlan_udp4.h"
 
 typedef void *(*gro_tbl_create_fn)(uint16_t socket_id,
 		uint16_t max_flow_num,
@@ -18,14 +21,24 @@ typedef void (*gro_tbl_destroy_fn)(void *tbl);
 typedef uint32_t (*gro_tbl_pkt_count_fn)(void *tbl);
 
 static gro_tbl_create_fn tbl_create_fn[RTE_GRO_TYPE_MAX_NUM] = {
-		gro_tcp4_tbl_create, gro_vxlan_tcp4_tbl_create, NULL};
+		gro_tcp4_tbl_create, gro_vxlan_tcp4_tbl_create,
+		gro_udp4_tbl_create, gro_vxlan_udp4_tbl_create,
+		gro_tcp6_tbl_create, NULL};
 static gro_tbl_destroy_fn tbl_destroy_fn[RTE_GRO_TYPE_MAX_NUM] = {
 			gro_tcp4_tbl_destroy, gro_vxlan_tcp4_tbl_destroy,
+			gro_udp4_tbl_destroy, gro_vxlan_udp4_tbl_destroy,
+			gro_tcp6_tbl_destroy,
 			NULL};
 static gro_tbl_pkt_count_fn tbl_pkt_count_fn[RTE_GRO_TYPE_MAX_NUM] = {
 			gro_tcp4_tbl_pkt_count, gro_vxlan_tcp4_tbl_pkt_count,
+			gro_udp4_tbl_pkt_count, gro_vxlan_udp4_tbl_pkt_count,
+			gro_tcp6_tbl_pkt_count,
 			NULL};
 
+#define GRO_SUPPORTED_TYPES (RTE_GRO_TCP_IPV4 | \
+		RTE_GRO_IPV4_VXLAN_TCP_IPV4 | RTE_GRO_UDP_IPV4 | \
+		RTE_GRO_IPV4_VXLAN_UDP_IPV4 | RTE_GRO_TCP_IPV6)
+
 #define IS_IPV4_TCP_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
 		((ptype & RTE_PTYPE_L4_TCP) == RTE_PTYPE_L4_TCP))
 
@@ -40,6 +53,29 @@ static gro_tbl_pkt_count_fn tbl_pkt_count_fn[RTE_GRO_TYPE_MAX_NUM] = {
 		     RTE_PTYPE_INNER_L3_IPV4_EXT | \
 		     RTE_PTYPE_INNER_L3_IPV4_EXT_UNKNOWN)) != 0))
 
+/* Non-first fragments are usually reported as RTE_PTYPE_L4_FRAG */
+#define IS_IPV4_UDP_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
+		(((ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_UDP) || \
+		 ((ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_FRAG)) && \
+		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
+
+#define IS_IPV4_VXLAN_UDP4_PKT(ptype) (RTE_ETH_IS_IPV4_HDR(ptype) && \
+		((ptype & RTE_PTYPE_L4_UDP) == RTE_PTYPE_L4_UDP) && \
+		((ptype & RTE_PTYPE_TUNNEL_VXLAN) == \
+		 RTE_PTYPE_TUNNEL_VXLAN) && \
+		 (((ptype & RTE_PTYPE_INNER_L4_MASK) == \
+		   RTE_PTYPE_INNER_L4_UDP) || \
+		  ((ptype & RTE_PTYPE_INNER_L4_MASK) == \
+		   RTE_PTYPE_INNER_L4_FRAG)) && \
+		  (((ptype & RTE_PTYPE_INNER_L3_MASK) & \
+		    (RTE_PTYPE_INNER_L3_IPV4 | \
+		     RTE_PTYPE_INNER_L3_IPV4_EXT | \
+		     RTE_PTYPE_INNER_L3_IPV4_EXT_UNKNOWN)) != 0))
+
+#define IS_IPV6_TCP_PKT(ptype) (RTE_ETH_IS_IPV6_HDR(ptype) && \
+		((ptype & RTE_PTYPE_L4_MASK) == RTE_PTYPE_L4_TCP) && \
+		(RTE_ETH_IS_TUNNEL_PKT(ptype) == 0))
+
 /*
  * GRO context structure. It keeps the table structures, which are
  * used to merge packets, for different GRO types. Before using
@@ -121,55 +157,108 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 	/* allocate a reassembly table for TCP/IPv4 GRO */
 	struct gro_tcp4_tbl tcp_tbl;
 	struct gro_tcp4_flow tcp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
-	struct gro_tcp4_item tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM] = {{0} };
+	struct gro_tcp4_item tcp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t tcp_buckets[RTE_GRO_MAX_BURST_ITEM_NUM];
 
 	/* Allocate a reassembly table for VXLAN GRO */
 	struct gro_vxlan_tcp4_tbl vxlan_tbl;
 	struct gro_vxlan_tcp4_flow vxlan_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
-	struct gro_vxlan_tcp4_item vxlan_items[RTE_GRO_MAX_BURST_ITEM_NUM] = {
-		{{0}, 0, 0} };
+	struct gro_vxlan_tcp4_item vxlan_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t vxlan_buckets[RTE_GRO_MAX_BURST_ITEM_NUM];
+
+	/* Allocate a reassembly table for UDP/IPv4 GRO */
+	struct gro_udp4_tbl udp_tbl;
+	struct gro_udp4_flow udp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_udp4_item udp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t udp_buckets[RTE_GRO_MAX_BURST_ITEM_NUM];
+
+	/* Allocate a reassembly table for VXLAN UDP GRO */
+	struct gro_vxlan_udp4_tbl vxlan_udp_tbl;
+	struct gro_vxlan_udp4_flow vxlan_udp_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_vxlan_udp4_item vxlan_udp_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t vxlan_udp_buckets[RTE_GRO_MAX_BURST_ITEM_NUM];
+
+	/* Allocate a reassembly table for TCP/IPv6 GRO */
+	struct gro_tcp6_tbl tcp6_tbl;
+	struct gro_tcp6_flow tcp6_flows[RTE_GRO_MAX_BURST_ITEM_NUM];
+	struct gro_tcp4_item tcp6_items[RTE_GRO_MAX_BURST_ITEM_NUM];
+	uint32_t tcp6_buckets[RTE_GRO_MAX_BURST_ITEM_NUM];
 
 	struct rte_mbuf *unprocess_pkts[nb_pkts];
-	uint32_t item_num;
+	uint32_t item_num, bucket_mask;
 	int32_t ret;
 	uint16_t i, unprocess_num = 0, nb_after_gro = nb_pkts;
-	uint8_t do_tcp4_gro = 0, do_vxlan_gro = 0;
+	uint8_t do_tcp4_gro = 0, do_vxlan_gro = 0, do_udp4_gro = 0,
+		do_vxlan_udp_gro = 0, do_tcp6_gro = 0;
+
+	/* the buckets arrays hold the buckets of item_num flows */
+	RTE_BUILD_BUG_ON((RTE_GRO_MAX_BURST_ITEM_NUM &
+				(RTE_GRO_MAX_BURST_ITEM_NUM - 1)) != 0);
 
-	if (unlikely((param->gro_types & (RTE_GRO_IPV4_VXLAN_TCP_IPV4 |
-					RTE_GRO_TCP_IPV4)) == 0))
+	if (unlikely((param->gro_types & GRO_SUPPORTED_TYPES) == 0))
 		return nb_pkts;
 
 	/* Get the maximum number of packets */
 	item_num = RTE_MIN(nb_pkts, (param->max_flow_num *
 				param->max_item_per_flow));
 	item_num = RTE_MIN(item_num, RTE_GRO_MAX_BURST_ITEM_NUM);
+	bucket_mask = rte_align32pow2(RTE_MAX(item_num, 1U)) - 1;
 
 	if (param->gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV4) {
-		for (i = 0; i < item_num; i++)
-			vxlan_flows[i].start_index = INVALID_ARRAY_INDEX;
-
 		vxlan_tbl.flows = vxlan_flows;
 		vxlan_tbl.items = vxlan_items;
-		vxlan_tbl.flow_num = 0;
-		vxlan_tbl.item_num = 0;
+		vxlan_tbl.buckets = vxlan_buckets;
 		vxlan_tbl.max_flow_num = item_num;
 		vxlan_tbl.max_item_num = item_num;
+		vxlan_tbl.bucket_mask = bucket_mask;
+		gro_vxlan_tcp4_tbl_init(&vxlan_tbl);
 		do_vxlan_gro = 1;
 	}
 
-	if (param->gro_types & RTE_GRO_TCP_IPV4) {
-		for (i = 0; i < item_num; i++)
-			tcp_flows[i].start_index = INVALID_ARRAY_INDEX;
+	if (param->gro_types & RTE_GRO_IPV4_VXLAN_UDP_IPV4) {
+		vxlan_udp_tbl.flows = vxlan_udp_flows;
+		vxlan_udp_tbl.items = vxlan_udp_items;
+		vxlan_udp_tbl.buckets = vxlan_udp_buckets;
+		vxlan_udp_tbl.max_flow_num = item_num;
+		vxlan_udp_tbl.max_item_num = item_num;
+		vxlan_udp_tbl.bucket_mask = bucket_mask;
+		gro_vxlan_udp4_tbl_init(&vxlan_udp_tbl);
+		do_vxlan_udp_gro = 1;
+	}
 
+	if (param->gro_types & RTE_GRO_TCP_IPV4) {
 		tcp_tbl.flows = tcp_flows;
 		tcp_tbl.items = tcp_items;
-		tcp_tbl.flow_num = 0;
-		tcp_tbl.item_num = 0;
+		tcp_tbl.buckets = tcp_buckets;
 		tcp_tbl.max_flow_num = item_num;
 		tcp_tbl.max_item_num = item_num;
+		tcp_tbl.bucket_mask = bucket_mask;
+		gro_tcp4_tbl_init(&tcp_tbl);
 		do_tcp4_gro = 1;
 	}
 
+	if (param->gro_types & RTE_GRO_UDP_IPV4) {
+		udp_tbl.flows = udp_flows;
+		udp_tbl.items = udp_items;
+		udp_tbl.buckets = udp_buckets;
+		udp_tbl.max_flow_num = item_num;
+		udp_tbl.max_item_num = item_num;
+		udp_tbl.bucket_mask = bucket_mask;
+		gro_udp4_tbl_init(&udp_tbl);
+		do_udp4_gro = 1;
+	}
+
+	if (param->gro_types & RTE_GRO_TCP_IPV6) {
+		tcp6_tbl.flows = tcp6_flows;
+		tcp6_tbl.items = tcp6_items;
+		tcp6_tbl.buckets = tcp6_buckets;
+		tcp6_tbl.max_flow_num = item_num;
+		tcp6_tbl.max_item_num = item_num;
+		tcp6_tbl.bucket_mask = bucket_mask;
+		gro_tcp6_tbl_init(&tcp6_tbl);
+		do_tcp6_gro = 1;
+	}
+
 	for (i = 0; i < nb_pkts; i++) {
 		/*
 		 * The timestamp is ignored, since all packets
@@ -178,20 +267,26 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 		if (IS_IPV4_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
 				do_vxlan_gro) {
 			ret = gro_vxlan_tcp4_reassemble(pkts[i], &vxlan_tbl, 0);
-			if (ret > 0)
-				/* Merge successfully */
-				nb_after_gro--;
-			else if (ret < 0)
-				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV4_VXLAN_UDP4_PKT(pkts[i]->packet_type) &&
+				do_vxlan_udp_gro) {
+			ret = gro_vxlan_udp4_reassemble(pkts[i],
+					&vxlan_udp_tbl, 0);
+		} else if (IS_IPV4_UDP_PKT(pkts[i]->packet_type) &&
+				do_udp4_gro) {
+			ret = gro_udp4_reassemble(pkts[i], &udp_tbl, 0);
 		} else if (IS_IPV4_TCP_PKT(pkts[i]->packet_type) &&
 				do_tcp4_gro) {
 			ret = gro_tcp4_reassemble(pkts[i], &tcp_tbl, 0);
-			if (ret > 0)
-				/* merge successfully */
-				nb_after_gro--;
-			else if (ret < 0)
-				unprocess_pkts[unprocess_num++] = pkts[i];
+		} else if (IS_IPV6_TCP_PKT(pkts[i]->packet_type) &&
+				do_tcp6_gro) {
+			ret = gro_tcp6_reassemble(pkts[i], &tcp6_tbl, 0);
 		} else
+			ret = -1;
+
+		if (ret > 0)
+			/* merge successfully */
+			nb_after_gro--;
+		else if (ret < 0)
 			unprocess_pkts[unprocess_num++] = pkts[i];
 	}
 
@@ -202,16 +297,33 @@ rte_gro_reassemble_burst(struct rte_mbuf **pkts,
 			i = gro_vxlan_tcp4_tbl_timeout_flush(&vxlan_tbl,
 					0, pkts, nb_pkts);
 		}
+		if (do_vxlan_udp_gro) {
+			i += gro_vxlan_udp4_tbl_timeout_flush(&vxlan_udp_tbl,
+					0, &pkts[i], nb_pkts - i);
+		}
 		if (do_tcp4_gro) {
 			i += gro_tcp4_tbl_timeout_flush(&tcp_tbl, 0,
 					&pkts[i], nb_pkts - i);
 		}
+		if (do_udp4_gro) {
+			i += gro_udp4_tbl_timeout_flush(&udp_tbl, 0,
+					&pkts[i], nb_pkts - i);
+		}
+		if (do_tcp6_gro) {
+			i += gro_tcp6_tbl_timeout_flush(&tcp6_tbl, 0,
+					&pkts[i], nb_pkts - i);
+		}
 		/* Copy unprocessed packets */
 		if (unprocess_num > 0) {
 			memcpy(&pkts[i], unprocess_pkts,
 					sizeof(struct rte_mbuf *) *
 					unprocess_num);
 		}
+		/*
+		 * UDP/IPv4 fragments, which fill the gap between two
+		 * stored fragments, are merged when flushing.
+		 */
+		nb_after_gro = i + unprocess_num;
 	}
 
 	return nb_after_gro;
@@ -224,37 +336,61 @@ rte_gro_reassemble(struct rte_mbuf **pkts,
 {
 	struct rte_mbuf *unprocess_pkts[nb_pkts];
 	struct gro_ctx *gro_ctx = ctx;
-	void *tcp_tbl, *vxlan_tbl;
+	void *tcp_tbl, *vxlan_tbl, *udp_tbl, *vxlan_udp_tbl, *tcp6_tbl;
 	uint64_t current_time;
+	int32_t ret;
 	uint16_t i, unprocess_num = 0;
-	uint8_t do_tcp4_gro, do_vxlan_gro;
+	uint8_t do_tcp4_gro, do_vxlan_gro, do_udp4_gro, do_vxlan_udp_gro,
+		do_tcp6_gro;
 
-	if (unlikely((gro_ctx->gro_types & (RTE_GRO_IPV4_VXLAN_TCP_IPV4 |
-					RTE_GRO_TCP_IPV4)) == 0))
+	if (unlikely((gro_ctx->gro_types & GRO_SUPPORTED_TYPES) == 0))
 		return nb_pkts;
 
 	tcp_tbl = gro_ctx->tbls[RTE_GRO_TCP_IPV4_INDEX];
 	vxlan_tbl = gro_ctx->tbls[RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX];
+	udp_tbl = gro_ctx->tbls[RTE_GRO_UDP_IPV4_INDEX];
+	vxlan_udp_tbl = gro_ctx->tbls[RTE_GRO_IPV4_VXLAN_UDP_IPV4_INDEX];
+	tcp6_tbl = gro_ctx->tbls[RTE_GRO_TCP_IPV6_INDEX];
 
 	do_tcp4_gro = (gro_ctx->gro_types & RTE_GRO_TCP_IPV4) ==
 		RTE_GRO_TCP_IPV4;
 	do_vxlan_gro = (gro_ctx->gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV4) ==
 		RTE_GRO_IPV4_VXLAN_TCP_IPV4;
+	do_udp4_gro = (gro_ctx->gro_types & RTE_GRO_UDP_IPV4) ==
+		RTE_GRO_UDP_IPV4;
+	do_vxlan_udp_gro = (gro_ctx->gro_types &
+			RTE_GRO_IPV4_VXLAN_UDP_IPV4) ==
+		RTE_GRO_IPV4_VXLAN_UDP_IPV4;
+	do_tcp6_gro = (gro_ctx->gro_types & RTE_GRO_TCP_IPV6) ==
+		RTE_GRO_TCP_IPV6;
 
 	current_time = rte_rdtsc();
 
 	for (i = 0; i < nb_pkts; i++) {
 		if (IS_IPV4_VXLAN_TCP4_PKT(pkts[i]->packet_type) &&
 				do_vxlan_gro) {
-			if (gro_vxlan_tcp4_reassemble(pkts[i], vxlan_tbl,
-						current_time) < 0)
-				unprocess_pkts[unprocess_num++] = pkts[i];
+			ret = gro_vxlan_tcp4_reassemble(pkts[i], vxlan_tbl,
+					current_time);
+		} else if (IS_IPV4_VXLAN_UDP4_PKT(pkts[i]->packet_type) &&
+				do_vxlan_udp_gro) {
+			ret = gro_vxlan_udp4_reassemble(pkts[i],
+					vxlan_udp_tbl, current_time);
+		} else if (IS_IPV4_UDP_PKT(pkts[i]->packet_type) &&
+				do_udp4_gro) {
+			ret = gro_udp4_reassemble(pkts[i], udp_tbl,
+					current_time);
 		} else if (IS_IPV4_TCP_PKT(pkts[i]->packet_type) &&
 				do_tcp4_gro) {
-			if (gro_tcp4_reassemble(pkts[i], tcp_tbl,
-						current_time) < 0)
-				unprocess_pkts[unprocess_num++] = pkts[i];
+			ret = gro_tcp4_reassemble(pkts[i], tcp_tbl,
+					current_time);
+		} else if (IS_IPV6_TCP_PKT(pkts[i]->packet_type) &&
+				do_tcp6_gro) {
+			ret = gro_tcp6_reassemble(pkts[i], tcp6_tbl,
+					current_time);
 		} else
+			ret = -1;
+
+		if (ret < 0)
 			unprocess_pkts[unprocess_num++] = pkts[i];
 	}
 	if (unprocess_num > 0) {
@@ -275,6 +411,7 @@ rte_gro_timeout_flush(void *ctx,
 	struct gro_ctx *gro_ctx = ctx;
 	uint64_t flush_timestamp;
 	uint16_t num = 0;
+	uint16_t left_nb_out = max_nb_out;
 
 	gro_types = gro_types & gro_ctx->gro_types;
 	flush_timestamp = rte_rdtsc() - timeout_cycles;
@@ -282,16 +419,39 @@ rte_gro_timeout_flush(void *ctx,
 	if (gro_types & RTE_GRO_IPV4_VXLAN_TCP_IPV4) {
 		num = gro_vxlan_tcp4_tbl_timeout_flush(gro_ctx->tbls[
 				RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX],
-				flush_timestamp, out, max_nb_out);
-		max_nb_out -= num;
+				flush_timestamp, out, left_nb_out);
+		left_nb_out = max_nb_out - num;
 	}
 
 	/* If no available space in 'out', stop flushing. */
-	if ((gro_types & RTE_GRO_TCP_IPV4) && max_nb_out > 0) {
+	if ((gro_types & RTE_GRO_IPV4_VXLAN_UDP_IPV4) && left_nb_out > 0) {
+		num += gro_vxlan_udp4_tbl_timeout_flush(gro_ctx->tbls[
+				RTE_GRO_IPV4_VXLAN_UDP_IPV4_INDEX],
+				flush_timestamp, &out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_TCP_IPV4) && left_nb_out > 0) {
 		num += gro_tcp4_tbl_timeout_flush(
 				gro_ctx->tbls[RTE_GRO_TCP_IPV4_INDEX],
 				flush_timestamp,
-				&out[num], max_nb_out);
+				&out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_UDP_IPV4) && left_nb_out > 0) {
+		num += gro_udp4_tbl_timeout_flush(
+				gro_ctx->tbls[RTE_GRO_UDP_IPV4_INDEX],
+				flush_timestamp,
+				&out[num], left_nb_out);
+		left_nb_out = max_nb_out - num;
+	}
+
+	if ((gro_types & RTE_GRO_TCP_IPV6) && left_nb_out > 0) {
+		num += gro_tcp6_tbl_timeout_flush(
+				gro_ctx->tbls[RTE_GRO_TCP_IPV6_INDEX],
+				flush_timestamp,
+				&out[num], left_nb_out);
 	}
 
 	return num;
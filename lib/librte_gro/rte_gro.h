@@ -23,7 +23,7 @@ extern "C" {
  */
 #define RTE_GRO_TYPE_MAX_NUM 64
 /**< the max number of supported GRO types */
-#define RTE_GRO_TYPE_SUPPORT_NUM 2
+#define RTE_GRO_TYPE_SUPPORT_NUM 5
 /**< the number of currently supported GRO types */
 
 #define RTE_GRO_TCP_IPV4_INDEX 0
@@ -32,6 +32,15 @@ extern "C" {
 #define RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX 1
 #define RTE_GRO_IPV4_VXLAN_TCP_IPV4 (1ULL << RTE_GRO_IPV4_VXLAN_TCP_IPV4_INDEX)
 /**< VxLAN GRO flag. */
+#define RTE_GRO_UDP_IPV4_INDEX 2
+#define RTE_GRO_UDP_IPV4 (1ULL << RTE_GRO_UDP_IPV4_INDEX)
+/**< UDP/IPv4 fragment GRO flag */
+#define RTE_GRO_IPV4_VXLAN_UDP_IPV4_INDEX 3
+#define RTE_GRO_IPV4_VXLAN_UDP_IPV4 (1ULL << RTE_GRO_IPV4_VXLAN_UDP_IPV4_INDEX)
+/**< VxLAN UDP/IPv4 fragment GRO flag. */
+#define RTE_GRO_TCP_IPV6_INDEX 4
+#define RTE_GRO_TCP_IPV6 (1ULL << RTE_GRO_TCP_IPV6_INDEX)
+/**< TCP/IPv6 GRO flag */
 
 /**
  * Structure used to create GRO context objects or used to pass
@@ -83,9 +92,10 @@ void rte_gro_ctx_destroy(void *ctx);
  * This is one of the main reassembly APIs, which merges numbers of
  * packets at a time. It doesn't check if input packets have correct
  * checksums and doesn't re-calculate checksums for merged packets.
- * It assumes the packets are complete (i.e., MF==0 && frag_off==0),
- * when IP fragmentation is possible (i.e., DF==0). The GROed packets
- * are returned as soon as the function finishes.
+ * It assumes the TCP packets are complete (i.e., MF==0 && frag_off==0),
+ * when IP fragmentation is possible (i.e., DF==0). The fragments of
+ * UDP/IPv4 datagrams are merged with each other instead. The GROed
+ * packets are returned as soon as the function finishes.
  *
  * @param pkts
  *  Pointer array pointing to the packets to reassemble. Besides, it
@@ -111,8 +121,9 @@ uint16_t rte_gro_reassemble_burst(struct rte_mbuf **pkts,
  * existed packets in the reassembly tables of a given GRO context.
  * It doesn't check if input packets have correct checksums and doesn't
  * re-calculate checksums for merged packets. Additionally, it assumes
- * the packets are complete (i.e., MF==0 && frag_off==0), when IP
- * fragmentation is possible (i.e., DF==0).
+ * the TCP packets are complete (i.e., MF==0 && frag_off==0), when IP
+ * fragmentation is possible (i.e., DF==0). The fragments of UDP/IPv4
+ * datagrams are merged with each other instead.
  *
  * If the input packets have invalid parameters (e.g. no data payload,
  * unsupported GRO types), they are returned to applications. Otherwise,
@@ -0,0 +1,86 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <errno.h>
+
+#include "gso_common.h"
+#include "gso_udp4.h"
+
+static void
+update_ipv4_frag_headers(struct rte_mbuf *pkt, struct rte_mbuf **segs,
+		uint16_t nb_segs)
+{
+	struct ipv4_hdr *ipv4_hdr;
+	uint16_t frag_offset, tail_idx, i;
+	uint16_t l3_offset = pkt->l2_len;
+	uint16_t hdr_offset = l3_offset + pkt->l3_len;
+
+	frag_offset = 0;
+	tail_idx = nb_segs - 1;
+
+	for (i = 0; i < nb_segs; i++) {
+		ipv4_hdr = (struct ipv4_hdr *)(rte_pktmbuf_mtod(segs[i],
+					char *) + l3_offset);
+		ipv4_hdr->total_length = rte_cpu_to_be_16(segs[i]->pkt_len -
+				l3_offset);
+		ipv4_hdr->fragment_offset = rte_cpu_to_be_16(
+				(frag_offset / IPV4_HDR_OFFSET_UNITS) |
+				(i < tail_idx ? IPV4_HDR_MF_FLAG : 0));
+		frag_offset += segs[i]->pkt_len - hdr_offset;
+	}
+}
+
+int
+gso_udp4_segment(struct rte_mbuf *pkt,
+		uint16_t gso_size,
+		struct rte_mempool *direct_pool,
+		struct rte_mempool *indirect_pool,
+		struct rte_mbuf **pkts_out,
+		uint16_t nb_pkts_out)
+{
+	struct ipv4_hdr *ipv4_hdr;
+	uint16_t pyld_unit_size, hdr_offset;
+	uint16_t frag_off;
+	int ret;
+
+	/*
+	 * A L4 checksum offload would be done on each fragment, and written
+	 * into the payload of all but the first one.
+	 */
+	if (unlikely(pkt->ol_flags & PKT_TX_L4_MASK))
+		return -EINVAL;
+
+	/* Don't process the fragmented packet */
+	ipv4_hdr = (struct ipv4_hdr *)(rte_pktmbuf_mtod(pkt, char *) +
+			pkt->l2_len);
+	frag_off = rte_be_to_cpu_16(ipv4_hdr->fragment_offset);
+	if (unlikely(IS_FRAGMENTED(frag_off))) {
+		pkts_out[0] = pkt;
+		return 1;
+	}
+
+	/*
+	 * The UDP header is a part of the payload of the first fragment,
+	 * the other fragments only have the L2 and IPv4 headers.
+	 */
+	hdr_offset = pkt->l2_len + pkt->l3_len;
+	if (unlikely(hdr_offset >= pkt->pkt_len)) {
+		pkts_out[0] = pkt;
+		return 1;
+	}
+
+	/* The fragment offsets are measured in units of 8 bytes */
+	if (unlikely(hdr_offset + IPV4_HDR_OFFSET_UNITS > gso_size))
+		return -EINVAL;
+	pyld_unit_size = RTE_ALIGN_FLOOR(gso_size - hdr_offset,
+			IPV4_HDR_OFFSET_UNITS);
+
+	/* Segment the payload */
+	ret = gso_do_segment(pkt, hdr_offset, pyld_unit_size, direct_pool,
+			indirect_pool, pkts_out, nb_pkts_out);
+	if (ret > 1)
+		update_ipv4_frag_headers(pkt, pkts_out, ret);
+
+	return ret;
+}
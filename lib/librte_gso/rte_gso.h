@@ -52,7 +52,10 @@ struct rte_gso_ctx {
 	 * gso_types.
 	 *
 	 * For example, if applications want to segment TCP/IPv4
-	 * packets, set DEV_TX_OFFLOAD_TCP_TSO in gso_types.
+	 * packets, set DEV_TX_OFFLOAD_TCP_TSO in gso_types. It also
+	 * enables the segmentation of TCP/IPv6 packets, and
+	 * DEV_TX_OFFLOAD_UDP_TSO enables the fragmentation of
+	 * UDP/IPv4 packets.
 	 */
 	uint16_t gso_size;
 	/**< maximum size of an output GSO segment, including packet
@@ -74,8 +77,13 @@ struct rte_gso_ctx {
  * Before calling rte_gso_segment(), applications must set proper ol_flags
  * for the packet. The GSO library uses the same macros as that of TSO.
  * For example, set PKT_TX_TCP_SEG and PKT_TX_IPV4 in ol_flags to segment
- * a TCP/IPv4 packet. If rte_gso_segment() succeeds, the PKT_TX_TCP_SEG
- * flag is removed for all GSO segments and the input packet.
+ * a TCP/IPv4 packet, PKT_TX_TCP_SEG and PKT_TX_IPV6 to segment a TCP/IPv6
+ * packet, or PKT_TX_UDP_SEG and PKT_TX_IPV4 to split a UDP/IPv4 packet
+ * into IPv4 fragments. If rte_gso_segment() succeeds, the PKT_TX_TCP_SEG
+ * or PKT_TX_UDP_SEG flag is removed for all GSO segments and the input
+ * packet. A UDP/IPv4 packet must not request a L4 checksum offload, as
+ * the checksum covers the whole datagram: it must be computed before
+ * calling rte_gso_segment(), which otherwise returns -EINVAL.
  *
  * Each of the newly-created GSO segments is organized as a two-segment
  * MBUF, where the first segment is a standard MBUF, which stores a copy
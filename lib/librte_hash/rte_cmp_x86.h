@@ -72,3 +72,16 @@ rte_hash_k128_cmp_eq(const void *key1, const void *key2, size_t key_len)
 		rte_hash_k64_cmp_eq((const char *) key1 + 64,
 				(const char *) key2 + 64, key_len);
 }
+
+/* Vector key compare functions, built with the instruction set they use */
+int
+rte_hash_k32_cmp_eq_avx2(const void *key1, const void *key2, size_t key_len);
+
+int
+rte_hash_k48_cmp_eq_avx2(const void *key1, const void *key2, size_t key_len);
+
+int
+rte_hash_k64_cmp_eq_avx2(const void *key1, const void *key2, size_t key_len);
+
+int
+rte_hash_k64_cmp_eq_avx512(const void *key1, const void *key2, size_t key_len);
@@ -88,12 +88,21 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	struct rte_tailq_entry *te = NULL;
 	struct rte_hash_list *hash_list;
 	struct rte_ring *r = NULL;
+	struct rte_ring *r_ext = NULL;
 	char hash_name[RTE_HASH_NAMESIZE];
 	void *k = NULL;
 	void *buckets = NULL;
+	void *buckets_ext = NULL;
+	uint32_t *tbl_chng_cnt = NULL;
+	uint32_t *ext_bkt_to_free = NULL;
+	struct rte_hash_resize *resize = NULL;
 	char ring_name[RTE_RING_NAMESIZE];
+	char ext_ring_name[RTE_RING_NAMESIZE];
 	unsigned num_key_slots;
+	uint32_t num_buckets;
 	unsigned hw_trans_mem_support = 0;
+	unsigned readwrite_concur_lf_support = 0;
+	unsigned ext_table_support = 0;
 	unsigned i;
 	rte_hash_function default_hash_func = (rte_hash_function)rte_jhash;
 
@@ -118,6 +127,26 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT)
 		hw_trans_mem_support = 1;
 
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+		readwrite_concur_lf_support = 1;
+
+	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE)
+		ext_table_support = 1;
+
+	/*
+	 * The transactional cuckoo displacements don't update the table
+	 * change counter, so lock-free lookups could miss a moved key.
+	 */
+	if (readwrite_concur_lf_support && hw_trans_mem_support &&
+			(params->extra_flag &
+			 RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD)) {
+		rte_errno = EINVAL;
+		RTE_LOG(ERR, HASH, "rte_hash_create: lock-free read-write "
+			"concurrency is not supported with transactional "
+			"multi-writer add\n");
+		return NULL;
+	}
+
 	/* Store all keys and leave the first entry as a dummy entry for lookup_bulk */
 	if (hw_trans_mem_support)
 		/*
@@ -131,14 +160,37 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		num_key_slots = params->entries + 1;
 
 	snprintf(ring_name, sizeof(ring_name), "HT_%s", params->name);
-	/* Create ring (Dummy slot index is not enqueued) */
-	r = rte_ring_create(ring_name, rte_align32pow2(num_key_slots - 1),
+	/*
+	 * Create ring (Dummy slot index is not enqueued), holding all the
+	 * slots as its capacity is its size minus one
+	 */
+	r = rte_ring_create(ring_name, rte_align32pow2(num_key_slots),
 			params->socket_id, 0);
 	if (r == NULL) {
 		RTE_LOG(ERR, HASH, "memory allocation failed\n");
 		goto err;
 	}
 
+	num_buckets = rte_align32pow2(params->entries) / RTE_HASH_BUCKET_ENTRIES;
+
+	/*
+	 * As many extendable buckets as buckets, so that all the entries
+	 * can be stored even if their buckets overflow.
+	 */
+	if (ext_table_support) {
+		snprintf(ext_ring_name, sizeof(ext_ring_name), "HT_EXT_%s",
+				params->name);
+		/* Index zero is not used, as for the key slots */
+		r_ext = rte_ring_create(ext_ring_name,
+				rte_align32pow2(num_buckets + 1),
+				params->socket_id, 0);
+		if (r_ext == NULL) {
+			RTE_LOG(ERR, HASH, "ext buckets memory allocation "
+					"failed\n");
+			goto err;
+		}
+	}
+
 	snprintf(hash_name, sizeof(hash_name), "HT_%s", params->name);
 
 	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
@@ -171,9 +223,6 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
-	const uint32_t num_buckets = rte_align32pow2(params->entries)
-					/ RTE_HASH_BUCKET_ENTRIES;
-
 	buckets = rte_zmalloc_socket(NULL,
 				num_buckets * sizeof(struct rte_hash_bucket),
 				RTE_CACHE_LINE_SIZE, params->socket_id);
@@ -183,6 +232,18 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	if (ext_table_support) {
+		buckets_ext = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, params->socket_id);
+
+		if (buckets_ext == NULL) {
+			RTE_LOG(ERR, HASH, "ext buckets memory allocation "
+					"failed\n");
+			goto err_unlock;
+		}
+	}
+
 	const uint32_t key_entry_size = sizeof(struct rte_hash_key) + params->key_len;
 	const uint64_t key_tbl_size = (uint64_t) key_entry_size * num_key_slots;
 
@@ -194,6 +255,35 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		goto err_unlock;
 	}
 
+	/* Own cache line, as it is read by all lookups */
+	tbl_chng_cnt = rte_zmalloc_socket(NULL, sizeof(uint32_t),
+			RTE_CACHE_LINE_SIZE, params->socket_id);
+
+	if (tbl_chng_cnt == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		goto err_unlock;
+	}
+
+	resize = rte_zmalloc_socket(NULL, sizeof(struct rte_hash_resize),
+			0, params->socket_id);
+
+	if (resize == NULL) {
+		RTE_LOG(ERR, HASH, "memory allocation failed\n");
+		goto err_unlock;
+	}
+
+	if (ext_table_support && readwrite_concur_lf_support) {
+		ext_bkt_to_free = rte_zmalloc_socket(NULL,
+				num_key_slots * sizeof(uint32_t),
+				0, params->socket_id);
+
+		if (ext_bkt_to_free == NULL) {
+			RTE_LOG(ERR, HASH, "ext buckets memory allocation "
+					"failed\n");
+			goto err_unlock;
+		}
+	}
+
 /*
  * If x86 architecture is used, select appropriate compare function,
  * which may use x86 intrinsics, otherwise use memcmp
@@ -206,12 +296,28 @@ rte_hash_create(const struct rte_hash_parameters *params)
 		break;
 	case 32:
 		h->cmp_jump_table_idx = KEY_32_BYTES;
+#ifdef CC_AVX2_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			h->cmp_jump_table_idx = KEY_32_BYTES_AVX2;
+#endif
 		break;
 	case 48:
 		h->cmp_jump_table_idx = KEY_48_BYTES;
+#ifdef CC_AVX2_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			h->cmp_jump_table_idx = KEY_48_BYTES_AVX2;
+#endif
 		break;
 	case 64:
 		h->cmp_jump_table_idx = KEY_64_BYTES;
+#ifdef CC_AVX2_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
+			h->cmp_jump_table_idx = KEY_64_BYTES_AVX2;
+#endif
+#ifdef CC_AVX512_SUPPORT
+		if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F))
+			h->cmp_jump_table_idx = KEY_64_BYTES_AVX512;
+#endif
 		break;
 	case 80:
 		h->cmp_jump_table_idx = KEY_80_BYTES;
@@ -259,13 +365,34 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	h->hash_func = (params->hash_func == NULL) ?
 		default_hash_func : params->hash_func;
 	h->key_store = k;
+	h->key_store_slots = num_key_slots;
+	/* The key slots added by resizes are allocated by segments */
+	h->key_seg_shift = rte_bsf32(RTE_MIN(rte_align32pow2(params->entries),
+			(uint32_t)RTE_HASH_KEY_SEG_MAX_SLOTS));
 	h->free_slots = r;
 	h->hw_trans_mem_support = hw_trans_mem_support;
-
+	h->readwrite_concur_lf_support = readwrite_concur_lf_support;
+	h->tbl_chng_cnt = tbl_chng_cnt;
+	h->ext_table_support = ext_table_support;
+	h->free_ext_bkts = r_ext;
+	h->buckets_ext = buckets_ext;
+	h->ext_bkt_to_free = ext_bkt_to_free;
+	h->resize = resize;
+	h->socket_id = params->socket_id;
+
+	/* Vector functions are used if built and supported by the CPU */
 #if defined(RTE_ARCH_X86)
+#ifdef CC_AVX512_SUPPORT
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX512F))
+		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX512;
+	else
+#endif
+#ifdef CC_AVX2_SUPPORT
 	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_AVX2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_AVX2;
-	else if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
+	else
+#endif
+	if (rte_cpu_get_flag_enabled(RTE_CPUFLAG_SSE2))
 		h->sig_cmp_fn = RTE_HASH_COMPARE_SSE;
 	else
 #endif
@@ -277,6 +404,13 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	if (params->extra_flag & RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD) {
 		if (h->hw_trans_mem_support) {
 			h->add_key = ADD_KEY_MULTIWRITER_TM;
+			/* Extendable buckets are linked under the lock */
+			if (ext_table_support) {
+				h->multiwriter_lock = rte_malloc(NULL,
+							sizeof(rte_spinlock_t),
+							LCORE_CACHE_SIZE);
+				rte_spinlock_init(h->multiwriter_lock);
+			}
 		} else {
 			h->add_key = ADD_KEY_MULTIWRITER;
 			h->multiwriter_lock = rte_malloc(NULL,
@@ -291,6 +425,12 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	for (i = 1; i < params->entries + 1; i++)
 		rte_ring_sp_enqueue(r, (void *)((uintptr_t) i));
 
+	/* Populate free extendable buckets ring, from index 1 too. */
+	if (ext_table_support) {
+		for (i = 1; i <= num_buckets; i++)
+			rte_ring_sp_enqueue(r_ext, (void *)((uintptr_t) i));
+	}
+
 	te->data = (void *) h;
 	TAILQ_INSERT_TAIL(hash_list, te, next);
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
@@ -300,10 +440,15 @@ rte_hash_create(const struct rte_hash_parameters *params)
 	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
 err:
 	rte_ring_free(r);
+	rte_ring_free(r_ext);
 	rte_free(te);
 	rte_free(h);
 	rte_free(buckets);
+	rte_free(buckets_ext);
 	rte_free(k);
+	rte_free(tbl_chng_cnt);
+	rte_free(ext_bkt_to_free);
+	rte_free(resize);
 	return NULL;
 }
 
@@ -312,6 +457,7 @@ rte_hash_free(struct rte_hash *h)
 {
 	struct rte_tailq_entry *te;
 	struct rte_hash_list *hash_list;
+	unsigned i;
 
 	if (h == NULL)
 		return;
@@ -338,11 +484,22 @@ rte_hash_free(struct rte_hash *h)
 	if (h->hw_trans_mem_support)
 		rte_free(h->local_free_slots);
 
-	if (h->add_key == ADD_KEY_MULTIWRITER)
-		rte_free(h->multiwriter_lock);
+	/* Also allocated for extendable buckets with TM */
+	rte_free(h->multiwriter_lock);
 	rte_ring_free(h->free_slots);
+	rte_ring_free(h->free_ext_bkts);
 	rte_free(h->key_store);
+	for (i = 0; i < h->num_key_segs; i++)
+		rte_free(h->key_segs[i]);
+	rte_free(h->key_segs);
 	rte_free(h->buckets);
+	rte_free(h->buckets_ext);
+	rte_free(h->tbl_chng_cnt);
+	rte_free(h->ext_bkt_to_free);
+	rte_free(h->resize->old_buckets);
+	rte_free(h->resize->old_buckets_ext);
+	rte_ring_free(h->resize->old_free_slots);
+	rte_free(h->resize);
 	rte_free(h);
 	rte_free(te);
 }
@@ -366,6 +523,32 @@ rte_hash_secondary_hash(const hash_sig_t primary_hash)
 	return primary_hash ^ ((tag + 1) * alt_bits_xor);
 }
 
+/*
+ * Get the entry of a key slot. The slots added by resizes are stored in
+ * segments of the same size, after the slots of the initial key store.
+ */
+static inline struct rte_hash_key *
+get_key_entry(const struct rte_hash *h, uint32_t key_idx)
+{
+	if (likely(key_idx < h->key_store_slots))
+		return (struct rte_hash_key *)((char *)h->key_store +
+				(size_t)key_idx * h->key_entry_size);
+
+	key_idx -= h->key_store_slots;
+	return (struct rte_hash_key *)((char *)
+			h->key_segs[key_idx >> h->key_seg_shift] +
+			(size_t)(key_idx & ((1U << h->key_seg_shift) - 1)) *
+			h->key_entry_size);
+}
+
+/* A resize has buckets or free key slots left to move */
+static inline int
+resize_in_progress(const struct rte_hash *h)
+{
+	return h->resize->old_buckets != NULL ||
+		h->resize->old_free_slots != NULL;
+}
+
 void
 rte_hash_reset(struct rte_hash *h)
 {
@@ -375,8 +558,20 @@ rte_hash_reset(struct rte_hash *h)
 	if (h == NULL)
 		return;
 
+	/* Drop a resize in progress, its buckets are reset */
+	rte_free(h->resize->old_buckets);
+	rte_free(h->resize->old_buckets_ext);
+	h->resize->old_buckets = NULL;
+	h->resize->old_buckets_ext = NULL;
+	h->resize->next_bucket = h->resize->old_num_buckets;
+	rte_ring_free(h->resize->old_free_slots);
+	h->resize->old_free_slots = NULL;
+
 	memset(h->buckets, 0, h->num_buckets * sizeof(struct rte_hash_bucket));
-	memset(h->key_store, 0, h->key_entry_size * (h->entries + 1));
+	memset(h->key_store, 0, (size_t)h->key_entry_size * h->key_store_slots);
+	for (i = 0; i < h->num_key_segs; i++)
+		memset(h->key_segs[i], 0,
+			(size_t)h->key_entry_size << h->key_seg_shift);
 
 	/* clear the free ring */
 	while (rte_ring_dequeue(h->free_slots, &ptr) == 0)
@@ -386,6 +581,25 @@ rte_hash_reset(struct rte_hash *h)
 	for (i = 1; i < h->entries + 1; i++)
 		rte_ring_sp_enqueue(h->free_slots, (void *)((uintptr_t) i));
 
+	if (h->ext_table_support) {
+		memset(h->buckets_ext, 0,
+			h->num_buckets * sizeof(struct rte_hash_bucket));
+
+		/* clear and repopulate the free extendable buckets ring */
+		while (rte_ring_dequeue(h->free_ext_bkts, &ptr) == 0)
+			rte_pause();
+
+		for (i = 1; i <= h->num_buckets; i++)
+			rte_ring_sp_enqueue(h->free_ext_bkts,
+					(void *)((uintptr_t) i));
+
+		/* Same number of key slots as at creation */
+		if (h->ext_bkt_to_free != NULL)
+			memset(h->ext_bkt_to_free, 0, sizeof(uint32_t) *
+				(h->entries + 1 + (h->hw_trans_mem_support ?
+				(RTE_MAX_LCORE - 1) * LCORE_CACHE_SIZE : 0)));
+	}
+
 	if (h->hw_trans_mem_support) {
 		/* Reset local caches per lcore */
 		for (i = 0; i < RTE_MAX_LCORE; i++)
@@ -393,6 +607,23 @@ rte_hash_reset(struct rte_hash *h)
 	}
 }
 
+/*
+ * Signal lock-free readers that a key was copied to its alternative
+ * location, before it is removed from its current one: a reader that
+ * misses the key in both locations sees the counter change and retries.
+ */
+static inline void
+hash_table_changed(const struct rte_hash *h)
+{
+	if (!h->readwrite_concur_lf_support)
+		return;
+
+	__atomic_store_n(h->tbl_chng_cnt, *h->tbl_chng_cnt + 1,
+			__ATOMIC_RELEASE);
+	/* The stores overwriting the old location must come after */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
 /* Search for an entry that can be pushed to its alternative location */
 static inline int
 make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt,
@@ -424,7 +655,9 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt,
 	if (i != RTE_HASH_BUCKET_ENTRIES) {
 		next_bkt[i]->sig_alt[j] = bkt->sig_current[i];
 		next_bkt[i]->sig_current[j] = bkt->sig_alt[i];
-		next_bkt[i]->key_idx[j] = bkt->key_idx[i];
+		__atomic_store_n(&next_bkt[i]->key_idx[j], bkt->key_idx[i],
+				__ATOMIC_RELEASE);
+		hash_table_changed(h);
 		return i;
 	}
 
@@ -452,7 +685,9 @@ make_space_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt,
 	if (ret >= 0) {
 		next_bkt[i]->sig_alt[ret] = bkt->sig_current[i];
 		next_bkt[i]->sig_current[ret] = bkt->sig_alt[i];
-		next_bkt[i]->key_idx[ret] = bkt->key_idx[i];
+		__atomic_store_n(&next_bkt[i]->key_idx[ret], bkt->key_idx[i],
+				__ATOMIC_RELEASE);
+		hash_table_changed(h);
 		return i;
 	} else
 		return ret;
@@ -476,26 +711,290 @@ enqueue_slot_back(const struct rte_hash *h,
 		rte_ring_sp_enqueue(h->free_slots, slot_id);
 }
 
+/*
+ * Search a key in a bucket and update its data if found.
+ * Return the index where the key is stored, or -1 if not found.
+ */
+static inline int32_t
+search_and_update(const struct rte_hash *h, void *data, const void *key,
+		struct rte_hash_bucket *bkt, hash_sig_t sig, hash_sig_t alt_hash)
+{
+	unsigned i;
+	struct rte_hash_key *k;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		if (bkt->sig_current[i] == sig &&
+				bkt->sig_alt[i] == alt_hash &&
+				bkt->key_idx[i] != EMPTY_SLOT) {
+			k = get_key_entry(h, bkt->key_idx[i]);
+			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+				/* Update data */
+				__atomic_store_n(&k->pdata, data,
+						__ATOMIC_RELEASE);
+				/*
+				 * Return index where key is stored,
+				 * subtracting the first dummy index
+				 */
+				return bkt->key_idx[i] - 1;
+			}
+		}
+	}
+	return -1;
+}
+
+/*
+ * Insert an entry in the chain of extendable buckets of its primary
+ * bucket, linking a free extendable bucket at the end of the chain
+ * if all the chained buckets are full.
+ */
+static inline int
+add_key_ext_bkt(const struct rte_hash *h, struct rte_hash_bucket *prim_bkt,
+		hash_sig_t sig, hash_sig_t alt_hash, uint32_t new_idx)
+{
+	struct rte_hash_bucket *bkt, *last_bkt = prim_bkt;
+	void *ext_bkt_id = NULL;
+	unsigned i;
+
+	for (bkt = prim_bkt->next; bkt != NULL; bkt = bkt->next) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (bkt->key_idx[i] == EMPTY_SLOT) {
+				bkt->sig_current[i] = sig;
+				bkt->sig_alt[i] = alt_hash;
+				__atomic_store_n(&bkt->key_idx[i], new_idx,
+						__ATOMIC_RELEASE);
+				return 0;
+			}
+		}
+		last_bkt = bkt;
+	}
+
+	if (rte_ring_sc_dequeue(h->free_ext_bkts, &ext_bkt_id) != 0)
+		return -ENOSPC;
+
+	bkt = &h->buckets_ext[(uintptr_t)ext_bkt_id - 1];
+	bkt->next = NULL;
+	bkt->sig_current[0] = sig;
+	bkt->sig_alt[0] = alt_hash;
+	bkt->key_idx[0] = new_idx;
+	/* Link the bucket once filled, for lock-free readers */
+	__atomic_store_n(&last_bkt->next, bkt, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+/*
+ * Search a key in its buckets of a buckets table and in their chain,
+ * and update its data if found.
+ * Return the index where the key is stored, or -1 if not found.
+ */
+static inline int32_t
+search_and_update_table(const struct rte_hash *h, void *data,
+		const void *key, struct rte_hash_bucket *buckets,
+		uint32_t bucket_bitmask, hash_sig_t sig, hash_sig_t alt_hash)
+{
+	struct rte_hash_bucket *prim_bkt, *cur_bkt;
+	int32_t ret;
+
+	/* Check if key is already inserted in primary location */
+	prim_bkt = &buckets[sig & bucket_bitmask];
+	ret = search_and_update(h, data, key, prim_bkt, sig, alt_hash);
+	if (ret != -1)
+		return ret;
+
+	/* Check if key is already inserted in secondary location */
+	ret = search_and_update(h, data, key,
+			&buckets[alt_hash & bucket_bitmask], alt_hash, sig);
+	if (ret != -1)
+		return ret;
+
+	/* Check if key is already inserted in the extendable buckets */
+	for (cur_bkt = prim_bkt->next; cur_bkt != NULL;
+			cur_bkt = cur_bkt->next) {
+		ret = search_and_update(h, data, key, cur_bkt, sig, alt_hash);
+		if (ret != -1)
+			return ret;
+	}
+
+	return -1;
+}
+
+/*
+ * Insert an entry in its primary bucket, pushing entries to their
+ * alternative location if needed, or in the extendable buckets.
+ */
+static inline int
+insert_entry(const struct rte_hash *h, struct rte_hash_bucket *prim_bkt,
+		hash_sig_t sig, hash_sig_t alt_hash, uint32_t new_idx)
+{
+	unsigned i;
+	unsigned int nr_pushes = 0;
+	int ret;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+		/* Check if slot is available */
+		if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
+			prim_bkt->sig_current[i] = sig;
+			prim_bkt->sig_alt[i] = alt_hash;
+			__atomic_store_n(&prim_bkt->key_idx[i], new_idx,
+					__ATOMIC_RELEASE);
+			return 0;
+		}
+	}
+
+	/* Primary bucket full, need to make space for new entry
+	 * After recursive function.
+	 * Insert the new entry in the position of the pushed entry
+	 * if successful or return error
+	 */
+	ret = make_space_bucket(h, prim_bkt, &nr_pushes);
+	if (ret >= 0) {
+		prim_bkt->sig_current[ret] = sig;
+		prim_bkt->sig_alt[ret] = alt_hash;
+		__atomic_store_n(&prim_bkt->key_idx[ret], new_idx,
+				__ATOMIC_RELEASE);
+		return 0;
+	}
+
+	/* No room even after displacements, chain the entry */
+	if (h->ext_table_support)
+		return add_key_ext_bkt(h, prim_bkt, sig, alt_hash, new_idx);
+
+	return ret;
+}
+
+/*
+ * Move the entries of a bucket being migrated by a resize, and of its
+ * chain, to the current buckets table.
+ */
+static int
+migrate_bucket(const struct rte_hash *h, struct rte_hash_bucket *bkt)
+{
+	hash_sig_t sig, alt_hash;
+	unsigned i;
+	int ret;
+
+	for (; bkt != NULL; bkt = bkt->next) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (bkt->key_idx[i] == EMPTY_SLOT)
+				continue;
+
+			/*
+			 * The chains hang from the primary bucket: insert
+			 * from the primary signature, the one from which
+			 * the other is computed.
+			 */
+			sig = bkt->sig_current[i];
+			alt_hash = bkt->sig_alt[i];
+			if (rte_hash_secondary_hash(sig) != alt_hash) {
+				alt_hash = sig;
+				sig = bkt->sig_alt[i];
+			}
+
+			ret = insert_entry(h,
+					&h->buckets[sig & h->bucket_bitmask],
+					sig, alt_hash, bkt->key_idx[i]);
+			if (ret < 0)
+				return ret;
+
+			bkt->sig_current[i] = NULL_SIGNATURE;
+			bkt->sig_alt[i] = NULL_SIGNATURE;
+			bkt->key_idx[i] = EMPTY_SLOT;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Move up to nb_buckets buckets worth of free key slots of a resize in
+ * progress to the larger ring, and free the old ring once empty.
+ */
+static void
+resize_move_free_slots(const struct rte_hash *h, uint32_t nb_buckets)
+{
+	struct rte_hash_resize *rs = h->resize;
+	void *slots[RTE_HASH_BUCKET_ENTRIES];
+	unsigned n;
+
+	while (nb_buckets-- > 0) {
+		n = rte_ring_dequeue_burst(rs->old_free_slots, slots,
+				RTE_HASH_BUCKET_ENTRIES, NULL);
+		rte_ring_enqueue_bulk(h->free_slots, slots, n, NULL);
+		if (n < RTE_HASH_BUCKET_ENTRIES)
+			break;
+	}
+
+	if (rte_ring_empty(rs->old_free_slots)) {
+		rte_ring_free(rs->old_free_slots);
+		rs->old_free_slots = NULL;
+	}
+}
+
+/*
+ * Migrate up to nb_buckets buckets of a resize in progress, and as many
+ * buckets worth of free key slots, and free the old tables once all are
+ * migrated.
+ * Return the number of buckets left to migrate, counting the free key
+ * slots left by buckets.
+ */
+static int
+resize_step(const struct rte_hash *h, uint32_t nb_buckets)
+{
+	struct rte_hash_resize *rs = h->resize;
+	int ret, left = 0;
+
+	if (rs->old_free_slots != NULL)
+		resize_move_free_slots(h, nb_buckets);
+
+	while (rs->old_buckets != NULL && nb_buckets-- > 0 &&
+			rs->next_bucket < rs->old_num_buckets) {
+		ret = migrate_bucket(h, &rs->old_buckets[rs->next_bucket]);
+		if (ret < 0)
+			return ret;
+		rs->next_bucket++;
+	}
+
+	if (rs->next_bucket < rs->old_num_buckets)
+		left = rs->old_num_buckets - rs->next_bucket;
+	else {
+		rte_free(rs->old_buckets);
+		rte_free(rs->old_buckets_ext);
+		rs->old_buckets = NULL;
+		rs->old_buckets_ext = NULL;
+	}
+
+	if (rs->old_free_slots != NULL)
+		left += (rte_ring_count(rs->old_free_slots) +
+			RTE_HASH_BUCKET_ENTRIES - 1) / RTE_HASH_BUCKET_ENTRIES;
+
+	return left;
+}
+
 static inline int32_t
 __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 						hash_sig_t sig, void *data)
 {
 	hash_sig_t alt_hash;
 	uint32_t prim_bucket_idx, sec_bucket_idx;
-	unsigned i;
 	struct rte_hash_bucket *prim_bkt, *sec_bkt;
-	struct rte_hash_key *new_k, *k, *keys = h->key_store;
+	struct rte_hash_key *new_k;
 	void *slot_id = NULL;
 	uint32_t new_idx;
 	int ret;
 	unsigned n_slots;
 	unsigned lcore_id;
 	struct lcore_cache *cached_free_slots = NULL;
-	unsigned int nr_pushes = 0;
 
 	if (h->add_key == ADD_KEY_MULTIWRITER)
 		rte_spinlock_lock(h->multiwriter_lock);
 
+	/* Resize in progress, migrate a few more buckets */
+	if (unlikely(resize_in_progress(h))) {
+		ret = resize_step(h, RTE_HASH_RESIZE_STEP_BUCKETS);
+		if (ret < 0)
+			goto failure;
+	}
+
 	prim_bucket_idx = sig & h->bucket_bitmask;
 	prim_bkt = &h->buckets[prim_bucket_idx];
 	rte_prefetch0(prim_bkt);
@@ -533,53 +1032,26 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 		}
 	}
 
-	new_k = RTE_PTR_ADD(keys, (uintptr_t)slot_id * h->key_entry_size);
+	new_k = get_key_entry(h, (uintptr_t)slot_id);
 	rte_prefetch0(new_k);
 	new_idx = (uint32_t)((uintptr_t) slot_id);
 
-	/* Check if key is already inserted in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (prim_bkt->sig_current[i] == sig &&
-				prim_bkt->sig_alt[i] == alt_hash) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					prim_bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				/* Enqueue index of free slot back in the ring. */
-				enqueue_slot_back(h, cached_free_slots, slot_id);
-				/* Update data */
-				k->pdata = data;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				ret = prim_bkt->key_idx[i] - 1;
-				goto failure;
-			}
-		}
+	/* Check if key is already inserted */
+	ret = search_and_update_table(h, data, key, h->buckets,
+			h->bucket_bitmask, sig, alt_hash);
+	if (ret != -1)
+		goto key_found;
+
+	/* Or in the buckets not migrated yet by a resize */
+	if (unlikely(h->resize->old_buckets != NULL)) {
+		ret = search_and_update_table(h, data, key,
+				h->resize->old_buckets,
+				h->resize->old_bucket_bitmask, sig, alt_hash);
+		if (ret != -1)
+			goto key_found;
 	}
 
-	/* Check if key is already inserted in secondary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (sec_bkt->sig_alt[i] == sig &&
-				sec_bkt->sig_current[i] == alt_hash) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					sec_bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				/* Enqueue index of free slot back in the ring. */
-				enqueue_slot_back(h, cached_free_slots, slot_id);
-				/* Update data */
-				k->pdata = data;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				ret = sec_bkt->key_idx[i] - 1;
-				goto failure;
-			}
-		}
-	}
-
-	/* Copy key */
+	/* Copy key, made visible to readers by the release of key_idx */
 	rte_memcpy(new_k->key, key, h->key_len);
 	new_k->pdata = data;
 
@@ -603,35 +1075,23 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 
 		if (ret >= 0)
 			return new_idx - 1;
-	} else {
-#endif
-		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-			/* Check if slot is available */
-			if (likely(prim_bkt->key_idx[i] == EMPTY_SLOT)) {
-				prim_bkt->sig_current[i] = sig;
-				prim_bkt->sig_alt[i] = alt_hash;
-				prim_bkt->key_idx[i] = new_idx;
-				break;
-			}
-		}
 
-		if (i != RTE_HASH_BUCKET_ENTRIES) {
-			if (h->add_key == ADD_KEY_MULTIWRITER)
-				rte_spinlock_unlock(h->multiwriter_lock);
-			return new_idx - 1;
+		if (h->ext_table_support) {
+			rte_spinlock_lock(h->multiwriter_lock);
+			ret = add_key_ext_bkt(h, prim_bkt, sig, alt_hash,
+					new_idx);
+			rte_spinlock_unlock(h->multiwriter_lock);
+			if (ret == 0)
+				return new_idx - 1;
 		}
-
-		/* Primary bucket full, need to make space for new entry
-		 * After recursive function.
-		 * Insert the new entry in the position of the pushed entry
-		 * if successful or return error and
+	} else {
+#endif
+		/*
+		 * Insert the new entry, or return error and
 		 * store the new slot back in the ring
 		 */
-		ret = make_space_bucket(h, prim_bkt, &nr_pushes);
-		if (ret >= 0) {
-			prim_bkt->sig_current[ret] = sig;
-			prim_bkt->sig_alt[ret] = alt_hash;
-			prim_bkt->key_idx[ret] = new_idx;
+		ret = insert_entry(h, prim_bkt, sig, alt_hash, new_idx);
+		if (ret == 0) {
 			if (h->add_key == ADD_KEY_MULTIWRITER)
 				rte_spinlock_unlock(h->multiwriter_lock);
 			return new_idx - 1;
@@ -641,6 +1101,11 @@ __rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key,
 #endif
 	/* Error in addition, store new slot back in the ring and return error */
 	enqueue_slot_back(h, cached_free_slots, (void *)((uintptr_t) new_idx));
+	goto failure;
+
+key_found:
+	/* Enqueue index of free slot back in the ring. */
+	enqueue_slot_back(h, cached_free_slots, slot_id);
 
 failure:
 	if (h->add_key == ADD_KEY_MULTIWRITER)
@@ -690,56 +1155,201 @@ rte_hash_add_key_data(const struct rte_hash *h, const void *key, void *data)
 	else
 		return ret;
 }
-static inline int32_t
-__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
-					hash_sig_t sig, void **data)
+int __rte_experimental
+rte_hash_resize_step(struct rte_hash *h, uint32_t nb_buckets)
 {
-	uint32_t bucket_idx;
-	hash_sig_t alt_hash;
+	RETURN_IF_TRUE(((h == NULL) || (nb_buckets == 0)), -EINVAL);
+
+	if (!resize_in_progress(h))
+		return 0;
+
+	return resize_step(h, nb_buckets);
+}
+
+int __rte_experimental
+rte_hash_resize(struct rte_hash *h, uint32_t entries)
+{
+	struct rte_hash_resize *rs;
+	struct rte_ring *r = NULL;
+	struct rte_ring *r_ext = NULL;
+	char ring_name[RTE_RING_NAMESIZE];
+	void **key_segs = NULL;
+	void *buckets = NULL;
+	void *buckets_ext = NULL;
+	unsigned num_key_slots, num_key_segs;
+	uint32_t num_buckets;
 	unsigned i;
-	struct rte_hash_bucket *bkt;
-	struct rte_hash_key *k, *keys = h->key_store;
 
-	bucket_idx = sig & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	RETURN_IF_TRUE((h == NULL), -EINVAL);
 
-	/* Check if key is in primary location */
-	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->sig_current[i] == sig &&
-				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
-			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
-				if (data != NULL)
-					*data = k->pdata;
-				/*
-				 * Return index where key is stored,
-				 * subtracting the first dummy index
-				 */
-				return bkt->key_idx[i] - 1;
+	if (entries <= h->entries || entries > RTE_HASH_ENTRIES_MAX)
+		return -EINVAL;
+
+	/* Readers and writers never see the tables being swapped */
+	if (h->readwrite_concur_lf_support ||
+			h->add_key == ADD_KEY_MULTIWRITER_TM)
+		return -ENOTSUP;
+
+	/* Complete a previous resize first */
+	if (rte_hash_resize_step(h, UINT32_MAX) != 0)
+		return -ENOSPC;
+
+	rs = h->resize;
+	rs->generation++;
+
+	/* Same number of extra key slots for the lcore caches as at creation */
+	num_key_slots = entries + 1;
+	if (h->hw_trans_mem_support)
+		num_key_slots += (RTE_MAX_LCORE - 1) * LCORE_CACHE_SIZE;
+
+	/*
+	 * The keys keep their slot: the new slots are stored in segments
+	 * appended after the ones of the previous resizes.
+	 */
+	num_key_segs = (num_key_slots - h->key_store_slots +
+			(1U << h->key_seg_shift) - 1) >> h->key_seg_shift;
+	if (num_key_segs > h->num_key_segs) {
+		key_segs = rte_zmalloc_socket(NULL,
+				sizeof(void *) * num_key_segs, 0,
+				h->socket_id);
+		if (key_segs == NULL) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			goto err;
+		}
+		for (i = 0; i < h->num_key_segs; i++)
+			key_segs[i] = h->key_segs[i];
+		for (; i < num_key_segs; i++) {
+			key_segs[i] = rte_zmalloc_socket(NULL,
+				(uint64_t)h->key_entry_size <<
+					h->key_seg_shift,
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+			if (key_segs[i] == NULL)
+				break;
+		}
+		if (i != num_key_segs) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			goto err;
+		}
+	}
+
+	/* A larger ring is needed to hold all the free key slots */
+	if (rte_ring_get_capacity(h->free_slots) < entries) {
+		snprintf(ring_name, sizeof(ring_name), "HT%u_%s",
+				rs->generation, h->name);
+		r = rte_ring_create(ring_name, rte_align32pow2(num_key_slots),
+				h->socket_id, 0);
+		if (r == NULL) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			goto err;
+		}
+	}
+
+	num_buckets = rte_align32pow2(entries) / RTE_HASH_BUCKET_ENTRIES;
+	if (num_buckets != h->num_buckets) {
+		buckets = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+		if (buckets == NULL) {
+			RTE_LOG(ERR, HASH, "memory allocation failed\n");
+			goto err;
+		}
+
+		if (h->ext_table_support) {
+			snprintf(ring_name, sizeof(ring_name), "HT_EXT%u_%s",
+					rs->generation, h->name);
+			r_ext = rte_ring_create(ring_name,
+					rte_align32pow2(num_buckets + 1),
+					h->socket_id, 0);
+			buckets_ext = rte_zmalloc_socket(NULL,
+				num_buckets * sizeof(struct rte_hash_bucket),
+				RTE_CACHE_LINE_SIZE, h->socket_id);
+			if (r_ext == NULL || buckets_ext == NULL) {
+				RTE_LOG(ERR, HASH, "ext buckets memory "
+						"allocation failed\n");
+				goto err;
 			}
 		}
 	}
 
-	/* Calculate secondary hash */
-	alt_hash = rte_hash_secondary_hash(sig);
-	bucket_idx = alt_hash & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	if (key_segs != NULL) {
+		rte_free(h->key_segs);
+		h->key_segs = key_segs;
+		h->num_key_segs = num_key_segs;
+	}
+
+	/*
+	 * The free key slots are moved to the larger ring by the next
+	 * steps, after the new slots it starts with.
+	 */
+	if (r != NULL) {
+		rs->old_free_slots = h->free_slots;
+		h->free_slots = r;
+	}
+	for (i = h->entries + 1; i < entries + 1; i++)
+		rte_ring_sp_enqueue(h->free_slots, (void *)((uintptr_t) i));
+	h->entries = entries;
+
+	if (buckets == NULL)
+		return 0;
+
+	/* The buckets are migrated by the next additions */
+	for (i = 1; i <= num_buckets && r_ext != NULL; i++)
+		rte_ring_sp_enqueue(r_ext, (void *)((uintptr_t) i));
+
+	rs->old_buckets = h->buckets;
+	rs->old_buckets_ext = h->buckets_ext;
+	rs->old_num_buckets = h->num_buckets;
+	rs->old_bucket_bitmask = h->bucket_bitmask;
+	rs->next_bucket = 0;
+
+	rte_ring_free(h->free_ext_bkts);
+	h->free_ext_bkts = r_ext;
+	h->buckets_ext = buckets_ext;
+	h->buckets = buckets;
+	h->num_buckets = num_buckets;
+	h->bucket_bitmask = num_buckets - 1;
+
+	return 0;
+err:
+	if (key_segs != NULL) {
+		for (i = h->num_key_segs; i < num_key_segs; i++)
+			rte_free(key_segs[i]);
+		rte_free(key_segs);
+	}
+	rte_ring_free(r);
+	rte_ring_free(r_ext);
+	rte_free(buckets);
+	rte_free(buckets_ext);
+	return -ENOMEM;
+}
+
+/* Search a key in one of its two buckets */
+static inline int32_t
+search_one_bucket(const struct rte_hash *h, const void *key,
+		hash_sig_t sig, hash_sig_t alt_hash,
+		const struct rte_hash_bucket *bkt, void **data)
+{
+	unsigned i;
+	uint32_t key_idx;
+	struct rte_hash_key *k;
 
-	/* Check if key is in secondary location */
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
-		if (bkt->sig_current[i] == alt_hash &&
-				bkt->sig_alt[i] == sig) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+		if (bkt->sig_current[i] == sig &&
+				bkt->sig_alt[i] == alt_hash) {
+			key_idx = __atomic_load_n(&bkt->key_idx[i],
+					__ATOMIC_ACQUIRE);
+			if (key_idx == EMPTY_SLOT)
+				continue;
+			k = get_key_entry(h, key_idx);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				if (data != NULL)
-					*data = k->pdata;
+					*data = __atomic_load_n(&k->pdata,
+							__ATOMIC_ACQUIRE);
 				/*
 				 * Return index where key is stored,
 				 * subtracting the first dummy index
 				 */
-				return bkt->key_idx[i] - 1;
+				return key_idx - 1;
 			}
 		}
 	}
@@ -747,6 +1357,79 @@ __rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
 	return -ENOENT;
 }
 
+/* Search a key in its buckets of a buckets table and in their chain */
+static inline int32_t
+search_table(const struct rte_hash *h, const void *key,
+		hash_sig_t sig, hash_sig_t alt_hash,
+		const struct rte_hash_bucket *buckets, uint32_t bucket_bitmask,
+		void **data)
+{
+	const struct rte_hash_bucket *prim_bkt, *cur_bkt;
+	int32_t ret;
+
+	prim_bkt = &buckets[sig & bucket_bitmask];
+
+	/* Check if key is in primary location */
+	ret = search_one_bucket(h, key, sig, alt_hash, prim_bkt, data);
+	if (ret != -ENOENT)
+		return ret;
+
+	/* Check if key is in secondary location */
+	ret = search_one_bucket(h, key, alt_hash, sig,
+			&buckets[alt_hash & bucket_bitmask], data);
+	if (ret != -ENOENT)
+		return ret;
+
+	/* Check if key is in the extendable buckets, if any */
+	for (cur_bkt = __atomic_load_n(&prim_bkt->next, __ATOMIC_ACQUIRE);
+			cur_bkt != NULL;
+			cur_bkt = __atomic_load_n(&cur_bkt->next,
+				__ATOMIC_ACQUIRE)) {
+		ret = search_one_bucket(h, key, sig, alt_hash, cur_bkt, data);
+		if (ret != -ENOENT)
+			return ret;
+	}
+
+	return -ENOENT;
+}
+
+static inline int32_t
+__rte_hash_lookup_with_hash(const struct rte_hash *h, const void *key,
+					hash_sig_t sig, void **data)
+{
+	hash_sig_t alt_hash;
+	uint32_t cnt_b, cnt_a;
+	int32_t ret;
+
+	alt_hash = rte_hash_secondary_hash(sig);
+
+	do {
+		/*
+		 * A key moved by a concurrent writer is copied to its new
+		 * location before being removed from the old one, and the
+		 * change counter is incremented between: if the key is
+		 * missed, retry when the counter changed.
+		 */
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+
+		ret = search_table(h, key, sig, alt_hash, h->buckets,
+				h->bucket_bitmask, data);
+		if (ret != -ENOENT)
+			return ret;
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	/* Check if key is in the buckets not migrated yet by a resize */
+	if (unlikely(h->resize->old_buckets != NULL))
+		return search_table(h, key, sig, alt_hash,
+				h->resize->old_buckets,
+				h->resize->old_bucket_bitmask, data);
+
+	return -ENOENT;
+}
+
 int32_t
 rte_hash_lookup_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
@@ -777,14 +1460,13 @@ rte_hash_lookup_data(const struct rte_hash *h, const void *key, void **data)
 	return __rte_hash_lookup_with_hash(h, key, rte_hash_hash(h, key), data);
 }
 
+/* Put the index of a key slot back in the cache/ring of free slots */
 static inline void
-remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
+free_slot(const struct rte_hash *h, uint32_t key_idx)
 {
 	unsigned lcore_id, n_slots;
 	struct lcore_cache *cached_free_slots;
 
-	bkt->sig_current[i] = NULL_SIGNATURE;
-	bkt->sig_alt[i] = NULL_SIGNATURE;
 	if (h->hw_trans_mem_support) {
 		lcore_id = rte_lcore_id();
 		cached_free_slots = &h->local_free_slots[lcore_id];
@@ -798,34 +1480,85 @@ remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
 		}
 		/* Put index of new free slot in cache. */
 		cached_free_slots->objs[cached_free_slots->len] =
-				(void *)((uintptr_t)bkt->key_idx[i]);
+				(void *)((uintptr_t)key_idx);
 		cached_free_slots->len++;
 	} else {
 		rte_ring_sp_enqueue(h->free_slots,
-				(void *)((uintptr_t)bkt->key_idx[i]));
+				(void *)((uintptr_t)key_idx));
 	}
 }
 
+static inline void
+remove_entry(const struct rte_hash *h, struct rte_hash_bucket *bkt, unsigned i)
+{
+	bkt->sig_current[i] = NULL_SIGNATURE;
+	bkt->sig_alt[i] = NULL_SIGNATURE;
+
+	/*
+	 * With lock-free readers, the key slot may still be read: it is
+	 * freed by the application with rte_hash_free_key_with_position().
+	 */
+	if (!h->readwrite_concur_lf_support)
+		free_slot(h, bkt->key_idx[i]);
+}
+
+/*
+ * Unlink an extendable bucket emptied by a delete from its chain, and
+ * free it. With lock-free readers, the bucket may still be read: it is
+ * freed with the key slot of the last deleted entry, by
+ * rte_hash_free_key_with_position().
+ */
+static inline void
+unlink_ext_bkt(const struct rte_hash *h, struct rte_hash_bucket *prev_bkt,
+		struct rte_hash_bucket *bkt, uint32_t key_idx)
+{
+	unsigned i;
+	uint32_t ext_bkt_id;
+
+	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++)
+		if (bkt->key_idx[i] != EMPTY_SLOT)
+			return;
+
+	/* The next pointer of bkt is kept for the readers still in it */
+	__atomic_store_n(&prev_bkt->next, bkt->next, __ATOMIC_RELEASE);
+
+	/*
+	 * Buckets of the old extendable table of a resize in progress
+	 * are freed with that table.
+	 */
+	if (bkt < h->buckets_ext ||
+			bkt >= h->buckets_ext + h->num_buckets)
+		return;
+
+	ext_bkt_id = bkt - h->buckets_ext + 1;
+	if (h->readwrite_concur_lf_support)
+		h->ext_bkt_to_free[key_idx] = ext_bkt_id;
+	else
+		rte_ring_sp_enqueue(h->free_ext_bkts,
+				(void *)((uintptr_t)ext_bkt_id));
+}
+
+/* Delete a key from its buckets of a buckets table or from their chain */
 static inline int32_t
-__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
-						hash_sig_t sig)
+delete_from_table(const struct rte_hash *h, const void *key,
+		hash_sig_t sig, struct rte_hash_bucket *buckets,
+		uint32_t bucket_bitmask)
 {
-	uint32_t bucket_idx;
+	uint32_t bucket_idx, key_idx;
 	hash_sig_t alt_hash;
 	unsigned i;
-	struct rte_hash_bucket *bkt;
-	struct rte_hash_key *k, *keys = h->key_store;
+	struct rte_hash_bucket *bkt, *prim_bkt, *prev_bkt;
+	struct rte_hash_key *k;
 	int32_t ret;
 
-	bucket_idx = sig & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	bucket_idx = sig & bucket_bitmask;
+	prim_bkt = bkt = &buckets[bucket_idx];
 
 	/* Check if key is in primary location */
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == sig &&
 				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = get_key_entry(h, bkt->key_idx[i]);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				remove_entry(h, bkt, i);
 
@@ -834,7 +1567,8 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 				 * subtracting the first dummy index
 				 */
 				ret = bkt->key_idx[i] - 1;
-				bkt->key_idx[i] = EMPTY_SLOT;
+				__atomic_store_n(&bkt->key_idx[i], EMPTY_SLOT,
+						__ATOMIC_RELEASE);
 				return ret;
 			}
 		}
@@ -842,15 +1576,14 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 
 	/* Calculate secondary hash */
 	alt_hash = rte_hash_secondary_hash(sig);
-	bucket_idx = alt_hash & h->bucket_bitmask;
-	bkt = &h->buckets[bucket_idx];
+	bucket_idx = alt_hash & bucket_bitmask;
+	bkt = &buckets[bucket_idx];
 
 	/* Check if key is in secondary location */
 	for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
 		if (bkt->sig_current[i] == alt_hash &&
 				bkt->key_idx[i] != EMPTY_SLOT) {
-			k = (struct rte_hash_key *) ((char *)keys +
-					bkt->key_idx[i] * h->key_entry_size);
+			k = get_key_entry(h, bkt->key_idx[i]);
 			if (rte_hash_cmp_eq(key, k->key, h) == 0) {
 				remove_entry(h, bkt, i);
 
@@ -859,15 +1592,53 @@ __rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
 				 * subtracting the first dummy index
 				 */
 				ret = bkt->key_idx[i] - 1;
-				bkt->key_idx[i] = EMPTY_SLOT;
+				__atomic_store_n(&bkt->key_idx[i], EMPTY_SLOT,
+						__ATOMIC_RELEASE);
 				return ret;
 			}
 		}
 	}
 
+	/* Check if key is in the extendable buckets */
+	prev_bkt = prim_bkt;
+	for (bkt = prim_bkt->next; bkt != NULL; bkt = bkt->next) {
+		for (i = 0; i < RTE_HASH_BUCKET_ENTRIES; i++) {
+			if (bkt->sig_current[i] == sig &&
+					bkt->key_idx[i] != EMPTY_SLOT) {
+				key_idx = bkt->key_idx[i];
+				k = get_key_entry(h, key_idx);
+				if (rte_hash_cmp_eq(key, k->key, h) == 0) {
+					remove_entry(h, bkt, i);
+					__atomic_store_n(&bkt->key_idx[i],
+						EMPTY_SLOT, __ATOMIC_RELEASE);
+					unlink_ext_bkt(h, prev_bkt, bkt,
+						key_idx);
+					return key_idx - 1;
+				}
+			}
+		}
+		prev_bkt = bkt;
+	}
+
 	return -ENOENT;
 }
 
+static inline int32_t
+__rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key,
+						hash_sig_t sig)
+{
+	int32_t ret;
+
+	ret = delete_from_table(h, key, sig, h->buckets, h->bucket_bitmask);
+
+	/* Check the buckets not migrated yet by a resize */
+	if (ret == -ENOENT && unlikely(h->resize->old_buckets != NULL))
+		ret = delete_from_table(h, key, sig, h->resize->old_buckets,
+				h->resize->old_bucket_bitmask);
+
+	return ret;
+}
+
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h,
 			const void *key, hash_sig_t sig)
@@ -883,15 +1654,37 @@ rte_hash_del_key(const struct rte_hash *h, const void *key)
 	return __rte_hash_del_key_with_hash(h, key, rte_hash_hash(h, key));
 }
 
+int __rte_experimental
+rte_hash_free_key_with_position(const struct rte_hash *h,
+				const int32_t position)
+{
+	RETURN_IF_TRUE(((h == NULL) || (position < 0)), -EINVAL);
+
+	/* Out of bounds, or key slots freed on delete */
+	if ((uint32_t)position >= h->entries ||
+			!h->readwrite_concur_lf_support)
+		return -EINVAL;
+
+	/* Free the extendable bucket emptied when the key was deleted */
+	if (h->ext_table_support && h->ext_bkt_to_free[position + 1] != 0) {
+		rte_ring_sp_enqueue(h->free_ext_bkts, (void *)((uintptr_t)
+				h->ext_bkt_to_free[position + 1]));
+		h->ext_bkt_to_free[position + 1] = 0;
+	}
+
+	free_slot(h, position + 1);
+
+	return 0;
+}
+
 int
 rte_hash_get_key_with_position(const struct rte_hash *h, const int32_t position,
 			       void **key)
 {
 	RETURN_IF_TRUE(((h == NULL) || (key == NULL)), -EINVAL);
 
-	struct rte_hash_key *k, *keys = h->key_store;
-	k = (struct rte_hash_key *) ((char *) keys + (position + 1) *
-				     h->key_entry_size);
+	struct rte_hash_key *k;
+	k = get_key_entry(h, position + 1);
 	*key = k->key;
 
 	if (position !=
@@ -913,18 +1706,6 @@ compare_signatures(uint32_t *prim_hash_matches, uint32_t *sec_hash_matches,
 	unsigned int i;
 
 	switch (sig_cmp_fn) {
-#ifdef RTE_MACHINE_CPUFLAG_AVX2
-	case RTE_HASH_COMPARE_AVX2:
-		*prim_hash_matches = _mm256_movemask_ps((__m256)_mm256_cmpeq_epi32(
-				_mm256_load_si256(
-					(__m256i const *)prim_bkt->sig_current),
-				_mm256_set1_epi32(prim_hash)));
-		*sec_hash_matches = _mm256_movemask_ps((__m256)_mm256_cmpeq_epi32(
-				_mm256_load_si256(
-					(__m256i const *)sec_bkt->sig_current),
-				_mm256_set1_epi32(sec_hash)));
-		break;
-#endif
 #ifdef RTE_MACHINE_CPUFLAG_SSE2
 	case RTE_HASH_COMPARE_SSE:
 		/* Compare the first 4 signatures in the bucket */
@@ -964,14 +1745,16 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 			int32_t num_keys, int32_t *positions,
 			uint64_t *hit_mask, void *data[])
 {
-	uint64_t hits = 0;
-	int32_t i;
+	uint64_t hits = 0, all_hits;
+	int32_t i, ret;
+	uint32_t cnt_b, cnt_a;
+	const struct rte_hash_bucket *cur_bkt;
 	uint32_t prim_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	uint32_t sec_hash[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *primary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
 	const struct rte_hash_bucket *secondary_bkt[RTE_HASH_LOOKUP_BULK_MAX];
-	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
-	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX] = {0};
+	uint32_t prim_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
+	uint32_t sec_hitmask[RTE_HASH_LOOKUP_BULK_MAX];
 
 	/* Prefetch first keys */
 	for (i = 0; i < PREFETCH_OFFSET && i < num_keys; i++)
@@ -1006,86 +1789,183 @@ __rte_hash_lookup_bulk(const struct rte_hash *h, const void **keys,
 		rte_prefetch0(secondary_bkt[i]);
 	}
 
-	/* Compare signatures and prefetch key slot of first hit */
-	for (i = 0; i < num_keys; i++) {
-		compare_signatures(&prim_hitmask[i], &sec_hitmask[i],
-				primary_bkt[i], secondary_bkt[i],
-				prim_hash[i], sec_hash[i], h->sig_cmp_fn);
-
-		if (prim_hitmask[i]) {
-			uint32_t first_hit = __builtin_ctzl(prim_hitmask[i]);
-			uint32_t key_idx = primary_bkt[i]->key_idx[first_hit];
-			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
-			rte_prefetch0(key_slot);
-			continue;
-		}
+	all_hits = (num_keys == 64) ? UINT64_MAX : (1ULL << num_keys) - 1;
 
-		if (sec_hitmask[i]) {
-			uint32_t first_hit = __builtin_ctzl(sec_hitmask[i]);
-			uint32_t key_idx = secondary_bkt[i]->key_idx[first_hit];
-			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
-			rte_prefetch0(key_slot);
+	/*
+	 * As for a single lookup, retry the keys that were missed if the
+	 * table changed meanwhile.
+	 */
+	do {
+		cnt_b = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+
+		/* Compare signatures of the keys not found yet */
+		switch (h->sig_cmp_fn) {
+#ifdef CC_AVX512_SUPPORT
+		case RTE_HASH_COMPARE_AVX512:
+			rte_hash_compare_signatures_avx512(prim_hitmask,
+				sec_hitmask, primary_bkt, secondary_bkt,
+				prim_hash, sec_hash, num_keys, hits);
+			break;
+#endif
+#ifdef CC_AVX2_SUPPORT
+		case RTE_HASH_COMPARE_AVX2:
+			rte_hash_compare_signatures_avx2(prim_hitmask,
+				sec_hitmask, primary_bkt, secondary_bkt,
+				prim_hash, sec_hash, num_keys, hits);
+			break;
+#endif
+		default:
+			for (i = 0; i < num_keys; i++) {
+				prim_hitmask[i] = 0;
+				sec_hitmask[i] = 0;
+				if (hits & (1ULL << i))
+					continue;
+
+				compare_signatures(&prim_hitmask[i],
+					&sec_hitmask[i], primary_bkt[i],
+					secondary_bkt[i], prim_hash[i],
+					sec_hash[i], h->sig_cmp_fn);
+			}
 		}
-	}
 
-	/* Compare keys, first hits in primary first */
-	for (i = 0; i < num_keys; i++) {
-		positions[i] = -ENOENT;
-		while (prim_hitmask[i]) {
-			uint32_t hit_index = __builtin_ctzl(prim_hitmask[i]);
-
-			uint32_t key_idx = primary_bkt[i]->key_idx[hit_index];
-			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
-			/*
-			 * If key index is 0, do not compare key,
-			 * as it is checking the dummy slot
-			 */
-			if (!!key_idx & !rte_hash_cmp_eq(key_slot->key, keys[i], h)) {
-				if (data != NULL)
-					data[i] = key_slot->pdata;
+		/* Prefetch key slot of first hit */
+		for (i = 0; i < num_keys; i++) {
+			if (prim_hitmask[i]) {
+				uint32_t first_hit =
+					__builtin_ctzl(prim_hitmask[i]);
+				uint32_t key_idx =
+					primary_bkt[i]->key_idx[first_hit];
+				const struct rte_hash_key *key_slot =
+					get_key_entry(h, key_idx);
+				rte_prefetch0(key_slot);
+				continue;
+			}
 
-				hits |= 1ULL << i;
-				positions[i] = key_idx - 1;
-				goto next_key;
+			if (sec_hitmask[i]) {
+				uint32_t first_hit =
+					__builtin_ctzl(sec_hitmask[i]);
+				uint32_t key_idx =
+					secondary_bkt[i]->key_idx[first_hit];
+				const struct rte_hash_key *key_slot =
+					get_key_entry(h, key_idx);
+				rte_prefetch0(key_slot);
 			}
-			prim_hitmask[i] &= ~(1 << (hit_index));
 		}
 
-		while (sec_hitmask[i]) {
-			uint32_t hit_index = __builtin_ctzl(sec_hitmask[i]);
+		/* Compare keys, first hits in primary first */
+		for (i = 0; i < num_keys; i++) {
+			if (hits & (1ULL << i))
+				continue;
+
+			positions[i] = -ENOENT;
+			while (prim_hitmask[i]) {
+				uint32_t hit_index =
+					__builtin_ctzl(prim_hitmask[i]);
+
+				uint32_t key_idx = __atomic_load_n(
+					&primary_bkt[i]->key_idx[hit_index],
+					__ATOMIC_ACQUIRE);
+				const struct rte_hash_key *key_slot =
+					get_key_entry(h, key_idx);
+				/*
+				 * If key index is 0, do not compare key,
+				 * as it is checking the dummy slot
+				 */
+				if (!!key_idx &
+					!rte_hash_cmp_eq(
+						key_slot->key, keys[i], h)) {
+					if (data != NULL)
+						data[i] = __atomic_load_n(
+							&key_slot->pdata,
+							__ATOMIC_ACQUIRE);
+
+					hits |= 1ULL << i;
+					positions[i] = key_idx - 1;
+					goto next_key;
+				}
+				prim_hitmask[i] &= ~(1 << (hit_index));
+			}
 
-			uint32_t key_idx = secondary_bkt[i]->key_idx[hit_index];
-			const struct rte_hash_key *key_slot =
-				(const struct rte_hash_key *)(
-				(const char *)h->key_store +
-				key_idx * h->key_entry_size);
-			/*
-			 * If key index is 0, do not compare key,
-			 * as it is checking the dummy slot
-			 */
+			while (sec_hitmask[i]) {
+				uint32_t hit_index =
+					__builtin_ctzl(sec_hitmask[i]);
 
-			if (!!key_idx & !rte_hash_cmp_eq(key_slot->key, keys[i], h)) {
-				if (data != NULL)
-					data[i] = key_slot->pdata;
+				uint32_t key_idx = __atomic_load_n(
+					&secondary_bkt[i]->key_idx[hit_index],
+					__ATOMIC_ACQUIRE);
+				const struct rte_hash_key *key_slot =
+					get_key_entry(h, key_idx);
+				/*
+				 * If key index is 0, do not compare key,
+				 * as it is checking the dummy slot
+				 */
 
-				hits |= 1ULL << i;
-				positions[i] = key_idx - 1;
-				goto next_key;
+				if (!!key_idx &
+					!rte_hash_cmp_eq(
+						key_slot->key, keys[i], h)) {
+					if (data != NULL)
+						data[i] = __atomic_load_n(
+							&key_slot->pdata,
+							__ATOMIC_ACQUIRE);
+
+					hits |= 1ULL << i;
+					positions[i] = key_idx - 1;
+					goto next_key;
+				}
+				sec_hitmask[i] &= ~(1 << (hit_index));
 			}
-			sec_hitmask[i] &= ~(1 << (hit_index));
-		}
 
 next_key:
-		continue;
+			continue;
+		}
+
+		/* Search the missed keys in the extendable buckets, if any */
+		if (unlikely(h->ext_table_support) && hits != all_hits) {
+			for (i = 0; i < num_keys; i++) {
+				if (hits & (1ULL << i))
+					continue;
+				for (cur_bkt = __atomic_load_n(
+						&primary_bkt[i]->next,
+						__ATOMIC_ACQUIRE);
+						cur_bkt != NULL;
+						cur_bkt = __atomic_load_n(
+						&cur_bkt->next,
+						__ATOMIC_ACQUIRE)) {
+					ret = search_one_bucket(h, keys[i],
+						prim_hash[i], sec_hash[i],
+						cur_bkt, data != NULL ?
+						&data[i] : NULL);
+					if (ret != -ENOENT) {
+						hits |= 1ULL << i;
+						positions[i] = ret;
+						break;
+					}
+				}
+			}
+		}
+
+		/* All keys found, no need to check the counter */
+		if (hits == all_hits)
+			break;
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		cnt_a = __atomic_load_n(h->tbl_chng_cnt, __ATOMIC_ACQUIRE);
+	} while (cnt_b != cnt_a);
+
+	/* Search the missed keys in the buckets not migrated yet, if any */
+	if (unlikely(h->resize->old_buckets != NULL) && hits != all_hits) {
+		for (i = 0; i < num_keys; i++) {
+			if (hits & (1ULL << i))
+				continue;
+			ret = search_table(h, keys[i], prim_hash[i],
+					sec_hash[i], h->resize->old_buckets,
+					h->resize->old_bucket_bitmask,
+					data != NULL ? &data[i] : NULL);
+			if (ret != -ENOENT) {
+				hits |= 1ULL << i;
+				positions[i] = ret;
+			}
+		}
 	}
 
 	if (hit_mask != NULL)
@@ -1120,6 +2000,27 @@ rte_hash_lookup_bulk_data(const struct rte_hash *h, const void **keys,
 	return __builtin_popcountl(*hit_mask);
 }
 
+/* Get a bucket by index, the extendable buckets following the buckets */
+static inline const struct rte_hash_bucket *
+iterate_bucket(const struct rte_hash *h, uint32_t bucket_idx)
+{
+	const struct rte_hash_resize *rs = h->resize;
+
+	if (bucket_idx < h->num_buckets)
+		return &h->buckets[bucket_idx];
+	bucket_idx -= h->num_buckets;
+	if (h->ext_table_support) {
+		if (bucket_idx < h->num_buckets)
+			return &h->buckets_ext[bucket_idx];
+		bucket_idx -= h->num_buckets;
+	}
+
+	/* Buckets not migrated yet by a resize */
+	if (bucket_idx < rs->old_num_buckets)
+		return &rs->old_buckets[bucket_idx];
+	return &rs->old_buckets_ext[bucket_idx - rs->old_num_buckets];
+}
+
 int32_t
 rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32_t *next)
 {
@@ -1128,7 +2029,13 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 
 	RETURN_IF_TRUE(((h == NULL) || (next == NULL)), -EINVAL);
 
-	const uint32_t total_entries = h->num_buckets * RTE_HASH_BUCKET_ENTRIES;
+	uint32_t total_buckets = h->num_buckets;
+
+	/* Include the buckets not migrated yet by a resize, if any */
+	if (h->resize->old_buckets != NULL)
+		total_buckets += h->resize->old_num_buckets;
+	const uint32_t total_entries = (h->ext_table_support ? 2 : 1) *
+			total_buckets * RTE_HASH_BUCKET_ENTRIES;
 	/* Out of bounds */
 	if (*next >= total_entries)
 		return -ENOENT;
@@ -1137,8 +2044,11 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	bucket_idx = *next / RTE_HASH_BUCKET_ENTRIES;
 	idx = *next % RTE_HASH_BUCKET_ENTRIES;
 
-	/* If current position is empty, go to the next one */
-	while (h->buckets[bucket_idx].key_idx[idx] == EMPTY_SLOT) {
+	/*
+	 * If current position is empty, go to the next one. The free
+	 * extendable buckets are empty.
+	 */
+	while (iterate_bucket(h, bucket_idx)->key_idx[idx] == EMPTY_SLOT) {
 		(*next)++;
 		/* End of table */
 		if (*next == total_entries)
@@ -1148,9 +2058,8 @@ rte_hash_iterate(const struct rte_hash *h, const void **key, void **data, uint32
 	}
 
 	/* Get position of entry in key table */
-	position = h->buckets[bucket_idx].key_idx[idx];
-	next_key = (struct rte_hash_key *) ((char *)h->key_store +
-				position * h->key_entry_size);
+	position = iterate_bucket(h, bucket_idx)->key_idx[idx];
+	next_key = get_key_entry(h, position);
 	/* Return key and data */
 	*key = next_key->key;
 	*data = next_key->pdata;
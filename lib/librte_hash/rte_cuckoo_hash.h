@@ -46,15 +46,20 @@ enum cmp_jump_table_case {
 	KEY_96_BYTES,
 	KEY_112_BYTES,
 	KEY_128_BYTES,
+	KEY_32_BYTES_AVX2,
+	KEY_48_BYTES_AVX2,
+	KEY_64_BYTES_AVX2,
+	KEY_64_BYTES_AVX512,
 	KEY_OTHER_BYTES,
 	NUM_KEY_CMP_CASES,
 };
 
 /*
  * Table storing all different key compare functions
- * (multi-process supported)
+ * (multi-process supported).
+ * The vector functions not built fall back to the 16 bytes ones.
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	rte_hash_k16_cmp_eq,
 	rte_hash_k32_cmp_eq,
@@ -64,6 +69,20 @@ const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	rte_hash_k96_cmp_eq,
 	rte_hash_k112_cmp_eq,
 	rte_hash_k128_cmp_eq,
+#ifdef CC_AVX2_SUPPORT
+	rte_hash_k32_cmp_eq_avx2,
+	rte_hash_k48_cmp_eq_avx2,
+	rte_hash_k64_cmp_eq_avx2,
+#else
+	rte_hash_k32_cmp_eq,
+	rte_hash_k48_cmp_eq,
+	rte_hash_k64_cmp_eq,
+#endif
+#ifdef CC_AVX512_SUPPORT
+	rte_hash_k64_cmp_eq_avx512,
+#else
+	rte_hash_k64_cmp_eq,
+#endif
 	memcmp
 };
 #else
@@ -81,7 +100,7 @@ enum cmp_jump_table_case {
  * Table storing all different key compare functions
  * (multi-process supported)
  */
-const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
+static const rte_hash_cmp_eq_t cmp_jump_table[NUM_KEY_CMP_CASES] = {
 	NULL,
 	memcmp
 };
@@ -113,6 +132,12 @@ enum add_key_case {
 
 #define RTE_HASH_TSX_MAX_RETRY  10
 
+/** Number of buckets migrated by each add or delete during a resize. */
+#define RTE_HASH_RESIZE_STEP_BUCKETS	2
+
+/** Max number of key slots of a segment appended to the key store. */
+#define RTE_HASH_KEY_SEG_MAX_SLOTS	(1 << 16)
+
 struct lcore_cache {
 	unsigned len; /**< Cache len */
 	void *objs[LCORE_CACHE_SIZE]; /**< Cache objects */
@@ -133,6 +158,7 @@ enum rte_hash_sig_compare_function {
 	RTE_HASH_COMPARE_SCALAR = 0,
 	RTE_HASH_COMPARE_SSE,
 	RTE_HASH_COMPARE_AVX2,
+	RTE_HASH_COMPARE_AVX512,
 	RTE_HASH_COMPARE_NUM
 };
 
@@ -145,8 +171,25 @@ struct rte_hash_bucket {
 	hash_sig_t sig_alt[RTE_HASH_BUCKET_ENTRIES];
 
 	uint8_t flag[RTE_HASH_BUCKET_ENTRIES];
+
+	struct rte_hash_bucket *next;
+	/**< Next bucket of the chain of extendable buckets */
 } __rte_cache_aligned;
 
+/** State of an online resize: buckets left to migrate to the new table. */
+struct rte_hash_resize {
+	struct rte_hash_bucket *old_buckets;
+	/**< Buckets being migrated, NULL if no resize in progress */
+	struct rte_hash_bucket *old_buckets_ext;
+	/**< Extendable buckets chained to the buckets being migrated */
+	uint32_t old_num_buckets;       /**< Number of buckets to migrate. */
+	uint32_t old_bucket_bitmask;    /**< Bitmask of the old buckets. */
+	uint32_t next_bucket;           /**< Next bucket to migrate. */
+	struct rte_ring *old_free_slots;
+	/**< Free key slots left to move to a larger ring, NULL if none */
+	uint32_t generation;            /**< Number of resizes, for names. */
+};
+
 /** A hash table structure. */
 struct rte_hash {
 	char name[RTE_HASH_NAMESIZE];   /**< Name of the hash. */
@@ -161,7 +204,23 @@ struct rte_hash {
 	/**< Local cache per lcore, storing some indexes of the free slots */
 	enum add_key_case add_key; /**< Multi-writer hash add behavior */
 
-	rte_spinlock_t *multiwriter_lock; /**< Multi-writer spinlock for w/o TM */
+	rte_spinlock_t *multiwriter_lock;
+	/**< Multi-writer spinlock for w/o TM, and for extendable buckets */
+	uint8_t readwrite_concur_lf_support;
+	/**< Lock-free lookups concurrent with a writer */
+	uint32_t *tbl_chng_cnt;
+	/**< Counter incremented each time a key is moved in the table, so
+	 * that lock-free lookups can detect they may have missed it.
+	 */
+	int socket_id;                  /**< Socket of the tables. */
+	uint8_t ext_table_support;      /**< Enable extendable bucket table */
+	struct rte_ring *free_ext_bkts;
+	/**< Ring that stores the indexes of the free extendable buckets */
+	uint32_t *ext_bkt_to_free;
+	/**< Extendable bucket to free with each key slot, with lock-free
+	 * readers: the buckets emptied by a delete are freed by
+	 * rte_hash_free_key_with_position().
+	 */
 
 	/* Fields used in lookup */
 
@@ -180,10 +239,18 @@ struct rte_hash {
 	uint32_t key_entry_size;         /**< Size of each key entry. */
 
 	void *key_store;                /**< Table storing all keys and data */
+	uint32_t key_store_slots;       /**< Number of slots of key_store. */
+	uint32_t key_seg_shift;
+	/**< Log2 of the number of slots of each key segment. */
+	void **key_segs;
+	/**< Key segments appended by resizes, for the slots after key_store */
+	uint32_t num_key_segs;          /**< Number of key segments. */
 	struct rte_hash_bucket *buckets;
 	/**< Table with buckets storing all the	hash values and key indexes
 	 * to the key table.
 	 */
+	struct rte_hash_bucket *buckets_ext; /**< Extendable buckets table */
+	struct rte_hash_resize *resize; /**< Online resize state */
 } __rte_cache_aligned;
 
 struct queue_node {
@@ -193,4 +260,24 @@ struct queue_node {
 	int prev_slot;               /* Parent(slot) in search path */
 };
 
+/*
+ * Signature compare functions of the bulk lookup, built with the
+ * instruction set they use and selected at runtime.
+ */
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hitmask,
+		uint32_t *sec_hitmask,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys, uint64_t hits);
+
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hitmask,
+		uint32_t *sec_hitmask,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys, uint64_t hits);
+
 #endif
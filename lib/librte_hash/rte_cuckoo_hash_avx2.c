@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <x86intrin.h>
+
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_ring.h>
+#include <rte_spinlock.h>
+
+#include "rte_hash.h"
+#include "rte_cuckoo_hash.h"
+
+/* Compare 32 bytes keys, in one 256-bit register */
+int
+rte_hash_k32_cmp_eq_avx2(const void *key1, const void *key2,
+		size_t key_len __rte_unused)
+{
+	const __m256i k1 = _mm256_loadu_si256((const __m256i *)key1);
+	const __m256i k2 = _mm256_loadu_si256((const __m256i *)key2);
+	const __m256i x = _mm256_xor_si256(k1, k2);
+
+	return !_mm256_testz_si256(x, x);
+}
+
+/* Compare 48 bytes keys, the last 16 bytes in a 128-bit register */
+int
+rte_hash_k48_cmp_eq_avx2(const void *key1, const void *key2,
+		size_t key_len __rte_unused)
+{
+	const __m256i k1 = _mm256_loadu_si256((const __m256i *)key1);
+	const __m256i k2 = _mm256_loadu_si256((const __m256i *)key2);
+	const __m128i k3 = _mm_loadu_si128(
+			(const __m128i *)((const char *)key1 + 32));
+	const __m128i k4 = _mm_loadu_si128(
+			(const __m128i *)((const char *)key2 + 32));
+	const __m256i x = _mm256_or_si256(_mm256_xor_si256(k1, k2),
+			_mm256_castsi128_si256(_mm_xor_si128(k3, k4)));
+
+	return !_mm256_testz_si256(x, x);
+}
+
+/* Compare 64 bytes keys, in two 256-bit registers */
+int
+rte_hash_k64_cmp_eq_avx2(const void *key1, const void *key2,
+		size_t key_len __rte_unused)
+{
+	const __m256i k1 = _mm256_loadu_si256((const __m256i *)key1);
+	const __m256i k2 = _mm256_loadu_si256((const __m256i *)key2);
+	const __m256i k3 = _mm256_loadu_si256(
+			(const __m256i *)((const char *)key1 + 32));
+	const __m256i k4 = _mm256_loadu_si256(
+			(const __m256i *)((const char *)key2 + 32));
+	const __m256i x = _mm256_or_si256(_mm256_xor_si256(k1, k2),
+			_mm256_xor_si256(k3, k4));
+
+	return !_mm256_testz_si256(x, x);
+}
+
+/*
+ * Compare the signatures of the primary and secondary buckets of the
+ * keys not found yet, 8 signatures of a bucket at once.
+ */
+void
+rte_hash_compare_signatures_avx2(uint32_t *prim_hitmask,
+		uint32_t *sec_hitmask,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys, uint64_t hits)
+{
+	int32_t i;
+
+	RTE_BUILD_BUG_ON(RTE_HASH_BUCKET_ENTRIES != 8);
+
+	for (i = 0; i < num_keys; i++) {
+		if (hits & (1ULL << i)) {
+			prim_hitmask[i] = 0;
+			sec_hitmask[i] = 0;
+			continue;
+		}
+
+		prim_hitmask[i] = _mm256_movemask_ps((__m256)_mm256_cmpeq_epi32(
+				_mm256_load_si256(
+				(__m256i const *)primary_bkt[i]->sig_current),
+				_mm256_set1_epi32(prim_hash[i])));
+		sec_hitmask[i] = _mm256_movemask_ps((__m256)_mm256_cmpeq_epi32(
+				_mm256_load_si256(
+				(__m256i const *)secondary_bkt[i]->sig_current),
+				_mm256_set1_epi32(sec_hash[i])));
+	}
+}
@@ -0,0 +1,64 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <x86intrin.h>
+
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_ring.h>
+#include <rte_spinlock.h>
+
+#include "rte_hash.h"
+#include "rte_cuckoo_hash.h"
+
+/* Compare 64 bytes keys, in one 512-bit register */
+int
+rte_hash_k64_cmp_eq_avx512(const void *key1, const void *key2,
+		size_t key_len __rte_unused)
+{
+	const __m512i k1 = _mm512_loadu_si512(key1);
+	const __m512i k2 = _mm512_loadu_si512(key2);
+
+	return _mm512_cmpneq_epi64_mask(k1, k2) != 0;
+}
+
+/*
+ * Compare the signatures of the primary and secondary buckets of the
+ * keys not found yet, the 16 signatures of both buckets at once.
+ */
+void
+rte_hash_compare_signatures_avx512(uint32_t *prim_hitmask,
+		uint32_t *sec_hitmask,
+		const struct rte_hash_bucket **primary_bkt,
+		const struct rte_hash_bucket **secondary_bkt,
+		const hash_sig_t *prim_hash, const hash_sig_t *sec_hash,
+		int32_t num_keys, uint64_t hits)
+{
+	__m512i sigs, hashes;
+	__mmask16 matches;
+	int32_t i;
+
+	RTE_BUILD_BUG_ON(RTE_HASH_BUCKET_ENTRIES != 8);
+
+	for (i = 0; i < num_keys; i++) {
+		if (hits & (1ULL << i)) {
+			prim_hitmask[i] = 0;
+			sec_hitmask[i] = 0;
+			continue;
+		}
+
+		/* Primary signatures in the low half, secondary in the high */
+		sigs = _mm512_inserti64x4(_mm512_castsi256_si512(
+				_mm256_load_si256((__m256i const *)
+					primary_bkt[i]->sig_current)),
+				_mm256_load_si256((__m256i const *)
+					secondary_bkt[i]->sig_current), 1);
+		hashes = _mm512_inserti64x4(_mm512_set1_epi32(prim_hash[i]),
+				_mm256_set1_epi32(sec_hash[i]), 1);
+		matches = _mm512_cmpeq_epi32_mask(sigs, hashes);
+
+		prim_hitmask[i] = matches & 0xff;
+		sec_hitmask[i] = matches >> 8;
+	}
+}
@@ -14,6 +14,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include <rte_compat.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,6 +36,33 @@ extern "C" {
 /** Default behavior of insertion, single writer/multi writer */
 #define RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD 0x02
 
+/**
+ * Flag to support lock-free lookups concurrently with a writer.
+ *
+ * The lookup functions can be called by any number of threads while
+ * another thread adds or deletes keys. A key present in the table during
+ * the whole lookup is always found, even if it is moved by a concurrent
+ * cuckoo displacement.
+ *
+ * The key slots are not freed when keys are deleted, as lookups may still
+ * be reading them: once no reader can reference a deleted key anymore
+ * (for instance after all readers went through a quiescent state), the
+ * writer must free its position with rte_hash_free_key_with_position().
+ *
+ * It can't be combined with both RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT
+ * and RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD.
+ */
+#define RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF 0x04
+
+/**
+ * Flag to enable the extendable bucket table.
+ *
+ * When a key cannot be inserted in its two buckets, even after cuckoo
+ * displacements, it is inserted in a chain of extra buckets linked to its
+ * primary bucket, so that all the configured entries can be added.
+ */
+#define RTE_HASH_EXTRA_FLAGS_EXT_TABLE 0x08
+
 /** Signature of key that is stored internally. */
 typedef uint32_t hash_sig_t;
 
@@ -123,6 +152,60 @@ rte_hash_free(struct rte_hash *h);
 void
 rte_hash_reset(struct rte_hash *h);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Start growing a hash table online.
+ *
+ * The keys keep their positions: the new key slots are allocated by
+ * this call, in segments added to the key table without copying it.
+ * The buckets are migrated incrementally to a new buckets table, and the
+ * free key slots to a larger ring if needed: a few of them at each
+ * addition of a key, or explicitly with rte_hash_resize_step(). Until the
+ * migration is complete, the lookups and deletions search both tables.
+ *
+ * A resize in progress is completed before starting another one.
+ * This operation is not multi-thread safe, and is not supported for the
+ * tables created with RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, or with
+ * both RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT and
+ * RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD.
+ *
+ * @param h
+ *   Hash table to resize.
+ * @param entries
+ *   New total number of entries, greater than the current one.
+ * @return
+ *   - 0 if the resize is started (or done, if no bucket is migrated)
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOTSUP if the table cannot be resized.
+ *   - -ENOMEM if the new tables cannot be allocated.
+ *   - -ENOSPC if a previous resize cannot be completed.
+ */
+int __rte_experimental
+rte_hash_resize(struct rte_hash *h, uint32_t entries);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Migrate buckets of a resize in progress to the new buckets table,
+ * and as many buckets worth of free key slots to the new ring, if any.
+ * This operation is not multi-thread safe.
+ *
+ * @param h
+ *   Hash table being resized.
+ * @param nb_buckets
+ *   Maximum number of buckets to migrate.
+ * @return
+ *   - Number of buckets left to migrate, including the buckets worth of
+ *     free key slots, 0 if no resize is in progress.
+ *   - -EINVAL if the parameters are invalid.
+ *   - -ENOSPC if an entry cannot be inserted in the new table.
+ */
+int __rte_experimental
+rte_hash_resize_step(struct rte_hash *h, uint32_t nb_buckets);
+
 /**
  * Add a key-value pair to an existing hash table.
  * This operation is not multi-thread safe
@@ -206,6 +289,8 @@ rte_hash_add_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t
  * Remove a key from an existing hash table.
  * This operation is not multi-thread safe
  * and should only be called from one thread.
+ * With RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, the position of the key is
+ * not freed, see rte_hash_free_key_with_position().
  *
  * @param h
  *   Hash table to remove the key from.
@@ -225,6 +310,8 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
  * Remove a key from an existing hash table.
  * This operation is not multi-thread safe
  * and should only be called from one thread.
+ * With RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, the position of the key is
+ * not freed, see rte_hash_free_key_with_position().
  *
  * @param h
  *   Hash table to remove the key from.
@@ -242,6 +329,29 @@ rte_hash_del_key(const struct rte_hash *h, const void *key);
 int32_t
 rte_hash_del_key_with_hash(const struct rte_hash *h, const void *key, hash_sig_t sig);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free the position of a deleted key, in a hash table created with
+ * RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF, so that it can be reused by
+ * a new key.
+ * This operation is not multi-thread safe
+ * and should only be called from the writer thread, once no concurrent
+ * lookup can reference the deleted key anymore.
+ *
+ * @param h
+ *   Hash table to free the key position from.
+ * @param position
+ *   Position returned when the key was deleted.
+ * @return
+ *   - 0 if freed successfully
+ *   - -EINVAL if the parameters are invalid.
+ */
+int __rte_experimental
+rte_hash_free_key_with_position(const struct rte_hash *h,
+				const int32_t position);
+
 /**
  * Find a key in the hash table given the position.
  * This operation is multi-thread safe.
@@ -5,6 +5,10 @@
 #ifndef _IP_FRAG_COMMON_H_
 #define _IP_FRAG_COMMON_H_
 
+#include <rte_jhash.h>
+#include <rte_hash_crc.h>
+#include <rte_prefetch.h>
+
 #include "rte_ip_frag.h"
 
 /* logging macros. */
@@ -14,9 +18,20 @@
 #define	IP_FRAG_LOG(lvl, fmt, args...)	do {} while(0)
 #endif /* IP_FRAG_DEBUG */
 
+#ifdef RTE_LIBRTE_IP_FRAG_TBL_STAT
+#define	IP_FRAG_TBL_STAT_UPDATE(s, f, v)	((s)->f += (v))
+#else
+#define	IP_FRAG_TBL_STAT_UPDATE(s, f, v)	do {} while (0)
+#endif /* IP_FRAG_TBL_STAT */
+
 #define IPV4_KEYLEN 1
 #define IPV6_KEYLEN 4
 
+#define	PRIME_VALUE	0xeaad8405
+
+#define	IP_FRAG_TBL_POS(tbl, sig)	\
+	((tbl)->pkt + ((sig) & (tbl)->entry_mask))
+
 /* helper macros */
 #define	IP_FRAG_MBUF2DR(dr, mb)	((dr)->row[(dr)->cnt++] = (mb))
 
@@ -34,6 +49,11 @@ struct ip_frag_pkt * ip_frag_find(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		const struct ip_frag_key *key, uint64_t tms);
 
+struct ip_frag_pkt * ip_frag_find_sig(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr,
+		const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+		uint64_t tms);
+
 struct ip_frag_pkt * ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	const struct ip_frag_key *key, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
@@ -48,6 +68,91 @@ struct rte_mbuf *ipv6_frag_reassemble(struct ip_frag_pkt *fp);
  * misc frag key functions
  */
 
+static inline void
+ipv4_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
+{
+	uint32_t v;
+	const uint32_t *p;
+
+	p = (const uint32_t *)&key->src_dst;
+
+#ifdef RTE_ARCH_X86
+	v = rte_hash_crc_4byte(p[0], PRIME_VALUE);
+	v = rte_hash_crc_4byte(p[1], v);
+	v = rte_hash_crc_4byte(key->id, v);
+#else
+
+	v = rte_jhash_3words(p[0], p[1], key->id, PRIME_VALUE);
+#endif /* RTE_ARCH_X86 */
+
+	*v1 =  v;
+	*v2 = (v << 7) + (v >> 14);
+}
+
+static inline void
+ipv6_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
+{
+	uint32_t v;
+	const uint32_t *p;
+
+	p = (const uint32_t *) &key->src_dst;
+
+#ifdef RTE_ARCH_X86
+	v = rte_hash_crc_4byte(p[0], PRIME_VALUE);
+	v = rte_hash_crc_4byte(p[1], v);
+	v = rte_hash_crc_4byte(p[2], v);
+	v = rte_hash_crc_4byte(p[3], v);
+	v = rte_hash_crc_4byte(p[4], v);
+	v = rte_hash_crc_4byte(p[5], v);
+	v = rte_hash_crc_4byte(p[6], v);
+	v = rte_hash_crc_4byte(p[7], v);
+	v = rte_hash_crc_4byte(key->id, v);
+#else
+
+	v = rte_jhash_3words(p[0], p[1], p[2], PRIME_VALUE);
+	v = rte_jhash_3words(p[3], p[4], p[5], v);
+	v = rte_jhash_3words(p[6], p[7], key->id, v);
+#endif /* RTE_ARCH_X86 */
+
+	*v1 =  v;
+	*v2 = (v << 7) + (v >> 14);
+}
+
+/* calculate the two hash values of a key */
+static inline void
+ip_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
+{
+	/* different hashing methods for IPv4 and IPv6 */
+	if (key->key_len == IPV4_KEYLEN)
+		ipv4_frag_hash(key, v1, v2);
+	else
+		ipv6_frag_hash(key, v1, v2);
+}
+
+/* number of fragments whose mbufs the death row has room for */
+static inline uint32_t
+ip_frag_dr_room(const struct rte_ip_frag_death_row *dr)
+{
+	return (IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt) / (IP_MAX_FRAG_NUM + 1);
+}
+
+/* prefetch the entries of the two buckets where a key can be stored */
+static inline void
+ip_frag_tbl_prefetch(const struct rte_ip_frag_tbl *tbl, uint32_t sig1,
+	uint32_t sig2)
+{
+	const struct ip_frag_pkt *p1, *p2;
+	uint32_t i;
+
+	p1 = IP_FRAG_TBL_POS(tbl, sig1);
+	p2 = IP_FRAG_TBL_POS(tbl, sig2);
+
+	for (i = 0; i != tbl->bucket_entries; i++) {
+		rte_prefetch0(&p1[i].key);
+		rte_prefetch0(&p2[i].key);
+	}
+}
+
 /* check if key is empty */
 static inline int
 ip_frag_key_is_empty(const struct ip_frag_key * key)
@@ -131,6 +236,34 @@ ip_frag_inuse(struct rte_ip_frag_tbl *tbl, const struct  ip_frag_pkt *fp)
 	}
 }
 
+/* delete the entry of the table, put its mbufs on death row */
+static inline void
+ip_frag_tbl_del(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	struct ip_frag_pkt *fp)
+{
+	ip_frag_free(fp, dr);
+	ip_frag_key_invalidate(&fp->key);
+	TAILQ_REMOVE(&tbl->lru, fp, lru);
+	tbl->use_entries--;
+}
+
+/* count the reassembled packet, or the dropped entry of an invalid one */
+static inline void
+ip_frag_tbl_stat_result(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_pkt *fp, const struct rte_mbuf *mb)
+{
+#ifdef RTE_LIBRTE_IP_FRAG_TBL_STAT
+	if (mb != NULL)
+		tbl->stat.reasm_num++;
+	else if (ip_frag_key_is_empty(&fp->key))
+		tbl->stat.fail_invalid++;
+#else
+	RTE_SET_USED(tbl);
+	RTE_SET_USED(fp);
+	RTE_SET_USED(mb);
+#endif /* IP_FRAG_TBL_STAT */
+}
+
 /* reset the fragment */
 static inline void
 ip_frag_reset(struct ip_frag_pkt *fp, uint64_t tms)
@@ -4,34 +4,9 @@
 
 #include <stddef.h>
 
-#include <rte_jhash.h>
-#include <rte_hash_crc.h>
-
 #include "ip_frag_common.h"
 
-#define	PRIME_VALUE	0xeaad8405
-
-#define	IP_FRAG_TBL_POS(tbl, sig)	\
-	((tbl)->pkt + ((sig) & (tbl)->entry_mask))
-
-#ifdef RTE_LIBRTE_IP_FRAG_TBL_STAT
-#define	IP_FRAG_TBL_STAT_UPDATE(s, f, v)	((s)->f += (v))
-#else
-#define	IP_FRAG_TBL_STAT_UPDATE(s, f, v)	do {} while (0)
-#endif /* IP_FRAG_TBL_STAT */
-
 /* local frag table helper functions */
-static inline void
-ip_frag_tbl_del(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
-	struct ip_frag_pkt *fp)
-{
-	ip_frag_free(fp, dr);
-	ip_frag_key_invalidate(&fp->key);
-	TAILQ_REMOVE(&tbl->lru, fp, lru);
-	tbl->use_entries--;
-	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, del_num, 1);
-}
-
 static inline void
 ip_frag_tbl_add(struct rte_ip_frag_tbl *tbl,  struct ip_frag_pkt *fp,
 	const struct ip_frag_key *key, uint64_t tms)
@@ -55,56 +30,6 @@ ip_frag_tbl_reuse(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 }
 
 
-static inline void
-ipv4_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
-{
-	uint32_t v;
-	const uint32_t *p;
-
-	p = (const uint32_t *)&key->src_dst;
-
-#ifdef RTE_ARCH_X86
-	v = rte_hash_crc_4byte(p[0], PRIME_VALUE);
-	v = rte_hash_crc_4byte(p[1], v);
-	v = rte_hash_crc_4byte(key->id, v);
-#else
-
-	v = rte_jhash_3words(p[0], p[1], key->id, PRIME_VALUE);
-#endif /* RTE_ARCH_X86 */
-
-	*v1 =  v;
-	*v2 = (v << 7) + (v >> 14);
-}
-
-static inline void
-ipv6_frag_hash(const struct ip_frag_key *key, uint32_t *v1, uint32_t *v2)
-{
-	uint32_t v;
-	const uint32_t *p;
-
-	p = (const uint32_t *) &key->src_dst;
-
-#ifdef RTE_ARCH_X86
-	v = rte_hash_crc_4byte(p[0], PRIME_VALUE);
-	v = rte_hash_crc_4byte(p[1], v);
-	v = rte_hash_crc_4byte(p[2], v);
-	v = rte_hash_crc_4byte(p[3], v);
-	v = rte_hash_crc_4byte(p[4], v);
-	v = rte_hash_crc_4byte(p[5], v);
-	v = rte_hash_crc_4byte(p[6], v);
-	v = rte_hash_crc_4byte(p[7], v);
-	v = rte_hash_crc_4byte(key->id, v);
-#else
-
-	v = rte_jhash_3words(p[0], p[1], p[2], PRIME_VALUE);
-	v = rte_jhash_3words(p[3], p[4], p[5], v);
-	v = rte_jhash_3words(p[6], p[7], key->id, v);
-#endif /* RTE_ARCH_X86 */
-
-	*v1 =  v;
-	*v2 = (v << 7) + (v >> 14);
-}
-
 struct rte_mbuf *
 ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 	struct rte_mbuf *mb, uint16_t ofs, uint16_t len, uint16_t more_frags)
@@ -232,33 +157,33 @@ ip_frag_process(struct ip_frag_pkt *fp, struct rte_ip_frag_death_row *dr,
 }
 
 
+static struct ip_frag_pkt *
+ip_frag_lookup_bucket(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms, struct ip_frag_pkt **free, struct ip_frag_pkt **stale);
+
 /*
- * Find an entry in the table for the corresponding fragment.
- * If such entry is not present, then allocate a new one.
- * If the entry is stale, then free and reuse it.
+ * Complete the search of an entry for a fragment, once the table has been
+ * looked up: allocate a new entry if none was found, or reuse the found
+ * one if it is timed out.
  */
-struct ip_frag_pkt *
-ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
-	const struct ip_frag_key *key, uint64_t tms)
+static inline struct ip_frag_pkt *
+ip_frag_find_complete(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, const struct ip_frag_key *key,
+	uint64_t tms, struct ip_frag_pkt *pkt, struct ip_frag_pkt *free,
+	struct ip_frag_pkt *stale)
 {
-	struct ip_frag_pkt *pkt, *free, *stale, *lru;
+	struct ip_frag_pkt *lru;
 	uint64_t max_cycles;
 
-	/*
-	 * Actually the two line below are totally redundant.
-	 * they are here, just to make gcc 4.6 happy.
-	 */
-	free = NULL;
-	stale = NULL;
 	max_cycles = tbl->max_cycles;
 
-	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
-
-	if ((pkt = ip_frag_lookup(tbl, key, tms, &free, &stale)) == NULL) {
+	if (pkt == NULL) {
 
 		/*timed-out entry, free and invalidate it*/
 		if (stale != NULL) {
 			ip_frag_tbl_del(tbl, dr, stale);
+			IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, del_num, 1);
 			free = stale;
 
 		/*
@@ -271,6 +196,7 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 			lru = TAILQ_FIRST(&tbl->lru);
 			if (max_cycles + lru->start < tms) {
 				ip_frag_tbl_del(tbl, dr, lru);
+				IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, del_num, 1);
 			} else {
 				free = NULL;
 				IP_FRAG_TBL_STAT_UPDATE(&tbl->stat,
@@ -299,15 +225,80 @@ ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
 	return pkt;
 }
 
+/*
+ * Find an entry in the table for the corresponding fragment.
+ * If such entry is not present, then allocate a new one.
+ * If the entry is stale, then free and reuse it.
+ */
+struct ip_frag_pkt *
+ip_frag_find(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, uint64_t tms)
+{
+	struct ip_frag_pkt *pkt, *free, *stale;
+
+	/*
+	 * Actually the two line below are totally redundant.
+	 * they are here, just to make gcc 4.6 happy.
+	 */
+	free = NULL;
+	stale = NULL;
+
+	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
+
+	pkt = ip_frag_lookup(tbl, key, tms, &free, &stale);
+	return ip_frag_find_complete(tbl, dr, key, tms, pkt, free, stale);
+}
+
+/*
+ * Same as ip_frag_find(), but with the hash values of the key already
+ * calculated, so that the bulk reassembly can prefetch the buckets.
+ */
+struct ip_frag_pkt *
+ip_frag_find_sig(struct rte_ip_frag_tbl *tbl, struct rte_ip_frag_death_row *dr,
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms)
+{
+	struct ip_frag_pkt *pkt, *free, *stale;
+
+	free = NULL;
+	stale = NULL;
+
+	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, find_num, 1);
+
+	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
+		pkt = tbl->last;
+	else
+		pkt = ip_frag_lookup_bucket(tbl, key, sig1, sig2, tms,
+			&free, &stale);
+
+	return ip_frag_find_complete(tbl, dr, key, tms, pkt, free, stale);
+}
+
 struct ip_frag_pkt *
 ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	const struct ip_frag_key *key, uint64_t tms,
 	struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
+{
+	uint32_t sig1, sig2;
+
+	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
+		return tbl->last;
+
+	ip_frag_hash(key, &sig1, &sig2);
+
+	return ip_frag_lookup_bucket(tbl, key, sig1, sig2, tms, free, stale);
+}
+
+/* search the two buckets of a key for it, an empty and a stale entry */
+static struct ip_frag_pkt *
+ip_frag_lookup_bucket(struct rte_ip_frag_tbl *tbl,
+	const struct ip_frag_key *key, uint32_t sig1, uint32_t sig2,
+	uint64_t tms, struct ip_frag_pkt **free, struct ip_frag_pkt **stale)
 {
 	struct ip_frag_pkt *p1, *p2;
 	struct ip_frag_pkt *empty, *old;
 	uint64_t max_cycles;
-	uint32_t i, assoc, sig1, sig2;
+	uint32_t i, assoc;
 
 	empty = NULL;
 	old = NULL;
@@ -315,15 +306,6 @@ ip_frag_lookup(struct rte_ip_frag_tbl *tbl,
 	max_cycles = tbl->max_cycles;
 	assoc = tbl->bucket_entries;
 
-	if (tbl->last != NULL && ip_frag_key_cmp(key, &tbl->last->key) == 0)
-		return tbl->last;
-
-	/* different hashing methods for IPv4 and IPv6 */
-	if (key->key_len == IPV4_KEYLEN)
-		ipv4_frag_hash(key, &sig1, &sig2);
-	else
-		ipv6_frag_hash(key, &sig1, &sig2);
-
 	p1 = IP_FRAG_TBL_POS(tbl, sig1);
 	p2 = IP_FRAG_TBL_POS(tbl, sig2);
 
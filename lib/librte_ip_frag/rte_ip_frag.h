@@ -20,6 +20,7 @@ extern "C" {
 #include <stdio.h>
 
 #include <rte_config.h>
+#include <rte_compat.h>
 #include <rte_malloc.h>
 #include <rte_memory.h>
 #include <rte_ip.h>
@@ -65,10 +66,14 @@ struct ip_frag_pkt {
 
 #define IP_FRAG_DEATH_ROW_LEN 32 /**< death row size (in packets) */
 
+/** death row size in mbufs */
+#define IP_FRAG_DEATH_ROW_MBUF_LEN \
+	(IP_FRAG_DEATH_ROW_LEN * (IP_MAX_FRAG_NUM + 1))
+
 /** mbuf death row (packets to be freed) */
 struct rte_ip_frag_death_row {
 	uint32_t cnt;          /**< number of mbufs currently on death row */
-	struct rte_mbuf *row[IP_FRAG_DEATH_ROW_LEN * (IP_MAX_FRAG_NUM + 1)];
+	struct rte_mbuf *row[IP_FRAG_DEATH_ROW_MBUF_LEN];
 	/**< mbufs to be freed */
 };
 
@@ -82,6 +87,9 @@ struct ip_frag_tbl_stat {
 	uint64_t reuse_num;     /**< # of reuse (del/add) ops. */
 	uint64_t fail_total;    /**< total # of add failures. */
 	uint64_t fail_nospace;  /**< # of 'no space' add failures. */
+	uint64_t expire_num;    /**< # of del ops by explicit expiry. */
+	uint64_t reasm_num;     /**< # of reassembled packets. */
+	uint64_t fail_invalid;  /**< # of dropped invalid packets. */
 } __rte_cache_aligned;
 
 /** fragmentation table */
@@ -210,6 +218,40 @@ struct rte_mbuf *rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_mbuf *mb, uint64_t tms, struct ipv6_hdr *ip_hdr,
 		struct ipv6_extension_fragment *frag_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reassemble a burst of IPv6 packets, like
+ * rte_ipv4_frag_reassemble_bulk() does for IPv4. The fragment header must
+ * directly follow the IPv6 header, see
+ * rte_ipv6_frag_get_ipv6_fragment_header().
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to.
+ * @param mbs
+ *   Array of incoming mbufs, with their l2_len/l3_len fields set.
+ * @param nb_mbs
+ *   Number of mbufs in mbs.
+ * @param tms
+ *   Arrival timestamp of the burst.
+ * @param out
+ *   Array of at least nb_mbs entries to store the reassembled packets and
+ *   the packets which aren't fragments. It may be the same array as mbs.
+ * @param nb_out
+ *   Returns the number of mbufs stored in out.
+ * @return
+ *   Number of mbufs consumed from mbs, less than nb_mbs if the death row
+ *   is full.
+ */
+uint16_t __rte_experimental
+rte_ipv6_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_mbs, uint64_t tms, struct rte_mbuf **out,
+		uint16_t *nb_out);
+
 /**
  * Return a pointer to the packet's fragment header, if found.
  * It only looks at the extension header that's right after the fixed IPv6
@@ -283,6 +325,52 @@ struct rte_mbuf * rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 		struct rte_ip_frag_death_row *dr,
 		struct rte_mbuf *mb, uint64_t tms, struct ipv4_hdr *ip_hdr);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reassemble a burst of IPv4 packets.
+ *
+ * The keys of the fragments are hashed and the buckets of the table they
+ * fall in are prefetched for a group of fragments before any of them is
+ * looked up, so that the cache misses on the table are overlapped. The
+ * fragments are then processed in order, as with
+ * rte_ipv4_frag_reassemble_packet(), so several fragments of the same
+ * packet may be in the burst. The packets which aren't fragments are
+ * passed through to out unchanged, in their order.
+ *
+ * Every packet may put up to IP_MAX_FRAG_NUM + 1 mbufs on the death row.
+ * The function stops before a group of packets the death row has no room
+ * for, and returns the number of packets consumed from mbs: the caller
+ * must then free the death row and call it again for the remaining
+ * packets. With an empty death row, at least IP_FRAG_DEATH_ROW_LEN
+ * packets are consumed.
+ *
+ * @param tbl
+ *   Table where to lookup/add the fragmented packets.
+ * @param dr
+ *   Death row to free buffers to.
+ * @param mbs
+ *   Array of incoming mbufs, with their l2_len/l3_len fields set.
+ * @param nb_mbs
+ *   Number of mbufs in mbs.
+ * @param tms
+ *   Arrival timestamp of the burst.
+ * @param out
+ *   Array of at least nb_mbs entries to store the reassembled packets and
+ *   the packets which aren't fragments. It may be the same array as mbs.
+ * @param nb_out
+ *   Returns the number of mbufs stored in out.
+ * @return
+ *   Number of mbufs consumed from mbs, less than nb_mbs if the death row
+ *   is full.
+ */
+uint16_t __rte_experimental
+rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_mbs, uint64_t tms, struct rte_mbuf **out,
+		uint16_t *nb_out);
+
 /**
  * Check if the IPv4 packet is fragmented
  *
@@ -314,6 +402,40 @@ void rte_ip_frag_free_death_row(struct rte_ip_frag_death_row *dr,
 		uint32_t prefetch);
 
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete the entries of a fragmentation table, which have been waiting
+ * for their missing fragments longer than the table's max_cycles. Their
+ * mbufs are put on the death row.
+ *
+ * The entries are otherwise only deleted when a lookup finds them stale,
+ * so this function lets an idle core reclaim the mbufs held by the
+ * entries of incomplete packets, e.g. after a burst of fragments.
+ * The entries are checked from the oldest one, and the function stops at
+ * the first entry which has not expired, so its cost only depends on the
+ * number of deleted entries. The same table mustn't be accessed by
+ * another thread concurrently.
+ *
+ * @param tbl
+ *   Fragmentation table to delete the expired entries from.
+ * @param dr
+ *   Death row to free buffers to. The function stops when the death row
+ *   has no room left for the mbufs of the next expired entry.
+ * @param tms
+ *   Current timestamp, the entries created before tms - max_cycles are
+ *   expired.
+ * @param max_nb_del
+ *   Maximum number of entries to delete, it bounds the work of a call.
+ * @return
+ *   Number of deleted entries.
+ */
+uint32_t __rte_experimental
+rte_ip_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, uint64_t tms,
+		uint32_t max_nb_del);
+
 /**
  * Dump fragmentation table statistics to file.
  *
@@ -93,6 +93,34 @@ rte_ip_frag_table_destroy(struct rte_ip_frag_tbl *tbl)
 	rte_free(tbl);
 }
 
+/* delete the expired entries, from the head of the LRU list */
+uint32_t __rte_experimental
+rte_ip_frag_table_del_expired_entries(struct rte_ip_frag_tbl *tbl,
+	struct rte_ip_frag_death_row *dr, uint64_t tms, uint32_t max_nb_del)
+{
+	struct ip_frag_pkt *fp;
+	uint32_t n;
+
+	for (n = 0; n != max_nb_del; n++) {
+		fp = TAILQ_FIRST(&tbl->lru);
+
+		/* entries are sorted by their creation time in the LRU list. */
+		if (fp == NULL || tbl->max_cycles + fp->start >= tms)
+			break;
+
+		/* check that death row has enough space for the mbufs. */
+		if (IP_FRAG_DEATH_ROW_MBUF_LEN - dr->cnt < fp->last_idx)
+			break;
+
+		ip_frag_tbl_del(tbl, dr, fp);
+		if (tbl->last == fp)
+			tbl->last = NULL;
+	}
+
+	IP_FRAG_TBL_STAT_UPDATE(&tbl->stat, expire_num, n);
+	return n;
+}
+
 /* dump frag table statistics to file */
 void
 rte_ip_frag_table_statistics_dump(FILE *f, const struct rte_ip_frag_tbl *tbl)
@@ -110,7 +138,10 @@ rte_ip_frag_table_statistics_dump(FILE *f, const struct rte_ip_frag_tbl *tbl)
 		"entries reused by timeout:\t%" PRIu64 ";\n"
 		"total add failures:\t%" PRIu64 ";\n"
 		"add no-space failures:\t%" PRIu64 ";\n"
-		"add hash-collisions failures:\t%" PRIu64 ";\n",
+		"add hash-collisions failures:\t%" PRIu64 ";\n"
+		"entries deleted by expiry:\t%" PRIu64 ";\n"
+		"packets reassembled:\t%" PRIu64 ";\n"
+		"invalid packets dropped:\t%" PRIu64 ";\n",
 		tbl->max_entries,
 		tbl->use_entries,
 		tbl->stat.find_num,
@@ -119,5 +150,8 @@ rte_ip_frag_table_statistics_dump(FILE *f, const struct rte_ip_frag_tbl *tbl)
 		tbl->stat.reuse_num,
 		fail_total,
 		fail_nospace,
-		fail_total - fail_nospace);
+		fail_total - fail_nospace,
+		tbl->stat.expire_num,
+		tbl->stat.reasm_num,
+		tbl->stat.fail_invalid);
 }
@@ -3,6 +3,7 @@
  */
 
 #include <stddef.h>
+#include <string.h>
 
 #include <rte_debug.h>
 
@@ -147,6 +148,7 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	/* process the fragmented packet. */
 	mb = ip_frag_process(fp, dr, mb, ip_ofs, ip_len, ip_flag);
+	ip_frag_tbl_stat_result(tbl, fp, mb);
 	ip_frag_inuse(tbl, fp);
 
 	IP_FRAG_LOG(DEBUG, "%s:%d:\n"
@@ -161,3 +163,94 @@ rte_ipv4_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Reassemble a burst of IPv4 fragments.
+ * The keys of a group of up to IP_FRAG_DEATH_ROW_LEN fragments are hashed
+ * and their buckets prefetched before any of them is looked up, so that
+ * the misses on the table are overlapped. A group is only processed if
+ * the death row has room for the mbufs it may free. The fragments are
+ * still looked up and processed in order, so fragments of the same
+ * datagram within the burst are handled as with
+ * rte_ipv4_frag_reassemble_packet().
+ */
+uint16_t __rte_experimental
+rte_ipv4_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_mbs, uint64_t tms, struct rte_mbuf **out,
+		uint16_t *nb_out)
+{
+	struct ip_frag_pkt *fp;
+	struct ipv4_hdr *ip_hdr;
+	struct rte_mbuf *mb[IP_FRAG_DEATH_ROW_LEN];
+	struct ip_frag_key key[IP_FRAG_DEATH_ROW_LEN];
+	uint32_t sig1[IP_FRAG_DEATH_ROW_LEN], sig2[IP_FRAG_DEATH_ROW_LEN];
+	uint16_t ip_ofs[IP_FRAG_DEATH_ROW_LEN], ip_len[IP_FRAG_DEATH_ROW_LEN];
+	uint16_t ip_flag[IP_FRAG_DEATH_ROW_LEN];
+	uint16_t flag_offset;
+	uint32_t i, j, k, n;
+
+	n = 0;
+	for (i = 0; i < nb_mbs; i += k) {
+		/* stop once the death row is full, it can't be checked later */
+		k = RTE_MIN(nb_mbs - i, ip_frag_dr_room(dr));
+		k = RTE_MIN(k, (uint32_t)IP_FRAG_DEATH_ROW_LEN);
+		if (k == 0)
+			break;
+
+		/* build the keys, hash them and prefetch their buckets. */
+		for (j = 0; j != k; j++) {
+			mb[j] = mbs[i + j];
+			ip_hdr = rte_pktmbuf_mtod_offset(mb[j],
+				struct ipv4_hdr *, mb[j]->l2_len);
+
+			/* not a fragment, it is passed through. */
+			if (!rte_ipv4_frag_pkt_is_fragmented(ip_hdr)) {
+				key[j].key_len = 0;
+				continue;
+			}
+
+			flag_offset = rte_be_to_cpu_16(ip_hdr->fragment_offset);
+			ip_ofs[j] = (uint16_t)((flag_offset &
+				IPV4_HDR_OFFSET_MASK) * IPV4_HDR_OFFSET_UNITS);
+			ip_flag[j] = (uint16_t)(flag_offset & IPV4_HDR_MF_FLAG);
+			ip_len[j] = (uint16_t)(rte_be_to_cpu_16(
+				ip_hdr->total_length) - mb[j]->l3_len);
+
+			/* use first 8 bytes only */
+			memcpy(&key[j].src_dst[0], &ip_hdr->src_addr,
+				sizeof(key[j].src_dst[0]));
+			key[j].id = ip_hdr->packet_id;
+			key[j].key_len = IPV4_KEYLEN;
+
+			ipv4_frag_hash(&key[j], &sig1[j], &sig2[j]);
+			ip_frag_tbl_prefetch(tbl, sig1[j], sig2[j]);
+		}
+
+		/* find/add the entries and process the fragments. */
+		for (j = 0; j != k; j++) {
+			if (key[j].key_len == 0) {
+				out[n++] = mb[j];
+				continue;
+			}
+
+			fp = ip_frag_find_sig(tbl, dr, &key[j], sig1[j],
+				sig2[j], tms);
+			if (fp == NULL) {
+				IP_FRAG_MBUF2DR(dr, mb[j]);
+				continue;
+			}
+
+			mb[j] = ip_frag_process(fp, dr, mb[j], ip_ofs[j],
+				ip_len[j], ip_flag[j]);
+			ip_frag_tbl_stat_result(tbl, fp, mb[j]);
+			ip_frag_inuse(tbl, fp);
+
+			if (mb[j] != NULL)
+				out[n++] = mb[j];
+		}
+	}
+
+	*nb_out = n;
+	return i;
+}
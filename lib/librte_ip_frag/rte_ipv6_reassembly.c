@@ -188,6 +188,7 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 	/* process the fragmented packet. */
 	mb = ip_frag_process(fp, dr, mb, ip_ofs, ip_len,
 			MORE_FRAGS(frag_hdr->frag_data));
+	ip_frag_tbl_stat_result(tbl, fp, mb);
 	ip_frag_inuse(tbl, fp);
 
 	IP_FRAG_LOG(DEBUG, "%s:%d:\n"
@@ -202,3 +203,87 @@ rte_ipv6_frag_reassemble_packet(struct rte_ip_frag_tbl *tbl,
 
 	return mb;
 }
+
+/*
+ * Reassemble a burst of IPv6 fragments, see
+ * rte_ipv4_frag_reassemble_bulk().
+ */
+uint16_t __rte_experimental
+rte_ipv6_frag_reassemble_bulk(struct rte_ip_frag_tbl *tbl,
+		struct rte_ip_frag_death_row *dr, struct rte_mbuf **mbs,
+		uint16_t nb_mbs, uint64_t tms, struct rte_mbuf **out,
+		uint16_t *nb_out)
+{
+	struct ip_frag_pkt *fp;
+	struct ipv6_hdr *ip_hdr;
+	struct ipv6_extension_fragment *frag_hdr;
+	struct rte_mbuf *mb[IP_FRAG_DEATH_ROW_LEN];
+	struct ip_frag_key key[IP_FRAG_DEATH_ROW_LEN];
+	uint32_t sig1[IP_FRAG_DEATH_ROW_LEN], sig2[IP_FRAG_DEATH_ROW_LEN];
+	uint16_t ip_ofs[IP_FRAG_DEATH_ROW_LEN], ip_len[IP_FRAG_DEATH_ROW_LEN];
+	uint16_t ip_flag[IP_FRAG_DEATH_ROW_LEN];
+	uint32_t i, j, k, n;
+
+	n = 0;
+	for (i = 0; i < nb_mbs; i += k) {
+		/* stop once the death row is full, it can't be checked later */
+		k = RTE_MIN(nb_mbs - i, ip_frag_dr_room(dr));
+		k = RTE_MIN(k, (uint32_t)IP_FRAG_DEATH_ROW_LEN);
+		if (k == 0)
+			break;
+
+		/* build the keys, hash them and prefetch their buckets. */
+		for (j = 0; j != k; j++) {
+			mb[j] = mbs[i + j];
+			ip_hdr = rte_pktmbuf_mtod_offset(mb[j],
+				struct ipv6_hdr *, mb[j]->l2_len);
+
+			/* not a fragment, it is passed through. */
+			frag_hdr = rte_ipv6_frag_get_ipv6_fragment_header(
+				ip_hdr);
+			if (frag_hdr == NULL) {
+				key[j].key_len = 0;
+				continue;
+			}
+
+			ip_ofs[j] = FRAG_OFFSET(frag_hdr->frag_data) * 8;
+			ip_flag[j] = MORE_FRAGS(frag_hdr->frag_data);
+			ip_len[j] = rte_be_to_cpu_16(ip_hdr->payload_len) -
+				sizeof(*frag_hdr);
+
+			rte_memcpy(&key[j].src_dst[0], ip_hdr->src_addr, 16);
+			rte_memcpy(&key[j].src_dst[2], ip_hdr->dst_addr, 16);
+			key[j].id = frag_hdr->id;
+			key[j].key_len = IPV6_KEYLEN;
+
+			ipv6_frag_hash(&key[j], &sig1[j], &sig2[j]);
+			ip_frag_tbl_prefetch(tbl, sig1[j], sig2[j]);
+		}
+
+		/* find/add the entries and process the fragments. */
+		for (j = 0; j != k; j++) {
+			if (key[j].key_len == 0) {
+				out[n++] = mb[j];
+				continue;
+			}
+
+			fp = ip_frag_find_sig(tbl, dr, &key[j], sig1[j],
+				sig2[j], tms);
+			if (fp == NULL) {
+				IP_FRAG_MBUF2DR(dr, mb[j]);
+				continue;
+			}
+
+			mb[j] = ip_frag_process(fp, dr, mb[j], ip_ofs[j],
+				ip_len[j], ip_flag[j]);
+			ip_frag_tbl_stat_result(tbl, fp, mb[j]);
+			ip_frag_inuse(tbl, fp);
+
+			if (mb[j] != NULL)
+				out[n++] = mb[j];
+		}
+	}
+
+	*nb_out = n;
+	return i;
+}
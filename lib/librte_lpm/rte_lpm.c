@@ -4,6 +4,7 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -1885,3 +1886,172 @@ rte_lpm_delete_all_v1604(struct rte_lpm *lpm)
 BIND_DEFAULT_SYMBOL(rte_lpm_delete_all, _v1604, 16.04);
 MAP_STATIC_SYMBOL(void rte_lpm_delete_all(struct rte_lpm *lpm),
 		rte_lpm_delete_all_v1604);
+
+/* Version of the format of the files written by rte_lpm_save(). */
+#define LPM_SNAPSHOT_VERSION 1
+
+/* Read as another value on a machine of the other byte order. */
+#define LPM_SNAPSHOT_MAGIC UINT64_C(0x52544c504d344631) /* "RTLPM4F1" */
+
+/* Header of a saved LPM object, followed by its rules and tables. */
+struct lpm_snapshot_header {
+	uint64_t magic;          /**< LPM_SNAPSHOT_MAGIC. */
+	uint32_t version;        /**< LPM_SNAPSHOT_VERSION. */
+	uint32_t entry_size;     /**< Size of a tbl24 or tbl8 entry. */
+	uint32_t rule_size;      /**< Size of a rule. */
+	uint32_t max_rules;      /**< Max number of rules. */
+	uint32_t number_tbl8s;   /**< Number of tbl8s. */
+	uint32_t nb_rules;       /**< Number of rules saved. */
+};
+
+/*
+ * Saves an LPM object to a file
+ */
+int __rte_experimental
+rte_lpm_save(const struct rte_lpm *lpm, const char *filename)
+{
+	struct lpm_snapshot_header hdr;
+	char tmp_name[PATH_MAX];
+	uint32_t i;
+	FILE *f;
+	int ret = 0;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (filename == NULL))
+		return -EINVAL;
+
+	if (snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", filename) >=
+			(int)sizeof(tmp_name))
+		return -ENAMETOOLONG;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = LPM_SNAPSHOT_MAGIC;
+	hdr.version = LPM_SNAPSHOT_VERSION;
+	hdr.entry_size = sizeof(struct rte_lpm_tbl_entry);
+	hdr.rule_size = sizeof(struct rte_lpm_rule);
+	hdr.max_rules = lpm->max_rules;
+	hdr.number_tbl8s = lpm->number_tbl8s;
+
+	/* The rules of all the depths are at the start of the rules table */
+	for (i = 0; i < RTE_LPM_MAX_DEPTH; i++)
+		hdr.nb_rules = RTE_MAX(hdr.nb_rules,
+				lpm->rule_info[i].first_rule +
+				lpm->rule_info[i].used_rules);
+
+	f = fopen(tmp_name, "wb");
+	if (f == NULL)
+		return -errno;
+
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+			fwrite(lpm->rule_info, sizeof(lpm->rule_info), 1, f) != 1 ||
+			fwrite(lpm->rules_tbl, sizeof(lpm->rules_tbl[0]),
+				hdr.nb_rules, f) != hdr.nb_rules ||
+			fwrite(lpm->tbl24, sizeof(lpm->tbl24), 1, f) != 1 ||
+			fwrite(lpm->tbl8, sizeof(lpm->tbl8[0]) *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES,
+				lpm->number_tbl8s, f) != lpm->number_tbl8s)
+		ret = -EIO;
+
+	if (fclose(f) != 0 && ret == 0)
+		ret = -EIO;
+
+	if (ret == 0 && rename(tmp_name, filename) != 0)
+		ret = -errno;
+
+	if (ret != 0) {
+		RTE_LOG(ERR, LPM, "Cannot save LPM %s to %s\n", lpm->name,
+				filename);
+		remove(tmp_name);
+		return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Creates an LPM object from a file
+ */
+struct rte_lpm * __rte_experimental
+rte_lpm_restore(const char *name, int socket_id, const char *filename)
+{
+	struct lpm_snapshot_header hdr;
+	struct rte_lpm_config config;
+	struct rte_lpm *lpm;
+	uint32_t i;
+	FILE *f;
+
+	/* Check user arguments. */
+	if ((name == NULL) || (filename == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	f = fopen(filename, "rb");
+	if (f == NULL) {
+		rte_errno = errno;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+			hdr.magic != LPM_SNAPSHOT_MAGIC ||
+			hdr.version != LPM_SNAPSHOT_VERSION ||
+			hdr.entry_size != sizeof(struct rte_lpm_tbl_entry) ||
+			hdr.rule_size != sizeof(struct rte_lpm_rule) ||
+			hdr.nb_rules > hdr.max_rules) {
+		RTE_LOG(ERR, LPM, "%s is not a saved LPM\n", filename);
+		fclose(f);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	config.max_rules = hdr.max_rules;
+	config.number_tbl8s = hdr.number_tbl8s;
+	config.flags = 0;
+
+	lpm = rte_lpm_create_v1604(name, socket_id, &config);
+	if (lpm == NULL) {
+		fclose(f);
+		return NULL;
+	}
+
+	/* Copy the tables straight to their final location */
+	if (fread(lpm->rule_info, sizeof(lpm->rule_info), 1, f) != 1 ||
+			fread(lpm->rules_tbl, sizeof(lpm->rules_tbl[0]),
+				hdr.nb_rules, f) != hdr.nb_rules ||
+			fread(lpm->tbl24, sizeof(lpm->tbl24), 1, f) != 1 ||
+			fread(lpm->tbl8, sizeof(lpm->tbl8[0]) *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES,
+				lpm->number_tbl8s, f) != lpm->number_tbl8s)
+		goto truncated;
+
+	/* Nothing may follow the tables */
+	if (fgetc(f) != EOF)
+		goto truncated;
+
+	for (i = 0; i < RTE_LPM_MAX_DEPTH; i++)
+		if (lpm->rule_info[i].first_rule +
+				lpm->rule_info[i].used_rules > hdr.nb_rules)
+			goto truncated;
+
+	/* The lookup follows the group indexes without checking them */
+	for (i = 0; i < RTE_LPM_TBL24_NUM_ENTRIES; i++) {
+		const struct rte_lpm_tbl_entry *e = &lpm->tbl24[i];
+
+		if (!e->valid || !e->valid_group)
+			continue;
+		if (e->next_hop >= lpm->number_tbl8s ||
+				!lpm->tbl8[e->next_hop *
+				RTE_LPM_TBL8_GROUP_NUM_ENTRIES].valid_group)
+			goto truncated;
+	}
+
+	fclose(f);
+	return lpm;
+
+truncated:
+	RTE_LOG(ERR, LPM, "%s is truncated or corrupted\n", filename);
+	fclose(f);
+	rte_lpm_free_v1604(lpm);
+	rte_errno = EINVAL;
+	return NULL;
+}
@@ -328,6 +328,53 @@ rte_lpm_delete_all_v20(struct rte_lpm_v20 *lpm);
 void
 rte_lpm_delete_all_v1604(struct rte_lpm *lpm);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Save the rules and the tables of an LPM object to a file, to restore
+ * it later with rte_lpm_restore() without adding the rules again.
+ * The file is written to a temporary file first, and then renamed.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param filename
+ *   Path of the file to create or replace
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments, a negative errno value
+ *   if the file cannot be written
+ */
+int __rte_experimental
+rte_lpm_save(const struct rte_lpm *lpm, const char *filename);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an LPM object from a file written by rte_lpm_save(), with the
+ * configuration, the rules and the tables of the saved object.
+ * The file must have been written by the same version of the library,
+ * on a machine of the same byte order.
+ * The file is rejected if its size does not match its header, or if an
+ * entry of the tables points to a group that does not exist.
+ *
+ * @param name
+ *   LPM object name
+ * @param socket_id
+ *   NUMA socket ID for LPM table memory allocation
+ * @param filename
+ *   Path of the file to read
+ * @return
+ *   Handle to LPM object on success, NULL otherwise with rte_errno set
+ *   to an appropriate values. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter or file content
+ *    - EEXIST - an LPM object with the same name already exists
+ *    - ENOMEM - no appropriate memory area found for the tables
+ *    - errno values of fopen() and fread() if the file cannot be read
+ */
+struct rte_lpm * __rte_experimental
+rte_lpm_restore(const char *name, int socket_id, const char *filename);
+
 /**
  * Lookup an IP into the LPM table.
  *
@@ -3,6 +3,7 @@
  */
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -959,3 +960,163 @@ rte_lpm6_delete_all(struct rte_lpm6 *lpm)
 	/* Delete all rules form the rules table. */
 	memset(lpm->rules_tbl, 0, sizeof(struct rte_lpm6_rule) * lpm->max_rules);
 }
+
+/* Version of the format of the files written by rte_lpm6_save(). */
+#define LPM6_SNAPSHOT_VERSION 1
+
+/* Read as another value on a machine of the other byte order. */
+#define LPM6_SNAPSHOT_MAGIC UINT64_C(0x52544c504d364631) /* "RTLPM6F1" */
+
+/* Header of a saved LPM6 object, followed by its rules and tables. */
+struct lpm6_snapshot_header {
+	uint64_t magic;          /**< LPM6_SNAPSHOT_MAGIC. */
+	uint32_t version;        /**< LPM6_SNAPSHOT_VERSION. */
+	uint32_t entry_size;     /**< Size of a tbl24 or tbl8 entry. */
+	uint32_t rule_size;      /**< Size of a rule. */
+	uint32_t max_rules;      /**< Max number of rules. */
+	uint32_t used_rules;     /**< Number of rules saved. */
+	uint32_t number_tbl8s;   /**< Number of tbl8s. */
+	uint32_t next_tbl8;      /**< Number of tbl8s saved. */
+	uint32_t reserved;
+};
+
+/*
+ * Saves an LPM6 object to a file
+ */
+int __rte_experimental
+rte_lpm6_save(const struct rte_lpm6 *lpm, const char *filename)
+{
+	struct lpm6_snapshot_header hdr;
+	char tmp_name[PATH_MAX];
+	FILE *f;
+	int ret = 0;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (filename == NULL))
+		return -EINVAL;
+
+	if (snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", filename) >=
+			(int)sizeof(tmp_name))
+		return -ENAMETOOLONG;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.magic = LPM6_SNAPSHOT_MAGIC;
+	hdr.version = LPM6_SNAPSHOT_VERSION;
+	hdr.entry_size = sizeof(struct rte_lpm6_tbl_entry);
+	hdr.rule_size = sizeof(struct rte_lpm6_rule);
+	hdr.max_rules = lpm->max_rules;
+	hdr.used_rules = lpm->used_rules;
+	hdr.number_tbl8s = lpm->number_tbl8s;
+	hdr.next_tbl8 = lpm->next_tbl8;
+
+	f = fopen(tmp_name, "wb");
+	if (f == NULL)
+		return -errno;
+
+	/* The tbl8s are allocated in order, the unused ones are not saved */
+	if (fwrite(&hdr, sizeof(hdr), 1, f) != 1 ||
+			fwrite(lpm->rules_tbl, sizeof(lpm->rules_tbl[0]),
+				hdr.used_rules, f) != hdr.used_rules ||
+			fwrite(lpm->tbl24, sizeof(lpm->tbl24), 1, f) != 1 ||
+			fwrite(lpm->tbl8, sizeof(lpm->tbl8[0]) *
+				RTE_LPM6_TBL8_GROUP_NUM_ENTRIES,
+				hdr.next_tbl8, f) != hdr.next_tbl8)
+		ret = -EIO;
+
+	if (fclose(f) != 0 && ret == 0)
+		ret = -EIO;
+
+	if (ret == 0 && rename(tmp_name, filename) != 0)
+		ret = -errno;
+
+	if (ret != 0) {
+		RTE_LOG(ERR, LPM, "Cannot save LPM6 %s to %s\n", lpm->name,
+				filename);
+		remove(tmp_name);
+		return ret;
+	}
+
+	return 0;
+}
+
+/*
+ * Creates an LPM6 object from a file
+ */
+struct rte_lpm6 * __rte_experimental
+rte_lpm6_restore(const char *name, int socket_id, const char *filename)
+{
+	struct lpm6_snapshot_header hdr;
+	struct rte_lpm6_config config;
+	struct rte_lpm6 *lpm;
+	uint32_t i;
+	FILE *f;
+
+	/* Check user arguments. */
+	if ((name == NULL) || (filename == NULL)) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	f = fopen(filename, "rb");
+	if (f == NULL) {
+		rte_errno = errno;
+		return NULL;
+	}
+
+	if (fread(&hdr, sizeof(hdr), 1, f) != 1 ||
+			hdr.magic != LPM6_SNAPSHOT_MAGIC ||
+			hdr.version != LPM6_SNAPSHOT_VERSION ||
+			hdr.entry_size != sizeof(struct rte_lpm6_tbl_entry) ||
+			hdr.rule_size != sizeof(struct rte_lpm6_rule) ||
+			hdr.used_rules > hdr.max_rules ||
+			hdr.next_tbl8 > hdr.number_tbl8s) {
+		RTE_LOG(ERR, LPM, "%s is not a saved LPM6\n", filename);
+		fclose(f);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	config.max_rules = hdr.max_rules;
+	config.number_tbl8s = hdr.number_tbl8s;
+	config.flags = 0;
+
+	lpm = rte_lpm6_create(name, socket_id, &config);
+	if (lpm == NULL) {
+		fclose(f);
+		return NULL;
+	}
+
+	/* Copy the tables straight to their final location */
+	if (fread(lpm->rules_tbl, sizeof(lpm->rules_tbl[0]),
+				hdr.used_rules, f) != hdr.used_rules ||
+			fread(lpm->tbl24, sizeof(lpm->tbl24), 1, f) != 1 ||
+			fread(lpm->tbl8, sizeof(lpm->tbl8[0]) *
+				RTE_LPM6_TBL8_GROUP_NUM_ENTRIES,
+				hdr.next_tbl8, f) != hdr.next_tbl8 ||
+			fgetc(f) != EOF)
+		goto truncated;
+
+	/* The lookup follows the group indexes without checking them */
+	for (i = 0; i < RTE_LPM6_TBL24_NUM_ENTRIES; i++)
+		if (lpm->tbl24[i].valid && lpm->tbl24[i].ext_entry &&
+				lpm->tbl24[i].next_hop >= hdr.next_tbl8)
+			goto truncated;
+
+	for (i = 0; i < hdr.next_tbl8 * RTE_LPM6_TBL8_GROUP_NUM_ENTRIES; i++)
+		if (lpm->tbl8[i].valid && lpm->tbl8[i].ext_entry &&
+				lpm->tbl8[i].next_hop >= hdr.next_tbl8)
+			goto truncated;
+
+	lpm->used_rules = hdr.used_rules;
+	lpm->next_tbl8 = hdr.next_tbl8;
+
+	fclose(f);
+	return lpm;
+
+truncated:
+	RTE_LOG(ERR, LPM, "%s is truncated or corrupted\n", filename);
+	fclose(f);
+	rte_lpm6_free(lpm);
+	rte_errno = EINVAL;
+	return NULL;
+}
@@ -0,0 +1,478 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#ifndef _RTE_LPM64_H_
+#define _RTE_LPM64_H_
+
+/**
+ * @file
+ * RTE Longest Prefix Match (LPM) with 64-bit table entries
+ *
+ * IPv4 LPM table using the same DIR-24-8 algorithm as rte_lpm.h, with
+ * 8-byte table entries so that the next hops can hold up to 56 bits,
+ * e.g. a pointer, and with a deferred reclamation of the tbl8 groups:
+ * the routes can be updated by one writer while the lookups run
+ * concurrently on other lcores without any lock.
+ *
+ * The lookup threads are registered as readers, and report a quiescent
+ * state, with rte_lpm64_quiescent(), each time they do not hold any
+ * reference to the table, e.g. between two bursts of packets. A tbl8
+ * group released by a route deletion is reused only after all the
+ * registered readers reported a quiescent state.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <rte_branch_prediction.h>
+#include <rte_byteorder.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_config.h>
+#include <rte_memory.h>
+#include <rte_vect.h>
+
+#include "rte_lpm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max value of a next hop. */
+#define RTE_LPM64_MAX_NEXT_HOP          ((UINT64_C(1) << 56) - 1)
+
+/** Max number of readers registered to an LPM table. */
+#define RTE_LPM64_MAX_READERS           RTE_MAX_LCORE
+
+/** @internal bitmask with valid and valid_group fields set */
+#define RTE_LPM64_VALID_EXT_ENTRY_BITMASK UINT64_C(0x0300000000000000)
+
+/** Bitmask used to indicate successful lookup */
+#define RTE_LPM64_LOOKUP_SUCCESS        UINT64_C(0x0100000000000000)
+
+#if RTE_BYTE_ORDER == RTE_LITTLE_ENDIAN
+/** @internal Tbl24 and tbl8 entry structure. */
+__extension__
+struct rte_lpm64_tbl_entry {
+	/**
+	 * Stores Next hop (tbl8 or tbl24 when valid_group is not set) or
+	 * a group index pointing to a tbl8 structure (tbl24 only, when
+	 * valid_group is set)
+	 */
+	uint64_t next_hop    :56;
+	uint64_t valid       :1;   /**< Validation flag. */
+	/**
+	 * For tbl24:
+	 *  - valid_group == 0: entry stores a next hop
+	 *  - valid_group == 1: entry stores a group_index pointing to a tbl8
+	 * For tbl8:
+	 *  - valid_group indicates whether the current tbl8 is in use or not
+	 */
+	uint64_t valid_group :1;
+	uint64_t depth       :6; /**< Rule depth. */
+};
+#else
+__extension__
+struct rte_lpm64_tbl_entry {
+	uint64_t depth       :6;
+	uint64_t valid_group :1;
+	uint64_t valid       :1;
+	uint64_t next_hop    :56;
+};
+#endif
+
+/** LPM configuration structure. */
+struct rte_lpm64_config {
+	uint32_t max_rules;      /**< Max number of rules. */
+	uint32_t number_tbl8s;   /**< Number of tbl8s to allocate. */
+	int flags;               /**< This field is currently unused. */
+};
+
+/** @internal Rule structure. */
+struct rte_lpm64_rule {
+	uint32_t ip; /**< Rule IP address. */
+	uint64_t next_hop; /**< Rule next hop. */
+};
+
+/** @internal Quiescent state counter of a reader. */
+struct rte_lpm64_reader {
+	/** Last token seen in a quiescent state, 0 if not registered. */
+	uint64_t token;
+} __rte_cache_aligned;
+
+/** @internal tbl8 group waiting for the readers before being reused. */
+struct rte_lpm64_tbl8_pending {
+	uint64_t token; /**< Token to be seen by all the readers. */
+	uint32_t group_idx; /**< Index of the tbl8 group. */
+};
+
+/** @internal LPM structure. */
+struct rte_lpm64 {
+	/* LPM metadata. */
+	char name[RTE_LPM_NAMESIZE];        /**< Name of the lpm. */
+	uint32_t max_rules; /**< Max. balanced rules per lpm. */
+	uint32_t number_tbl8s; /**< Number of tbl8s. */
+	struct rte_lpm_rule_info rule_info[RTE_LPM_MAX_DEPTH]; /**< Rule info table. */
+
+	/* Deferred reclamation of the tbl8 groups. */
+	uint64_t token; /**< Incremented at each release of a tbl8 group. */
+	uint32_t pending_head; /**< First tbl8 group waiting for the readers. */
+	uint32_t pending_count; /**< Number of tbl8 groups waiting. */
+	struct rte_lpm64_tbl8_pending *pending; /**< Waiting tbl8 groups. */
+	struct rte_lpm64_reader readers[RTE_LPM64_MAX_READERS];
+	/**< Quiescent state counters of the readers. */
+
+	/* LPM Tables. */
+	struct rte_lpm64_tbl_entry tbl24[RTE_LPM_TBL24_NUM_ENTRIES]
+			__rte_cache_aligned; /**< LPM tbl24 table. */
+	struct rte_lpm64_tbl_entry *tbl8; /**< LPM tbl8 table. */
+	struct rte_lpm64_rule *rules_tbl; /**< LPM rules. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an LPM object with 64-bit table entries.
+ *
+ * @param name
+ *   LPM object name
+ * @param socket_id
+ *   NUMA socket ID for LPM table memory allocation
+ * @param config
+ *   Structure containing the configuration
+ * @return
+ *   Handle to LPM object on success, NULL otherwise with rte_errno set
+ *   to an appropriate values. Possible rte_errno values include:
+ *    - EINVAL - invalid parameter passed to function
+ *    - EEXIST - an LPM object with the same name already exists
+ *    - ENOMEM - no appropriate memory area found
+ */
+struct rte_lpm64 * __rte_experimental
+rte_lpm64_create(const char *name, int socket_id,
+		const struct rte_lpm64_config *config);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find an existing LPM object and return a pointer to it.
+ *
+ * @param name
+ *   Name of the lpm object as passed to rte_lpm64_create()
+ * @return
+ *   Pointer to lpm object or NULL if object not found with rte_errno
+ *   set appropriately. Possible rte_errno values include:
+ *    - ENOENT - required entry not available to return.
+ */
+struct rte_lpm64 * __rte_experimental
+rte_lpm64_find_existing(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free an LPM object. The readers must not use it anymore.
+ *
+ * @param lpm
+ *   LPM object handle
+ */
+void __rte_experimental
+rte_lpm64_free(struct rte_lpm64 *lpm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a rule to the LPM table.
+ * This operation may run concurrently with the lookups, but not with
+ * another update of the table.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP of the rule to be added to the LPM table
+ * @param depth
+ *   Depth of the rule to be added to the LPM table
+ * @param next_hop
+ *   Next hop of the rule to be added to the LPM table,
+ *   up to RTE_LPM64_MAX_NEXT_HOP
+ * @return
+ *   0 on success, negative value otherwise:
+ *    - -EINVAL - invalid parameter passed to function
+ *    - -ENOSPC - no room for the rule, or no free tbl8 group, including
+ *      after reclaiming the groups no more used by the readers
+ */
+int __rte_experimental
+rte_lpm64_add(struct rte_lpm64 *lpm, uint32_t ip, uint8_t depth,
+		uint64_t next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Check if a rule is present in the LPM table,
+ * and provide its next hop if it is.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP of the rule to be searched
+ * @param depth
+ *   Depth of the rule to searched
+ * @param next_hop
+ *   Next hop of the rule (valid only if it is found)
+ * @return
+ *   1 if the rule exists, 0 if it does not, a negative value on failure
+ */
+int __rte_experimental
+rte_lpm64_is_rule_present(struct rte_lpm64 *lpm, uint32_t ip, uint8_t depth,
+		uint64_t *next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete a rule from the LPM table.
+ * This operation may run concurrently with the lookups, but not with
+ * another update of the table. A tbl8 group no more used after the
+ * deletion is reused once all the readers reported a quiescent state.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP of the rule to be deleted from the LPM table
+ * @param depth
+ *   Depth of the rule to be deleted from the LPM table
+ * @return
+ *   0 on success, negative value otherwise
+ */
+int __rte_experimental
+rte_lpm64_delete(struct rte_lpm64 *lpm, uint32_t ip, uint8_t depth);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete all rules from the LPM table.
+ * This operation must not run concurrently with the lookups.
+ *
+ * @param lpm
+ *   LPM object handle
+ */
+void __rte_experimental
+rte_lpm64_delete_all(struct rte_lpm64 *lpm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Register a lookup thread as a reader of the LPM table: the tbl8 groups
+ * released by the next deletions are not reused until it reports a
+ * quiescent state. It must be called before the first lookup.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param reader_id
+ *   Reader identifier, below RTE_LPM64_MAX_READERS, e.g. the lcore id
+ * @return
+ *   0 on success, -EINVAL if the parameters are invalid
+ */
+int __rte_experimental
+rte_lpm64_reader_register(struct rte_lpm64 *lpm, unsigned int reader_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Unregister a reader of the LPM table, which does not hold any
+ * reference to it anymore.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param reader_id
+ *   Reader identifier, as passed to rte_lpm64_reader_register()
+ */
+void __rte_experimental
+rte_lpm64_reader_unregister(struct rte_lpm64 *lpm, unsigned int reader_id);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Reclaim the tbl8 groups released by the deletions and seen by all the
+ * registered readers in a quiescent state. It is also done by
+ * rte_lpm64_add() when no tbl8 group is free.
+ * This operation must not run concurrently with an update of the table.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @return
+ *   Number of tbl8 groups still waiting for the readers
+ */
+uint32_t __rte_experimental
+rte_lpm64_reclaim(struct rte_lpm64 *lpm);
+
+/**
+ * Report a quiescent state of a reader: it does not hold any reference
+ * to the tbl8 groups of the LPM table read so far.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param reader_id
+ *   Reader identifier, as passed to rte_lpm64_reader_register()
+ */
+static inline void
+rte_lpm64_quiescent(struct rte_lpm64 *lpm, unsigned int reader_id)
+{
+	uint64_t token = __atomic_load_n(&lpm->token, __ATOMIC_ACQUIRE);
+
+	/* The lookups done before must complete before the store */
+	__atomic_store_n(&lpm->readers[reader_id].token, token,
+			__ATOMIC_RELEASE);
+}
+
+/**
+ * Lookup an IP into the LPM table.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP to be looked up in the LPM table
+ * @param next_hop
+ *   Next hop of the most specific rule found for IP (valid on lookup hit only)
+ * @return
+ *   -EINVAL for incorrect arguments, -ENOENT on lookup miss, 0 on lookup hit
+ */
+static inline int
+rte_lpm64_lookup(const struct rte_lpm64 *lpm, uint32_t ip, uint64_t *next_hop)
+{
+	unsigned tbl24_index = (ip >> 8);
+	uint64_t tbl_entry;
+	const uint64_t *ptbl;
+
+	/* DEBUG: Check user input arguments. */
+	RTE_LPM_RETURN_IF_TRUE(((lpm == NULL) || (next_hop == NULL)), -EINVAL);
+
+	/* Copy tbl24 entry */
+	ptbl = (const uint64_t *)(&lpm->tbl24[tbl24_index]);
+	tbl_entry = __atomic_load_n(ptbl, __ATOMIC_ACQUIRE);
+
+	/* Copy tbl8 entry (only if needed) */
+	if (unlikely((tbl_entry & RTE_LPM64_VALID_EXT_ENTRY_BITMASK) ==
+			RTE_LPM64_VALID_EXT_ENTRY_BITMASK)) {
+
+		unsigned tbl8_index = (uint8_t)ip +
+				((tbl_entry & RTE_LPM64_MAX_NEXT_HOP) *
+						RTE_LPM_TBL8_GROUP_NUM_ENTRIES);
+
+		ptbl = (const uint64_t *)&lpm->tbl8[tbl8_index];
+		tbl_entry = __atomic_load_n(ptbl, __ATOMIC_ACQUIRE);
+	}
+
+	*next_hop = tbl_entry & RTE_LPM64_MAX_NEXT_HOP;
+	return (tbl_entry & RTE_LPM64_LOOKUP_SUCCESS) ? 0 : -ENOENT;
+}
+
+/**
+ * Lookup multiple IP addresses in an LPM table.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ips
+ *   Array of IPs to be looked up in the LPM table
+ * @param next_hops
+ *   Next hop of the most specific rule found for IP (valid on lookup hit
+ *   only), with the bit RTE_LPM64_LOOKUP_SUCCESS set on lookup hit.
+ * @param n
+ *   Number of elements in ips (and next_hops) array to lookup.
+ * @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+static inline int
+rte_lpm64_lookup_bulk(const struct rte_lpm64 *lpm, const uint32_t *ips,
+		uint64_t *next_hops, const unsigned n)
+{
+	unsigned i;
+	unsigned tbl8_index;
+	const uint64_t *ptbl;
+
+	/* DEBUG: Check user input arguments. */
+	RTE_LPM_RETURN_IF_TRUE(((lpm == NULL) || (ips == NULL) ||
+			(next_hops == NULL)), -EINVAL);
+
+	for (i = 0; i < n; i++) {
+		/* Simply copy tbl24 entry to output */
+		ptbl = (const uint64_t *)&lpm->tbl24[ips[i] >> 8];
+		next_hops[i] = __atomic_load_n(ptbl, __ATOMIC_ACQUIRE);
+
+		/* Overwrite output with tbl8 entry if needed */
+		if (unlikely((next_hops[i] &
+				RTE_LPM64_VALID_EXT_ENTRY_BITMASK) ==
+				RTE_LPM64_VALID_EXT_ENTRY_BITMASK)) {
+
+			tbl8_index = (uint8_t)ips[i] +
+					((next_hops[i] & RTE_LPM64_MAX_NEXT_HOP) *
+					 RTE_LPM_TBL8_GROUP_NUM_ENTRIES);
+
+			ptbl = (const uint64_t *)&lpm->tbl8[tbl8_index];
+			next_hops[i] = __atomic_load_n(ptbl, __ATOMIC_ACQUIRE);
+		}
+		next_hops[i] &= RTE_LPM64_LOOKUP_SUCCESS |
+				RTE_LPM64_MAX_NEXT_HOP;
+	}
+	return 0;
+}
+
+/**
+ * Lookup four IP addresses in an LPM table.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   Four IPs to be looked up in the LPM table
+ * @param hop
+ *   Next hop of the most specific rule found for each IP, or the
+ *   default value if the lookup failed.
+ * @param defv
+ *   Default value to populate into corresponding element of hop[] array,
+ *   if lookup would fail.
+ */
+static inline void
+rte_lpm64_lookupx4(const struct rte_lpm64 *lpm, xmm_t ip, uint64_t hop[4],
+	uint64_t defv)
+{
+	rte_xmm_t ips;
+	uint64_t tbl[4];
+	unsigned i;
+
+	ips.x = ip;
+
+	/* Load the four tbl24 entries first, then the tbl8 ones if needed */
+	for (i = 0; i < 4; i++)
+		tbl[i] = __atomic_load_n(
+				(const uint64_t *)&lpm->tbl24[ips.u32[i] >> 8],
+				__ATOMIC_ACQUIRE);
+
+	for (i = 0; i < 4; i++) {
+		if (unlikely((tbl[i] & RTE_LPM64_VALID_EXT_ENTRY_BITMASK) ==
+				RTE_LPM64_VALID_EXT_ENTRY_BITMASK))
+			tbl[i] = __atomic_load_n((const uint64_t *)
+					&lpm->tbl8[(uint8_t)ips.u32[i] +
+					(tbl[i] & RTE_LPM64_MAX_NEXT_HOP) *
+					RTE_LPM_TBL8_GROUP_NUM_ENTRIES],
+					__ATOMIC_ACQUIRE);
+
+		hop[i] = (tbl[i] & RTE_LPM64_LOOKUP_SUCCESS) ?
+				tbl[i] & RTE_LPM64_MAX_NEXT_HOP : defv;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LPM64_H_ */
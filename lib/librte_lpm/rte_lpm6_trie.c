@@ -0,0 +1,598 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/queue.h>
+
+#include <rte_log.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_memory.h>
+#include <rte_malloc.h>
+#include <rte_eal.h>
+#include <rte_eal_memconfig.h>
+#include <rte_errno.h>
+#include <rte_rwlock.h>
+#include <rte_prefetch.h>
+#include <rte_hash.h>
+#include <rte_jhash.h>
+
+#include "rte_lpm6_trie.h"
+
+TAILQ_HEAD(rte_lpm6_trie_list, rte_tailq_entry);
+
+static struct rte_tailq_elem rte_lpm6_trie_tailq = {
+	.name = "RTE_LPM6_TRIE",
+};
+EAL_REGISTER_TAILQ(rte_lpm6_trie_tailq)
+
+#define BYTE_SIZE                 8
+#define TBL24_DEPTH               24
+#define TBL24_BYTES               3
+
+/* Number of addresses walked together by the bulk lookup */
+#define LOOKUP_BULK_BATCH         16
+
+/* Key of the rules hash table. */
+struct lpm6_trie_rule_key {
+	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE]; /**< Rule IP address. */
+	uint32_t depth; /**< Rule depth. */
+};
+
+static inline uint32_t
+next_hop_entry(uint8_t depth, uint32_t next_hop)
+{
+	return RTE_LPM6_TRIE_VALID_ENTRY |
+		((uint32_t)depth << RTE_LPM6_TRIE_DEPTH_SHIFT) |
+		(next_hop << RTE_LPM6_TRIE_NEXT_HOP_SHIFT);
+}
+
+static inline uint8_t
+entry_depth(uint32_t tbl_entry)
+{
+	return (uint8_t)(tbl_entry >> RTE_LPM6_TRIE_DEPTH_SHIFT);
+}
+
+static inline uint32_t *
+entry_group(struct rte_lpm6_trie *lpm, uint32_t tbl_entry)
+{
+	return &lpm->tbl8[(tbl_entry >> RTE_LPM6_TRIE_GROUP_SHIFT) *
+			RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES];
+}
+
+/*
+ * Masks an IPv6 address with the depth, in the rule key.
+ */
+static void
+rule_key_init(struct lpm6_trie_rule_key *key, const uint8_t *ip,
+		uint8_t depth)
+{
+	int i, part_depth = depth;
+
+	memset(key, 0, sizeof(*key));
+	for (i = 0; i < RTE_LPM6_IPV6_ADDR_SIZE && part_depth > 0; i++) {
+		if (part_depth < BYTE_SIZE)
+			key->ip[i] = ip[i] & (uint8_t)~(UINT8_MAX >> part_depth);
+		else
+			key->ip[i] = ip[i];
+		part_depth -= BYTE_SIZE;
+	}
+	key->depth = depth;
+}
+
+/*
+ * Find an existing lpm table and return a pointer to it.
+ */
+struct rte_lpm6_trie * __rte_experimental
+rte_lpm6_trie_find_existing(const char *name)
+{
+	struct rte_lpm6_trie *l = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_lpm6_trie_list *lpm_list;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm6_trie_tailq.head, rte_lpm6_trie_list);
+
+	rte_rwlock_read_lock(RTE_EAL_TAILQ_RWLOCK);
+	TAILQ_FOREACH(te, lpm_list, next) {
+		l = te->data;
+		if (strncmp(name, l->name, RTE_LPM6_NAMESIZE) == 0)
+			break;
+	}
+	rte_rwlock_read_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	if (te == NULL) {
+		rte_errno = ENOENT;
+		return NULL;
+	}
+
+	return l;
+}
+
+/*
+ * Allocates memory for LPM object
+ */
+struct rte_lpm6_trie * __rte_experimental
+rte_lpm6_trie_create(const char *name, int socket_id,
+		const struct rte_lpm6_config *config)
+{
+	char mem_name[RTE_LPM6_NAMESIZE];
+	struct rte_lpm6_trie *lpm = NULL;
+	struct rte_tailq_entry *te;
+	struct rte_hash_parameters rules_params = { 0 };
+	struct rte_hash *rules_tbl;
+	size_t tbl8s_size;
+	struct rte_lpm6_trie_list *lpm_list;
+	uint32_t i;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm6_trie_tailq.head, rte_lpm6_trie_list);
+
+	/* Check user arguments. */
+	if ((name == NULL) || (socket_id < -1) || (config == NULL) ||
+			(config->max_rules == 0) ||
+			config->number_tbl8s > RTE_LPM6_TRIE_TBL8_MAX_NUM_GROUPS) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	tbl8s_size = sizeof(uint32_t) * RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES *
+			(size_t)config->number_tbl8s;
+
+	/* The hash table takes the tailq lock, create it first */
+	snprintf(mem_name, sizeof(mem_name), "LPM6T_RULES_%s", name);
+	rules_params.name = mem_name;
+	rules_params.entries = config->max_rules;
+	rules_params.key_len = sizeof(struct lpm6_trie_rule_key);
+	rules_params.hash_func = rte_jhash;
+	rules_params.socket_id = socket_id;
+	/* Extendable buckets, so that max_rules can always be added */
+	rules_params.extra_flag = RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+
+	rules_tbl = rte_hash_create(&rules_params);
+	if (rules_tbl == NULL) {
+		RTE_LOG(ERR, LPM, "LPM rules hash table creation failed\n");
+		/* rte_errno is set by rte_hash_create() */
+		return NULL;
+	}
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* guarantee there's no existing */
+	TAILQ_FOREACH(te, lpm_list, next) {
+		lpm = te->data;
+		if (strncmp(name, lpm->name, RTE_LPM6_NAMESIZE) == 0)
+			break;
+	}
+
+	if (te != NULL) {
+		lpm = NULL;
+		rte_errno = EEXIST;
+		goto exit;
+	}
+
+	/* allocate tailq entry */
+	te = rte_zmalloc("LPM6_TRIE_TAILQ_ENTRY", sizeof(*te), 0);
+	if (te == NULL) {
+		RTE_LOG(ERR, LPM, "Failed to allocate tailq entry\n");
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	/* Allocate memory to store the LPM data structures. */
+	snprintf(mem_name, sizeof(mem_name), "LPM6T_%s", name);
+	lpm = rte_zmalloc_socket(mem_name, sizeof(*lpm),
+			RTE_CACHE_LINE_SIZE, socket_id);
+	if (lpm == NULL) {
+		RTE_LOG(ERR, LPM, "LPM memory allocation failed\n");
+		rte_free(te);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	lpm->tbl8 = rte_zmalloc_socket(NULL, tbl8s_size,
+			RTE_CACHE_LINE_SIZE, socket_id);
+	lpm->tbl8_free = rte_malloc_socket(NULL,
+			sizeof(uint32_t) * config->number_tbl8s, 0, socket_id);
+	if ((lpm->tbl8 == NULL && tbl8s_size != 0) ||
+			(lpm->tbl8_free == NULL && config->number_tbl8s != 0)) {
+		RTE_LOG(ERR, LPM, "LPM tables memory allocation failed\n");
+		rte_free(lpm->tbl8);
+		rte_free(lpm->tbl8_free);
+		rte_free(lpm);
+		lpm = NULL;
+		rte_free(te);
+		rte_errno = ENOMEM;
+		goto exit;
+	}
+
+	/* Save user arguments. */
+	lpm->rules_tbl = rules_tbl;
+	lpm->max_rules = config->max_rules;
+	lpm->number_tbl8s = config->number_tbl8s;
+	snprintf(lpm->name, sizeof(lpm->name), "%s", name);
+
+	/* The first groups are on top of the stack */
+	for (i = 0; i < lpm->number_tbl8s; i++)
+		lpm->tbl8_free[i] = lpm->number_tbl8s - 1 - i;
+	lpm->free_tbl8s = lpm->number_tbl8s;
+
+	te->data = lpm;
+
+	TAILQ_INSERT_TAIL(lpm_list, te, next);
+
+exit:
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	if (lpm == NULL)
+		rte_hash_free(rules_tbl);
+
+	return lpm;
+}
+
+/*
+ * Deallocates memory for given LPM table.
+ */
+void __rte_experimental
+rte_lpm6_trie_free(struct rte_lpm6_trie *lpm)
+{
+	struct rte_lpm6_trie_list *lpm_list;
+	struct rte_tailq_entry *te;
+
+	/* Check user arguments. */
+	if (lpm == NULL)
+		return;
+
+	lpm_list = RTE_TAILQ_CAST(rte_lpm6_trie_tailq.head, rte_lpm6_trie_list);
+
+	rte_rwlock_write_lock(RTE_EAL_TAILQ_RWLOCK);
+
+	/* find our tailq entry */
+	TAILQ_FOREACH(te, lpm_list, next) {
+		if (te->data == (void *) lpm)
+			break;
+	}
+	if (te != NULL)
+		TAILQ_REMOVE(lpm_list, te, next);
+
+	rte_rwlock_write_unlock(RTE_EAL_TAILQ_RWLOCK);
+
+	rte_hash_free(lpm->rules_tbl);
+	rte_free(lpm->tbl8_free);
+	rte_free(lpm->tbl8);
+	rte_free(lpm);
+	rte_free(te);
+}
+
+/*
+ * Takes a free tbl8 group and fills it with the entry it is replacing,
+ * so that the lookups keep the same result once it is linked.
+ */
+static int32_t
+tbl8_alloc(struct rte_lpm6_trie *lpm, uint32_t tbl_entry)
+{
+	uint32_t group_idx, *group;
+	unsigned int i;
+
+	if (lpm->free_tbl8s == 0)
+		return -ENOSPC;
+
+	group_idx = lpm->tbl8_free[--lpm->free_tbl8s];
+	group = &lpm->tbl8[group_idx * RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES];
+	for (i = 0; i < RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES; i++)
+		group[i] = tbl_entry;
+
+	return group_idx;
+}
+
+static void
+tbl8_free(struct rte_lpm6_trie *lpm, uint32_t tbl_entry)
+{
+	lpm->tbl8_free[lpm->free_tbl8s++] =
+			tbl_entry >> RTE_LPM6_TRIE_GROUP_SHIFT;
+}
+
+/*
+ * Returns 1 if all the entries of a group hold the same next hop and
+ * depth, so that the group can be replaced by one entry of its parent.
+ */
+static int
+tbl8_is_uniform(const uint32_t *group)
+{
+	unsigned int i;
+
+	if (group[0] & RTE_LPM6_TRIE_EXT_ENTRY)
+		return 0;
+
+	for (i = 1; i < RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES; i++)
+		if (group[i] != group[0])
+			return 0;
+
+	return 1;
+}
+
+/*
+ * Writes the new entry over the entries of a range, and of the groups
+ * they link to, unless they hold a more specific rule.
+ */
+static void
+fill_range(struct rte_lpm6_trie *lpm, uint32_t *tbl, uint32_t first,
+		uint32_t count, uint8_t depth, uint32_t new_entry)
+{
+	uint32_t i, tbl_entry;
+
+	for (i = first; i < first + count; i++) {
+		tbl_entry = tbl[i];
+		if (tbl_entry & RTE_LPM6_TRIE_EXT_ENTRY)
+			fill_range(lpm, entry_group(lpm, tbl_entry), 0,
+					RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES,
+					depth, new_entry);
+		else if (entry_depth(tbl_entry) <= depth)
+			tbl[i] = new_entry;
+	}
+}
+
+/*
+ * Replaces the entries of the prefix ip/depth by new_entry, where no
+ * more specific rule is set. The entries of a prefix always have a depth
+ * greater or equal to the prefix depth, so this is used both to add a
+ * rule and to replace a deleted one with its parent rule.
+ */
+static int
+update_prefix(struct rte_lpm6_trie *lpm, const uint8_t *ip, uint8_t depth,
+		uint32_t new_entry)
+{
+	uint32_t *path_tbl[RTE_LPM6_IPV6_ADDR_SIZE];
+	uint32_t path_idx[RTE_LPM6_IPV6_ADDR_SIZE];
+	uint32_t *tbl = lpm->tbl24;
+	uint32_t idx, tbl_entry;
+	unsigned int level = 0, end = TBL24_DEPTH;
+	int32_t group_idx;
+	int ret = 0;
+
+	idx = (ip[0] << 16) | (ip[1] << 8) | ip[2];
+
+	/* Walk down to the table holding the last bits of the prefix */
+	while (depth > end) {
+		tbl_entry = tbl[idx];
+		if (!(tbl_entry & RTE_LPM6_TRIE_EXT_ENTRY)) {
+			group_idx = tbl8_alloc(lpm, tbl_entry);
+			if (group_idx < 0) {
+				ret = group_idx;
+				break;
+			}
+			tbl_entry = RTE_LPM6_TRIE_EXT_ENTRY |
+				((uint32_t)group_idx << RTE_LPM6_TRIE_GROUP_SHIFT);
+			/* The group must be filled before being linked */
+			rte_smp_wmb();
+			tbl[idx] = tbl_entry;
+		}
+
+		path_tbl[level] = tbl;
+		path_idx[level] = idx;
+		tbl = entry_group(lpm, tbl_entry);
+		idx = ip[TBL24_BYTES + level];
+		level++;
+		end += BYTE_SIZE;
+	}
+
+	if (ret == 0)
+		fill_range(lpm, tbl, idx, 1 << (end - depth), depth, new_entry);
+
+	/*
+	 * Merge back the groups left uniform, from the deepest one:
+	 * the groups of a deleted rule, or the ones just allocated when
+	 * running out of groups.
+	 */
+	while (level > 0 && tbl8_is_uniform(tbl)) {
+		level--;
+		tbl_entry = path_tbl[level][path_idx[level]];
+		path_tbl[level][path_idx[level]] = tbl[0];
+		tbl8_free(lpm, tbl_entry);
+		tbl = path_tbl[level];
+	}
+
+	return ret;
+}
+
+/*
+ * Add a route
+ */
+int __rte_experimental
+rte_lpm6_trie_add(struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint8_t depth, uint32_t next_hop)
+{
+	struct lpm6_trie_rule_key key;
+	void *old_data;
+	int ret, exists;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (ip == NULL) || (depth < 1) ||
+			(depth > RTE_LPM6_MAX_DEPTH) ||
+			(next_hop > RTE_LPM6_TRIE_MAX_NEXT_HOP))
+		return -EINVAL;
+
+	rule_key_init(&key, ip, depth);
+
+	exists = rte_hash_lookup_data(lpm->rules_tbl, &key, &old_data) >= 0;
+
+	ret = rte_hash_add_key_data(lpm->rules_tbl, &key,
+			(void *)(uintptr_t)next_hop);
+	if (ret < 0)
+		return ret;
+
+	/*
+	 * Setting the rule may need new groups, even for an existing rule
+	 * whose groups were merged with the ones of its neighbours. The trie
+	 * is left unchanged on failure, so is the rules table: an existing
+	 * rule gets back its next hop.
+	 */
+	ret = update_prefix(lpm, key.ip, depth, next_hop_entry(depth, next_hop));
+	if (ret < 0) {
+		if (exists)
+			rte_hash_add_key_data(lpm->rules_tbl, &key, old_data);
+		else
+			rte_hash_del_key(lpm->rules_tbl, &key);
+	}
+
+	return ret;
+}
+
+/*
+ * Look for a rule in the LPM trie
+ */
+int __rte_experimental
+rte_lpm6_trie_is_rule_present(struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint8_t depth, uint32_t *next_hop)
+{
+	struct lpm6_trie_rule_key key;
+	void *data;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (ip == NULL) || (next_hop == NULL) ||
+			(depth < 1) || (depth > RTE_LPM6_MAX_DEPTH))
+		return -EINVAL;
+
+	rule_key_init(&key, ip, depth);
+
+	if (rte_hash_lookup_data(lpm->rules_tbl, &key, &data) < 0)
+		return 0;
+
+	*next_hop = (uint32_t)(uintptr_t)data;
+	return 1;
+}
+
+/*
+ * Deletes a rule
+ */
+int __rte_experimental
+rte_lpm6_trie_delete(struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint8_t depth)
+{
+	struct lpm6_trie_rule_key key, parent_key;
+	uint32_t parent_entry = 0;
+	uint8_t parent_depth;
+	void *data;
+	int ret;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (ip == NULL) || (depth < 1) ||
+			(depth > RTE_LPM6_MAX_DEPTH))
+		return -EINVAL;
+
+	rule_key_init(&key, ip, depth);
+
+	if (rte_hash_lookup(lpm->rules_tbl, &key) < 0)
+		return -ENOENT;
+
+	/* The entries of the rule now go to the most specific parent rule */
+	for (parent_depth = depth - 1; parent_depth > 0; parent_depth--) {
+		rule_key_init(&parent_key, key.ip, parent_depth);
+		if (rte_hash_lookup_data(lpm->rules_tbl, &parent_key,
+				&data) >= 0) {
+			parent_entry = next_hop_entry(parent_depth,
+					(uint32_t)(uintptr_t)data);
+			break;
+		}
+	}
+
+	/*
+	 * The groups of the rule may have been merged, if it was set over
+	 * a whole group with the same next hop as its neighbours, and
+	 * splitting them again may fail: the rule is only removed from the
+	 * rules table once the trie no longer routes it.
+	 */
+	ret = update_prefix(lpm, key.ip, depth, parent_entry);
+	if (ret < 0)
+		return ret;
+
+	rte_hash_del_key(lpm->rules_tbl, &key);
+	return 0;
+}
+
+/*
+ * Delete all rules from the LPM table.
+ */
+void __rte_experimental
+rte_lpm6_trie_delete_all(struct rte_lpm6_trie *lpm)
+{
+	uint32_t i;
+
+	rte_hash_reset(lpm->rules_tbl);
+
+	memset(lpm->tbl24, 0, sizeof(lpm->tbl24));
+
+	for (i = 0; i < lpm->number_tbl8s; i++)
+		lpm->tbl8_free[i] = lpm->number_tbl8s - 1 - i;
+	lpm->free_tbl8s = lpm->number_tbl8s;
+}
+
+/*
+ * Looks up a group of IP addresses, one level of all the addresses of
+ * a batch at a time: the accesses to the entries of a level are
+ * independent and overlap, instead of waiting for each other.
+ */
+int __rte_experimental
+rte_lpm6_trie_lookup_bulk(const struct rte_lpm6_trie *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n)
+{
+	const uint32_t *entries[LOOKUP_BULK_BATCH];
+	uint32_t tbl_entry[LOOKUP_BULK_BATCH];
+	uint32_t pending;
+	unsigned int i, j, num, level;
+
+	/* Check user arguments. */
+	if ((lpm == NULL) || (ips == NULL) || (next_hops == NULL))
+		return -EINVAL;
+
+	for (i = 0; i < n; i += num) {
+		num = RTE_MIN(n - i, (unsigned int)LOOKUP_BULK_BATCH);
+
+		for (j = 0; j < num; j++) {
+			entries[j] = &lpm->tbl24[(ips[i + j][0] << 16) |
+					(ips[i + j][1] << 8) | ips[i + j][2]];
+			rte_prefetch0(entries[j]);
+		}
+
+		pending = 0;
+		for (j = 0; j < num; j++) {
+			tbl_entry[j] = *entries[j];
+			if (tbl_entry[j] & RTE_LPM6_TRIE_EXT_ENTRY)
+				pending |= 1 << j;
+		}
+
+		for (level = TBL24_BYTES; pending != 0; level++) {
+			uint32_t walk = pending;
+
+			while (walk != 0) {
+				j = __builtin_ctz(walk);
+				walk &= walk - 1;
+				entries[j] = &lpm->tbl8[(tbl_entry[j] >>
+					RTE_LPM6_TRIE_GROUP_SHIFT) *
+					RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES +
+					ips[i + j][level]];
+				rte_prefetch0(entries[j]);
+			}
+
+			walk = pending;
+			while (walk != 0) {
+				j = __builtin_ctz(walk);
+				walk &= walk - 1;
+				tbl_entry[j] = *entries[j];
+				if (!(tbl_entry[j] & RTE_LPM6_TRIE_EXT_ENTRY))
+					pending &= ~(1 << j);
+			}
+		}
+
+		for (j = 0; j < num; j++)
+			next_hops[i + j] =
+				(tbl_entry[j] & RTE_LPM6_TRIE_VALID_ENTRY) ?
+				(int32_t)(tbl_entry[j] >>
+					RTE_LPM6_TRIE_NEXT_HOP_SHIFT) : -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,281 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#ifndef _RTE_LPM6_TRIE_H_
+#define _RTE_LPM6_TRIE_H_
+
+/**
+ * @file
+ * RTE Longest Prefix Match (LPM) for IPv6, multibit trie
+ *
+ * Alternative to rte_lpm6.h for large IPv6 routing tables: a first
+ * stride of 24 bits, as in DIR-24-8, followed by tbl8 groups of 8 bits.
+ * Unlike rte_lpm6, the prefixes are pushed to the leaves, so a table
+ * entry is either a next hop or a link to the next group, and a group
+ * left with 256 identical next hops after a deletion is merged back in
+ * its parent entry. The rules are kept in a hash table, which makes the
+ * additions and deletions independent of the number of rules.
+ *
+ * The bulk lookup walks the levels of a batch of addresses together,
+ * prefetching the entries of the next level of all the addresses before
+ * reading them, so that the memory accesses overlap.
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ */
+
+#include <errno.h>
+#include <stdint.h>
+#include <rte_branch_prediction.h>
+#include <rte_common.h>
+#include <rte_compat.h>
+#include <rte_memory.h>
+
+#include "rte_lpm.h"
+#include "rte_lpm6.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Max value of a next hop. */
+#define RTE_LPM6_TRIE_MAX_NEXT_HOP            ((1 << 22) - 1)
+
+/** Max number of tbl8 groups. */
+#define RTE_LPM6_TRIE_TBL8_MAX_NUM_GROUPS     (1 << 24)
+
+/** @internal Number of entries of the first stride. */
+#define RTE_LPM6_TRIE_TBL24_NUM_ENTRIES       (1 << 24)
+
+/** @internal Number of entries of a tbl8 group. */
+#define RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES  256
+
+/** @internal Entry links to a tbl8 group. */
+#define RTE_LPM6_TRIE_EXT_ENTRY               0x1
+
+/** @internal Entry holds the next hop of a rule. */
+#define RTE_LPM6_TRIE_VALID_ENTRY             0x2
+
+/** @internal Position of the group index in a linking entry. */
+#define RTE_LPM6_TRIE_GROUP_SHIFT             1
+
+/** @internal Position of the rule depth in a next hop entry. */
+#define RTE_LPM6_TRIE_DEPTH_SHIFT             2
+
+/** @internal Position of the next hop in a next hop entry. */
+#define RTE_LPM6_TRIE_NEXT_HOP_SHIFT          10
+
+/** @internal LPM6 trie structure. */
+struct rte_lpm6_trie {
+	/* LPM metadata. */
+	char name[RTE_LPM6_NAMESIZE];    /**< Name of the lpm. */
+	uint32_t max_rules;              /**< Max number of rules. */
+	uint32_t number_tbl8s;           /**< Number of tbl8s. */
+	uint32_t free_tbl8s;             /**< Number of free tbl8s. */
+	uint32_t *tbl8_free;             /**< Stack of the free tbl8s. */
+	struct rte_hash *rules_tbl;      /**< LPM rules. */
+
+	/* LPM Tables. */
+	uint32_t *tbl8;                  /**< LPM tbl8 groups. */
+	uint32_t tbl24[RTE_LPM6_TRIE_TBL24_NUM_ENTRIES]
+			__rte_cache_aligned; /**< LPM tbl24 table. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Create an LPM6 trie object.
+ *
+ * @param name
+ *   LPM object name
+ * @param socket_id
+ *   NUMA socket ID for LPM table memory allocation
+ * @param config
+ *   Structure containing the configuration
+ * @return
+ *   Handle to LPM object on success, NULL otherwise with rte_errno set
+ *   to an appropriate values. Possible rte_errno values include:
+ *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
+ *    - E_RTE_SECONDARY - function was called from a secondary process instance
+ *    - EINVAL - invalid parameter passed to function
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+struct rte_lpm6_trie * __rte_experimental
+rte_lpm6_trie_create(const char *name, int socket_id,
+		const struct rte_lpm6_config *config);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Find an existing LPM6 trie object and return a pointer to it.
+ *
+ * @param name
+ *   Name of the lpm object as passed to rte_lpm6_trie_create()
+ * @return
+ *   Pointer to lpm object or NULL if object not found with rte_errno
+ *   set appropriately. Possible rte_errno values include:
+ *    - ENOENT - required entry not available to return.
+ */
+struct rte_lpm6_trie * __rte_experimental
+rte_lpm6_trie_find_existing(const char *name);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Free an LPM6 trie object.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @return
+ *   None
+ */
+void __rte_experimental
+rte_lpm6_trie_free(struct rte_lpm6_trie *lpm);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Add a rule to the LPM6 trie, or update the next hop of an existing one.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP of the rule to be added to the LPM table
+ * @param depth
+ *   Depth of the rule to be added to the LPM table
+ * @param next_hop
+ *   Next hop of the rule to be added to the LPM table
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments, -ENOSPC when the rules
+ *   or the tbl8 groups are exhausted, in which case an existing rule keeps
+ *   its next hop
+ */
+int __rte_experimental
+rte_lpm6_trie_add(struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint8_t depth, uint32_t next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Check if a rule is present in the LPM6 trie,
+ * and provide its next hop if it is.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP of the rule to be searched
+ * @param depth
+ *   Depth of the rule to searched
+ * @param next_hop
+ *   Next hop of the rule (valid only if it is found)
+ * @return
+ *   1 if the rule exists, 0 if it does not, a negative value on failure
+ */
+int __rte_experimental
+rte_lpm6_trie_is_rule_present(struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint8_t depth, uint32_t *next_hop);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete a rule from the LPM6 trie.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP of the rule to be deleted from the LPM table
+ * @param depth
+ *   Depth of the rule to be deleted from the LPM table
+ * @return
+ *   0 on success, -EINVAL for incorrect arguments, -ENOENT if the rule
+ *   does not exist, -ENOSPC if no tbl8 group is left to split the entry
+ *   the rule was merged into, in which case the rule is kept
+ */
+int __rte_experimental
+rte_lpm6_trie_delete(struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint8_t depth);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Delete all rules from the LPM6 trie.
+ *
+ * @param lpm
+ *   LPM object handle
+ */
+void __rte_experimental
+rte_lpm6_trie_delete_all(struct rte_lpm6_trie *lpm);
+
+/**
+ * Lookup an IP into the LPM6 trie.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ip
+ *   IP to be looked up in the LPM table
+ * @param next_hop
+ *   Next hop of the most specific rule found for IP (valid on lookup hit only)
+ * @return
+ *   -EINVAL for incorrect arguments, -ENOENT on lookup miss, 0 on lookup hit
+ */
+static inline int
+rte_lpm6_trie_lookup(const struct rte_lpm6_trie *lpm, const uint8_t *ip,
+		uint32_t *next_hop)
+{
+	uint32_t tbl_entry;
+	unsigned int i;
+
+	/* DEBUG: Check user input arguments. */
+	RTE_LPM_RETURN_IF_TRUE(((lpm == NULL) || (ip == NULL) ||
+			(next_hop == NULL)), -EINVAL);
+
+	tbl_entry = lpm->tbl24[(ip[0] << 16) | (ip[1] << 8) | ip[2]];
+
+	/* One byte of the address per tbl8 level */
+	for (i = 3; unlikely(tbl_entry & RTE_LPM6_TRIE_EXT_ENTRY); i++)
+		tbl_entry = lpm->tbl8[(tbl_entry >> RTE_LPM6_TRIE_GROUP_SHIFT) *
+				RTE_LPM6_TRIE_TBL8_GROUP_NUM_ENTRIES + ip[i]];
+
+	*next_hop = tbl_entry >> RTE_LPM6_TRIE_NEXT_HOP_SHIFT;
+	return (tbl_entry & RTE_LPM6_TRIE_VALID_ENTRY) ? 0 : -ENOENT;
+}
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Lookup multiple IP addresses in the LPM6 trie.
+ *
+ * @param lpm
+ *   LPM object handle
+ * @param ips
+ *   Array of IPs to be looked up in the LPM table
+ * @param next_hops
+ *   Next hop of the most specific rule found for IP (valid on lookup hit only).
+ *   This is an array of four byte values. The next hop will be stored on
+ *   each position on success; otherwise the position will be set to -1.
+ * @param n
+ *   Number of elements in ips (and next_hops) array to lookup.
+ * @return
+ *   -EINVAL for incorrect arguments, otherwise 0
+ */
+int __rte_experimental
+rte_lpm6_trie_lookup_bulk(const struct rte_lpm6_trie *lpm,
+		uint8_t ips[][RTE_LPM6_IPV6_ADDR_SIZE],
+		int32_t *next_hops, unsigned int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_LPM6_TRIE_H_ */
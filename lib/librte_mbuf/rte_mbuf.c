@@ -50,6 +50,7 @@ rte_pktmbuf_pool_init(struct rte_mempool *mp, void *opaque_arg)
 	user_mbp_priv = opaque_arg;
 	if (user_mbp_priv == NULL) {
 		default_mbp_priv.mbuf_priv_size = 0;
+		default_mbp_priv.flags = 0;
 		if (mp->elt_size > sizeof(struct rte_mbuf))
 			roomsz = mp->elt_size - sizeof(struct rte_mbuf);
 		else
@@ -59,8 +60,12 @@ rte_pktmbuf_pool_init(struct rte_mempool *mp, void *opaque_arg)
 	}
 
 	RTE_ASSERT(mp->elt_size >= sizeof(struct rte_mbuf) +
-		user_mbp_priv->mbuf_data_room_size +
+		((user_mbp_priv->flags & RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF) ?
+			sizeof(struct rte_mbuf_ext_shared_info) :
+			user_mbp_priv->mbuf_data_room_size) +
 		user_mbp_priv->mbuf_priv_size);
+	RTE_ASSERT((user_mbp_priv->flags &
+		~RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF) == 0);
 
 	mbp_priv = rte_mempool_get_priv(mp);
 	memcpy(mbp_priv, user_mbp_priv, sizeof(*mbp_priv));
@@ -128,6 +133,7 @@ rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
 		(unsigned)data_room_size;
 	mbp_priv.mbuf_data_room_size = data_room_size;
 	mbp_priv.mbuf_priv_size = priv_size;
+	mbp_priv.flags = 0;
 
 	mp = rte_mempool_create_empty(name, n, elt_size, cache_size,
 		 sizeof(struct rte_pktmbuf_pool_private), socket_id, 0);
@@ -157,6 +163,178 @@ rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
 	return mp;
 }
 
+/* position in the external areas while initializing a pinned pool */
+struct rte_pktmbuf_extmem_init_ctx {
+	const struct rte_pktmbuf_extmem *ext_mem; /* external areas */
+	unsigned int ext_num;	/* number of external areas */
+	unsigned int ext;	/* current area */
+	size_t off;		/* offset of the next buffer in current area */
+};
+
+/*
+ * Free callback of the shared info of a pinned external buffer, called
+ * when the last mbuf attached to the buffer is detached, after the mbuf
+ * owning the buffer was freed: return this mbuf to its pool.
+ */
+static void
+rte_pktmbuf_free_pinned_extmem(void *addr, void *opaque)
+{
+	struct rte_mbuf *m = opaque;
+
+	RTE_SET_USED(addr);
+	RTE_ASSERT(RTE_MBUF_HAS_EXTBUF(m));
+	RTE_ASSERT(RTE_MBUF_HAS_PINNED_EXTBUF(m));
+	RTE_ASSERT(m->shinfo->fcb_opaque == m);
+
+	rte_mbuf_ext_refcnt_set(m->shinfo, 1);
+	m->ol_flags = EXT_ATTACHED_MBUF;
+	if (m->next != NULL) {
+		m->next = NULL;
+		m->nb_segs = 1;
+	}
+	rte_mbuf_refcnt_set(m, 1);
+	rte_mbuf_raw_free(m);
+}
+
+/*
+ * pktmbuf constructor of a pool with pinned external buffers, given as a
+ * callback function to rte_mempool_obj_iter(). Attach the mbuf to the
+ * next buffer of the external areas.
+ */
+static void
+rte_pktmbuf_init_extmem(struct rte_mempool *mp, void *opaque_arg,
+	void *_m, __attribute__((unused)) unsigned int i)
+{
+	struct rte_pktmbuf_extmem_init_ctx *ctx = opaque_arg;
+	const struct rte_pktmbuf_extmem *ext_mem;
+	struct rte_mbuf_ext_shared_info *shinfo;
+	struct rte_mbuf *m = _m;
+	uint32_t mbuf_size, priv_size;
+
+	priv_size = rte_pktmbuf_priv_size(mp);
+	mbuf_size = sizeof(struct rte_mbuf) + priv_size;
+
+	RTE_ASSERT(RTE_ALIGN(priv_size, RTE_MBUF_PRIV_ALIGN) == priv_size);
+	RTE_ASSERT(mp->elt_size >= mbuf_size + sizeof(*shinfo));
+
+	memset(m, 0, mbuf_size);
+	m->priv_size = priv_size;
+
+	/* move to the next area when the current one is exhausted */
+	ext_mem = &ctx->ext_mem[ctx->ext];
+	while (ctx->off + ext_mem->elt_size > ext_mem->buf_len) {
+		ctx->off = 0;
+		ctx->ext++;
+		/* the number of buffers was checked at pool creation */
+		RTE_ASSERT(ctx->ext < ctx->ext_num);
+		ext_mem = &ctx->ext_mem[ctx->ext];
+	}
+	m->buf_addr = RTE_PTR_ADD(ext_mem->buf_ptr, ctx->off);
+	m->buf_iova = ext_mem->buf_iova + ctx->off;
+	m->buf_len = ext_mem->elt_size;
+	ctx->off += ext_mem->elt_size;
+
+	/* keep some headroom between start of buffer and data */
+	m->data_off = RTE_MIN(RTE_PKTMBUF_HEADROOM, (uint16_t)m->buf_len);
+
+	/* init some constant fields */
+	m->pool = mp;
+	m->nb_segs = 1;
+	m->port = MBUF_INVALID_PORT;
+	m->ol_flags = EXT_ATTACHED_MBUF;
+	rte_mbuf_refcnt_set(m, 1);
+	m->next = NULL;
+
+	/* the shared info is stored after the private area */
+	shinfo = RTE_PTR_ADD(m, mbuf_size);
+	m->shinfo = shinfo;
+	shinfo->free_cb = rte_pktmbuf_free_pinned_extmem;
+	shinfo->fcb_opaque = m;
+	rte_mbuf_ext_refcnt_set(shinfo, 1);
+}
+
+/* Helper to create a mbuf pool with pinned external buffers */
+struct rte_mempool * __rte_experimental
+rte_pktmbuf_pool_create_extbuf(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
+	int socket_id, const struct rte_pktmbuf_extmem *ext_mem,
+	unsigned int ext_num)
+{
+	struct rte_mempool *mp;
+	struct rte_pktmbuf_pool_private mbp_priv;
+	struct rte_pktmbuf_extmem_init_ctx init_ctx;
+	const char *mp_ops_name;
+	unsigned int elt_size;
+	unsigned int i, n_bufs;
+	int ret;
+
+	if (RTE_ALIGN(priv_size, RTE_MBUF_PRIV_ALIGN) != priv_size) {
+		RTE_LOG(ERR, MBUF, "mbuf priv_size=%u is not aligned\n",
+			priv_size);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	/* check the external areas provide enough buffers */
+	if (ext_mem == NULL || ext_num == 0) {
+		rte_errno = EINVAL;
+		return NULL;
+	}
+	n_bufs = 0;
+	for (i = 0; i < ext_num; i++) {
+		if (ext_mem[i].buf_ptr == NULL ||
+				ext_mem[i].elt_size < data_room_size ||
+				ext_mem[i].elt_size == 0) {
+			RTE_LOG(ERR, MBUF, "invalid external area %u\n", i);
+			rte_errno = EINVAL;
+			return NULL;
+		}
+		n_bufs += ext_mem[i].buf_len / ext_mem[i].elt_size;
+	}
+	if (n_bufs < n) {
+		RTE_LOG(ERR, MBUF,
+			"external areas too small for %u mbufs\n", n);
+		rte_errno = EINVAL;
+		return NULL;
+	}
+
+	memset(&init_ctx, 0, sizeof(init_ctx));
+	init_ctx.ext_mem = ext_mem;
+	init_ctx.ext_num = ext_num;
+
+	elt_size = sizeof(struct rte_mbuf) + (unsigned int)priv_size +
+		sizeof(struct rte_mbuf_ext_shared_info);
+	mbp_priv.mbuf_data_room_size = data_room_size;
+	mbp_priv.mbuf_priv_size = priv_size;
+	mbp_priv.flags = RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF;
+
+	mp = rte_mempool_create_empty(name, n, elt_size, cache_size,
+		 sizeof(struct rte_pktmbuf_pool_private), socket_id, 0);
+	if (mp == NULL)
+		return NULL;
+
+	mp_ops_name = rte_mbuf_best_mempool_ops();
+	ret = rte_mempool_set_ops_byname(mp, mp_ops_name, NULL);
+	if (ret != 0) {
+		RTE_LOG(ERR, MBUF, "error setting mempool handler\n");
+		rte_mempool_free(mp);
+		rte_errno = -ret;
+		return NULL;
+	}
+	rte_pktmbuf_pool_init(mp, &mbp_priv);
+
+	ret = rte_mempool_populate_default(mp);
+	if (ret < 0) {
+		rte_mempool_free(mp);
+		rte_errno = -ret;
+		return NULL;
+	}
+
+	rte_mempool_obj_iter(mp, rte_pktmbuf_init_extmem, &init_ctx);
+
+	return mp;
+}
+
 /* helper to create a mbuf pool */
 struct rte_mempool *
 rte_pktmbuf_pool_create(const char *name, unsigned int n,
@@ -276,6 +454,64 @@ const void *__rte_pktmbuf_read(const struct rte_mbuf *m, uint32_t off,
 	return buf;
 }
 
+/* max number of segments held before a put to their mempool */
+#define MBUF_FREE_PENDING_SZ 64
+
+/*
+ * Unlink a segment, and add it to the pending segments if it can be freed.
+ * The pending segments are put in their mempool when the array is full or
+ * when the segment comes from another mempool.
+ */
+static __rte_always_inline void
+mbuf_free_seg_via_array(struct rte_mbuf *m, struct rte_mbuf **pending,
+	unsigned int *nb_pending)
+{
+	m = rte_pktmbuf_prefree_seg(m);
+	if (unlikely(m == NULL))
+		return;
+
+	RTE_ASSERT(!RTE_MBUF_CLONED(m) &&
+		(!RTE_MBUF_HAS_EXTBUF(m) || RTE_MBUF_HAS_PINNED_EXTBUF(m)));
+	RTE_ASSERT(m->next == NULL);
+	RTE_ASSERT(m->nb_segs == 1);
+	__rte_mbuf_sanity_check(m, 0);
+
+	if (*nb_pending == MBUF_FREE_PENDING_SZ ||
+			(*nb_pending != 0 && m->pool != pending[0]->pool)) {
+		rte_mempool_put_bulk(pending[0]->pool, (void **)pending,
+			*nb_pending);
+		*nb_pending = 0;
+	}
+
+	pending[(*nb_pending)++] = m;
+}
+
+/* free a bulk of packet mbufs, putting segments in their pool by batches */
+void __rte_experimental
+rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count)
+{
+	struct rte_mbuf *m, *m_next, *pending[MBUF_FREE_PENDING_SZ];
+	unsigned int idx, nb_pending = 0;
+
+	for (idx = 0; idx < count; idx++) {
+		m = mbufs[idx];
+		if (unlikely(m == NULL))
+			continue;
+
+		__rte_mbuf_sanity_check(m, 1);
+
+		do {
+			m_next = m->next;
+			mbuf_free_seg_via_array(m, pending, &nb_pending);
+			m = m_next;
+		} while (m != NULL);
+	}
+
+	if (nb_pending != 0)
+		rte_mempool_put_bulk(pending[0]->pool, (void **)pending,
+			nb_pending);
+}
+
 /*
  * Get the name of a RX offload flag. Must be kept synchronized with flag
  * definitions in rte_mbuf.h.
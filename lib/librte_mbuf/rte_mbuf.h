@@ -41,6 +41,9 @@
 #include <rte_prefetch.h>
 #include <rte_branch_prediction.h>
 #include <rte_mbuf_ptype.h>
+#ifdef RTE_ARCH_X86_64
+#include <emmintrin.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -651,6 +654,7 @@ rte_mbuf_prefetch_part2(struct rte_mbuf *m)
 
 
 static inline uint16_t rte_pktmbuf_priv_size(struct rte_mempool *mp);
+static inline uint32_t rte_pktmbuf_priv_flags(struct rte_mempool *mp);
 
 /**
  * Return the IO address of the beginning of the mbuf data
@@ -750,6 +754,16 @@ rte_mbuf_to_baddr(struct rte_mbuf *md)
  */
 #define RTE_MBUF_HAS_EXTBUF(mb) ((mb)->ol_flags & EXT_ATTACHED_MBUF)
 
+/**
+ * Returns TRUE if given mbuf has a pinned external buffer, or FALSE
+ * otherwise. The pinned external buffer is allocated at pool creation
+ * time and should not be freed on mbuf freeing.
+ *
+ * External buffer is a user-provided anonymous buffer.
+ */
+#define RTE_MBUF_HAS_PINNED_EXTBUF(mb) \
+	(rte_pktmbuf_priv_flags((mb)->pool) & RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF)
+
 /**
  * Returns TRUE if given mbuf is direct, or FALSE otherwise.
  *
@@ -768,8 +782,15 @@ rte_mbuf_to_baddr(struct rte_mbuf *md)
 struct rte_pktmbuf_pool_private {
 	uint16_t mbuf_data_room_size; /**< Size of data space in each mbuf. */
 	uint16_t mbuf_priv_size;      /**< Size of private area in each mbuf. */
+	uint32_t flags; /**< Pool flags, see RTE_PKTMBUF_POOL_F_*. */
 };
 
+/**
+ * The mbufs of the pool are permanently attached to external buffers,
+ * see rte_pktmbuf_pool_create_extbuf().
+ */
+#define RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF (1 << 0)
+
 #ifdef RTE_LIBRTE_MBUF_DEBUG
 
 /**  check mbuf type in debug mode */
@@ -1012,7 +1033,8 @@ static inline struct rte_mbuf *rte_mbuf_raw_alloc(struct rte_mempool *mp)
 static __rte_always_inline void
 rte_mbuf_raw_free(struct rte_mbuf *m)
 {
-	RTE_ASSERT(RTE_MBUF_DIRECT(m));
+	RTE_ASSERT(!RTE_MBUF_CLONED(m) &&
+		(!RTE_MBUF_HAS_EXTBUF(m) || RTE_MBUF_HAS_PINNED_EXTBUF(m)));
 	RTE_ASSERT(rte_mbuf_refcnt_read(m) == 1);
 	RTE_ASSERT(m->next == NULL);
 	RTE_ASSERT(m->nb_segs == 1);
@@ -1151,6 +1173,84 @@ rte_pktmbuf_pool_create_by_ops(const char *name, unsigned int n,
 	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
 	int socket_id, const char *ops_name);
 
+/**
+ * External memory area of a pool of mbufs with pinned external buffers,
+ * see rte_pktmbuf_pool_create_extbuf().
+ */
+struct rte_pktmbuf_extmem {
+	void *buf_ptr;		/**< The virtual address of the area. */
+	rte_iova_t buf_iova;	/**< The IO address of the area. */
+	size_t buf_len;		/**< The length of the area. */
+	uint16_t elt_size;	/**< The size of the buffers in the area. */
+};
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Create a mbuf pool with pinned external buffers.
+ *
+ * This function creates and initializes a packet mbuf pool whose data
+ * buffers are not embedded in the mempool elements, but taken from the
+ * external memory areas given by the application, for instance a file
+ * cache or memory shared with another process. Each mbuf is attached to
+ * its buffer at pool creation and stays attached for the lifetime of the
+ * pool; the areas must not be freed before the pool.
+ *
+ * The mbufs are flagged with EXT_ATTACHED_MBUF and use a shared info
+ * structure stored in the mempool element, after the private area, whose
+ * free callback returns the mbuf to the pool. They can be transmitted
+ * and freed like any other mbuf, and other mbufs can be attached to them
+ * with rte_pktmbuf_attach() or rte_pktmbuf_clone() (from a pool without
+ * pinned buffers): the reference counter of the shared info is then
+ * incremented and the pinned mbuf goes back to its pool only when it and
+ * all the mbufs attached to it are freed.
+ *
+ * The mbufs of such a pool are not direct: they cannot be attached to
+ * another buffer, and rte_pktmbuf_detach() does nothing on them. Most
+ * PMDs do not support them on Rx, as they reset the offload flags.
+ *
+ * @param name
+ *   The name of the mbuf pool.
+ * @param n
+ *   The number of elements in the mbuf pool.
+ * @param cache_size
+ *   Size of the per-core object cache. See rte_mempool_create() for
+ *   details.
+ * @param priv_size
+ *   Size of application private are between the rte_mbuf structure
+ *   and the shared info structure. This value must be aligned to
+ *   RTE_MBUF_PRIV_ALIGN.
+ * @param data_room_size
+ *   Size of data buffer in each mbuf, including RTE_PKTMBUF_HEADROOM.
+ *   It must not be larger than the element size of the external areas.
+ * @param socket_id
+ *   The socket identifier where the memory should be allocated. The
+ *   value can be *SOCKET_ID_ANY* if there is no NUMA constraint for the
+ *   reserved zone.
+ * @param ext_mem
+ *   Array of external memory areas, split in buffers of their element
+ *   size, given to the mbufs in order.
+ * @param ext_num
+ *   Number of external memory areas. They must provide at least n
+ *   buffers in total.
+ * @return
+ *   The pointer to the new allocated mempool, on success. NULL on error
+ *   with rte_errno set appropriately. Possible rte_errno values include:
+ *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
+ *    - E_RTE_SECONDARY - function was called from a secondary process instance
+ *    - EINVAL - cache size provided is too large, priv_size is not aligned,
+ *      or the external areas are invalid or too small.
+ *    - ENOSPC - the maximum number of memzones has already been allocated
+ *    - EEXIST - a memzone with the same name already exists
+ *    - ENOMEM - no appropriate memory area found in which to create memzone
+ */
+struct rte_mempool * __rte_experimental
+rte_pktmbuf_pool_create_extbuf(const char *name, unsigned int n,
+	unsigned int cache_size, uint16_t priv_size, uint16_t data_room_size,
+	int socket_id, const struct rte_pktmbuf_extmem *ext_mem,
+	unsigned int ext_num);
+
 /**
  * Get the data room size of mbufs stored in a pktmbuf_pool
  *
@@ -1192,6 +1292,23 @@ rte_pktmbuf_priv_size(struct rte_mempool *mp)
 	return mbp_priv->mbuf_priv_size;
 }
 
+/**
+ * Get the flags of a pktmbuf_pool
+ *
+ * @param mp
+ *   The packet mbuf pool.
+ * @return
+ *   The RTE_PKTMBUF_POOL_F_* flags of this mempool.
+ */
+static inline uint32_t
+rte_pktmbuf_priv_flags(struct rte_mempool *mp)
+{
+	struct rte_pktmbuf_pool_private *mbp_priv;
+
+	mbp_priv = (struct rte_pktmbuf_pool_private *)rte_mempool_get_priv(mp);
+	return mbp_priv->flags;
+}
+
 /**
  * Reset the data_off field of a packet mbuf to its default value.
  *
@@ -1226,7 +1343,8 @@ static inline void rte_pktmbuf_reset(struct rte_mbuf *m)
 	m->nb_segs = 1;
 	m->port = MBUF_INVALID_PORT;
 
-	m->ol_flags = 0;
+	/* a pinned external buffer stays attached */
+	m->ol_flags &= EXT_ATTACHED_MBUF;
 	m->packet_type = 0;
 	rte_pktmbuf_reset_headroom(m);
 
@@ -1256,28 +1374,85 @@ static inline struct rte_mbuf *rte_pktmbuf_alloc(struct rte_mempool *mp)
 }
 
 /**
- * Allocate a bulk of mbufs, initialize refcnt and reset the fields to default
- * values.
+ * @internal Reset the fields of a bulk of mbufs, as rte_pktmbuf_reset()
+ * does for each of them.
  *
- *  @param pool
- *    The mempool from which mbufs are allocated.
- *  @param mbufs
- *    Array of pointers to mbufs
- *  @param count
- *    Array size
- *  @return
- *   - 0: Success
- *   - -ENOENT: Not enough entries in the mempool; no mbufs are retrieved.
+ * On x86_64, the fields are written with 16-byte vector stores: the
+ * rearm data and the offload flags from a template computed once for the
+ * bulk, with the data offset taken from the buffer length of each mbuf,
+ * then the Rx descriptor fields, and the next and tx_offload fields, set
+ * to 0. The store of the Rx descriptor fields also clears hash.rss; the
+ * rest of the hash field is left as is.
+ *
+ * The mbufs must come from *pool* and have only one segment.
+ *
+ * @param pool
+ *   The mempool from which the mbufs were allocated.
+ * @param mbufs
+ *   Array of pointers to mbufs.
+ * @param count
+ *   Array size.
  */
-static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
-	 struct rte_mbuf **mbufs, unsigned count)
+static inline void
+__rte_pktmbuf_reset_bulk(struct rte_mempool *pool, struct rte_mbuf **mbufs,
+	unsigned int count)
 {
-	unsigned idx = 0;
-	int rc;
+#ifdef RTE_ARCH_X86_64
+	struct rte_mbuf *m;
+	unsigned int idx;
+	uint64_t rearm, ol_flags;
+	__m128i rearm_ol, zero;
+
+	/* the vector stores rely on this layout */
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rearm_data) % 16 != 0);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_off) !=
+		offsetof(struct rte_mbuf, rearm_data));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, refcnt) !=
+		offsetof(struct rte_mbuf, rearm_data) + 2);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, nb_segs) !=
+		offsetof(struct rte_mbuf, rearm_data) + 4);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, port) !=
+		offsetof(struct rte_mbuf, rearm_data) + 6);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, ol_flags) !=
+		offsetof(struct rte_mbuf, rearm_data) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, rx_descriptor_fields1) !=
+		offsetof(struct rte_mbuf, rearm_data) + 16);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, packet_type) !=
+		offsetof(struct rte_mbuf, rx_descriptor_fields1));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, pkt_len) !=
+		offsetof(struct rte_mbuf, rx_descriptor_fields1) + 4);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, data_len) !=
+		offsetof(struct rte_mbuf, rx_descriptor_fields1) + 8);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, vlan_tci) !=
+		offsetof(struct rte_mbuf, rx_descriptor_fields1) + 10);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, next) % 16 != 0);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_mbuf, tx_offload) !=
+		offsetof(struct rte_mbuf, next) + 8);
+
+	/* refcnt = 1, nb_segs = 1, port; data_off is set per mbuf */
+	rearm = (uint64_t)1 << 16 |
+		(uint64_t)1 << 32 |
+		(uint64_t)MBUF_INVALID_PORT << 48;
+	/* the mbufs of a pinned pool stay attached to their buffer */
+	ol_flags = (rte_pktmbuf_priv_flags(pool) &
+		RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF) ? EXT_ATTACHED_MBUF : 0;
+	zero = _mm_setzero_si128();
+
+	for (idx = 0; idx != count; idx++) {
+		m = mbufs[idx];
+		MBUF_RAW_ALLOC_CHECK(m);
+		rearm_ol = _mm_set_epi64x(ol_flags, rearm |
+			RTE_MIN((uint16_t)RTE_PKTMBUF_HEADROOM, m->buf_len));
+		_mm_store_si128((__m128i *)&m->rearm_data, rearm_ol);
+		_mm_store_si128((__m128i *)&m->rx_descriptor_fields1, zero);
+		m->vlan_tci_outer = 0;
+		_mm_store_si128((__m128i *)&m->next, zero);
+		__rte_mbuf_sanity_check(m, 1);
+	}
+#else
+	unsigned int idx = 0;
 
-	rc = rte_mempool_get_bulk(pool, (void **)mbufs, count);
-	if (unlikely(rc))
-		return rc;
+	RTE_SET_USED(pool);
 
 	/* To understand duff's device on loop unwinding optimization, see
 	 * https://en.wikipedia.org/wiki/Duff's_device.
@@ -1308,6 +1483,33 @@ static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
 			/* fall-through */
 		}
 	}
+#endif
+}
+
+/**
+ * Allocate a bulk of mbufs, initialize refcnt and reset the fields to default
+ * values.
+ *
+ *  @param pool
+ *    The mempool from which mbufs are allocated.
+ *  @param mbufs
+ *    Array of pointers to mbufs
+ *  @param count
+ *    Array size
+ *  @return
+ *   - 0: Success
+ *   - -ENOENT: Not enough entries in the mempool; no mbufs are retrieved.
+ */
+static inline int rte_pktmbuf_alloc_bulk(struct rte_mempool *pool,
+	 struct rte_mbuf **mbufs, unsigned count)
+{
+	int rc;
+
+	rc = rte_mempool_get_bulk(pool, (void **)mbufs, count);
+	if (unlikely(rc))
+		return rc;
+
+	__rte_pktmbuf_reset_bulk(pool, mbufs, count);
 	return 0;
 }
 
@@ -1575,10 +1777,15 @@ static inline void rte_pktmbuf_detach(struct rte_mbuf *m)
 	uint32_t mbuf_size, buf_len;
 	uint16_t priv_size;
 
-	if (RTE_MBUF_HAS_EXTBUF(m))
+	if (RTE_MBUF_HAS_EXTBUF(m)) {
+		/* a pinned external buffer is never detached from its mbuf */
+		if (rte_pktmbuf_priv_flags(mp) &
+				RTE_PKTMBUF_POOL_F_PINNED_EXT_BUF)
+			return;
 		__rte_pktmbuf_free_extbuf(m);
-	else
+	} else {
 		__rte_pktmbuf_free_direct(m);
+	}
 
 	priv_size = rte_pktmbuf_priv_size(mp);
 	mbuf_size = (uint32_t)(sizeof(struct rte_mbuf) + priv_size);
@@ -1593,6 +1800,38 @@ static inline void rte_pktmbuf_detach(struct rte_mbuf *m)
 	m->ol_flags = 0;
 }
 
+/**
+ * @internal Handle the free of a mbuf with a pinned external buffer.
+ *
+ * Other mbufs may still be attached to the pinned buffer: in that case,
+ * the reference counter of the shared info is decremented and the mbuf
+ * is returned to its pool by the free callback of the shared info, when
+ * the last attached mbuf is detached.
+ *
+ * @param m
+ *   The mbuf with a pinned external buffer, being freed.
+ * @return
+ *   - 0 if the mbuf can be freed now.
+ *   - 1 if the mbuf will be freed by the free callback.
+ */
+static inline int
+__rte_pktmbuf_pinned_extbuf_decref(struct rte_mbuf *m)
+{
+	struct rte_mbuf_ext_shared_info *shinfo = m->shinfo;
+
+	m->ol_flags = EXT_ATTACHED_MBUF;
+
+	if (likely(rte_mbuf_ext_refcnt_read(shinfo) == 1))
+		return 0;
+
+	if (rte_atomic16_add_return(&shinfo->refcnt_atomic, -1) != 0)
+		return 1;
+
+	/* the attached mbufs were freed meanwhile */
+	rte_mbuf_ext_refcnt_set(shinfo, 1);
+	return 0;
+}
+
 /**
  * Decrease reference counter and unlink a mbuf segment
  *
@@ -1614,8 +1853,13 @@ rte_pktmbuf_prefree_seg(struct rte_mbuf *m)
 
 	if (likely(rte_mbuf_refcnt_read(m) == 1)) {
 
-		if (!RTE_MBUF_DIRECT(m))
+		if (!RTE_MBUF_DIRECT(m)) {
 			rte_pktmbuf_detach(m);
+			if (RTE_MBUF_HAS_EXTBUF(m) &&
+					RTE_MBUF_HAS_PINNED_EXTBUF(m) &&
+					__rte_pktmbuf_pinned_extbuf_decref(m))
+				return NULL;
+		}
 
 		if (m->next != NULL) {
 			m->next = NULL;
@@ -1626,8 +1870,13 @@ rte_pktmbuf_prefree_seg(struct rte_mbuf *m)
 
 	} else if (__rte_mbuf_refcnt_update(m, -1) == 0) {
 
-		if (!RTE_MBUF_DIRECT(m))
+		if (!RTE_MBUF_DIRECT(m)) {
 			rte_pktmbuf_detach(m);
+			if (RTE_MBUF_HAS_EXTBUF(m) &&
+					RTE_MBUF_HAS_PINNED_EXTBUF(m) &&
+					__rte_pktmbuf_pinned_extbuf_decref(m))
+				return NULL;
+		}
 
 		if (m->next != NULL) {
 			m->next = NULL;
@@ -1688,6 +1937,25 @@ static inline void rte_pktmbuf_free(struct rte_mbuf *m)
 	}
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Free a bulk of packet mbufs back into their original mempools.
+ *
+ * Free the mbufs, and all their segments in case of chained buffers, as
+ * rte_pktmbuf_free() does for each of them. The segments are returned to
+ * their mempools by batches of consecutive segments of the same mempool,
+ * so that each batch costs one mempool put.
+ *
+ * @param mbufs
+ *   Array of pointers to packet mbufs. The array may contain NULL pointers.
+ * @param count
+ *   Array size.
+ */
+void __rte_experimental
+rte_pktmbuf_free_bulk(struct rte_mbuf **mbufs, unsigned int count);
+
 /**
  * Creates a "clone" of the given packet mbuf.
  *
@@ -40,10 +40,6 @@ static struct rte_tailq_elem rte_mempool_tailq = {
 };
 EAL_REGISTER_TAILQ(rte_mempool_tailq)
 
-#define CACHE_FLUSHTHRESH_MULTIPLIER 1.5
-#define CALC_CACHE_FLUSHTHRESH(c)	\
-	((typeof(c))((c) * CACHE_FLUSHTHRESH_MULTIPLIER))
-
 /*
  * return the greatest common divisor between a and b (fast algorithm)
  *
@@ -842,8 +838,51 @@ static void
 mempool_cache_init(struct rte_mempool_cache *cache, uint32_t size)
 {
 	cache->size = size;
-	cache->flushthresh = CALC_CACHE_FLUSHTHRESH(size);
+	cache->flushthresh = RTE_MEMPOOL_CACHE_FLUSHTHRESH(size);
 	cache->len = 0;
+	cache->calls = 0;
+	cache->adaptive = 0;
+	cache->min_size = size;
+	cache->max_size = size;
+	memset(&cache->stats, 0, sizeof(cache->stats));
+}
+
+/*
+ * Make a default cache adaptive: its size can go down to a quarter of the
+ * initial size, and up to the size allowing all the lcores to hold
+ * objects in their caches without exhausting the pool.
+ */
+static void
+mempool_cache_init_adaptive(struct rte_mempool_cache *cache, uint32_t size,
+	uint32_t pool_size)
+{
+	uint32_t max_size;
+
+	max_size = pool_size / rte_lcore_count();
+	max_size = max_size * 2 / 3; /* keep room for the flush threshold */
+	max_size = RTE_MIN(max_size, (uint32_t)RTE_MEMPOOL_CACHE_MAX_SIZE);
+
+	cache->adaptive = 1;
+	cache->min_size = RTE_MAX(size / 4, 1U);
+	cache->max_size = RTE_MAX(max_size, size);
+}
+
+/* get the statistics of a cache */
+void __rte_experimental
+rte_mempool_cache_stats_get(const struct rte_mempool_cache *cache,
+	struct rte_mempool_cache_stats *stats)
+{
+	*stats = cache->stats;
+	/* add the calls not accounted yet */
+	stats->calls += cache->calls;
+}
+
+/* reset the statistics of a cache */
+void __rte_experimental
+rte_mempool_cache_stats_reset(struct rte_mempool_cache *cache)
+{
+	cache->calls = 0;
+	memset(&cache->stats, 0, sizeof(cache->stats));
 }
 
 /*
@@ -918,7 +957,7 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	/* asked cache too big */
 	if (cache_size > RTE_MEMPOOL_CACHE_MAX_SIZE ||
-	    CALC_CACHE_FLUSHTHRESH(cache_size) > n) {
+	    RTE_MEMPOOL_CACHE_FLUSHTHRESH(cache_size) > n) {
 		rte_errno = EINVAL;
 		return NULL;
 	}
@@ -994,9 +1033,14 @@ rte_mempool_create_empty(const char *name, unsigned n, unsigned elt_size,
 
 	/* Init all default caches. */
 	if (cache_size != 0) {
-		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++)
+		for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
 			mempool_cache_init(&mp->local_cache[lcore_id],
 					   cache_size);
+			if (flags & MEMPOOL_F_CACHE_ADAPTIVE)
+				mempool_cache_init_adaptive(
+					&mp->local_cache[lcore_id],
+					cache_size, n);
+		}
 	}
 
 	te->data = mp;
@@ -1177,6 +1221,31 @@ rte_mempool_dump_cache(FILE *f, const struct rte_mempool *mp)
 		count += cache_count;
 	}
 	fprintf(f, "    total_cache_count=%u\n", count);
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		const struct rte_mempool_cache *cache =
+			&mp->local_cache[lcore_id];
+		struct rte_mempool_cache_stats stats;
+
+		rte_mempool_cache_stats_get(cache, &stats);
+		if (stats.calls + stats.backend_get + stats.backend_put == 0)
+			continue;
+		fprintf(f, "    cache_stats[%u]:\n", lcore_id);
+		fprintf(f, "      size=%"PRIu32"\n", cache->size);
+		fprintf(f, "      backend_get=%"PRIu64"\n", stats.backend_get);
+		fprintf(f, "      backend_put=%"PRIu64"\n", stats.backend_put);
+#ifdef RTE_LIBRTE_MEMPOOL_DEBUG
+		fprintf(f, "      calls=%"PRIu64"\n", stats.calls);
+		fprintf(f, "      backend_avoided=%"PRIu64"\n",
+			stats.calls > stats.backend_get + stats.backend_put ?
+			stats.calls - stats.backend_get - stats.backend_put :
+			0);
+#endif
+		if (cache->adaptive) {
+			fprintf(f, "      grow=%"PRIu64"\n", stats.grow);
+			fprintf(f, "      shrink=%"PRIu64"\n", stats.shrink);
+		}
+	}
 	return count;
 }
 
@@ -1387,6 +1456,7 @@ rte_mempool_dump(FILE *f, struct rte_mempool *mp)
 	if ((cache_count + common_count) > mp->size)
 		common_count = mp->size - cache_count;
 	fprintf(f, "  common_pool_count=%u\n", common_count);
+	rte_mempool_ops_dump(f, mp);
 
 	/* sum and dump statistics */
 #ifdef RTE_LIBRTE_MEMPOOL_DEBUG
@@ -77,6 +77,40 @@ struct rte_mempool_debug_stats {
 } __rte_cache_aligned;
 #endif
 
+/**
+ * A structure that stores the statistics of a per-core object cache.
+ *
+ * The number of backend (common pool) calls avoided by the cache is
+ * calls - backend_get - backend_put.
+ */
+struct rte_mempool_cache_stats {
+	uint64_t calls;       /**< Get/put calls served through the cache. */
+	uint64_t backend_get; /**< Backend dequeues, to refill the cache. */
+	uint64_t backend_put; /**< Backend enqueues, to flush the cache. */
+	uint64_t grow;        /**< Adaptive cache size increases. */
+	uint64_t shrink;      /**< Adaptive cache size decreases. */
+};
+
+/**
+ * Adaptive cache: the size of a cache is doubled when it causes a backend
+ * call after less than this number of get/put calls.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_GROW_CALLS 8
+/**
+ * Adaptive cache: the size of a cache is halved when it causes a backend
+ * call after more than this number of get/put calls.
+ */
+#define RTE_MEMPOOL_CACHE_ADAPT_SHRINK_CALLS 1024
+
+/** Ratio of the flush threshold of a cache to its size. */
+#define RTE_MEMPOOL_CACHE_FLUSHTHRESH_MULTIPLIER 1.5
+/**
+ * Flush threshold of a cache of size *c*: the cache may overflow up to
+ * this number of objects before being flushed to the common pool.
+ */
+#define RTE_MEMPOOL_CACHE_FLUSHTHRESH(c)	\
+	((typeof(c))((c) * RTE_MEMPOOL_CACHE_FLUSHTHRESH_MULTIPLIER))
+
 /**
  * A structure that stores a per-core object cache.
  */
@@ -84,6 +118,11 @@ struct rte_mempool_cache {
 	uint32_t size;	      /**< Size of the cache */
 	uint32_t flushthresh; /**< Threshold before we flush excess elements */
 	uint32_t len;	      /**< Current cache count */
+	uint32_t adaptive;    /**< Non-zero if size is adapted at runtime */
+	uint32_t min_size;    /**< Lower bound of the adaptive size */
+	uint32_t max_size;    /**< Upper bound of the adaptive size */
+	uint32_t calls;       /**< Get/put calls since last backend call */
+	struct rte_mempool_cache_stats stats; /**< Cache statistics */
 	/*
 	 * Cache is allocated to this size to allow it to overflow in certain
 	 * cases to avoid needless emptying of cache.
@@ -264,6 +303,8 @@ struct rte_mempool {
 #define MEMPOOL_F_POOL_CREATED   0x0010 /**< Internal: pool is created. */
 #define MEMPOOL_F_NO_IOVA_CONTIG 0x0020 /**< Don't need IOVA contiguous objs. */
 #define MEMPOOL_F_NO_PHYS_CONTIG MEMPOOL_F_NO_IOVA_CONTIG /* deprecated */
+/** Adapt the size of the default caches to each lcore at runtime. */
+#define MEMPOOL_F_CACHE_ADAPTIVE 0x0040
 
 /**
  * @internal When debug is enabled, store some statistics.
@@ -575,6 +616,14 @@ int rte_mempool_op_populate_default(struct rte_mempool *mp,
 typedef int (*rte_mempool_get_info_t)(const struct rte_mempool *mp,
 		struct rte_mempool_info *info);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Dump the driver specific status of a mempool, e.g. statistics.
+ */
+typedef void (*rte_mempool_dump_t)(FILE *f, const struct rte_mempool *mp);
+
 
 /** Structure defining mempool operations structure */
 struct rte_mempool_ops {
@@ -602,6 +651,10 @@ struct rte_mempool_ops {
 	 * Dequeue a number of contiguous object blocks.
 	 */
 	rte_mempool_dequeue_contig_blocks_t dequeue_contig_blocks;
+	/**
+	 * Optional callback to dump driver specific status.
+	 */
+	rte_mempool_dump_t dump;
 } __rte_cache_aligned;
 
 #define RTE_MEMPOOL_MAX_OPS_IDX 16  /**< Max registered ops structs */
@@ -807,6 +860,20 @@ __rte_experimental
 int rte_mempool_ops_get_info(const struct rte_mempool *mp,
 			 struct rte_mempool_info *info);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Wrapper for mempool_ops dump callback.
+ *
+ * @param[in] f
+ *   A pointer to a file for output.
+ * @param[in] mp
+ *   Pointer to the memory pool.
+ */
+__rte_experimental
+void rte_mempool_ops_dump(FILE *f, const struct rte_mempool *mp);
+
 /**
  * @internal wrapper for mempool_ops free callback.
  *
@@ -956,6 +1023,13 @@ typedef void (rte_mempool_ctor_t)(struct rte_mempool *, void *);
  *     "single-consumer". Otherwise, it is "multi-consumers".
  *   - MEMPOOL_F_NO_IOVA_CONTIG: If set, allocated objects won't
  *     necessarily be contiguous in IO memory.
+ *   - MEMPOOL_F_CACHE_ADAPTIVE: If set, the size and the flush threshold
+ *     of each lcore default cache are adapted at runtime: a cache which
+ *     often needs the common pool, because the lcore gets more objects
+ *     than it puts or the opposite, is grown up to the smaller of
+ *     RTE_MEMPOOL_CACHE_MAX_SIZE and the mempool size shared among the
+ *     lcores; a cache which rarely needs it is shrunk down to a quarter
+ *     of *cache_size*. See rte_mempool_cache_stats_get().
  * @return
  *   The pointer to the new allocated mempool, on success. NULL on error
  *   with rte_errno set appropriately. Possible rte_errno values include:
@@ -1318,6 +1392,70 @@ rte_mempool_default_cache(struct rte_mempool *mp, unsigned lcore_id)
 	return &mp->local_cache[lcore_id];
 }
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Get the statistics of a mempool cache.
+ *
+ * Statistics are updated by the lcore owning the cache, without
+ * synchronization: they can be slightly out of date when read from
+ * another lcore.
+ *
+ * @param cache
+ *   A pointer to the mempool cache, for instance the result of
+ *   rte_mempool_default_cache().
+ * @param stats
+ *   A pointer to a structure filled with the statistics.
+ */
+void __rte_experimental
+rte_mempool_cache_stats_get(const struct rte_mempool_cache *cache,
+		struct rte_mempool_cache_stats *stats);
+
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice.
+ *
+ * Reset the statistics of a mempool cache.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ */
+void __rte_experimental
+rte_mempool_cache_stats_reset(struct rte_mempool_cache *cache);
+
+/**
+ * @internal Account for a backend call made for a cache, and adapt the
+ * cache size if it is adaptive.
+ *
+ * @param cache
+ *   A pointer to the mempool cache.
+ */
+static __rte_always_inline void
+__mempool_cache_adapt(struct rte_mempool_cache *cache)
+{
+	uint32_t calls = cache->calls;
+
+	cache->stats.calls += calls;
+	cache->calls = 0;
+
+	if (likely(cache->adaptive == 0))
+		return;
+
+	if (calls < RTE_MEMPOOL_CACHE_ADAPT_GROW_CALLS &&
+			cache->size < cache->max_size) {
+		cache->size = RTE_MIN(cache->size * 2, cache->max_size);
+		cache->stats.grow++;
+	} else if (calls > RTE_MEMPOOL_CACHE_ADAPT_SHRINK_CALLS &&
+			cache->size > cache->min_size) {
+		cache->size = RTE_MAX(cache->size / 2, cache->min_size);
+		cache->stats.shrink++;
+	} else
+		return;
+
+	cache->flushthresh = RTE_MEMPOOL_CACHE_FLUSHTHRESH(cache->size);
+}
+
 /**
  * Flush a user-owned mempool cache to the specified mempool.
  *
@@ -1336,6 +1474,7 @@ rte_mempool_cache_flush(struct rte_mempool_cache *cache,
 		return;
 	rte_mempool_ops_enqueue_bulk(mp, cache->objs, cache->len);
 	cache->len = 0;
+	cache->stats.backend_put++;
 }
 
 /**
@@ -1363,6 +1502,7 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 	if (unlikely(cache == NULL || n > RTE_MEMPOOL_CACHE_MAX_SIZE))
 		goto ring_enqueue;
 
+	cache->calls++;
 	cache_objs = &cache->objs[cache->len];
 
 	/*
@@ -1381,6 +1521,8 @@ __mempool_generic_put(struct rte_mempool *mp, void * const *obj_table,
 		rte_mempool_ops_enqueue_bulk(mp, &cache->objs[cache->size],
 				cache->len - cache->size);
 		cache->len = cache->size;
+		cache->stats.backend_put++;
+		__mempool_cache_adapt(cache);
 	}
 
 	return;
@@ -1480,9 +1622,18 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 	uint32_t index, len;
 	void **cache_objs;
 
-	/* No cache provided or cannot be satisfied from cache */
-	if (unlikely(cache == NULL || n >= cache->size))
+	/* No cache provided */
+	if (unlikely(cache == NULL))
+		goto ring_dequeue;
+
+	cache->calls++;
+
+	/* Cannot be satisfied from cache */
+	if (unlikely(n >= cache->size)) {
+		cache->stats.backend_get++;
+		__mempool_cache_adapt(cache);
 		goto ring_dequeue;
+	}
 
 	cache_objs = cache->objs;
 
@@ -1491,6 +1642,9 @@ __mempool_generic_get(struct rte_mempool *mp, void **obj_table,
 		/* No. Backfill the cache first, and then fill from it */
 		uint32_t req = n + (cache->size - cache->len);
 
+		cache->stats.backend_get++;
+		__mempool_cache_adapt(cache);
+
 		/* How many do we require i.e. number to fill the cache + the request */
 		ret = rte_mempool_ops_dequeue_bulk(mp,
 			&cache->objs[cache->len], req);
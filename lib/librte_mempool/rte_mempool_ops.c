@@ -61,6 +61,7 @@ rte_mempool_register_ops(const struct rte_mempool_ops *h)
 	ops->populate = h->populate;
 	ops->get_info = h->get_info;
 	ops->dequeue_contig_blocks = h->dequeue_contig_blocks;
+	ops->dump = h->dump;
 
 	rte_spinlock_unlock(&rte_mempool_ops_table.sl);
 
@@ -149,6 +150,19 @@ rte_mempool_ops_get_info(const struct rte_mempool *mp,
 	return ops->get_info(mp, info);
 }
 
+/* wrapper to dump the driver specific status of a mempool */
+void
+rte_mempool_ops_dump(FILE *f, const struct rte_mempool *mp)
+{
+	struct rte_mempool_ops *ops;
+
+	ops = rte_mempool_get_ops(mp->ops_index);
+
+	if (ops->dump == NULL)
+		return;
+	ops->dump(f, mp);
+}
+
 
 /* sets mempool ops previously registered by rte_mempool_register_ops. */
 int
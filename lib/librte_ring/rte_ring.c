@@ -32,6 +32,7 @@
 #include <rte_spinlock.h>
 
 #include "rte_ring.h"
+#include "rte_ring_elem.h"
 
 TAILQ_HEAD(rte_ring_list, rte_tailq_entry);
 
@@ -44,11 +45,17 @@ EAL_REGISTER_TAILQ(rte_ring_tailq)
 #define POWEROF2(x) ((((x)-1) & (x)) == 0)
 
 /* return the size of memory occupied by a ring */
-ssize_t
-rte_ring_get_memsize(unsigned count)
+ssize_t __rte_experimental
+rte_ring_get_memsize_elem(unsigned int esize, unsigned int count)
 {
 	ssize_t sz;
 
+	/* Check if element size is a multiple of 4B */
+	if (esize == 0 || esize % 4 != 0) {
+		RTE_LOG(ERR, RING, "element size is not a multiple of 4\n");
+		return -EINVAL;
+	}
+
 	/* count must be a power of 2 */
 	if ((!POWEROF2(count)) || (count > RTE_RING_SZ_MASK )) {
 		RTE_LOG(ERR, RING,
@@ -57,11 +64,36 @@ rte_ring_get_memsize(unsigned count)
 		return -EINVAL;
 	}
 
-	sz = sizeof(struct rte_ring) + count * sizeof(void *);
+	sz = sizeof(struct rte_ring) + (ssize_t)count * esize;
 	sz = RTE_ALIGN(sz, RTE_CACHE_LINE_SIZE);
 	return sz;
 }
 
+/* return the size of memory occupied by a ring of pointers */
+ssize_t
+rte_ring_get_memsize(unsigned count)
+{
+	return rte_ring_get_memsize_elem(sizeof(void *), count);
+}
+
+/* default max head/tail distance of an RTS ring, as a fraction of capacity */
+#define RTS_HTD_MAX_DEF_DIV	8
+
+/* check that the producer and consumer sync flags are consistent */
+static int
+ring_check_flags(unsigned int flags)
+{
+	if ((flags & (RING_F_SP_ENQ | RING_F_MP_RTS_ENQ)) ==
+			(RING_F_SP_ENQ | RING_F_MP_RTS_ENQ) ||
+			(flags & (RING_F_SC_DEQ | RING_F_MC_RTS_DEQ)) ==
+			(RING_F_SC_DEQ | RING_F_MC_RTS_DEQ)) {
+		RTE_LOG(ERR, RING,
+			"Requested flags are invalid, single and RTS sync modes are exclusive\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
 int
 rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 	unsigned flags)
@@ -75,6 +107,14 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 			  RTE_CACHE_LINE_MASK) != 0);
 	RTE_BUILD_BUG_ON((offsetof(struct rte_ring, prod) &
 			  RTE_CACHE_LINE_MASK) != 0);
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, sync_type) !=
+			offsetof(struct rte_ring_rts_headtail, sync_type));
+	RTE_BUILD_BUG_ON(offsetof(struct rte_ring_headtail, tail) !=
+			offsetof(struct rte_ring_rts_headtail, tail.val.pos));
+
+	ret = ring_check_flags(flags);
+	if (ret != 0)
+		return ret;
 
 	/* init the ring structure */
 	memset(r, 0, sizeof(*r));
@@ -82,8 +122,14 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 	if (ret < 0 || ret >= (int)sizeof(r->name))
 		return -ENAMETOOLONG;
 	r->flags = flags;
-	r->prod.single = (flags & RING_F_SP_ENQ) ? __IS_SP : __IS_MP;
-	r->cons.single = (flags & RING_F_SC_DEQ) ? __IS_SC : __IS_MC;
+	if (flags & RING_F_MP_RTS_ENQ)
+		r->prod.sync_type = RTE_RING_SYNC_MT_RTS;
+	else
+		r->prod.single = (flags & RING_F_SP_ENQ) ? __IS_SP : __IS_MP;
+	if (flags & RING_F_MC_RTS_DEQ)
+		r->cons.sync_type = RTE_RING_SYNC_MT_RTS;
+	else
+		r->cons.single = (flags & RING_F_SC_DEQ) ? __IS_SC : __IS_MC;
 
 	if (flags & RING_F_EXACT_SZ) {
 		r->size = rte_align32pow2(count + 1);
@@ -103,13 +149,21 @@ rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
 	r->prod.head = r->cons.head = 0;
 	r->prod.tail = r->cons.tail = 0;
 
+	/* RTS head/tail start at 0, as the memset above did */
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_RTS)
+		r->rts_prod.htd_max = RTE_MAX(r->capacity / RTS_HTD_MAX_DEF_DIV,
+				1U);
+	if (r->cons.sync_type == RTE_RING_SYNC_MT_RTS)
+		r->rts_cons.htd_max = RTE_MAX(r->capacity / RTS_HTD_MAX_DEF_DIV,
+				1U);
+
 	return 0;
 }
 
-/* create the ring */
-struct rte_ring *
-rte_ring_create(const char *name, unsigned count, int socket_id,
-		unsigned flags)
+/* create the ring for a given element size */
+struct rte_ring * __rte_experimental
+rte_ring_create_elem(const char *name, unsigned int esize, unsigned int count,
+		int socket_id, unsigned int flags)
 {
 	char mz_name[RTE_MEMZONE_NAMESIZE];
 	struct rte_ring *r;
@@ -123,11 +177,17 @@ rte_ring_create(const char *name, unsigned count, int socket_id,
 
 	ring_list = RTE_TAILQ_CAST(rte_ring_tailq.head, rte_ring_list);
 
+	ret = ring_check_flags(flags);
+	if (ret != 0) {
+		rte_errno = -ret;
+		return NULL;
+	}
+
 	/* for an exact size ring, round up from count to a power of two */
 	if (flags & RING_F_EXACT_SZ)
 		count = rte_align32pow2(count + 1);
 
-	ring_size = rte_ring_get_memsize(count);
+	ring_size = rte_ring_get_memsize_elem(esize, count);
 	if (ring_size < 0) {
 		rte_errno = ring_size;
 		return NULL;
@@ -174,6 +234,15 @@ rte_ring_create(const char *name, unsigned count, int socket_id,
 	return r;
 }
 
+/* create the ring */
+struct rte_ring *
+rte_ring_create(const char *name, unsigned count, int socket_id,
+		unsigned flags)
+{
+	return rte_ring_create_elem(name, sizeof(void *), count, socket_id,
+		flags);
+}
+
 /* free the ring */
 void
 rte_ring_free(struct rte_ring *r)
@@ -228,9 +297,17 @@ rte_ring_dump(FILE *f, const struct rte_ring *r)
 	fprintf(f, "  size=%"PRIu32"\n", r->size);
 	fprintf(f, "  capacity=%"PRIu32"\n", r->capacity);
 	fprintf(f, "  ct=%"PRIu32"\n", r->cons.tail);
-	fprintf(f, "  ch=%"PRIu32"\n", r->cons.head);
+	if (r->cons.sync_type == RTE_RING_SYNC_MT_RTS) {
+		fprintf(f, "  ch=%"PRIu32"\n", r->rts_cons.head.val.pos);
+		fprintf(f, "  chtd_max=%"PRIu32"\n", r->rts_cons.htd_max);
+	} else
+		fprintf(f, "  ch=%"PRIu32"\n", r->cons.head);
 	fprintf(f, "  pt=%"PRIu32"\n", r->prod.tail);
-	fprintf(f, "  ph=%"PRIu32"\n", r->prod.head);
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_RTS) {
+		fprintf(f, "  ph=%"PRIu32"\n", r->rts_prod.head.val.pos);
+		fprintf(f, "  phtd_max=%"PRIu32"\n", r->rts_prod.htd_max);
+	} else
+		fprintf(f, "  ph=%"PRIu32"\n", r->prod.head);
 	fprintf(f, "  used=%u\n", rte_ring_count(r));
 	fprintf(f, "  avail=%u\n", rte_ring_free_count(r));
 }
@@ -47,6 +47,7 @@ extern "C" {
 #include <rte_branch_prediction.h>
 #include <rte_memzone.h>
 #include <rte_pause.h>
+#include <rte_compat.h>
 
 #define RTE_TAILQ_RING_NAME "RTE_RING"
 
@@ -62,11 +63,44 @@ enum rte_ring_queue_behavior {
 
 struct rte_memzone; /* forward declaration, so as not to require memzone.h */
 
+/** prod/cons sync types */
+enum rte_ring_sync_type {
+	RTE_RING_SYNC_MT,     /**< multi-thread safe (default mode) */
+	RTE_RING_SYNC_ST,     /**< single thread only */
+	RTE_RING_SYNC_MT_RTS, /**< multi-thread relaxed tail sync */
+};
+
 /* structure to hold a pair of head/tail values and other metadata */
 struct rte_ring_headtail {
 	volatile uint32_t head;  /**< Prod/consumer head. */
 	volatile uint32_t tail;  /**< Prod/consumer tail. */
-	uint32_t single;         /**< True if single prod/cons */
+	RTE_STD_C11
+	union {
+		uint32_t single;  /**< True if single prod/cons */
+		/** sync type of prod/cons */
+		enum rte_ring_sync_type sync_type;
+	};
+};
+
+/* @internal position/counter pair of an RTS head or tail */
+union __rte_ring_rts_poscnt {
+	uint64_t raw __rte_aligned(8); /**< raw 64-bit value */
+	struct {
+		uint32_t cnt; /**< head/tail reference counter */
+		uint32_t pos; /**< head/tail position */
+	} val;
+};
+
+/*
+ * structure to hold the head/tail values of a relaxed tail sync (RTS)
+ * producer or consumer; the tail position and the sync type are at the
+ * same offsets as in struct rte_ring_headtail
+ */
+struct rte_ring_rts_headtail {
+	volatile union __rte_ring_rts_poscnt tail; /**< Prod/consumer tail. */
+	enum rte_ring_sync_type sync_type; /**< sync type of prod/cons */
+	uint32_t htd_max;   /**< max allowed distance between head/tail */
+	volatile union __rte_ring_rts_poscnt head; /**< Prod/consumer head. */
 };
 
 /**
@@ -96,11 +130,21 @@ struct rte_ring {
 	char pad0 __rte_cache_aligned; /**< empty cache line */
 
 	/** Ring producer status. */
-	struct rte_ring_headtail prod __rte_cache_aligned;
+	RTE_STD_C11
+	union {
+		struct rte_ring_headtail prod;
+		struct rte_ring_rts_headtail rts_prod;
+	}  __rte_cache_aligned;
+
 	char pad1 __rte_cache_aligned; /**< empty cache line */
 
 	/** Ring consumer status. */
-	struct rte_ring_headtail cons __rte_cache_aligned;
+	RTE_STD_C11
+	union {
+		struct rte_ring_headtail cons;
+		struct rte_ring_rts_headtail rts_cons;
+	}  __rte_cache_aligned;
+
 	char pad2 __rte_cache_aligned; /**< empty cache line */
 };
 
@@ -115,6 +159,16 @@ struct rte_ring {
  * ring space will be wasted.
  */
 #define RING_F_EXACT_SZ 0x0004
+/**
+ * The default enqueue is "multi-producer relaxed tail sync" (RTS).
+ * See rte_ring_rts.h.
+ */
+#define RING_F_MP_RTS_ENQ 0x0008
+/**
+ * The default dequeue is "multi-consumer relaxed tail sync" (RTS).
+ * See rte_ring_rts.h.
+ */
+#define RING_F_MC_RTS_DEQ 0x0010
 #define RTE_RING_SZ_MASK  (0x7fffffffU) /**< Ring size mask */
 
 /* @internal defines for passing to the enqueue dequeue worker functions */
@@ -170,6 +224,14 @@ ssize_t rte_ring_get_memsize(unsigned count);
  *    - RING_F_SC_DEQ: If this flag is set, the default behavior when
  *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
  *      is "single-consumer". Otherwise, it is "multi-consumers".
+ *    - RING_F_MP_RTS_ENQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *      is "multi-producer relaxed tail sync". Cannot be combined with
+ *      RING_F_SP_ENQ.
+ *    - RING_F_MC_RTS_DEQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *      is "multi-consumer relaxed tail sync". Cannot be combined with
+ *      RING_F_SC_DEQ.
  * @return
  *   0 on success, or a negative value on error.
  */
@@ -205,12 +267,20 @@ int rte_ring_init(struct rte_ring *r, const char *name, unsigned count,
  *    - RING_F_SC_DEQ: If this flag is set, the default behavior when
  *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
  *      is "single-consumer". Otherwise, it is "multi-consumers".
+ *    - RING_F_MP_RTS_ENQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_enqueue()`` or ``rte_ring_enqueue_bulk()``
+ *      is "multi-producer relaxed tail sync". Cannot be combined with
+ *      RING_F_SP_ENQ.
+ *    - RING_F_MC_RTS_DEQ: If this flag is set, the default behavior when
+ *      using ``rte_ring_dequeue()`` or ``rte_ring_dequeue_bulk()``
+ *      is "multi-consumer relaxed tail sync". Cannot be combined with
+ *      RING_F_SC_DEQ.
  * @return
  *   On success, the pointer to the new allocated ring. NULL on error with
  *    rte_errno set appropriately. Possible errno values include:
  *    - E_RTE_NO_CONFIG - function could not get pointer to rte_config structure
  *    - E_RTE_SECONDARY - function was called from a secondary process instance
- *    - EINVAL - count provided is not a power of 2
+ *    - EINVAL - count provided is not a power of 2, or invalid flags
  *    - ENOSPC - the maximum number of memzones has already been allocated
  *    - EEXIST - a memzone with the same name already exists
  *    - ENOMEM - no appropriate memory area found in which to create memzone
@@ -312,6 +382,8 @@ void rte_ring_dump(FILE *f, const struct rte_ring *r);
 #include "rte_ring_generic.h"
 #endif
 
+#include "rte_ring_rts.h"
+
 /**
  * @internal Enqueue several objects on the ring
  *
@@ -469,6 +541,10 @@ static __rte_always_inline unsigned int
 rte_ring_enqueue_bulk(struct rte_ring *r, void * const *obj_table,
 		      unsigned int n, unsigned int *free_space)
 {
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_RTS)
+		return __rte_ring_do_rts_enqueue(r, obj_table, n,
+				RTE_RING_QUEUE_FIXED, free_space);
+
 	return __rte_ring_do_enqueue(r, obj_table, n, RTE_RING_QUEUE_FIXED,
 			r->prod.single, free_space);
 }
@@ -604,6 +680,10 @@ static __rte_always_inline unsigned int
 rte_ring_dequeue_bulk(struct rte_ring *r, void **obj_table, unsigned int n,
 		unsigned int *available)
 {
+	if (r->cons.sync_type == RTE_RING_SYNC_MT_RTS)
+		return __rte_ring_do_rts_dequeue(r, obj_table, n,
+				RTE_RING_QUEUE_FIXED, available);
+
 	return __rte_ring_do_dequeue(r, obj_table, n, RTE_RING_QUEUE_FIXED,
 				r->cons.single, available);
 }
@@ -852,6 +932,10 @@ static __rte_always_inline unsigned
 rte_ring_enqueue_burst(struct rte_ring *r, void * const *obj_table,
 		      unsigned int n, unsigned int *free_space)
 {
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_RTS)
+		return __rte_ring_do_rts_enqueue(r, obj_table, n,
+				RTE_RING_QUEUE_VARIABLE, free_space);
+
 	return __rte_ring_do_enqueue(r, obj_table, n, RTE_RING_QUEUE_VARIABLE,
 			r->prod.single, free_space);
 }
@@ -932,6 +1016,10 @@ static __rte_always_inline unsigned
 rte_ring_dequeue_burst(struct rte_ring *r, void **obj_table,
 		unsigned int n, unsigned int *available)
 {
+	if (r->cons.sync_type == RTE_RING_SYNC_MT_RTS)
+		return __rte_ring_do_rts_dequeue(r, obj_table, n,
+				RTE_RING_QUEUE_VARIABLE, available);
+
 	return __rte_ring_do_dequeue(r, obj_table, n,
 				RTE_RING_QUEUE_VARIABLE,
 				r->cons.single, available);
@@ -0,0 +1,371 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#ifndef _RTE_RING_PEEK_ZC_H_
+#define _RTE_RING_PEEK_ZC_H_
+
+/**
+ * @file
+ * RTE Ring zero-copy API
+ *
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * These functions give direct access to the ring slots, avoiding the copy
+ * of the objects pointers from/to an intermediate table:
+ *
+ * - A producer reserves free slots with rte_ring_enqueue_zc_bulk_start()
+ *   or rte_ring_enqueue_zc_burst_start(), writes the objects in place and
+ *   commits all or part of them with rte_ring_enqueue_zc_finish().
+ * - A consumer peeks at the available objects with
+ *   rte_ring_dequeue_zc_bulk_start() or rte_ring_dequeue_zc_burst_start(),
+ *   and releases the ones it actually takes with
+ *   rte_ring_dequeue_zc_finish(). The other ones stay in the ring.
+ *
+ * Because the ring is circular, the slots are returned as up to two
+ * ranges, see struct rte_ring_zc_data.
+ *
+ * On a single-producer (single-consumer) side, the start/finish functions
+ * behave as the sp (sc) functions split in two. On a multi-producer
+ * (multi-consumer) side, a start function waits until no other thread of
+ * the same side is between start and finish, so that the unused slots
+ * can be given back: the zero-copy operations of a side are serialized.
+ * In that case, all the threads of that side must use the zero-copy API;
+ * the regular enqueue (dequeue) functions must not be called concurrently
+ * on the same ring. Relaxed tail sync (RTS) ring sides are not supported:
+ * the start functions reserve no slot on them.
+ *
+ * As with the other ring functions, a thread must not be preempted
+ * between start and finish, or the other threads of the same side wait.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <rte_debug.h>
+#include <rte_ring.h>
+
+/**
+ * Ring slots reserved by a zero-copy start function.
+ *
+ * Slot i, with i < n returned by the start function, is ptr1[i] if
+ * i < n1, and ptr2[i - n1] otherwise.
+ */
+struct rte_ring_zc_data {
+	void **ptr1;      /**< First range of slots. */
+	void **ptr2;      /**< Second range of slots, NULL if not needed. */
+	unsigned int n1;  /**< Number of slots in the first range. */
+	uint32_t head;    /**< @internal Head at start. */
+	uint32_t n;       /**< @internal Number of slots reserved at start. */
+};
+
+/**
+ * @internal Move the head of one side of the ring for a zero-copy
+ * operation.
+ *
+ * @param d
+ *   The head/tail of the side doing the operation.
+ * @param s
+ *   The head/tail of the other side.
+ * @param capacity
+ *   The ring capacity for an enqueue, 0 for a dequeue.
+ * @param num
+ *   The number of slots to reserve.
+ * @param behavior
+ *   RTE_RING_QUEUE_FIXED:    Reserve a fixed number of slots
+ *   RTE_RING_QUEUE_VARIABLE: Reserve as many slots as possible
+ * @param old_head
+ *   Returns the head value before the move.
+ * @param entries
+ *   Returns the number of free (enqueue) or used (dequeue) entries before
+ *   the move.
+ * @return
+ *   The number of slots reserved.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_zc_move_head(struct rte_ring_headtail *d,
+		const struct rte_ring_headtail *s, uint32_t capacity,
+		unsigned int num, enum rte_ring_queue_behavior behavior,
+		uint32_t *old_head, uint32_t *entries)
+{
+	uint32_t head;
+	unsigned int n;
+	int st = (d->sync_type == RTE_RING_SYNC_ST);
+
+	for (;;) {
+		n = num;
+		head = __atomic_load_n(&d->head, __ATOMIC_ACQUIRE);
+
+		/* wait for the other threads of this side to finish */
+		if (!st &&
+				__atomic_load_n(&d->tail, __ATOMIC_ACQUIRE) !=
+				head) {
+			rte_pause();
+			continue;
+		}
+
+		/* same modulo 32-bit arithmetic as the regular functions */
+		*entries = capacity +
+			__atomic_load_n(&s->tail, __ATOMIC_ACQUIRE) - head;
+		if (unlikely(n > *entries))
+			n = (behavior == RTE_RING_QUEUE_FIXED) ? 0 : *entries;
+		if (n == 0)
+			break;
+
+		if (st) {
+			d->head = head + n;
+			break;
+		}
+		if (__atomic_compare_exchange_n(&d->head, &head, head + n,
+				0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			break;
+	}
+
+	*old_head = head;
+	return n;
+}
+
+/**
+ * @internal Commit or release the first n slots reserved by a zero-copy
+ * start function, giving back the other ones.
+ */
+static __rte_always_inline void
+__rte_ring_zc_update_tail(struct rte_ring_headtail *ht, uint32_t head,
+		unsigned int n)
+{
+	/*
+	 * No other thread of this side can move the head until the tail
+	 * reaches it: rewind the head first, then release the slots.
+	 */
+	__atomic_store_n(&ht->head, head + n, __ATOMIC_RELAXED);
+	__atomic_store_n(&ht->tail, head + n, __ATOMIC_RELEASE);
+}
+
+/**
+ * @internal Fill the slot ranges of a zero-copy reservation.
+ */
+static __rte_always_inline void
+__rte_ring_zc_get_slots(struct rte_ring *r, uint32_t head, unsigned int n,
+		struct rte_ring_zc_data *zcd)
+{
+	void **ring = (void **)&r[1];
+	uint32_t idx = head & r->mask;
+
+	zcd->head = head;
+	zcd->n = n;
+	zcd->ptr1 = ring + idx;
+	if (likely(idx + n <= r->size)) {
+		zcd->n1 = n;
+		zcd->ptr2 = NULL;
+	} else {
+		zcd->n1 = r->size - idx;
+		zcd->ptr2 = ring;
+	}
+}
+
+/**
+ * @internal Start a zero-copy enqueue.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_enqueue_zc_start(struct rte_ring *r, unsigned int n,
+		enum rte_ring_queue_behavior behavior,
+		struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	uint32_t head, free_entries;
+
+	/* the RTS head/tail can't be serialized on */
+	if (unlikely(r->prod.sync_type == RTE_RING_SYNC_MT_RTS)) {
+		if (free_space != NULL)
+			*free_space = 0;
+		return 0;
+	}
+
+	n = __rte_ring_zc_move_head(&r->prod, &r->cons, r->capacity, n,
+			behavior, &head, &free_entries);
+	if (n != 0)
+		__rte_ring_zc_get_slots(r, head, n, zcd);
+
+	if (free_space != NULL)
+		*free_space = free_entries - n;
+	return n;
+}
+
+/**
+ * @internal Start a zero-copy dequeue.
+ */
+static __rte_always_inline unsigned int
+__rte_ring_do_dequeue_zc_start(struct rte_ring *r, unsigned int n,
+		enum rte_ring_queue_behavior behavior,
+		struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	uint32_t head, entries;
+
+	/* the RTS head/tail can't be serialized on */
+	if (unlikely(r->cons.sync_type == RTE_RING_SYNC_MT_RTS)) {
+		if (available != NULL)
+			*available = 0;
+		return 0;
+	}
+
+	n = __rte_ring_zc_move_head(&r->cons, &r->prod, 0, n,
+			behavior, &head, &entries);
+	if (n != 0)
+		__rte_ring_zc_get_slots(r, head, n, zcd);
+
+	if (available != NULL)
+		*available = entries - n;
+	return n;
+}
+
+/**
+ * Reserve a fixed number of free slots for a zero-copy enqueue.
+ *
+ * If n slots are reserved, the caller must write the objects in the slots
+ * described by *zcd*, then call rte_ring_enqueue_zc_finish().
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of slots to reserve.
+ * @param zcd
+ *   Structure filled with the reserved slots.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   reservation.
+ * @return
+ *   The number of slots reserved, either 0 or n.
+ */
+static __rte_always_inline unsigned int __rte_experimental
+rte_ring_enqueue_zc_bulk_start(struct rte_ring *r, unsigned int n,
+		struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	return __rte_ring_do_enqueue_zc_start(r, n, RTE_RING_QUEUE_FIXED,
+			zcd, free_space);
+}
+
+/**
+ * Reserve up to n free slots for a zero-copy enqueue.
+ *
+ * If slots are reserved, the caller must write the objects in the slots
+ * described by *zcd*, then call rte_ring_enqueue_zc_finish().
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The maximum number of slots to reserve.
+ * @param zcd
+ *   Structure filled with the reserved slots.
+ * @param free_space
+ *   If non-NULL, returns the amount of space in the ring after the
+ *   reservation.
+ * @return
+ *   The number of slots reserved.
+ */
+static __rte_always_inline unsigned int __rte_experimental
+rte_ring_enqueue_zc_burst_start(struct rte_ring *r, unsigned int n,
+		struct rte_ring_zc_data *zcd, unsigned int *free_space)
+{
+	return __rte_ring_do_enqueue_zc_start(r, n, RTE_RING_QUEUE_VARIABLE,
+			zcd, free_space);
+}
+
+/**
+ * Complete a zero-copy enqueue: the objects written in the first n
+ * reserved slots are made available to the consumers, and the other
+ * reserved slots are given back.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param zcd
+ *   The structure filled by the start function.
+ * @param n
+ *   The number of objects to enqueue, at most the number of slots
+ *   reserved. Must not be called if no slot was reserved.
+ */
+static __rte_always_inline void __rte_experimental
+rte_ring_enqueue_zc_finish(struct rte_ring *r,
+		const struct rte_ring_zc_data *zcd, unsigned int n)
+{
+	RTE_ASSERT(n <= zcd->n);
+	__rte_ring_zc_update_tail(&r->prod, zcd->head, n);
+}
+
+/**
+ * Peek at a fixed number of objects for a zero-copy dequeue.
+ *
+ * If n objects are returned, the caller can read them in the slots
+ * described by *zcd*, then must call rte_ring_dequeue_zc_finish().
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The number of objects to peek at.
+ * @param zcd
+ *   Structure filled with the slots of the objects.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   objects peeked at.
+ * @return
+ *   The number of objects peeked at, either 0 or n.
+ */
+static __rte_always_inline unsigned int __rte_experimental
+rte_ring_dequeue_zc_bulk_start(struct rte_ring *r, unsigned int n,
+		struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	return __rte_ring_do_dequeue_zc_start(r, n, RTE_RING_QUEUE_FIXED,
+			zcd, available);
+}
+
+/**
+ * Peek at up to n objects for a zero-copy dequeue.
+ *
+ * If objects are returned, the caller can read them in the slots
+ * described by *zcd*, then must call rte_ring_dequeue_zc_finish().
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param n
+ *   The maximum number of objects to peek at.
+ * @param zcd
+ *   Structure filled with the slots of the objects.
+ * @param available
+ *   If non-NULL, returns the number of remaining ring entries after the
+ *   objects peeked at.
+ * @return
+ *   The number of objects peeked at.
+ */
+static __rte_always_inline unsigned int __rte_experimental
+rte_ring_dequeue_zc_burst_start(struct rte_ring *r, unsigned int n,
+		struct rte_ring_zc_data *zcd, unsigned int *available)
+{
+	return __rte_ring_do_dequeue_zc_start(r, n, RTE_RING_QUEUE_VARIABLE,
+			zcd, available);
+}
+
+/**
+ * Complete a zero-copy dequeue: the first n objects peeked at are
+ * removed from the ring, the other ones stay in it.
+ *
+ * @param r
+ *   A pointer to the ring structure.
+ * @param zcd
+ *   The structure filled by the start function.
+ * @param n
+ *   The number of objects to dequeue, at most the number of objects
+ *   peeked at. Must not be called if no object was peeked at.
+ */
+static __rte_always_inline void __rte_experimental
+rte_ring_dequeue_zc_finish(struct rte_ring *r,
+		const struct rte_ring_zc_data *zcd, unsigned int n)
+{
+	RTE_ASSERT(n <= zcd->n);
+	__rte_ring_zc_update_tail(&r->cons, zcd->head, n);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _RTE_RING_PEEK_ZC_H_ */
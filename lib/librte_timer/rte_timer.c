@@ -7,6 +7,7 @@
 #include <stdint.h>
 #include <inttypes.h>
 #include <assert.h>
+#include <errno.h>
 #include <sys/queue.h>
 
 #include <rte_atomic.h>
@@ -14,6 +15,7 @@
 #include <rte_cycles.h>
 #include <rte_per_lcore.h>
 #include <rte_memory.h>
+#include <rte_malloc.h>
 #include <rte_launch.h>
 #include <rte_eal.h>
 #include <rte_lcore.h>
@@ -26,6 +28,33 @@
 
 LIST_HEAD(rte_timer_list, rte_timer);
 
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_BITS 8
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_MAP_WORDS (TIMER_WHEEL_SLOTS / 64)
+
+/* no limit on the number of expired timers to gather */
+#define TIMER_EXPIRE_ALL UINT32_MAX
+
+/* default wheel slot width, in fractions of a second */
+#define TIMER_WHEEL_DEFAULT_RES_DIV 100000
+
+/**
+ * Hierarchical timing wheel of one lcore. Level n has TIMER_WHEEL_SLOTS
+ * slots of 2^(n * TIMER_WHEEL_BITS) ticks each; timers too far in the
+ * future for the last level wait in the overflow list. Slots of upper
+ * levels are cascaded into lower levels when the current tick enters them.
+ */
+struct timer_wheel {
+	uint64_t cur_tick;   /**< next tick to be processed */
+	unsigned n_pending;  /**< number of timers linked in the wheel */
+	/** non-empty hint for level 0 slots, may have stale bits set */
+	uint64_t map[TIMER_WHEEL_MAP_WORDS];
+	struct rte_timer *slot[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	struct rte_timer *overflow; /**< timers beyond the last level */
+} __rte_cache_aligned;
+
 struct priv_timer {
 	struct rte_timer pending_head;  /**< dummy timer instance to head up list */
 	rte_spinlock_t list_lock;       /**< lock to protect list access */
@@ -39,6 +68,9 @@ struct priv_timer {
 
 	unsigned prev_lcore;              /**< used for lcore round robin */
 
+	/** timer wheel of this lcore, only used by the wheel engine */
+	struct timer_wheel *wheel;
+
 	/** running timer on this lcore now */
 	struct rte_timer *running_tim;
 
@@ -51,6 +83,12 @@ struct priv_timer {
 /** per-lcore private info for timers */
 static struct priv_timer priv_timer[RTE_MAX_LCORE];
 
+/** engine used to keep pending timers */
+static enum rte_timer_engine timer_engine = RTE_TIMER_ENGINE_SKIPLIST;
+
+/** log2 of the timer wheel slot width, in timer cycles */
+static unsigned timer_wheel_shift;
+
 /* when debug is enabled, store some statistics */
 #ifdef RTE_LIBRTE_TIMER_DEBUG
 #define __TIMER_STAT_ADD(name, n) do {					\
@@ -62,6 +100,18 @@ static struct priv_timer priv_timer[RTE_MAX_LCORE];
 #define __TIMER_STAT_ADD(name, n) do {} while(0)
 #endif
 
+/* Free the timer wheels, if any */
+static void
+timer_wheel_free_all(void)
+{
+	unsigned lcore_id;
+
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		rte_free(priv_timer[lcore_id].wheel);
+		priv_timer[lcore_id].wheel = NULL;
+	}
+}
+
 /* Init the timer library. */
 void
 rte_timer_subsystem_init(void)
@@ -77,6 +127,53 @@ rte_timer_subsystem_init(void)
 	}
 }
 
+/* Init the timer library with the given engine. */
+int __rte_experimental
+rte_timer_subsystem_init_engine(enum rte_timer_engine engine,
+				uint64_t resolution)
+{
+	struct timer_wheel *wheel;
+	uint64_t cur_tick;
+	unsigned lcore_id;
+
+	if (engine != RTE_TIMER_ENGINE_SKIPLIST &&
+			engine != RTE_TIMER_ENGINE_WHEEL)
+		return -EINVAL;
+
+	rte_timer_subsystem_init();
+	timer_wheel_free_all();
+	timer_engine = RTE_TIMER_ENGINE_SKIPLIST;
+	if (engine == RTE_TIMER_ENGINE_SKIPLIST)
+		return 0;
+
+	if (resolution == 0)
+		resolution = rte_get_timer_hz() / TIMER_WHEEL_DEFAULT_RES_DIV;
+	if (resolution <= 1)
+		timer_wheel_shift = 0;
+	else
+		timer_wheel_shift = 64 - __builtin_clzll(resolution - 1);
+
+	cur_tick = rte_get_timer_cycles() >> timer_wheel_shift;
+	for (lcore_id = 0; lcore_id < RTE_MAX_LCORE; lcore_id++) {
+		/* timers can only be armed on these lcores */
+		if (!rte_lcore_is_enabled(lcore_id) &&
+				!rte_lcore_has_role(lcore_id, ROLE_SERVICE))
+			continue;
+
+		wheel = rte_zmalloc_socket("timer_wheel", sizeof(*wheel),
+			RTE_CACHE_LINE_SIZE, rte_lcore_to_socket_id(lcore_id));
+		if (wheel == NULL) {
+			timer_wheel_free_all();
+			return -ENOMEM;
+		}
+		wheel->cur_tick = cur_tick;
+		priv_timer[lcore_id].wheel = wheel;
+	}
+
+	timer_engine = RTE_TIMER_ENGINE_WHEEL;
+	return 0;
+}
+
 /* Initialize the timer handle tim for use */
 void
 rte_timer_init(struct rte_timer *tim)
@@ -242,23 +339,14 @@ timer_get_prev_entries_for_node(struct rte_timer *tim, unsigned tim_lcore,
 }
 
 /*
- * add in list, lock if needed
- * timer must be in config state
- * timer must not be in a list
+ * add in skiplist, list must be locked
  */
 static void
-timer_add(struct rte_timer *tim, unsigned tim_lcore, int local_is_locked)
+timer_skiplist_add(struct rte_timer *tim, unsigned tim_lcore)
 {
-	unsigned lcore_id = rte_lcore_id();
 	unsigned lvl;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs to be scheduled on another core, we need to
-	 * lock the list; if it is on local core, we need to lock if
-	 * we are not called from rte_timer_manage() */
-	if (tim_lcore != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
-
 	/* find where exactly this element goes in the list of elements
 	 * for each depth. */
 	timer_get_prev_entries(tim->expire, tim_lcore, prev);
@@ -282,31 +370,17 @@ timer_add(struct rte_timer *tim, unsigned tim_lcore, int local_is_locked)
 	 * NOTE: this is not atomic on 32-bit*/
 	priv_timer[tim_lcore].pending_head.expire = priv_timer[tim_lcore].\
 			pending_head.sl_next[0]->expire;
-
-	if (tim_lcore != lcore_id || !local_is_locked)
-		rte_spinlock_unlock(&priv_timer[tim_lcore].list_lock);
 }
 
 /*
- * del from list, lock if needed
- * timer must be in config state
- * timer must be in a list
+ * del from skiplist, list must be locked
  */
 static void
-timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
-		int local_is_locked)
+timer_skiplist_del(struct rte_timer *tim, unsigned prev_owner)
 {
-	unsigned lcore_id = rte_lcore_id();
-	unsigned prev_owner = prev_status.owner;
 	int i;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH+1];
 
-	/* if timer needs is pending another core, we need to lock the
-	 * list; if it is on local core, we need to lock if we are not
-	 * called from rte_timer_manage() */
-	if (prev_owner != lcore_id || !local_is_locked)
-		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
-
 	/* save the lowest list entry into the expire field of the dummy hdr.
 	 * NOTE: this is not atomic on 32-bit */
 	if (tim == priv_timer[prev_owner].pending_head.sl_next[0])
@@ -326,6 +400,179 @@ timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
 			priv_timer[prev_owner].curr_skiplist_depth --;
 		else
 			break;
+}
+
+/*
+ * Link a timer in the slot of the wheel matching its expiry tick. Timers
+ * already expired are put in the slot of the next tick to be processed.
+ */
+static void
+timer_wheel_insert(struct timer_wheel *wheel, struct rte_timer *tim)
+{
+	uint64_t tick = tim->expire >> timer_wheel_shift;
+	uint64_t delta;
+	struct rte_timer **head;
+	unsigned lvl, idx;
+
+	if (tick < wheel->cur_tick)
+		tick = wheel->cur_tick;
+	delta = tick - wheel->cur_tick;
+
+	for (lvl = 0; lvl < TIMER_WHEEL_LEVELS; lvl++)
+		if (delta < (1ULL << ((lvl + 1) * TIMER_WHEEL_BITS)))
+			break;
+
+	if (lvl == TIMER_WHEEL_LEVELS) {
+		head = &wheel->overflow;
+	} else {
+		idx = (tick >> (lvl * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+		head = &wheel->slot[lvl][idx];
+		if (lvl == 0)
+			wheel->map[idx / 64] |= 1ULL << (idx % 64);
+	}
+
+	tim->wl.next = *head;
+	if (tim->wl.next != NULL)
+		tim->wl.next->wl.pprev = &tim->wl.next;
+	tim->wl.pprev = head;
+	*head = tim;
+}
+
+/*
+ * add in timer wheel, list must be locked
+ */
+static void
+timer_wheel_add(struct rte_timer *tim, unsigned tim_lcore)
+{
+	struct timer_wheel *wheel = priv_timer[tim_lcore].wheel;
+
+	/* an empty wheel may lag far behind the current time, catch up
+	 * so that rte_timer_manage() does not walk all the idle ticks */
+	if (wheel->n_pending == 0)
+		wheel->cur_tick = rte_get_timer_cycles() >> timer_wheel_shift;
+
+	timer_wheel_insert(wheel, tim);
+	wheel->n_pending++;
+}
+
+/*
+ * del from timer wheel, list must be locked
+ */
+static void
+timer_wheel_del(struct rte_timer *tim, unsigned prev_owner)
+{
+	/* timer was unlinked by rte_timer_manage() of its owner while
+	 * we were configuring it */
+	if (tim->wl.pprev == NULL)
+		return;
+
+	*tim->wl.pprev = tim->wl.next;
+	if (tim->wl.next != NULL)
+		tim->wl.next->wl.pprev = tim->wl.pprev;
+	tim->wl.pprev = NULL;
+	priv_timer[prev_owner].wheel->n_pending--;
+}
+
+/*
+ * Move the timers of the upper level slots entered by tick to lower
+ * levels. Called when the lowest level wraps.
+ */
+static void
+timer_wheel_cascade(struct timer_wheel *wheel, uint64_t tick)
+{
+	struct rte_timer *tim, *next_tim;
+	unsigned lvl, idx = 0;
+
+	for (lvl = 1; lvl <= TIMER_WHEEL_LEVELS; lvl++) {
+		if (lvl == TIMER_WHEEL_LEVELS) {
+			/* all levels wrapped, try again with overflowed timers */
+			tim = wheel->overflow;
+			wheel->overflow = NULL;
+		} else {
+			idx = (tick >> (lvl * TIMER_WHEEL_BITS)) &
+				TIMER_WHEEL_MASK;
+			tim = wheel->slot[lvl][idx];
+			wheel->slot[lvl][idx] = NULL;
+		}
+
+		for ( ; tim != NULL; tim = next_tim) {
+			next_tim = tim->wl.next;
+			timer_wheel_insert(wheel, tim);
+		}
+
+		/* next level is only entered when this one wraps */
+		if (idx != 0)
+			break;
+	}
+}
+
+/*
+ * Return the first possibly non-empty level 0 slot in [idx, end), or
+ * end if there is none.
+ */
+static unsigned
+timer_wheel_next_slot(const struct timer_wheel *wheel, unsigned idx,
+		unsigned end)
+{
+	uint64_t word;
+
+	while (idx < end) {
+		word = wheel->map[idx / 64] >> (idx % 64);
+		if (word != 0)
+			return RTE_MIN(idx + __builtin_ctzll(word), end);
+		idx = RTE_ALIGN_FLOOR(idx, 64) + 64;
+	}
+
+	return end;
+}
+
+/*
+ * add in list, lock if needed
+ * timer must be in config state
+ * timer must not be in a list
+ */
+static void
+timer_add(struct rte_timer *tim, unsigned tim_lcore, int local_is_locked)
+{
+	unsigned lcore_id = rte_lcore_id();
+
+	/* if timer needs to be scheduled on another core, we need to
+	 * lock the list; if it is on local core, we need to lock if
+	 * we are not called from rte_timer_manage() */
+	if (tim_lcore != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[tim_lcore].list_lock);
+
+	if (timer_engine == RTE_TIMER_ENGINE_WHEEL)
+		timer_wheel_add(tim, tim_lcore);
+	else
+		timer_skiplist_add(tim, tim_lcore);
+
+	if (tim_lcore != lcore_id || !local_is_locked)
+		rte_spinlock_unlock(&priv_timer[tim_lcore].list_lock);
+}
+
+/*
+ * del from list, lock if needed
+ * timer must be in config state
+ * timer must be in a list
+ */
+static void
+timer_del(struct rte_timer *tim, union rte_timer_status prev_status,
+		int local_is_locked)
+{
+	unsigned lcore_id = rte_lcore_id();
+	unsigned prev_owner = prev_status.owner;
+
+	/* if timer needs is pending another core, we need to lock the
+	 * list; if it is on local core, we need to lock if we are not
+	 * called from rte_timer_manage() */
+	if (prev_owner != lcore_id || !local_is_locked)
+		rte_spinlock_lock(&priv_timer[prev_owner].list_lock);
+
+	if (timer_engine == RTE_TIMER_ENGINE_WHEEL)
+		timer_wheel_del(tim, prev_owner);
+	else
+		timer_skiplist_del(tim, prev_owner);
 
 	if (prev_owner != lcore_id || !local_is_locked)
 		rte_spinlock_unlock(&priv_timer[prev_owner].list_lock);
@@ -356,6 +603,11 @@ __rte_timer_reset(struct rte_timer *tim, uint64_t expire,
 			tim_lcore = rte_get_next_lcore(LCORE_ID_ANY, 0, 1);
 	}
 
+	/* lcore was not known when the timer wheels were allocated */
+	if (timer_engine == RTE_TIMER_ENGINE_WHEEL &&
+			priv_timer[tim_lcore].wheel == NULL)
+		return -1;
+
 	/* wait that the timer is in correct status before update,
 	 * and mark it as being configured */
 	ret = timer_set_config_state(tim, &prev_status);
@@ -476,24 +728,89 @@ rte_timer_pending(struct rte_timer *tim)
 	return tim->status.state == RTE_TIMER_PENDING;
 }
 
-/* must be called periodically, run all timer that expired */
-void rte_timer_manage(void)
+/*
+ * transition a list of expired timers, linked through sl_next[0], from
+ * PENDING to RUNNING; list must be locked
+ */
+static struct rte_timer *
+timer_set_running_list(struct rte_timer *tim)
 {
-	union rte_timer_status status;
-	struct rte_timer *tim, *next_tim;
+	struct rte_timer *next_tim;
 	struct rte_timer *run_first_tim, **pprev;
-	unsigned lcore_id = rte_lcore_id();
+	int ret;
+
+	run_first_tim = tim;
+	pprev = &run_first_tim;
+
+	for ( ; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+
+		ret = timer_set_running_state(tim);
+		if (likely(ret == 0)) {
+			pprev = &tim->sl_next[0];
+		} else {
+			/* another core is trying to re-config this one,
+			 * remove it from local expired list
+			 */
+			*pprev = next_tim;
+		}
+	}
+
+	return run_first_tim;
+}
+
+/*
+ * pop at most max expired timers from the head of the skiplist and link
+ * them through sl_next[0]; list must be locked
+ */
+static struct rte_timer *
+timer_skiplist_pop_expired(unsigned lcore_id, uint64_t cur_time,
+		unsigned max)
+{
+	struct rte_timer *head = &priv_timer[lcore_id].pending_head;
+	struct rte_timer *tim, *run_first_tim, **run_last;
+	unsigned i, count = 0;
+
+	run_first_tim = NULL;
+	run_last = &run_first_tim;
+
+	while (count < max && (tim = head->sl_next[0]) != NULL &&
+			tim->expire <= cur_time) {
+		/* the first timer is first at all levels it belongs to */
+		for (i = 0; i < priv_timer[lcore_id].curr_skiplist_depth; i++) {
+			if (head->sl_next[i] != tim)
+				break;
+			head->sl_next[i] = tim->sl_next[i];
+		}
+		while (priv_timer[lcore_id].curr_skiplist_depth > 0 &&
+				head->sl_next[priv_timer[lcore_id].
+					curr_skiplist_depth - 1] == NULL)
+			priv_timer[lcore_id].curr_skiplist_depth--;
+
+		*run_last = tim;
+		run_last = &tim->sl_next[0];
+		count++;
+	}
+	*run_last = NULL;
+
+	return run_first_tim;
+}
+
+/*
+ * remove at most max expired timers from the skiplist and mark them as
+ * running
+ */
+static struct rte_timer *
+timer_skiplist_get_expired(unsigned lcore_id, unsigned max)
+{
+	struct rte_timer *tim, *run_first_tim;
 	struct rte_timer *prev[MAX_SKIPLIST_DEPTH + 1];
 	uint64_t cur_time;
-	int i, ret;
-
-	/* timer manager only runs on EAL thread with valid lcore_id */
-	assert(lcore_id < RTE_MAX_LCORE);
+	int i;
 
-	__TIMER_STAT_ADD(manage, 1);
 	/* optimize for the case where per-cpu list is empty */
 	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL)
-		return;
+		return NULL;
 	cur_time = rte_get_timer_cycles();
 
 #ifdef RTE_ARCH_64
@@ -501,7 +818,7 @@ void rte_timer_manage(void)
 	 * updated atomically, so we can consult that for a quick check here
 	 * outside the lock */
 	if (likely(priv_timer[lcore_id].pending_head.expire > cur_time))
-		return;
+		return NULL;
 #endif
 
 	/* browse ordered list, add expired timers in 'expired' list */
@@ -511,7 +828,12 @@ void rte_timer_manage(void)
 	if (priv_timer[lcore_id].pending_head.sl_next[0] == NULL ||
 	    priv_timer[lcore_id].pending_head.sl_next[0]->expire > cur_time) {
 		rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
-		return;
+		return NULL;
+	}
+
+	if (max != TIMER_EXPIRE_ALL) {
+		tim = timer_skiplist_pop_expired(lcore_id, cur_time, max);
+		goto expired;
 	}
 
 	/* save start of list of expired timers */
@@ -529,23 +851,9 @@ void rte_timer_manage(void)
 		prev[i] ->sl_next[i] = NULL;
 	}
 
+expired:
 	/* transition run-list from PENDING to RUNNING */
-	run_first_tim = tim;
-	pprev = &run_first_tim;
-
-	for ( ; tim != NULL; tim = next_tim) {
-		next_tim = tim->sl_next[0];
-
-		ret = timer_set_running_state(tim);
-		if (likely(ret == 0)) {
-			pprev = &tim->sl_next[0];
-		} else {
-			/* another core is trying to re-config this one,
-			 * remove it from local expired list
-			 */
-			*pprev = next_tim;
-		}
-	}
+	run_first_tim = timer_set_running_list(tim);
 
 	/* update the next to expire timer value */
 	priv_timer[lcore_id].pending_head.expire =
@@ -554,6 +862,122 @@ void rte_timer_manage(void)
 
 	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
 
+	return run_first_tim;
+}
+
+/*
+ * unlink at most max timers of the elapsed ticks from the wheel and link
+ * them through wl.next; list must be locked
+ */
+static struct rte_timer *
+timer_wheel_collect(struct timer_wheel *wheel, uint64_t cur_tick,
+		unsigned max)
+{
+	struct rte_timer *tim, *run_first_tim, **run_last;
+	uint64_t tick;
+	unsigned idx, end, next, count = 0;
+
+	run_first_tim = NULL;
+	run_last = &run_first_tim;
+
+	/* process each elapsed tick, gather expired slots in 'expired' list */
+	while (wheel->cur_tick < cur_tick && wheel->n_pending != 0) {
+		tick = wheel->cur_tick;
+		idx = tick & TIMER_WHEEL_MASK;
+		/* cascading again a tick left half-processed is harmless,
+		 * timers of the next round go back to the same slot */
+		if (idx == 0)
+			timer_wheel_cascade(wheel, tick);
+
+		/* skip empty slots up to the next wrap or the current tick */
+		if (cur_tick - tick < TIMER_WHEEL_SLOTS - idx)
+			end = idx + (cur_tick - tick);
+		else
+			end = TIMER_WHEEL_SLOTS;
+		next = timer_wheel_next_slot(wheel, idx, end);
+		wheel->cur_tick = tick + (next - idx);
+		if (next == end)
+			continue;
+
+		while ((tim = wheel->slot[0][next]) != NULL && count < max) {
+			wheel->slot[0][next] = tim->wl.next;
+			if (tim->wl.next != NULL)
+				tim->wl.next->wl.pprev = &wheel->slot[0][next];
+			tim->wl.pprev = NULL;
+			wheel->n_pending--;
+			*run_last = tim;
+			run_last = &tim->wl.next;
+			count++;
+		}
+
+		/* keep the rest of the slot for the next call */
+		if (tim != NULL)
+			break;
+
+		wheel->map[next / 64] &= ~(1ULL << (next % 64));
+		wheel->cur_tick++;
+	}
+	*run_last = NULL;
+
+	return run_first_tim;
+}
+
+/*
+ * remove at most max expired timers from the timer wheel and mark them
+ * as running
+ */
+static struct rte_timer *
+timer_wheel_get_expired(unsigned lcore_id, unsigned max)
+{
+	struct timer_wheel *wheel = priv_timer[lcore_id].wheel;
+	struct rte_timer *run_first_tim;
+	uint64_t cur_tick;
+
+	/* optimize for the case where per-cpu wheel is empty */
+	if (wheel->n_pending == 0)
+		return NULL;
+	cur_tick = rte_get_timer_cycles() >> timer_wheel_shift;
+
+#ifdef RTE_ARCH_64
+	/* on 64-bit the current tick of the wheel is updated atomically,
+	 * so we can check if there is a new tick to process outside the
+	 * lock */
+	if (likely(wheel->cur_tick >= cur_tick))
+		return NULL;
+#endif
+
+	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+
+	run_first_tim = timer_wheel_collect(wheel, cur_tick, max);
+
+	/* transition run-list from PENDING to RUNNING, wl.next and
+	 * sl_next[0] share the same storage */
+	run_first_tim = timer_set_running_list(run_first_tim);
+
+	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+
+	return run_first_tim;
+}
+
+/* must be called periodically, run all timer that expired */
+void rte_timer_manage(void)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim;
+	unsigned lcore_id = rte_lcore_id();
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	__TIMER_STAT_ADD(manage, 1);
+	if (timer_engine == RTE_TIMER_ENGINE_WHEEL)
+		run_first_tim = timer_wheel_get_expired(lcore_id,
+				TIMER_EXPIRE_ALL);
+	else
+		run_first_tim = timer_skiplist_get_expired(lcore_id,
+				TIMER_EXPIRE_ALL);
+
 	/* now scan expired list and call callbacks */
 	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
 		next_tim = tim->sl_next[0];
@@ -592,6 +1016,68 @@ void rte_timer_manage(void)
 	priv_timer[lcore_id].running_tim = NULL;
 }
 
+/* gather expired timers of the running lcore without calling callbacks */
+int __rte_experimental
+rte_timer_expire_burst(struct rte_timer **timers, unsigned int n)
+{
+	union rte_timer_status status;
+	struct rte_timer *tim, *next_tim;
+	struct rte_timer *run_first_tim, *reload_first_tim, **reload_last;
+	unsigned lcore_id = rte_lcore_id();
+	unsigned int count = 0;
+
+	/* timer manager only runs on EAL thread with valid lcore_id */
+	assert(lcore_id < RTE_MAX_LCORE);
+
+	if (n == 0)
+		return 0;
+
+	__TIMER_STAT_ADD(manage, 1);
+	if (timer_engine == RTE_TIMER_ENGINE_WHEEL)
+		run_first_tim = timer_wheel_get_expired(lcore_id, n);
+	else
+		run_first_tim = timer_skiplist_get_expired(lcore_id, n);
+
+	reload_first_tim = NULL;
+	reload_last = &reload_first_tim;
+
+	/* stop single timers, keep periodic ones aside to reload them
+	 * with a single lock */
+	for (tim = run_first_tim; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+		timers[count++] = tim;
+
+		if (tim->period == 0) {
+			__TIMER_STAT_ADD(pending, -1);
+			status.state = RTE_TIMER_STOP;
+			status.owner = RTE_TIMER_NO_OWNER;
+			rte_wmb();
+			tim->status.u32 = status.u32;
+		} else {
+			*reload_last = tim;
+			reload_last = &tim->sl_next[0];
+		}
+	}
+	*reload_last = NULL;
+
+	if (reload_first_tim == NULL)
+		return count;
+
+	rte_spinlock_lock(&priv_timer[lcore_id].list_lock);
+	for (tim = reload_first_tim; tim != NULL; tim = next_tim) {
+		next_tim = tim->sl_next[0];
+		status.state = RTE_TIMER_PENDING;
+		status.owner = (int16_t)lcore_id;
+		rte_wmb();
+		tim->status.u32 = status.u32;
+		__rte_timer_reset(tim, tim->expire + tim->period,
+			tim->period, lcore_id, tim->f, tim->arg, 1);
+	}
+	rte_spinlock_unlock(&priv_timer[lcore_id].list_lock);
+
+	return count;
+}
+
 /* dump statistics about timers */
 void rte_timer_dump_stats(FILE *f)
 {
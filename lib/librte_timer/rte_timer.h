@@ -39,6 +39,7 @@
 #include <stddef.h>
 #include <rte_common.h>
 #include <rte_config.h>
+#include <rte_compat.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -59,6 +60,14 @@ enum rte_timer_type {
 	PERIODICAL
 };
 
+/**
+ * Timer engine: the data structure used to keep pending timers.
+ */
+enum rte_timer_engine {
+	RTE_TIMER_ENGINE_SKIPLIST, /**< Ordered skiplist, O(log n) add/del. */
+	RTE_TIMER_ENGINE_WHEEL,    /**< Hierarchical timing wheel, O(1). */
+};
+
 /**
  * Timer status: A union of the state (stopped, pending, running,
  * config) and an owner (the id of the lcore that owns the timer).
@@ -99,7 +108,16 @@ typedef void (*rte_timer_cb_t)(struct rte_timer *, void *);
 struct rte_timer
 {
 	uint64_t expire;       /**< Time when timer expire. */
-	struct rte_timer *sl_next[MAX_SKIPLIST_DEPTH];
+	RTE_STD_C11
+	union {
+		/** Skiplist links (skiplist engine). */
+		struct rte_timer *sl_next[MAX_SKIPLIST_DEPTH];
+		/** Slot list links (timer wheel engine). */
+		struct {
+			struct rte_timer *next;   /**< Next timer in slot. */
+			struct rte_timer **pprev; /**< Link pointing to us. */
+		} wl;
+	};
 	volatile union rte_timer_status status; /**< Status of timer. */
 	uint64_t period;       /**< Period of timer (0 if not periodic). */
 	rte_timer_cb_t f;      /**< Callback function. */
@@ -139,6 +157,38 @@ struct rte_timer
  */
 void rte_timer_subsystem_init(void);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Initialize the timer library with a given timer engine.
+ *
+ * Timers are kept in a skiplist unless another engine is selected
+ * here; rte_timer_subsystem_init() keeps the current engine. The
+ * hierarchical timing wheel engine keeps pending timers in per-lcore
+ * slot lists, which makes arming, stopping and expiring a timer O(1)
+ * regardless of the number of pending timers, at the cost of expiry
+ * precision: a timer expires on the first call to rte_timer_manage()
+ * following the end of the wheel slot containing its expiry time.
+ *
+ * Like rte_timer_subsystem_init(), this function must be called before
+ * any timer is armed, and must not be called while timers are pending.
+ *
+ * @param engine
+ *   The engine used to keep pending timers.
+ * @param resolution
+ *   Timer wheel slot width in timer cycles (see rte_get_timer_hz()),
+ *   rounded up to a power of two. If 0, a default of about 10 us is
+ *   used. Ignored by the skiplist engine.
+ * @return
+ *   - 0: Success.
+ *   - (-EINVAL): Invalid engine.
+ *   - (-ENOMEM): Not enough memory for the timer wheels.
+ */
+int __rte_experimental
+rte_timer_subsystem_init_engine(enum rte_timer_engine engine,
+				uint64_t resolution);
+
 /**
  * Initialize a timer handle.
  *
@@ -294,6 +344,37 @@ int rte_timer_pending(struct rte_timer *tim);
  */
 void rte_timer_manage(void);
 
+/**
+ * @warning
+ * @b EXPERIMENTAL: this API may change without prior notice
+ *
+ * Retrieve expired timers of the calling lcore without calling their
+ * callback functions.
+ *
+ * This function is an alternative to rte_timer_manage() for applications
+ * processing timer expiries in batches, for instance aging many flows at
+ * once. It gathers at most *n* expired timers of the calling lcore, in
+ * expiry order for the skiplist engine, taking the list lock once for the
+ * whole burst, and returns them in the *timers* array. The callback
+ * function and argument of the timers are not called, the caller is
+ * responsible for processing the returned timers, typically using the
+ * *arg* field.
+ *
+ * When this function returns, single timers are stopped and can be
+ * reset, stopped or freed by the caller, and periodic timers are pending
+ * again, reloaded for their next period. Expired timers left over
+ * because *n* was too small are returned by the next call.
+ *
+ * @param timers
+ *   An array of at least *n* pointers, filled with the expired timers.
+ * @param n
+ *   The maximum number of timers to retrieve.
+ * @return
+ *   The number of timers stored in *timers*.
+ */
+int __rte_experimental
+rte_timer_expire_burst(struct rte_timer **timers, unsigned int n);
+
 /**
  * Dump statistics about timers.
  *
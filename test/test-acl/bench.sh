@@ -0,0 +1,30 @@
+#!/bin/sh -e
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright(c) 2018 Intel Corporation
+
+# Compare the classify methods of the ACL library on synthetic rule sets
+# of increasing size.
+#
+# usage: bench.sh <testacl binary> [EAL options]
+# The rule set sizes and the methods can be changed with the RULES and ALGS
+# environment variables.
+
+TESTACL=${1:?usage: $0 <testacl binary> [EAL options]}
+shift
+
+RULES=${RULES:-"1000 10000 100000"}
+ALGS=${ALGS:-"sse avx2 avx512"}
+DIR=$(mktemp -d)
+trap 'rm -rf $DIR' EXIT
+
+for n in $RULES ; do
+	python $(dirname $0)/gen_rules.py --rules=$n \
+		$DIR/rules_$n $DIR/trace_$n
+	for alg in $ALGS ; do
+		printf "%s rules, %s: " $n $alg
+		$TESTACL "$@" -- --rulesf=$DIR/rules_$n --rulenum=$n \
+			--tracef=$DIR/trace_$n --tracenum=65536 --iter=10 \
+			--alg=$alg --verbose=0 | \
+			sed -n 's/.* \([0-9.]* cycles\/pkt\)/\1/p'
+	done
+done
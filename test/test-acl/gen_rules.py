@@ -0,0 +1,98 @@
+#!/usr/bin/env python
+# SPDX-License-Identifier: BSD-3-Clause
+# Copyright(c) 2018 Intel Corporation
+
+"""
+Generate a synthetic IPv4 5-tuple rule set in the ClassBench format used by
+testacl, and a trace file of packets that match its rules.
+"""
+
+from __future__ import print_function
+import random
+import sys
+from optparse import OptionParser
+
+
+def ipv4(v):
+    return "%d.%d.%d.%d" % (v >> 24, (v >> 16) & 0xff, (v >> 8) & 0xff,
+                            v & 0xff)
+
+
+def prefix(masklen):
+    if masklen == 0:
+        return 0
+    return random.getrandbits(32) & (((1 << masklen) - 1) << (32 - masklen))
+
+
+def host(net, masklen):
+    if masklen == 32:
+        return net
+    return net | random.getrandbits(32 - masklen)
+
+
+def port_range():
+    r = random.random()
+    if r < 0.3:
+        return (0, 65535)
+    if r < 0.65:
+        p = random.randrange(0, 1024)
+        return (p, p)
+    p = random.randrange(1024, 60000)
+    return (p, p + random.randrange(0, 5000))
+
+
+def gen_rules(num):
+    rules = []
+    for _ in range(num):
+        src_len = random.choice([0, 8, 16, 24, 24, 32, 32])
+        dst_len = random.choice([8, 16, 24, 24, 32, 32])
+        if random.random() < 0.5:
+            src_port = (0, 65535)
+        else:
+            p = random.randrange(1024, 65536)
+            src_port = (p, p)
+        rules.append((prefix(src_len), src_len, prefix(dst_len), dst_len,
+                      src_port, port_range(),
+                      random.choice([(6, 0xff), (17, 0xff), (0, 0)])))
+    return rules
+
+
+def write_rules(f, rules):
+    for (src, src_len, dst, dst_len, sp, dp, proto) in rules:
+        print("@%s/%d\t%s/%d\t%d : %d\t%d : %d\t0x%02x/0x%02x" %
+              (ipv4(src), src_len, ipv4(dst), dst_len, sp[0], sp[1],
+               dp[0], dp[1], proto[0], proto[1]), file=f)
+
+
+def write_trace(f, rules, num):
+    for _ in range(num):
+        (src, src_len, dst, dst_len, sp, dp, proto) = random.choice(rules)
+        print("%u %u %u %u %u" %
+              (host(src, src_len), host(dst, dst_len),
+               random.randint(sp[0], sp[1]), random.randint(dp[0], dp[1]),
+               proto[0] if proto[1] else random.choice([1, 6, 17])), file=f)
+
+
+def main():
+    parser = OptionParser(usage="%prog [options] <rules file> <trace file>")
+    parser.add_option("-r", "--rules", type="int", default=10000,
+                      help="number of rules (default %default)")
+    parser.add_option("-t", "--traces", type="int", default=65536,
+                      help="number of packets (default %default)")
+    parser.add_option("-s", "--seed", type="int", default=0,
+                      help="random seed (default %default)")
+    (opts, args) = parser.parse_args()
+    if len(args) != 2:
+        parser.print_help()
+        sys.exit(1)
+
+    random.seed(opts.seed)
+    rules = gen_rules(opts.rules)
+    with open(args[0], "w") as f:
+        write_rules(f, rules)
+    with open(args[1], "w") as f:
+        write_trace(f, rules, opts.traces)
+
+
+if __name__ == "__main__":
+    main()
@@ -40,6 +40,7 @@
 #define	OPT_ITER_NUM		"iter"
 #define	OPT_VERBOSE		"verbose"
 #define	OPT_IPV6		"ipv6"
+#define	OPT_BLD_WORKERS		"bldworkers"
 
 #define	TRACE_DEFAULT_NUM	0x10000
 #define	TRACE_STEP_MAX		0x1000
@@ -80,6 +81,10 @@ static const struct acl_alg acl_alg[] = {
 		.name = "altivec",
 		.alg = RTE_ACL_CLASSIFY_ALTIVEC,
 	},
+	{
+		.name = "avx512",
+		.alg = RTE_ACL_CLASSIFY_AVX512,
+	},
 };
 
 static struct {
@@ -96,6 +101,7 @@ static struct {
 	uint32_t            iter_num;
 	uint32_t            verbose;
 	uint32_t            ipv6;
+	uint32_t            bld_workers;
 	struct acl_alg      alg;
 	uint32_t            used_traces;
 	void               *traces;
@@ -757,7 +763,9 @@ acx_init(void)
 {
 	int ret;
 	FILE *f;
+	uint64_t tm;
 	struct rte_acl_config cfg;
+	struct rte_acl_build_workers workers;
 
 	memset(&cfg, 0, sizeof(cfg));
 
@@ -801,11 +809,18 @@ acx_init(void)
 	fclose(f);
 
 	/* perform build. */
-	ret = rte_acl_build(config.acx, &cfg);
+	memset(&workers, 0, sizeof(workers));
+	workers.num_workers = config.bld_workers;
+
+	tm = rte_rdtsc();
+	ret = rte_acl_build_parallel(config.acx, &cfg, &workers);
+	tm = rte_rdtsc() - tm;
 
 	dump_verbose(DUMP_NONE, stdout,
-		"rte_acl_build(%u) finished with %d\n",
-		config.bld_categories, ret);
+		"rte_acl_build(%u) with %u workers finished with %d "
+		"in %.3f sec\n",
+		config.bld_categories, config.bld_workers, ret,
+		(double)tm / rte_get_tsc_hz());
 
 	rte_acl_dump(config.acx);
 
@@ -952,7 +967,9 @@ print_usage(const char *prgname)
 		"[--" OPT_ITER_NUM "=<number of iterations to perform>]\n"
 		"[--" OPT_VERBOSE "=<verbose level>]\n"
 		"[--" OPT_SEARCH_ALG "=%s]\n"
-		"[--" OPT_IPV6 "=<IPv6 rules and trace files>]\n",
+		"[--" OPT_IPV6 "=<IPv6 rules and trace files>]\n"
+		"[--" OPT_BLD_WORKERS
+			"=<number of threads to build with>]\n",
 		prgname, RTE_ACL_RESULTS_MULTIPLIER,
 		(uint32_t)RTE_ACL_MAX_CATEGORIES,
 		buf);
@@ -975,6 +992,7 @@ dump_config(FILE *f)
 	fprintf(f, "%s:%u(%s)\n", OPT_SEARCH_ALG, config.alg.alg,
 		config.alg.name);
 	fprintf(f, "%s:%u\n", OPT_IPV6, config.ipv6);
+	fprintf(f, "%s:%u\n", OPT_BLD_WORKERS, config.bld_workers);
 }
 
 static void
@@ -1004,6 +1022,7 @@ get_input_opts(int argc, char **argv)
 		{OPT_VERBOSE, 1, 0, 0},
 		{OPT_SEARCH_ALG, 1, 0, 0},
 		{OPT_IPV6, 0, 0, 0},
+		{OPT_BLD_WORKERS, 1, 0, 0},
 		{NULL, 0, 0, 0}
 	};
 
@@ -1053,6 +1072,10 @@ get_input_opts(int argc, char **argv)
 			get_alg_opt(optarg, lgopts[opt_idx].name);
 		} else if (strcmp(lgopts[opt_idx].name, OPT_IPV6) == 0) {
 			config.ipv6 = 1;
+		} else if (strcmp(lgopts[opt_idx].name,
+				OPT_BLD_WORKERS) == 0) {
+			config.bld_workers = get_ulong_opt(optarg,
+				lgopts[opt_idx].name, 0, UINT32_MAX);
 		}
 	}
 	config.trace_sz = config.ipv6 ? sizeof(struct ipv6_5tuple) :
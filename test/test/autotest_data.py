@@ -40,6 +40,18 @@ def per_sockets(num):
                 "Func":    timer_autotest,
                 "Report":   None,
             },
+            {
+                "Name":    "Timer wheel autotest",
+                "Command": "timer_wheel_autotest",
+                "Func":    default_autotest,
+                "Report":  None,
+            },
+            {
+                "Name":    "Timer expire burst autotest",
+                "Command": "timer_expire_burst_autotest",
+                "Func":    default_autotest,
+                "Report":  None,
+            },
             {
                 "Name":    "Debug autotest",
                 "Command": "debug_autotest",
@@ -144,6 +156,18 @@ def per_sockets(num):
                 "Func":    default_autotest,
                 "Report":  None,
             },
+            {
+                "Name":    "LPM64 autotest",
+                "Command": "lpm64_autotest",
+                "Func":    default_autotest,
+                "Report":  None,
+            },
+            {
+                "Name":    "LPM6 trie autotest",
+                "Command": "lpm6_trie_autotest",
+                "Func":    default_autotest,
+                "Report":  None,
+            },
             {
                 "Name":    "Memcpy autotest",
                 "Command": "memcpy_autotest",
@@ -369,6 +393,19 @@ def per_sockets(num):
             },
         ]
     },
+    {
+        "Prefix":    "mbuf_perf",
+        "Memory":    per_sockets(512),
+        "Tests":
+        [
+            {
+                "Name":    "Mbuf performance autotest",
+                "Command": "mbuf_perf_autotest",
+                "Func":    default_autotest,
+                "Report":  None,
+            },
+        ]
+    },
     {
         "Prefix":    "memcpy_perf",
         "Memory":    per_sockets(512),
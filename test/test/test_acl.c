@@ -13,6 +13,7 @@
 #include <rte_ip.h>
 #include <rte_acl.h>
 #include <rte_common.h>
+#include <rte_lcore.h>
 
 #include "test_acl.h"
 
@@ -391,6 +392,51 @@ test_classify_buid(struct rte_acl_ctx *acx,
 	return 0;
 }
 
+/*
+ * Run the lookup with all the vector methods supported by the cpu.
+ */
+static int
+test_classify_alg(struct rte_acl_ctx *acx)
+{
+#ifdef RTE_ARCH_X86
+	static const struct {
+		enum rte_acl_classify_alg alg;
+		enum rte_cpu_flag_t flags[2];
+	} algs[] = {
+		{RTE_ACL_CLASSIFY_SSE,
+			{RTE_CPUFLAG_SSE4_1, RTE_CPUFLAG_SSE4_1} },
+		{RTE_ACL_CLASSIFY_AVX2,
+			{RTE_CPUFLAG_AVX2, RTE_CPUFLAG_AVX2} },
+		{RTE_ACL_CLASSIFY_AVX512,
+			{RTE_CPUFLAG_AVX512F, RTE_CPUFLAG_AVX512BW} },
+	};
+	uint32_t i;
+	int ret;
+
+	for (i = 0; i != RTE_DIM(algs); i++) {
+		if (rte_cpu_get_flag_enabled(algs[i].flags[0]) <= 0 ||
+				rte_cpu_get_flag_enabled(algs[i].flags[1]) <= 0)
+			continue;
+
+		/* not supported by the compiler */
+		if (rte_acl_classify_alg(acx, NULL, NULL, 0, 1,
+				algs[i].alg) == -ENOTSUP)
+			continue;
+
+		rte_acl_set_ctx_classify(acx, algs[i].alg);
+		ret = test_classify_run(acx);
+		if (ret != 0) {
+			printf("Line %i: classify method %d failed!\n",
+				__LINE__, algs[i].alg);
+			return ret;
+		}
+	}
+#else
+	RTE_SET_USED(acx);
+#endif
+	return 0;
+}
+
 #define	TEST_CLASSIFY_ITER	4
 
 /*
@@ -432,6 +478,13 @@ test_classify(void)
 			break;
 		}
 
+		ret = test_classify_alg(acx);
+		if (ret != 0) {
+			printf("Line %i, iter: %d: %s failed!\n",
+				__LINE__, i, __func__);
+			break;
+		}
+
 		/* reset rules and make sure that classify still works ok. */
 		rte_acl_reset_rules(acx);
 		ret = test_classify_run(acx);
@@ -446,6 +499,260 @@ test_classify(void)
 	return ret;
 }
 
+#define	TEST_UPDATE_DECOY	100
+
+/*
+ * Test the incremental updates of a built context: build it with half of
+ * the rules and higher priority copies of all of them, then add the other
+ * half and delete the copies without rebuilding.
+ */
+static int
+test_update(void)
+{
+	struct rte_acl_ctx *acx;
+	struct rte_acl_ipv4vlan_rule rule;
+	struct acl_ipv4vlan_rule rules[RTE_DIM(acl_test_rules)];
+	uint32_t userdata[RTE_DIM(acl_test_rules)];
+	uint32_t i, half;
+	int ret;
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	/* updates need a built context */
+	acl_ipv4vlan_convert_rule(&acl_test_rules[0], &rules[0]);
+	ret = rte_acl_update_add_rules(acx,
+		(struct rte_acl_rule *)rules, 1);
+	if (ret != -EINVAL) {
+		printf("Line %i: Update of a context not built "
+			"should have failed!\n", __LINE__);
+		goto err;
+	}
+
+	half = RTE_DIM(acl_test_rules) / 2;
+	ret = rte_acl_ipv4vlan_add_rules(acx, acl_test_rules, half);
+	for (i = 0; i != RTE_DIM(acl_test_rules) && ret == 0; i++) {
+		rule = acl_test_rules[i];
+		rule.data.userdata += TEST_UPDATE_DECOY;
+		rule.data.priority = RTE_ACL_MAX_PRIORITY - i;
+		ret = rte_acl_ipv4vlan_add_rules(acx, &rule, 1);
+	}
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* add the other half of the rules */
+	for (i = half; i != RTE_DIM(acl_test_rules); i++)
+		acl_ipv4vlan_convert_rule(&acl_test_rules[i], &rules[i - half]);
+
+	ret = rte_acl_update_add_rules(acx, (struct rte_acl_rule *)rules,
+		RTE_DIM(acl_test_rules) - half);
+	if (ret != 0) {
+		printf("Line %i: Incremental add failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_update_add_rules(acx, (struct rte_acl_rule *)rules, 1);
+	if (ret != -EEXIST) {
+		printf("Line %i: Adding an existing userdata "
+			"should have failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* delete the copies, in two steps */
+	for (i = 0; i != RTE_DIM(acl_test_rules); i++)
+		userdata[i] = acl_test_rules[i].data.userdata +
+			TEST_UPDATE_DECOY;
+
+	/* a userdata given twice is rejected, before any rule is deleted */
+	userdata[half] = userdata[0];
+	ret = rte_acl_update_del_rules(acx, userdata, half + 1);
+	if (ret != -EINVAL) {
+		printf("Line %i: Deleting a userdata twice "
+			"should have failed!\n", __LINE__);
+		goto err;
+	}
+	userdata[half] = acl_test_rules[half].data.userdata +
+		TEST_UPDATE_DECOY;
+
+	ret = rte_acl_update_del_rules(acx, userdata, half);
+	if (ret == 0)
+		ret = rte_acl_update_del_rules(acx, userdata + half,
+			RTE_DIM(acl_test_rules) - half);
+	if (ret != 0) {
+		printf("Line %i: Incremental delete failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = rte_acl_update_del_rules(acx, userdata, 1);
+	if (ret != -ENOENT) {
+		printf("Line %i: Deleting a missing userdata "
+			"should have failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = test_classify_run(acx);
+	if (ret != 0) {
+		printf("Line %i: Classify after updates failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* replace a rule of the main tries and one of the updates */
+	userdata[0] = acl_test_rules[0].data.userdata;
+	userdata[1] = acl_test_rules[RTE_DIM(acl_test_rules) - 1].data.userdata;
+	acl_ipv4vlan_convert_rule(&acl_test_rules[0], &rules[0]);
+	acl_ipv4vlan_convert_rule(&acl_test_rules[RTE_DIM(acl_test_rules) - 1],
+		&rules[1]);
+
+	ret = rte_acl_update_del_rules(acx, userdata, 2);
+	if (ret == 0)
+		ret = rte_acl_update_add_rules(acx,
+			(struct rte_acl_rule *)rules, 2);
+	if (ret != 0) {
+		printf("Line %i: Replacing rules failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = test_classify_run(acx);
+	if (ret != 0) {
+		printf("Line %i: Classify after replace failed!\n", __LINE__);
+		goto err;
+	}
+
+	/* a full build must give the same results */
+	ret = rte_acl_ipv4vlan_build(acx, ipv4_7tuple_layout,
+		RTE_ACL_MAX_CATEGORIES);
+	if (ret != 0) {
+		printf("Line %i: Building ACL context failed!\n", __LINE__);
+		goto err;
+	}
+
+	ret = test_classify_run(acx);
+	if (ret != 0)
+		printf("Line %i: Classify after rebuild failed!\n", __LINE__);
+
+err:
+	rte_acl_free(acx);
+	return ret == 0 ? 0 : -1;
+}
+
+#define	TEST_BUILD_WORKERS	8
+
+/*
+ * Test the parallel build: the context must classify the same way
+ * whatever the number of workers.
+ */
+static int
+test_build_parallel(void)
+{
+	static const size_t mem_sizes[] = {0, -1};
+	struct rte_acl_build_workers workers;
+	struct rte_acl_config cfg;
+	struct rte_acl_ctx *acx;
+	unsigned int lcore_id, lcores[TEST_BUILD_WORKERS];
+	uint32_t i, n;
+	int ret;
+
+	acx = rte_acl_create(&acl_param);
+	if (acx == NULL) {
+		printf("Line %i: Error creating ACL context!\n", __LINE__);
+		return -1;
+	}
+
+	ret = rte_acl_ipv4vlan_add_rules(acx, acl_test_rules,
+		RTE_DIM(acl_test_rules));
+	if (ret != 0) {
+		printf("Line %i: Adding rules to ACL context failed!\n",
+			__LINE__);
+		goto err;
+	}
+
+	memset(&workers, 0, sizeof(workers));
+
+	for (n = 0; n <= TEST_BUILD_WORKERS; n++) {
+		for (i = 0; i != RTE_DIM(mem_sizes); i++) {
+
+			memset(&cfg, 0, sizeof(cfg));
+			acl_ipv4vlan_config(&cfg, ipv4_7tuple_layout,
+				RTE_ACL_MAX_CATEGORIES);
+			cfg.max_size = mem_sizes[i];
+
+			workers.num_workers = n;
+			ret = rte_acl_build_parallel(acx, &cfg, &workers);
+			if (ret != 0) {
+				printf("Line %i: Building ACL context with %u "
+					"workers failed!\n", __LINE__, n);
+				goto err;
+			}
+
+			ret = test_classify_run(acx);
+			if (ret != 0) {
+				printf("Line %i: %s with %u workers, "
+					"max_size=%zu failed!\n", __LINE__,
+					__func__, n, mem_sizes[i]);
+				goto err;
+			}
+		}
+	}
+
+	/* build on the slave lcores, if any */
+	n = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (n != RTE_DIM(lcores))
+			lcores[n++] = lcore_id;
+	}
+
+	if (n != 0) {
+		workers.num_workers = n;
+		workers.lcore_id = lcores;
+		ret = rte_acl_build_parallel(acx, &cfg, &workers);
+		if (ret != 0) {
+			printf("Line %i: Building ACL context on %u lcores "
+				"failed!\n", __LINE__, n);
+			goto err;
+		}
+
+		ret = test_classify_run(acx);
+		if (ret != 0) {
+			printf("Line %i: %s on %u lcores failed!\n",
+				__LINE__, __func__, n);
+			goto err;
+		}
+	}
+
+	/* the calling lcore can't be a worker */
+	lcore_id = rte_lcore_id();
+	workers.num_workers = 1;
+	workers.lcore_id = &lcore_id;
+	ret = rte_acl_build_parallel(acx, &cfg, &workers);
+	if (ret != -EINVAL) {
+		printf("Line %i: Building ACL context on the calling lcore "
+			"should have failed!\n", __LINE__);
+		ret = -1;
+		goto err;
+	}
+
+	ret = test_classify_run(acx);
+	if (ret != 0)
+		printf("Line %i: %s failed!\n", __LINE__, __func__);
+
+err:
+	rte_acl_free(acx);
+	return ret;
+}
+
 static int
 test_build_ports_range(void)
 {
@@ -1612,6 +1919,10 @@ test_acl(void)
 		return -1;
 	if (test_classify() < 0)
 		return -1;
+	if (test_update() < 0)
+		return -1;
+	if (test_build_parallel() < 0)
+		return -1;
 	if (test_build_ports_range() < 0)
 		return -1;
 	if (test_convert() < 0)
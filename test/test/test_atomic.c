@@ -61,6 +61,17 @@
  *       atomic_sub(&count, tmp+1);
  *
  *   - At the end of the test, the *count* value must be 0.
+ *
+ * - Test "128-bit compare and exchange" (x86_64 only)
+ *
+ *   - Initialize a 128-bit atomic variable to zero.
+ *
+ *   - Invoke ``test_atomic128_cmp_exchange()`` on each lcore. Each lcore
+ *     adds 1 to the low 64 bits and 2 to the high 64 bits of the variable
+ *     several times, with a compare and exchange loop.
+ *
+ *   - At the end of the test, both halves must hold the sum of the
+ *     additions, which checks that the 128 bits are updated at once.
  */
 
 #define NUM_ATOMIC_TYPES 3
@@ -216,6 +227,33 @@ test_atomic_dec_and_test(__attribute__((unused)) void *arg)
 	return 0;
 }
 
+#ifdef RTE_ARCH_X86_64
+static rte_int128_t a128;
+
+static int
+test_atomic128_cmp_exchange(__attribute__((unused)) void *arg)
+{
+	rte_int128_t expected, desired;
+	unsigned int i;
+
+	while (rte_atomic32_read(&synchro) == 0)
+		;
+
+	expected = a128;
+	for (i = 0; i < N; i++) {
+		do {
+			desired.val[0] = expected.val[0] + 1;
+			desired.val[1] = expected.val[1] + 2;
+		} while (rte_atomic128_cmp_exchange(&a128, &expected,
+				&desired, 1, __ATOMIC_ACQ_REL,
+				__ATOMIC_RELAXED) == 0);
+		expected = desired;
+	}
+
+	return 0;
+}
+#endif
+
 static int
 test_atomic(void)
 {
@@ -340,6 +378,24 @@ test_atomic(void)
 		return -1;
 	}
 
+#ifdef RTE_ARCH_X86_64
+	printf("128-bit compare and exchange\n");
+
+	a128.val[0] = 0;
+	a128.val[1] = 0;
+	rte_eal_mp_remote_launch(test_atomic128_cmp_exchange, NULL,
+				 SKIP_MASTER);
+	rte_atomic32_set(&synchro, 1);
+	rte_eal_mp_wait_lcore();
+	rte_atomic32_clear(&synchro);
+
+	if (a128.val[0] != (uint64_t)N * (rte_lcore_count() - 1) ||
+			a128.val[1] != 2 * a128.val[0]) {
+		printf("Atomic128 compare and exchange failed\n");
+		return -1;
+	}
+#endif
+
 	return 0;
 }
 
@@ -0,0 +1,501 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_lcore.h>
+#include <rte_gro.h>
+
+#include "test.h"
+
+#define TEST_GRO_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define NUM_MBUFS 256
+#define MBUF_CACHE_SIZE 32
+#define MBUF_SIZE (RTE_PKTMBUF_HEADROOM + 512)
+
+#define TCP_ACK 0x10
+#define TCP_PAYLOAD_LEN 100
+#define FRAG_LEN 64
+#define NB_FRAGS 4
+#define IPV4_OPTS_LEN 4
+#define IPV4_OPT_NOP 1
+#define VXLAN_PORT 4789
+
+static struct rte_mempool *pool;
+
+/*
+ * Fills the payload of a packet with a pattern which depends on the
+ * offset of the payload in the stream or in the datagram.
+ */
+static void
+fill_payload(uint8_t *p, uint32_t offset, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i != len; i++)
+		p[i] = (uint8_t)(offset + i);
+}
+
+static int
+check_payload(const struct rte_mbuf *m, uint32_t hdr_len,
+		uint32_t offset, uint32_t len)
+{
+	uint8_t buf[MBUF_SIZE * NB_FRAGS];
+	const uint8_t *p;
+	uint32_t i;
+
+	if (m->pkt_len != hdr_len + len)
+		return -1;
+
+	p = rte_pktmbuf_read(m, hdr_len, len, buf);
+	if (p == NULL)
+		return -1;
+
+	for (i = 0; i != len; i++)
+		if (p[i] != (uint8_t)(offset + i))
+			return -1;
+	return 0;
+}
+
+/* Builds a TCP/IPv6 segment starting at seq in the stream. */
+static struct rte_mbuf *
+build_tcp6_segment(uint32_t seq)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+	struct ipv6_hdr *ip;
+	struct tcp_hdr *tcp;
+	uint16_t len;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	len = sizeof(*eth) + sizeof(*ip) + sizeof(*tcp) + TCP_PAYLOAD_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	memset(eth, 0, len);
+	eth->s_addr.addr_bytes[5] = 1;
+	eth->d_addr.addr_bytes[5] = 2;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv6);
+
+	ip = (struct ipv6_hdr *)(eth + 1);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(sizeof(*tcp) + TCP_PAYLOAD_LEN);
+	ip->proto = IPPROTO_TCP;
+	ip->hop_limits = 64;
+	ip->src_addr[0] = 0x20;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[0] = 0x20;
+	ip->dst_addr[15] = 2;
+
+	tcp = (struct tcp_hdr *)(ip + 1);
+	tcp->src_port = rte_cpu_to_be_16(1024);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(seq);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = sizeof(*tcp) << 2;
+	tcp->tcp_flags = TCP_ACK;
+	fill_payload((uint8_t *)(tcp + 1), seq, TCP_PAYLOAD_LEN);
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*tcp);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV6 |
+		RTE_PTYPE_L4_TCP;
+	return m;
+}
+
+/*
+ * Writes an IPv4 fragment of a UDP datagram made of NB_FRAGS fragments
+ * of FRAG_LEN bytes, including the UDP header.
+ */
+static void
+build_ipv4_fragment(struct ipv4_hdr *ip, uint16_t ip_id, uint32_t frag)
+{
+	uint16_t frag_off;
+
+	memset(ip, 0, sizeof(*ip));
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + FRAG_LEN);
+	ip->packet_id = rte_cpu_to_be_16(ip_id);
+	frag_off = frag * FRAG_LEN / IPV4_HDR_OFFSET_UNITS;
+	if (frag != NB_FRAGS - 1)
+		frag_off |= IPV4_HDR_MF_FLAG;
+	ip->fragment_offset = rte_cpu_to_be_16(frag_off);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 2));
+	fill_payload((uint8_t *)(ip + 1), frag * FRAG_LEN, FRAG_LEN);
+}
+
+static struct rte_mbuf *
+build_udp4_fragment(uint16_t ip_id, uint32_t frag)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+	uint16_t len;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	len = sizeof(*eth) + sizeof(struct ipv4_hdr) + FRAG_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	memset(eth, 0, sizeof(*eth));
+	eth->s_addr.addr_bytes[5] = 1;
+	eth->d_addr.addr_bytes[5] = 2;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	build_ipv4_fragment((struct ipv4_hdr *)(eth + 1), ip_id, frag);
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(struct ipv4_hdr);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		(frag == 0 ? RTE_PTYPE_L4_UDP : RTE_PTYPE_L4_FRAG);
+	return m;
+}
+
+static struct rte_mbuf *
+build_vxlan_udp4_fragment(uint16_t ip_id, uint32_t frag)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp;
+	struct vxlan_hdr *vxlan;
+	uint16_t len;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	len = 2 * sizeof(*eth) + 2 * sizeof(*ip) + sizeof(*udp) +
+		sizeof(*vxlan) + FRAG_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	memset(eth, 0, len);
+	eth->s_addr.addr_bytes[5] = 3;
+	eth->d_addr.addr_bytes[5] = 4;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+
+	ip = (struct ipv4_hdr *)(eth + 1);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(len - sizeof(*eth));
+	ip->packet_id = rte_cpu_to_be_16(frag);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(192, 168, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(192, 168, 0, 2));
+
+	udp = (struct udp_hdr *)(ip + 1);
+	udp->src_port = rte_cpu_to_be_16(49152);
+	udp->dst_port = rte_cpu_to_be_16(VXLAN_PORT);
+	udp->dgram_len = rte_cpu_to_be_16(len - sizeof(*eth) - sizeof(*ip));
+
+	vxlan = (struct vxlan_hdr *)(udp + 1);
+	vxlan->vx_flags = rte_cpu_to_be_32(0x08000000);
+	vxlan->vx_vni = rte_cpu_to_be_32(42 << 8);
+
+	eth = (struct ether_hdr *)(vxlan + 1);
+	eth->s_addr.addr_bytes[5] = 1;
+	eth->d_addr.addr_bytes[5] = 2;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	build_ipv4_fragment((struct ipv4_hdr *)(eth + 1), ip_id, frag);
+
+	m->outer_l2_len = sizeof(*eth);
+	m->outer_l3_len = sizeof(*ip);
+	m->l2_len = sizeof(*udp) + sizeof(*vxlan) + sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_UDP | RTE_PTYPE_TUNNEL_VXLAN |
+		RTE_PTYPE_INNER_L2_ETHER | RTE_PTYPE_INNER_L3_IPV4 |
+		RTE_PTYPE_INNER_L4_FRAG;
+	return m;
+}
+
+/* Checks the IPv4 header of a reassembled datagram. */
+static int
+check_ipv4_datagram(const struct ipv4_hdr *ip)
+{
+	if (rte_be_to_cpu_16(ip->total_length) !=
+			sizeof(*ip) + NB_FRAGS * FRAG_LEN)
+		return -1;
+	if (rte_be_to_cpu_16(ip->fragment_offset) != 0)
+		return -1;
+	return 0;
+}
+
+/*
+ * Sends the segments of a TCP/IPv6 stream, the first one behind the
+ * second one, both to a GRO context and to rte_gro_reassemble_burst().
+ * They must be merged into one packet.
+ */
+static int
+test_gro_tcp6(void)
+{
+	static const uint32_t order[] = {1, 0, 2, 3};
+	struct rte_gro_param param;
+	struct rte_mbuf *pkts[RTE_DIM(order)];
+	struct ipv6_hdr *ip;
+	uint32_t hdr_len, i;
+	void *ctx;
+
+	memset(&param, 0, sizeof(param));
+	param.gro_types = RTE_GRO_TCP_IPV6;
+	param.max_flow_num = 4;
+	param.max_item_per_flow = RTE_DIM(order);
+	param.socket_id = rte_socket_id();
+	hdr_len = sizeof(struct ether_hdr) + sizeof(*ip) +
+		sizeof(struct tcp_hdr);
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_GRO_ASSERT(ctx != NULL);
+
+	for (i = 0; i != RTE_DIM(order); i++) {
+		pkts[i] = build_tcp6_segment(order[i] * TCP_PAYLOAD_LEN);
+		TEST_GRO_ASSERT(pkts[i] != NULL);
+	}
+	TEST_GRO_ASSERT(rte_gro_reassemble(pkts, RTE_DIM(order), ctx) == 0);
+	TEST_GRO_ASSERT(rte_gro_get_pkt_count(ctx) == 1);
+	TEST_GRO_ASSERT(rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV6,
+				pkts, RTE_DIM(pkts)) == 1);
+	rte_gro_ctx_destroy(ctx);
+
+	ip = rte_pktmbuf_mtod_offset(pkts[0], struct ipv6_hdr *,
+			sizeof(struct ether_hdr));
+	TEST_GRO_ASSERT(rte_be_to_cpu_16(ip->payload_len) ==
+			sizeof(struct tcp_hdr) +
+			RTE_DIM(order) * TCP_PAYLOAD_LEN);
+	TEST_GRO_ASSERT(check_payload(pkts[0], hdr_len, 0,
+				RTE_DIM(order) * TCP_PAYLOAD_LEN) == 0);
+	rte_pktmbuf_free(pkts[0]);
+
+	for (i = 0; i != RTE_DIM(order); i++) {
+		pkts[i] = build_tcp6_segment(order[i] * TCP_PAYLOAD_LEN);
+		TEST_GRO_ASSERT(pkts[i] != NULL);
+	}
+	TEST_GRO_ASSERT(rte_gro_reassemble_burst(pkts, RTE_DIM(order),
+				&param) == 1);
+	TEST_GRO_ASSERT(check_payload(pkts[0], hdr_len, 0,
+				RTE_DIM(order) * TCP_PAYLOAD_LEN) == 0);
+	rte_pktmbuf_free(pkts[0]);
+
+	return 0;
+}
+
+/*
+ * Sends the fragments of two UDP/IPv4 datagrams out of order to a GRO
+ * context. For the second datagram, a fragment fills the gap between
+ * two stored fragments. Each datagram must be reassembled.
+ */
+static int
+test_gro_udp4(void)
+{
+	static const uint32_t order[NB_FRAGS] = {3, 0, 2, 1};
+	struct rte_gro_param param;
+	struct rte_mbuf *pkts[2 * NB_FRAGS + 1];
+	struct ipv4_hdr *ip;
+	uint32_t hdr_len, i, n;
+	void *ctx;
+
+	memset(&param, 0, sizeof(param));
+	param.gro_types = RTE_GRO_UDP_IPV4;
+	param.max_flow_num = 4;
+	param.max_item_per_flow = NB_FRAGS;
+	param.socket_id = rte_socket_id();
+	hdr_len = sizeof(struct ether_hdr) + sizeof(*ip);
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_GRO_ASSERT(ctx != NULL);
+
+	n = 0;
+	for (i = 0; i != NB_FRAGS; i++) {
+		pkts[n++] = build_udp4_fragment(1, i);
+		pkts[n++] = build_udp4_fragment(2, order[i]);
+	}
+	/* a packet which isn't a fragment isn't processed */
+	pkts[n] = build_udp4_fragment(3, 0);
+	ip = rte_pktmbuf_mtod_offset(pkts[n], struct ipv4_hdr *,
+			sizeof(struct ether_hdr));
+	ip->fragment_offset = 0;
+	n++;
+	for (i = 0; i != n; i++)
+		TEST_GRO_ASSERT(pkts[i] != NULL);
+
+	TEST_GRO_ASSERT(rte_gro_reassemble(pkts, n, ctx) == 1);
+	rte_pktmbuf_free(pkts[0]);
+
+	n = rte_gro_timeout_flush(ctx, 0, RTE_GRO_UDP_IPV4, pkts,
+			RTE_DIM(pkts));
+	TEST_GRO_ASSERT(n == 2);
+	TEST_GRO_ASSERT(rte_gro_get_pkt_count(ctx) == 0);
+	rte_gro_ctx_destroy(ctx);
+
+	for (i = 0; i != n; i++) {
+		ip = rte_pktmbuf_mtod_offset(pkts[i], struct ipv4_hdr *,
+				sizeof(struct ether_hdr));
+		TEST_GRO_ASSERT(check_ipv4_datagram(ip) == 0);
+		TEST_GRO_ASSERT(check_payload(pkts[i], hdr_len, 0,
+					NB_FRAGS * FRAG_LEN) == 0);
+		rte_pktmbuf_free(pkts[i]);
+	}
+
+	return 0;
+}
+
+/*
+ * Sends the fragments of two UDP/IPv4 datagrams whose first fragment has
+ * IPv4 options, which the other fragments don't have, to a GRO context:
+ * in order for the first datagram, the first fragment last for the
+ * second one. The header of each fragment must be removed by its own
+ * length.
+ */
+static int
+test_gro_udp4_options(void)
+{
+	static const uint32_t order[NB_FRAGS] = {3, 1, 2, 0};
+	struct rte_gro_param param;
+	struct rte_mbuf *pkts[2 * NB_FRAGS];
+	struct ipv4_hdr *ip;
+	uint8_t *opts;
+	uint32_t hdr_len, i, n;
+	void *ctx;
+
+	memset(&param, 0, sizeof(param));
+	param.gro_types = RTE_GRO_UDP_IPV4;
+	param.max_flow_num = 4;
+	param.max_item_per_flow = NB_FRAGS;
+	param.socket_id = rte_socket_id();
+	hdr_len = sizeof(struct ether_hdr) + sizeof(*ip) + IPV4_OPTS_LEN;
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_GRO_ASSERT(ctx != NULL);
+
+	n = 0;
+	for (i = 0; i != NB_FRAGS; i++) {
+		pkts[n++] = build_udp4_fragment(1, i);
+		pkts[n++] = build_udp4_fragment(2, order[i]);
+	}
+	for (i = 0; i != n; i++) {
+		TEST_GRO_ASSERT(pkts[i] != NULL);
+		ip = rte_pktmbuf_mtod_offset(pkts[i], struct ipv4_hdr *,
+				sizeof(struct ether_hdr));
+		if ((rte_be_to_cpu_16(ip->fragment_offset) &
+				IPV4_HDR_OFFSET_MASK) != 0)
+			continue;
+
+		/* insert NOP options, which are not copied, after the header */
+		TEST_GRO_ASSERT(rte_pktmbuf_append(pkts[i],
+				IPV4_OPTS_LEN) != NULL);
+		opts = (uint8_t *)(ip + 1);
+		memmove(opts + IPV4_OPTS_LEN, opts, FRAG_LEN);
+		memset(opts, IPV4_OPT_NOP, IPV4_OPTS_LEN);
+		ip->version_ihl += IPV4_OPTS_LEN / IPV4_IHL_MULTIPLIER;
+		ip->total_length = rte_cpu_to_be_16(
+			rte_be_to_cpu_16(ip->total_length) + IPV4_OPTS_LEN);
+		pkts[i]->l3_len += IPV4_OPTS_LEN;
+	}
+
+	TEST_GRO_ASSERT(rte_gro_reassemble(pkts, n, ctx) == 0);
+	n = rte_gro_timeout_flush(ctx, 0, RTE_GRO_UDP_IPV4, pkts,
+			RTE_DIM(pkts));
+	TEST_GRO_ASSERT(n == 2);
+	rte_gro_ctx_destroy(ctx);
+
+	for (i = 0; i != n; i++) {
+		ip = rte_pktmbuf_mtod_offset(pkts[i], struct ipv4_hdr *,
+				sizeof(struct ether_hdr));
+		TEST_GRO_ASSERT(rte_be_to_cpu_16(ip->total_length) ==
+				sizeof(*ip) + IPV4_OPTS_LEN +
+				NB_FRAGS * FRAG_LEN);
+		TEST_GRO_ASSERT(check_payload(pkts[i], hdr_len, 0,
+					NB_FRAGS * FRAG_LEN) == 0);
+		rte_pktmbuf_free(pkts[i]);
+	}
+
+	return 0;
+}
+
+/*
+ * Sends the fragments of a UDP/IPv4 datagram in VxLAN packets, out of
+ * order, to rte_gro_reassemble_burst(). The datagram must be reassembled
+ * and the outer headers updated.
+ */
+static int
+test_gro_vxlan_udp4(void)
+{
+	static const uint32_t order[NB_FRAGS] = {1, 3, 0, 2};
+	struct rte_gro_param param;
+	struct rte_mbuf *pkts[NB_FRAGS];
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp;
+	uint32_t hdr_len, i;
+
+	memset(&param, 0, sizeof(param));
+	param.gro_types = RTE_GRO_IPV4_VXLAN_UDP_IPV4;
+	param.max_flow_num = 4;
+	param.max_item_per_flow = NB_FRAGS;
+	hdr_len = 2 * sizeof(struct ether_hdr) + 2 * sizeof(*ip) +
+		sizeof(*udp) + sizeof(struct vxlan_hdr);
+
+	for (i = 0; i != NB_FRAGS; i++) {
+		pkts[i] = build_vxlan_udp4_fragment(1, order[i]);
+		TEST_GRO_ASSERT(pkts[i] != NULL);
+	}
+	TEST_GRO_ASSERT(rte_gro_reassemble_burst(pkts, NB_FRAGS,
+				&param) == 1);
+
+	ip = rte_pktmbuf_mtod_offset(pkts[0], struct ipv4_hdr *,
+			sizeof(struct ether_hdr));
+	TEST_GRO_ASSERT(rte_be_to_cpu_16(ip->total_length) ==
+			hdr_len - sizeof(struct ether_hdr) +
+			NB_FRAGS * FRAG_LEN);
+	udp = (struct udp_hdr *)(ip + 1);
+	TEST_GRO_ASSERT(rte_be_to_cpu_16(udp->dgram_len) ==
+			rte_be_to_cpu_16(ip->total_length) - sizeof(*ip));
+	ip = rte_pktmbuf_mtod_offset(pkts[0], struct ipv4_hdr *,
+			hdr_len - sizeof(*ip));
+	TEST_GRO_ASSERT(check_ipv4_datagram(ip) == 0);
+	TEST_GRO_ASSERT(check_payload(pkts[0], hdr_len, 0,
+				NB_FRAGS * FRAG_LEN) == 0);
+	rte_pktmbuf_free(pkts[0]);
+
+	return 0;
+}
+
+static int
+test_gro(void)
+{
+	int ret;
+
+	pool = rte_pktmbuf_pool_create("gro_test_pool", NUM_MBUFS,
+			MBUF_CACHE_SIZE, 0, MBUF_SIZE, rte_socket_id());
+	TEST_GRO_ASSERT(pool != NULL);
+
+	ret = test_gro_tcp6();
+	if (ret == 0)
+		ret = test_gro_udp4();
+	if (ret == 0)
+		ret = test_gro_udp4_options();
+	if (ret == 0)
+		ret = test_gro_vxlan_udp4();
+
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gro_autotest, test_gro);
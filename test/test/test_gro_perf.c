@@ -0,0 +1,186 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_lcore.h>
+#include <rte_gro.h>
+
+#include "test.h"
+
+#define TEST_GRO_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define MAX_FLOWS UINT16_MAX
+#define SEGS_PER_FLOW 2
+#define NUM_MBUFS (MAX_FLOWS * SEGS_PER_FLOW + 2 * MBUF_CACHE_SIZE)
+#define MBUF_CACHE_SIZE 256
+#define PAYLOAD_LEN 64
+#define MBUF_SIZE (RTE_PKTMBUF_HEADROOM + 128)
+#define BURST_SIZE 32
+#define ROUNDS 8
+#define TCP_ACK 0x10
+
+/* Number of concurrent flows to run the benchmark with */
+static const uint32_t flow_nums[] = {1, 16, 256, 1024, 4096, 16384, MAX_FLOWS};
+
+static struct rte_mempool *pool;
+static struct rte_mbuf *pkts[MAX_FLOWS * SEGS_PER_FLOW];
+static struct rte_mbuf *out[MAX_FLOWS * SEGS_PER_FLOW];
+static uint32_t seqs[MAX_FLOWS];
+
+/*
+ * Builds a TCP/IPv4 segment of a flow, which follows the previous
+ * segment of this flow.
+ */
+static int
+build_segment(struct rte_mbuf *m, uint32_t flow)
+{
+	struct ether_hdr *eth;
+	struct ipv4_hdr *ip;
+	struct tcp_hdr *tcp;
+	uint16_t len;
+
+	len = sizeof(*eth) + sizeof(*ip) + sizeof(*tcp) + PAYLOAD_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	if (eth == NULL)
+		return -1;
+
+	memset(eth, 0, len);
+	eth->s_addr.addr_bytes[5] = 1;
+	eth->d_addr.addr_bytes[5] = 2;
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+
+	ip = (struct ipv4_hdr *)(eth + 1);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(len - sizeof(*eth));
+	ip->fragment_offset = rte_cpu_to_be_16(IPV4_HDR_DF_FLAG);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_TCP;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(10, 0, flow >> 8, flow));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 1, 0, 1));
+
+	tcp = (struct tcp_hdr *)(ip + 1);
+	tcp->src_port = rte_cpu_to_be_16(1024 + flow);
+	tcp->dst_port = rte_cpu_to_be_16(80);
+	tcp->sent_seq = rte_cpu_to_be_32(seqs[flow]);
+	tcp->recv_ack = rte_cpu_to_be_32(1);
+	tcp->data_off = sizeof(*tcp) << 2;
+	tcp->tcp_flags = TCP_ACK;
+	seqs[flow] += PAYLOAD_LEN;
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*tcp);
+	m->packet_type = RTE_PTYPE_L2_ETHER | RTE_PTYPE_L3_IPV4 |
+		RTE_PTYPE_L4_TCP;
+
+	return 0;
+}
+
+/*
+ * Sends SEGS_PER_FLOW segments of each flow, interleaving the flows,
+ * in a GRO context, then flushes them. Each flow must come out as one
+ * packet.
+ */
+static int
+test_gro_perf_flows(uint32_t nb_flows)
+{
+	struct rte_gro_param param;
+	void *ctx;
+	uint64_t begin, gro_time, flush_time;
+	uint32_t i, n, nb_pkts, nb_out, round;
+
+	memset(&param, 0, sizeof(param));
+	param.gro_types = RTE_GRO_TCP_IPV4;
+	param.max_flow_num = nb_flows;
+	param.max_item_per_flow = SEGS_PER_FLOW;
+	param.socket_id = rte_socket_id();
+
+	ctx = rte_gro_ctx_create(&param);
+	TEST_GRO_ASSERT(ctx != NULL);
+
+	nb_pkts = nb_flows * SEGS_PER_FLOW;
+	gro_time = 0;
+	flush_time = 0;
+
+	for (round = 0; round != ROUNDS; round++) {
+
+		TEST_GRO_ASSERT(rte_pktmbuf_alloc_bulk(pool, pkts,
+				nb_pkts) == 0);
+		for (i = 0; i != nb_pkts; i++)
+			TEST_GRO_ASSERT(build_segment(pkts[i],
+					i % nb_flows) == 0);
+
+		for (i = 0; i < nb_pkts; i += n) {
+			n = RTE_MIN(nb_pkts - i, (uint32_t)BURST_SIZE);
+			begin = rte_rdtsc();
+			nb_out = rte_gro_reassemble(pkts + i, n, ctx);
+			gro_time += rte_rdtsc() - begin;
+			/* all the packets must be held in the table */
+			TEST_GRO_ASSERT(nb_out == 0);
+		}
+
+		TEST_GRO_ASSERT(rte_gro_get_pkt_count(ctx) == nb_flows);
+
+		/* one flush call can't return more than UINT16_MAX packets */
+		nb_out = 0;
+		do {
+			begin = rte_rdtsc();
+			n = rte_gro_timeout_flush(ctx, 0, RTE_GRO_TCP_IPV4,
+					out + nb_out, UINT16_MAX);
+			flush_time += rte_rdtsc() - begin;
+			nb_out += n;
+		} while (n != 0);
+
+		TEST_GRO_ASSERT(nb_out == nb_flows);
+		for (i = 0; i != nb_out; i++) {
+			TEST_GRO_ASSERT(out[i]->nb_segs == SEGS_PER_FLOW);
+			rte_pktmbuf_free(out[i]);
+		}
+	}
+
+	printf("%8u flows: reassemble %8.1f cycles/pkt, "
+		"flush %8.1f cycles/pkt\n", nb_flows,
+		(double)gro_time / ((double)ROUNDS * nb_pkts),
+		(double)flush_time / ((double)ROUNDS * nb_pkts));
+
+	rte_gro_ctx_destroy(ctx);
+	return 0;
+}
+
+static int
+test_gro_perf(void)
+{
+	uint32_t i;
+	int ret = 0;
+
+	pool = rte_pktmbuf_pool_create("gro_perf_pool", NUM_MBUFS,
+			MBUF_CACHE_SIZE, 0, MBUF_SIZE, rte_socket_id());
+	TEST_GRO_ASSERT(pool != NULL);
+
+	printf("TCP/IPv4 GRO, %u segments of %u bytes per flow, "
+		"bursts of %u packets\n",
+		SEGS_PER_FLOW, PAYLOAD_LEN, BURST_SIZE);
+
+	for (i = 0; i != RTE_DIM(flow_nums) && ret == 0; i++)
+		ret = test_gro_perf_flows(flow_nums[i]);
+
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gro_perf_autotest, test_gro_perf);
@@ -0,0 +1,265 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rte_ether.h>
+#include <rte_ethdev.h>
+#include <rte_ip.h>
+#include <rte_tcp.h>
+#include <rte_udp.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_lcore.h>
+#include <rte_gso.h>
+
+#include "test.h"
+
+#define TEST_GSO_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define NUM_MBUFS 256
+#define MBUF_CACHE_SIZE 32
+#define MBUF_SIZE RTE_MBUF_DEFAULT_BUF_SIZE
+
+#define GSO_SIZE 300
+#define DATA_LEN 1000
+#define MAX_SEGS 16
+#define TCP_ACK 0x10
+#define TCP_PSH 0x08
+
+static struct rte_mempool *pool;
+
+static void
+fill_payload(uint8_t *p, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i != len; i++)
+		p[i] = (uint8_t)i;
+}
+
+/* Checks that a GSO segment carries the data from offset in the input. */
+static int
+check_payload(const struct rte_mbuf *m, uint32_t hdr_len, uint32_t offset)
+{
+	uint8_t buf[GSO_SIZE];
+	const uint8_t *p;
+	uint32_t i, len;
+
+	len = m->pkt_len - hdr_len;
+	p = rte_pktmbuf_read(m, hdr_len, len, buf);
+	if (p == NULL)
+		return -1;
+
+	for (i = 0; i != len; i++)
+		if (p[i] != (uint8_t)(offset + i))
+			return -1;
+	return 0;
+}
+
+static struct rte_mbuf *
+build_pkt(uint16_t hdr_len, void **l3_hdr)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, hdr_len + DATA_LEN);
+	memset(eth, 0, hdr_len);
+	eth->s_addr.addr_bytes[5] = 1;
+	eth->d_addr.addr_bytes[5] = 2;
+	fill_payload((uint8_t *)eth + hdr_len, DATA_LEN);
+	m->l2_len = sizeof(*eth);
+	*l3_hdr = eth + 1;
+	return m;
+}
+
+/*
+ * Segments a TCP/IPv6 packet. The segments must have contiguous sequence
+ * numbers, their own payload lengths, and PSH only in the last one.
+ */
+static int
+test_gso_tcp6(struct rte_gso_ctx *ctx)
+{
+	struct rte_mbuf *m, *segs[MAX_SEGS];
+	struct ipv6_hdr *ip;
+	struct tcp_hdr *tcp;
+	uint32_t hdr_len, offset, seq;
+	int i, n;
+
+	hdr_len = sizeof(struct ether_hdr) + sizeof(*ip) + sizeof(*tcp);
+	m = build_pkt(hdr_len, (void **)&ip);
+	TEST_GSO_ASSERT(m != NULL);
+
+	((struct ether_hdr *)(ip) - 1)->ether_type =
+		rte_cpu_to_be_16(ETHER_TYPE_IPv6);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(sizeof(*tcp) + DATA_LEN);
+	ip->proto = IPPROTO_TCP;
+	ip->hop_limits = 64;
+	tcp = (struct tcp_hdr *)(ip + 1);
+	seq = 1000;
+	tcp->sent_seq = rte_cpu_to_be_32(seq);
+	tcp->data_off = sizeof(*tcp) << 2;
+	tcp->tcp_flags = TCP_ACK | TCP_PSH;
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*tcp);
+	m->ol_flags = PKT_TX_IPV6 | PKT_TX_TCP_SEG;
+
+	n = rte_gso_segment(m, ctx, segs, RTE_DIM(segs));
+	TEST_GSO_ASSERT(n == (int)((DATA_LEN + GSO_SIZE - hdr_len - 1) /
+				(GSO_SIZE - hdr_len)));
+
+	offset = 0;
+	for (i = 0; i != n; i++) {
+		TEST_GSO_ASSERT(segs[i]->pkt_len <= GSO_SIZE);
+		TEST_GSO_ASSERT((segs[i]->ol_flags & PKT_TX_TCP_SEG) == 0);
+		ip = rte_pktmbuf_mtod_offset(segs[i], struct ipv6_hdr *,
+				sizeof(struct ether_hdr));
+		tcp = (struct tcp_hdr *)(ip + 1);
+		TEST_GSO_ASSERT(rte_be_to_cpu_16(ip->payload_len) ==
+				segs[i]->pkt_len - hdr_len + sizeof(*tcp));
+		TEST_GSO_ASSERT(rte_be_to_cpu_32(tcp->sent_seq) ==
+				seq + offset);
+		TEST_GSO_ASSERT(((tcp->tcp_flags & TCP_PSH) != 0) ==
+				(i == n - 1));
+		TEST_GSO_ASSERT(check_payload(segs[i], hdr_len, offset) == 0);
+		offset += segs[i]->pkt_len - hdr_len;
+	}
+	TEST_GSO_ASSERT(offset == DATA_LEN);
+
+	/* the input packet is freed with the last segment */
+	for (i = 0; i != n; i++)
+		rte_pktmbuf_free(segs[i]);
+
+	return 0;
+}
+
+/*
+ * Splits a UDP/IPv4 packet into IPv4 fragments. The fragments must share
+ * the IPv4 ID, have offsets in units of 8 bytes, and MF set except in
+ * the last one. The UDP header is only in the first fragment.
+ */
+static int
+test_gso_udp4(struct rte_gso_ctx *ctx)
+{
+	struct rte_mbuf *m, *segs[MAX_SEGS];
+	struct ipv4_hdr *ip;
+	struct udp_hdr *udp, udp_copy;
+	const struct udp_hdr *udp_hdr;
+	uint32_t hdr_len, offset;
+	uint16_t frag_off;
+	int i, n;
+
+	hdr_len = sizeof(struct ether_hdr) + sizeof(*ip);
+	m = build_pkt(hdr_len + sizeof(*udp), (void **)&ip);
+	TEST_GSO_ASSERT(m != NULL);
+
+	((struct ether_hdr *)(ip) - 1)->ether_type =
+		rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + sizeof(*udp) +
+			DATA_LEN);
+	ip->packet_id = rte_cpu_to_be_16(42);
+	ip->fragment_offset = rte_cpu_to_be_16(IPV4_HDR_DF_FLAG);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	udp = (struct udp_hdr *)(ip + 1);
+	udp->src_port = rte_cpu_to_be_16(1024);
+	udp->dst_port = rte_cpu_to_be_16(1025);
+	udp->dgram_len = rte_cpu_to_be_16(sizeof(*udp) + DATA_LEN);
+	m->l3_len = sizeof(*ip);
+	m->l4_len = sizeof(*udp);
+	/* the UDP checksum can't be offloaded for the fragments */
+	m->ol_flags = PKT_TX_IPV4 | PKT_TX_UDP_SEG | PKT_TX_UDP_CKSUM;
+	TEST_GSO_ASSERT(rte_gso_segment(m, ctx, segs, RTE_DIM(segs)) ==
+			-EINVAL);
+	TEST_GSO_ASSERT(m->ol_flags ==
+			(PKT_TX_IPV4 | PKT_TX_UDP_SEG | PKT_TX_UDP_CKSUM));
+
+	m->ol_flags = PKT_TX_IPV4 | PKT_TX_UDP_SEG;
+	n = rte_gso_segment(m, ctx, segs, RTE_DIM(segs));
+	TEST_GSO_ASSERT(n > 1);
+
+	offset = 0;
+	for (i = 0; i != n; i++) {
+		TEST_GSO_ASSERT(segs[i]->pkt_len <= GSO_SIZE);
+		TEST_GSO_ASSERT((segs[i]->ol_flags & PKT_TX_UDP_SEG) == 0);
+		TEST_GSO_ASSERT((segs[i]->ol_flags & PKT_TX_L4_MASK) == 0);
+		ip = rte_pktmbuf_mtod_offset(segs[i], struct ipv4_hdr *,
+				sizeof(struct ether_hdr));
+		TEST_GSO_ASSERT(rte_be_to_cpu_16(ip->total_length) ==
+				segs[i]->pkt_len - sizeof(struct ether_hdr));
+		TEST_GSO_ASSERT(rte_be_to_cpu_16(ip->packet_id) == 42);
+		frag_off = rte_be_to_cpu_16(ip->fragment_offset);
+		TEST_GSO_ASSERT((frag_off & IPV4_HDR_OFFSET_MASK) *
+				IPV4_HDR_OFFSET_UNITS == offset);
+		TEST_GSO_ASSERT(((frag_off & IPV4_HDR_MF_FLAG) == 0) ==
+				(i == n - 1));
+		TEST_GSO_ASSERT((frag_off & IPV4_HDR_DF_FLAG) == 0);
+		if (i == 0) {
+			/* the UDP header is in the payload of the fragment */
+			udp_hdr = rte_pktmbuf_read(segs[i], hdr_len,
+					sizeof(udp_copy), &udp_copy);
+			TEST_GSO_ASSERT(udp_hdr != NULL);
+			TEST_GSO_ASSERT(rte_be_to_cpu_16(udp_hdr->dgram_len) ==
+					sizeof(*udp) + DATA_LEN);
+			TEST_GSO_ASSERT(check_payload(segs[i],
+					hdr_len + sizeof(*udp), 0) == 0);
+		} else {
+			TEST_GSO_ASSERT(offset % IPV4_HDR_OFFSET_UNITS == 0);
+			TEST_GSO_ASSERT(check_payload(segs[i], hdr_len,
+					offset - sizeof(*udp)) == 0);
+		}
+		offset += segs[i]->pkt_len - hdr_len;
+	}
+	TEST_GSO_ASSERT(offset == sizeof(*udp) + DATA_LEN);
+
+	for (i = 0; i != n; i++)
+		rte_pktmbuf_free(segs[i]);
+
+	return 0;
+}
+
+static int
+test_gso(void)
+{
+	struct rte_gso_ctx ctx;
+	int ret;
+
+	pool = rte_pktmbuf_pool_create("gso_test_pool", NUM_MBUFS,
+			MBUF_CACHE_SIZE, 0, MBUF_SIZE, rte_socket_id());
+	TEST_GSO_ASSERT(pool != NULL);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.direct_pool = pool;
+	ctx.indirect_pool = pool;
+	ctx.gso_types = DEV_TX_OFFLOAD_TCP_TSO | DEV_TX_OFFLOAD_UDP_TSO;
+	ctx.gso_size = GSO_SIZE;
+
+	ret = test_gso_tcp6(&ctx);
+	if (ret == 0)
+		ret = test_gso_udp4(&ctx);
+
+	if (ret == 0 && rte_mempool_in_use_count(pool) != 0) {
+		printf("mbufs are leaked\n");
+		ret = -1;
+	}
+
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(gso_autotest, test_gso);
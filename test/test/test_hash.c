@@ -1044,6 +1044,19 @@ static int test_hash_creation_with_bad_parameters(void)
 		return -1;
 	}
 
+	memcpy(&params, &ut_params, sizeof(params));
+	params.name = "creation_with_bad_parameters_5";
+	params.extra_flag = RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF |
+		RTE_HASH_EXTRA_FLAGS_TRANS_MEM_SUPPORT |
+		RTE_HASH_EXTRA_FLAGS_MULTI_WRITER_ADD;
+	handle = rte_hash_create(&params);
+	if (handle != NULL) {
+		rte_hash_free(handle);
+		printf("Impossible creating lock-free hash successfully with "
+			"transactional multi-writer add\n");
+		return -1;
+	}
+
 	/* test with same name should fail */
 	memcpy(&params, &ut_params, sizeof(params));
 	params.name = "same_name";
@@ -1094,9 +1107,10 @@ test_hash_creation_with_good_parameters(void)
 #define ITERATIONS 3
 /*
  * Test to see the average table utilization (entries added/max entries)
- * before hitting a random entry that cannot be added
+ * before hitting a random entry that cannot be added.
+ * With extendable buckets, all the entries must be added.
  */
-static int test_average_table_utilization(void)
+static int test_average_table_utilization(uint32_t ext_table)
 {
 	struct rte_hash *handle;
 	uint8_t simple_key[MAX_KEYSIZE];
@@ -1105,13 +1119,16 @@ static int test_average_table_utilization(void)
 	int ret;
 
 	printf("\n# Running test to determine average utilization"
-	       "\n  before adding elements begins to fail\n");
+	       "\n  before adding elements begins to fail%s\n",
+	       ext_table ? ", with extendable buckets" : "");
 	printf("Measuring performance, please wait");
 	fflush(stdout);
 	ut_params.entries = 1 << 16;
 	ut_params.name = "test_average_utilization";
 	ut_params.hash_func = rte_jhash;
+	ut_params.extra_flag = ext_table ? RTE_HASH_EXTRA_FLAGS_EXT_TABLE : 0;
 	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
 	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
 
 	for (j = 0; j < ITERATIONS; j++) {
@@ -1128,6 +1145,15 @@ static int test_average_table_utilization(void)
 			return -1;
 		}
 
+		/* The failed addition was counted */
+		added_keys--;
+		if (ext_table && added_keys != ut_params.entries) {
+			printf("\nOnly %u keys added with extendable buckets\n",
+				added_keys);
+			rte_hash_free(handle);
+			return -1;
+		}
+
 		average_keys_added += added_keys;
 
 		/* Reset the table */
@@ -1212,6 +1238,217 @@ static int test_hash_iteration(void)
 	return -1;
 }
 
+/*
+ * Add, look up and delete keys that all have the same buckets, so that
+ * only 2 * RTE_HASH_BUCKET_ENTRIES keys fit without extendable buckets.
+ */
+#define EXT_BKT_ENTRIES 64
+#define EXT_BKT_MAIN_ENTRIES 16
+static int test_hash_ext_bucket(uint8_t extra_flag)
+{
+	struct rte_hash *handle;
+	uint32_t ext_keys[EXT_BKT_ENTRIES];
+	const void *key_ptrs[EXT_BKT_ENTRIES];
+	int32_t pos[EXT_BKT_ENTRIES], bulk_pos[EXT_BKT_ENTRIES];
+	const void *next_key;
+	void *next_data;
+	uint32_t iter = 0;
+	unsigned i, round;
+	int ret;
+
+	ut_params.entries = EXT_BKT_ENTRIES;
+	ut_params.name = "test_hash_ext_bucket";
+	ut_params.hash_func = pseudo_hash;
+	ut_params.key_len = sizeof(uint32_t);
+	ut_params.extra_flag = 0;
+	handle = rte_hash_create(&ut_params);
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (i = 0; i < EXT_BKT_ENTRIES; i++) {
+		ext_keys[i] = i;
+		key_ptrs[i] = &ext_keys[i];
+	}
+
+	/* Without extendable buckets, only the two buckets can be filled */
+	for (i = 0; i < EXT_BKT_ENTRIES; i++)
+		if (rte_hash_add_key(handle, &ext_keys[i]) < 0)
+			break;
+	RETURN_IF_ERROR(i != EXT_BKT_MAIN_ENTRIES,
+			"%u keys added without extendable buckets", i);
+	rte_hash_free(handle);
+
+	ut_params.extra_flag = extra_flag | RTE_HASH_EXTRA_FLAGS_EXT_TABLE;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	for (round = 0; round < 2; round++) {
+		for (i = 0; i < EXT_BKT_ENTRIES; i++) {
+			pos[i] = rte_hash_add_key(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(pos[i] < 0, "failed to add key %u", i);
+		}
+
+		for (i = 0; i < EXT_BKT_ENTRIES; i++) {
+			ret = rte_hash_lookup(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(ret != pos[i],
+					"failed to find key %u (%d)", i, ret);
+		}
+
+		ret = rte_hash_lookup_bulk(handle, key_ptrs, EXT_BKT_ENTRIES,
+				bulk_pos);
+		RETURN_IF_ERROR(ret != 0, "bulk lookup failed");
+		for (i = 0; i < EXT_BKT_ENTRIES; i++)
+			RETURN_IF_ERROR(bulk_pos[i] != pos[i],
+					"bulk lookup missed key %u", i);
+
+		/* Delete and add again the odd keys */
+		for (i = 1; i < EXT_BKT_ENTRIES; i += 2) {
+			ret = rte_hash_del_key(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(ret != pos[i],
+					"failed to delete key %u", i);
+			if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				rte_hash_free_key_with_position(handle, ret);
+		}
+		for (i = 0; i < EXT_BKT_ENTRIES; i++) {
+			ret = rte_hash_lookup(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(ret != (i % 2 ? -ENOENT : pos[i]),
+					"wrong lookup of key %u (%d)", i, ret);
+		}
+		for (i = 1; i < EXT_BKT_ENTRIES; i += 2) {
+			pos[i] = rte_hash_add_key(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(pos[i] < 0, "failed to add key %u", i);
+		}
+
+		/* Delete all the keys, their buckets are reused next round */
+		for (i = 0; i < EXT_BKT_ENTRIES; i++) {
+			ret = rte_hash_del_key(handle, &ext_keys[i]);
+			RETURN_IF_ERROR(ret != pos[i],
+					"failed to delete key %u", i);
+			if (extra_flag & RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF)
+				rte_hash_free_key_with_position(handle, ret);
+		}
+		RETURN_IF_ERROR(rte_hash_iterate(handle, &next_key, &next_data,
+				&iter) != -ENOENT, "table not empty");
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
+/*
+ * Grow a table while it is filled, checking that the keys are found,
+ * at the same positions, while their buckets are migrated and after,
+ * and that all the new key slots can be used.
+ */
+#define RESIZE_ENTRIES 256
+#define RESIZE_KEYS 4096
+#define RESIZE_BULK 64
+static int test_hash_resize(uint8_t extra_flag)
+{
+	struct rte_hash *handle;
+	static uint32_t resize_keys[RESIZE_KEYS];
+	static int32_t pos[RESIZE_KEYS];
+	const void *key_ptrs[RESIZE_BULK];
+	int32_t bulk_pos[RESIZE_BULK];
+	const void *next_key;
+	void *next_data;
+	uint32_t iter = 0, entries = RESIZE_ENTRIES, extra_key;
+	unsigned i, j, nb_keys = 0, count = 0;
+	int ret;
+
+	ut_params.entries = RESIZE_ENTRIES;
+	ut_params.name = "test_hash_resize";
+	ut_params.hash_func = rte_jhash;
+	ut_params.key_len = sizeof(uint32_t);
+	ut_params.extra_flag = extra_flag;
+	handle = rte_hash_create(&ut_params);
+	ut_params.extra_flag = 0;
+	RETURN_IF_ERROR(handle == NULL, "hash creation failed");
+
+	RETURN_IF_ERROR(rte_hash_resize(handle, RESIZE_ENTRIES) != -EINVAL,
+			"resize to the same size should fail");
+
+	for (i = 0; i < RESIZE_KEYS; i++)
+		resize_keys[i] = i * 7919;
+
+	/* Fill half of the table, then double it each time it is half full */
+	while (nb_keys < RESIZE_KEYS) {
+		if (nb_keys == entries / 2) {
+			entries *= 2;
+			ret = rte_hash_resize(handle, entries);
+			RETURN_IF_ERROR(ret != 0, "resize to %u failed (%d)",
+					entries, ret);
+		}
+
+		pos[nb_keys] = rte_hash_add_key(handle, &resize_keys[nb_keys]);
+		RETURN_IF_ERROR(pos[nb_keys] < 0, "failed to add key %u (%d)",
+				nb_keys, pos[nb_keys]);
+		nb_keys++;
+
+		/* Check all the keys while their buckets are being moved */
+		if (nb_keys % RESIZE_BULK != 0)
+			continue;
+		for (i = 0; i < nb_keys; i += RESIZE_BULK) {
+			for (j = 0; j < RESIZE_BULK; j++)
+				key_ptrs[j] = &resize_keys[i + j];
+			ret = rte_hash_lookup_bulk(handle, key_ptrs,
+					RESIZE_BULK, bulk_pos);
+			RETURN_IF_ERROR(ret != 0, "bulk lookup failed");
+			for (j = 0; j < RESIZE_BULK; j++) {
+				RETURN_IF_ERROR(bulk_pos[j] != pos[i + j],
+					"bulk lookup missed key %u", i + j);
+				ret = rte_hash_lookup(handle,
+						&resize_keys[i + j]);
+				RETURN_IF_ERROR(ret != pos[i + j],
+					"failed to find key %u (%d)",
+					i + j, ret);
+			}
+		}
+	}
+
+	/* Start one more resize, and delete keys during the migration */
+	RETURN_IF_ERROR(rte_hash_resize(handle, entries * 2) != 0,
+			"resize to %u failed", entries * 2);
+	ret = rte_hash_resize_step(handle, 1);
+	RETURN_IF_ERROR(ret <= 0, "resize completed too early (%d)", ret);
+	for (i = 1; i < RESIZE_KEYS; i += 2) {
+		ret = rte_hash_del_key(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(ret != pos[i], "failed to delete key %u", i);
+	}
+
+	while ((ret = rte_hash_resize_step(handle, 16)) > 0)
+		;
+	RETURN_IF_ERROR(ret != 0, "resize step failed (%d)", ret);
+
+	for (i = 0; i < RESIZE_KEYS; i++) {
+		ret = rte_hash_lookup(handle, &resize_keys[i]);
+		RETURN_IF_ERROR(ret != (i % 2 ? -ENOENT : pos[i]),
+				"wrong lookup of key %u (%d)", i, ret);
+	}
+
+	while (rte_hash_iterate(handle, &next_key, &next_data, &iter) >= 0)
+		count++;
+	RETURN_IF_ERROR(count != RESIZE_KEYS / 2,
+			"%u keys iterated instead of %u", count,
+			RESIZE_KEYS / 2);
+
+	/* All the key slots added by the resizes can be used */
+	if (extra_flag & RTE_HASH_EXTRA_FLAGS_EXT_TABLE) {
+		for (i = 0; i < entries * 2 - RESIZE_KEYS / 2; i++) {
+			extra_key = (RESIZE_KEYS + i) * 7919;
+			ret = rte_hash_add_key(handle, &extra_key);
+			RETURN_IF_ERROR(ret < 0, "failed to add extra key %u "
+					"(%d)", i, ret);
+		}
+		extra_key = (RESIZE_KEYS + i) * 7919;
+		RETURN_IF_ERROR(rte_hash_add_key(handle, &extra_key) !=
+				-ENOSPC, "added more keys than entries");
+	}
+
+	rte_hash_free(handle);
+	return 0;
+}
+
 static uint8_t key[16] = {0x00, 0x01, 0x02, 0x03,
 			0x04, 0x05, 0x06, 0x07,
 			0x08, 0x09, 0x0a, 0x0b,
@@ -1471,10 +1708,20 @@ test_hash(void)
 		return -1;
 	if (test_hash_creation_with_good_parameters() < 0)
 		return -1;
-	if (test_average_table_utilization() < 0)
+	if (test_average_table_utilization(0) < 0)
+		return -1;
+	if (test_average_table_utilization(1) < 0)
 		return -1;
 	if (test_hash_iteration() < 0)
 		return -1;
+	if (test_hash_ext_bucket(0) < 0)
+		return -1;
+	if (test_hash_ext_bucket(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		return -1;
+	if (test_hash_resize(0) < 0)
+		return -1;
+	if (test_hash_resize(RTE_HASH_EXTRA_FLAGS_EXT_TABLE) < 0)
+		return -1;
 
 	run_hash_func_tests();
 
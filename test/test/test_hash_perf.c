@@ -3,6 +3,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 
 #include <rte_lcore.h>
@@ -608,6 +609,122 @@ fbk_hash_perf_test(void)
 	return 0;
 }
 
+#define LARGE_ENTRIES (1 << 23)	/* Entries of the large tables. */
+#define LARGE_KEYS_TO_ADD (LARGE_ENTRIES * 3 / 4)
+#define LARGE_LOOKUP_KEYS (1 << 16)	/* Keys looked up, randomly chosen. */
+#define LARGE_LOOKUP_ROUNDS 16
+
+static const uint32_t large_key_lens[] = {16, 32, 48, 64};
+
+/* Build a key of the large table from its index: the index makes it unique */
+static void
+large_table_key(uint8_t *key, uint32_t idx, uint32_t key_len)
+{
+	uint32_t j, word;
+
+	for (j = 0; j < key_len; j += sizeof(uint32_t)) {
+		word = (j == 0) ? idx : rte_hash_crc_4byte(idx, j);
+		memcpy(&key[j], &word, sizeof(word));
+	}
+}
+
+/*
+ * Lookups in tables of 8M entries, much larger than the caches, with the
+ * key sizes having vector compare functions.
+ */
+static int
+large_table_perf_test(void)
+{
+	struct rte_hash_parameters params = {
+		.name = "large_table_perf",
+		.entries = LARGE_ENTRIES,
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+	};
+	const void *keys_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	int32_t positions_burst[RTE_HASH_LOOKUP_BULK_MAX];
+	uint8_t key[MAX_KEYSIZE];
+	uint8_t (*lookup_keys)[MAX_KEYSIZE];
+	struct rte_hash *handle;
+	uint64_t start, single_cycles, bulk_cycles;
+	unsigned int i, j, k, r;
+
+	printf("\nLOOKUPS IN %u ENTRIES TABLES, %u KEYS\n", LARGE_ENTRIES,
+		LARGE_KEYS_TO_ADD);
+
+	lookup_keys = rte_malloc(NULL, LARGE_LOOKUP_KEYS * MAX_KEYSIZE, 0);
+	if (lookup_keys == NULL) {
+		printf("Cannot allocate the lookup keys\n");
+		return -1;
+	}
+
+	for (i = 0; i < RTE_DIM(large_key_lens); i++) {
+		params.key_len = large_key_lens[i];
+		handle = rte_hash_create(&params);
+		if (handle == NULL) {
+			printf("Not enough memory for a %u entries table, "
+				"skipped\n", LARGE_ENTRIES);
+			break;
+		}
+
+		for (j = 0; j < LARGE_KEYS_TO_ADD; j++) {
+			large_table_key(key, j, params.key_len);
+			if (rte_hash_add_key(handle, key) < 0) {
+				printf("Cannot add key %u\n", j);
+				goto err;
+			}
+		}
+
+		for (j = 0; j < LARGE_LOOKUP_KEYS; j++)
+			large_table_key(lookup_keys[j],
+				rte_rand() % LARGE_KEYS_TO_ADD, params.key_len);
+
+		start = rte_rdtsc();
+		for (r = 0; r < LARGE_LOOKUP_ROUNDS; r++)
+			for (j = 0; j < LARGE_LOOKUP_KEYS; j++)
+				if (rte_hash_lookup(handle,
+						lookup_keys[j]) < 0) {
+					printf("Key %u not found\n", j);
+					goto err;
+				}
+		single_cycles = rte_rdtsc() - start;
+
+		start = rte_rdtsc();
+		for (r = 0; r < LARGE_LOOKUP_ROUNDS; r++) {
+			for (j = 0; j < LARGE_LOOKUP_KEYS;
+					j += RTE_HASH_LOOKUP_BULK_MAX) {
+				for (k = 0; k < RTE_HASH_LOOKUP_BULK_MAX; k++)
+					keys_burst[k] = lookup_keys[j + k];
+				rte_hash_lookup_bulk(handle, keys_burst,
+					RTE_HASH_LOOKUP_BULK_MAX,
+					positions_burst);
+				for (k = 0; k < RTE_HASH_LOOKUP_BULK_MAX; k++)
+					if (positions_burst[k] < 0) {
+						printf("Key %u not found\n",
+							j + k);
+						goto err;
+					}
+			}
+		}
+		bulk_cycles = rte_rdtsc() - start;
+
+		printf("Key size %u: lookup %"PRIu64", bulk lookup %"PRIu64
+			" cycles/key\n", params.key_len,
+			single_cycles / (LARGE_LOOKUP_ROUNDS * LARGE_LOOKUP_KEYS),
+			bulk_cycles / (LARGE_LOOKUP_ROUNDS * LARGE_LOOKUP_KEYS));
+		rte_hash_free(handle);
+	}
+
+	rte_free(lookup_keys);
+	return 0;
+
+err:
+	rte_hash_free(handle);
+	rte_free(lookup_keys);
+	return -1;
+}
+
 static int
 test_hash_perf(void)
 {
@@ -623,6 +740,8 @@ test_hash_perf(void)
 	}
 	if (fbk_hash_perf_test() < 0)
 		return -1;
+	if (large_table_perf_test() < 0)
+		return -1;
 
 	return 0;
 }
@@ -0,0 +1,381 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_hash.h>
+#include <rte_hash_crc.h>
+#include <rte_launch.h>
+#include <rte_lcore.h>
+#include <rte_malloc.h>
+#include <rte_pause.h>
+#include <rte_random.h>
+
+#include "test.h"
+
+/*
+ * Lock-free readers, with RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF
+ * ==============================================================
+ *
+ * The master lcore is the writer: it fills the table up to a high load,
+ * so that many keys are moved by cuckoo displacements, then deletes the
+ * keys it added, waits for the readers to go through a quiescent state
+ * and frees the key positions.
+ *
+ * The other lcores are readers: they look up keys added before the
+ * writer starts and never deleted, which must always be found with their
+ * data, with rte_hash_lookup_bulk_data() and rte_hash_lookup_data().
+ *
+ * The perf test measures the lookup cycles with 1 to all the readers,
+ * without and with a concurrent writer.
+ */
+
+#define TOTAL_ENTRY (16 * 1024)
+/* keys present for the whole test */
+#define NUM_PERSISTENT (TOTAL_ENTRY / 4)
+/* keys added and deleted by the writer, to reach ~95% load */
+#define NUM_CHURN (TOTAL_ENTRY * 95 / 100 - NUM_PERSISTENT)
+#define WRITER_ROUNDS 20
+#define PERF_WRITER_ROUNDS 5
+#define BURST_SIZE 32
+
+static struct {
+	struct rte_hash *h;
+	uint32_t *keys;		/* persistent keys, then churn keys */
+	int32_t *del_pos;	/* positions of the deleted keys */
+	volatile int writer_done;
+	uint64_t reader_loops[RTE_MAX_LCORE] __rte_cache_aligned;
+	uint64_t lookups[RTE_MAX_LCORE];
+	uint64_t cycles[RTE_MAX_LCORE];
+	uint64_t misses[RTE_MAX_LCORE];
+} tbl_rw_test_params;
+
+static inline void *
+key_data(uint32_t key)
+{
+	return (void *)((uintptr_t)key + 1);
+}
+
+static int
+test_rw_reader(__attribute__((unused)) void *arg)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	const void *keys[BURST_SIZE];
+	void *data[BURST_SIZE];
+	uint64_t hit_mask, begin, lookups = 0, misses = 0, loops = 0;
+	uint32_t i, j, key;
+	int ret;
+
+	begin = rte_rdtsc_precise();
+	while (!tbl_rw_test_params.writer_done) {
+		for (i = 0; i < NUM_PERSISTENT; i += BURST_SIZE) {
+			for (j = 0; j < BURST_SIZE; j++)
+				keys[j] = &tbl_rw_test_params.keys[i + j];
+
+			ret = rte_hash_lookup_bulk_data(tbl_rw_test_params.h,
+				keys, BURST_SIZE, &hit_mask, data);
+			if (ret != BURST_SIZE)
+				misses += BURST_SIZE - ret;
+			for (j = 0; j < BURST_SIZE; j++) {
+				key = tbl_rw_test_params.keys[i + j];
+				if ((hit_mask & (1ULL << j)) &&
+						data[j] != key_data(key))
+					misses++;
+			}
+			lookups += BURST_SIZE;
+		}
+
+		for (i = 0; i < NUM_PERSISTENT; i++) {
+			key = tbl_rw_test_params.keys[i];
+			if (rte_hash_lookup_data(tbl_rw_test_params.h, &key,
+					&data[0]) < 0 ||
+					data[0] != key_data(key))
+				misses++;
+		}
+		lookups += NUM_PERSISTENT;
+
+		/* quiescent state: no reference to any key is held */
+		__atomic_store_n(&tbl_rw_test_params.reader_loops[lcore_id],
+				++loops, __ATOMIC_RELEASE);
+	}
+
+	tbl_rw_test_params.cycles[lcore_id] = rte_rdtsc_precise() - begin;
+	tbl_rw_test_params.lookups[lcore_id] = lookups;
+	tbl_rw_test_params.misses[lcore_id] = misses;
+	return 0;
+}
+
+/* wait until all the readers went through a quiescent state */
+static void
+wait_readers_quiescent(void)
+{
+	uint64_t loops[RTE_MAX_LCORE];
+	unsigned int lcore_id;
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id)
+		loops[lcore_id] = __atomic_load_n(
+			&tbl_rw_test_params.reader_loops[lcore_id],
+			__ATOMIC_ACQUIRE);
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (rte_eal_get_lcore_state(lcore_id) != RUNNING)
+			continue;
+		while (__atomic_load_n(
+				&tbl_rw_test_params.reader_loops[lcore_id],
+				__ATOMIC_ACQUIRE) == loops[lcore_id] &&
+				!tbl_rw_test_params.writer_done)
+			rte_pause();
+	}
+}
+
+static int
+test_rw_writer(unsigned int rounds, uint64_t *added)
+{
+	uint32_t *keys = &tbl_rw_test_params.keys[NUM_PERSISTENT];
+	unsigned int r;
+	uint32_t i, nb_added;
+	int32_t pos;
+
+	*added = 0;
+	for (r = 0; r < rounds; r++) {
+		for (nb_added = 0; nb_added < NUM_CHURN; nb_added++) {
+			if (rte_hash_add_key_data(tbl_rw_test_params.h,
+					&keys[nb_added],
+					key_data(keys[nb_added])) < 0)
+				break;
+		}
+		*added += nb_added;
+
+		for (i = 0; i < nb_added; i++) {
+			pos = rte_hash_del_key(tbl_rw_test_params.h, &keys[i]);
+			if (pos < 0) {
+				printf("cannot delete key %u\n", keys[i]);
+				return -1;
+			}
+			tbl_rw_test_params.del_pos[i] = pos;
+		}
+
+		wait_readers_quiescent();
+		for (i = 0; i < nb_added; i++)
+			rte_hash_free_key_with_position(tbl_rw_test_params.h,
+				tbl_rw_test_params.del_pos[i]);
+	}
+
+	return 0;
+}
+
+static int
+init_params(uint8_t extra_flag)
+{
+	struct rte_hash_parameters hash_params = {
+		.name = "tests",
+		.entries = TOTAL_ENTRY,
+		.key_len = sizeof(uint32_t),
+		.hash_func = rte_hash_crc,
+		.hash_func_init_val = 0,
+		.socket_id = rte_socket_id(),
+		.extra_flag = extra_flag,
+	};
+	uint32_t i, j, tmp;
+
+	tbl_rw_test_params.h = rte_hash_create(&hash_params);
+	tbl_rw_test_params.keys = rte_malloc(NULL,
+		sizeof(uint32_t) * (NUM_PERSISTENT + NUM_CHURN), 0);
+	tbl_rw_test_params.del_pos = rte_malloc(NULL,
+		sizeof(int32_t) * NUM_CHURN, 0);
+	if (tbl_rw_test_params.h == NULL || tbl_rw_test_params.keys == NULL ||
+			tbl_rw_test_params.del_pos == NULL) {
+		printf("cannot allocate the hash table\n");
+		return -1;
+	}
+
+	/* shuffled distinct keys */
+	for (i = 0; i < NUM_PERSISTENT + NUM_CHURN; i++)
+		tbl_rw_test_params.keys[i] = i;
+	for (i = NUM_PERSISTENT + NUM_CHURN - 1; i > 0; i--) {
+		j = rte_rand() % (i + 1);
+		tmp = tbl_rw_test_params.keys[i];
+		tbl_rw_test_params.keys[i] = tbl_rw_test_params.keys[j];
+		tbl_rw_test_params.keys[j] = tmp;
+	}
+
+	for (i = 0; i < NUM_PERSISTENT; i++) {
+		if (rte_hash_add_key_data(tbl_rw_test_params.h,
+				&tbl_rw_test_params.keys[i],
+				key_data(tbl_rw_test_params.keys[i])) < 0) {
+			printf("cannot add persistent key %u\n", i);
+			return -1;
+		}
+	}
+
+	tbl_rw_test_params.writer_done = 0;
+	memset(tbl_rw_test_params.reader_loops, 0,
+		sizeof(tbl_rw_test_params.reader_loops));
+	return 0;
+}
+
+static void
+free_params(void)
+{
+	rte_hash_free(tbl_rw_test_params.h);
+	rte_free(tbl_rw_test_params.keys);
+	rte_free(tbl_rw_test_params.del_pos);
+	memset(&tbl_rw_test_params, 0, sizeof(tbl_rw_test_params));
+}
+
+/*
+ * Run the readers on nb_readers lcores, with the writer on the master
+ * lcore doing rounds of add/delete, or only waiting for some time if
+ * rounds is 0. Return the total number of misses of the readers.
+ */
+static int64_t
+run_readers_writer(unsigned int nb_readers, unsigned int rounds,
+	uint64_t *lookups, uint64_t *cycles, uint64_t *added)
+{
+	unsigned int lcore_id, n = 0;
+	uint64_t misses = 0;
+	int ret = 0;
+
+	tbl_rw_test_params.writer_done = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (n++ == nb_readers)
+			break;
+		rte_eal_remote_launch(test_rw_reader, NULL, lcore_id);
+	}
+
+	*added = 0;
+	if (rounds != 0)
+		ret = test_rw_writer(rounds, added);
+	else
+		rte_delay_ms(500);
+	tbl_rw_test_params.writer_done = 1;
+	rte_eal_mp_wait_lcore();
+
+	*lookups = 0;
+	*cycles = 0;
+	n = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (n++ == nb_readers)
+			break;
+		*lookups += tbl_rw_test_params.lookups[lcore_id];
+		*cycles += tbl_rw_test_params.cycles[lcore_id];
+		misses += tbl_rw_test_params.misses[lcore_id];
+	}
+
+	return ret < 0 ? -1 : (int64_t)misses;
+}
+
+static int
+test_hash_readwrite_functional(void)
+{
+	uint64_t lookups, cycles, added;
+	int64_t misses;
+	uint32_t i;
+
+	if (init_params(RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF) < 0)
+		goto err;
+
+	misses = run_readers_writer(rte_lcore_count() - 1, WRITER_ROUNDS,
+		&lookups, &cycles, &added);
+	if (misses < 0)
+		goto err;
+
+	printf("%"PRIu64" lookups of persistent keys during %"PRIu64
+		" concurrent additions: %"PRId64" misses\n",
+		lookups, added, misses);
+	if (misses != 0 || lookups == 0)
+		goto err;
+
+	/* all the positions were freed: the churn keys fit again */
+	for (i = NUM_PERSISTENT; i < NUM_PERSISTENT + NUM_CHURN; i++)
+		if (rte_hash_add_key(tbl_rw_test_params.h,
+				&tbl_rw_test_params.keys[i]) < 0)
+			break;
+	if (i < NUM_PERSISTENT + NUM_CHURN / 2) {
+		printf("key positions were not freed\n");
+		goto err;
+	}
+
+	free_params();
+	return 0;
+
+err:
+	free_params();
+	return -1;
+}
+
+static int
+test_hash_readwrite_main(void)
+{
+	if (rte_lcore_count() < 2) {
+		printf("More than one lcore is required for readwrite test\n");
+		return 0;
+	}
+
+	printf("Test lock-free readers with a concurrent writer\n");
+	if (test_hash_readwrite_functional() < 0)
+		return -1;
+
+	return 0;
+}
+
+static int
+test_hash_readwrite_perf(void)
+{
+	static const char * const modes[] = { "default", "lock-free" };
+	static const uint8_t flags[] = {
+		0, RTE_HASH_EXTRA_FLAGS_RW_CONCURRENCY_LF };
+	uint64_t lookups, cycles, added;
+	unsigned int m, nb_readers;
+	int64_t misses;
+
+	if (rte_lcore_count() < 2) {
+		printf("More than one lcore is required for readwrite test\n");
+		return 0;
+	}
+
+	printf("\n%-10s %-8s %-7s %-16s\n", "Table", "Readers", "Writer",
+		"Cycles/lookup");
+	for (m = 0; m < RTE_DIM(modes); m++) {
+		for (nb_readers = 1; nb_readers < rte_lcore_count();
+				nb_readers++) {
+			if (init_params(flags[m]) < 0)
+				goto err;
+			misses = run_readers_writer(nb_readers, 0, &lookups,
+				&cycles, &added);
+			if (misses != 0 || lookups == 0)
+				goto err;
+			printf("%-10s %-8u %-7s %-16.1f\n", modes[m],
+				nb_readers, "no",
+				(double)cycles / lookups);
+
+			/* the default table is not safe with a writer */
+			if (flags[m] == 0) {
+				free_params();
+				continue;
+			}
+
+			misses = run_readers_writer(nb_readers,
+				PERF_WRITER_ROUNDS, &lookups, &cycles, &added);
+			if (misses != 0 || lookups == 0)
+				goto err;
+			printf("%-10s %-8u %-7s %-16.1f\n", modes[m],
+				nb_readers, "yes",
+				(double)cycles / lookups);
+			free_params();
+		}
+	}
+
+	return 0;
+
+err:
+	free_params();
+	return -1;
+}
+
+REGISTER_TEST_COMMAND(hash_readwrite_autotest, test_hash_readwrite_main);
+REGISTER_TEST_COMMAND(hash_readwrite_perf_autotest, test_hash_readwrite_perf);
@@ -0,0 +1,355 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_lcore.h>
+#include <rte_ip_frag.h>
+
+#include "test.h"
+
+#define TEST_IPFRAG_ASSERT(cond) do {                                         \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define NUM_MBUFS 256
+#define MBUF_CACHE_SIZE 32
+
+#define BUCKET_NUM 16
+#define BUCKET_ENTRIES 4
+#define MAX_ENTRIES 64
+#define MAX_CYCLES 100
+
+#define NB_PKTS 8
+#define NB_BULK_FRAGS 200
+#define FRAG_LEN 64
+
+static struct rte_mempool *pool;
+static struct rte_ip_frag_death_row dr;
+
+/*
+ * Builds one of the two fragments of an IPv4 datagram, whose ID is id.
+ * If frag is 0, builds an unfragmented datagram instead.
+ */
+static struct rte_mbuf *
+build_frag(uint16_t id, int last, int frag)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+	struct ipv4_hdr *ip;
+	uint16_t len;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	len = sizeof(*eth) + sizeof(*ip) + FRAG_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	memset(eth, 0, len);
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+	ip = (struct ipv4_hdr *)(eth + 1);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + FRAG_LEN);
+	ip->packet_id = rte_cpu_to_be_16(id);
+	if (frag)
+		ip->fragment_offset = rte_cpu_to_be_16(last ?
+			FRAG_LEN / IPV4_HDR_OFFSET_UNITS : IPV4_HDR_MF_FLAG);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 1));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 0, 0, 2));
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+	return m;
+}
+
+/*
+ * Builds one of the two fragments of an IPv6 datagram, whose ID is id.
+ * If frag is 0, builds an unfragmented datagram instead.
+ */
+static struct rte_mbuf *
+build_frag6(uint32_t id, int last, int frag)
+{
+	struct rte_mbuf *m;
+	struct ether_hdr *eth;
+	struct ipv6_hdr *ip;
+	struct ipv6_extension_fragment *fh;
+	uint16_t len, l3_len;
+
+	m = rte_pktmbuf_alloc(pool);
+	if (m == NULL)
+		return NULL;
+
+	l3_len = sizeof(*ip) + (frag ? sizeof(*fh) : 0);
+	len = sizeof(*eth) + l3_len + FRAG_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	memset(eth, 0, len);
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv6);
+	ip = (struct ipv6_hdr *)(eth + 1);
+	ip->vtc_flow = rte_cpu_to_be_32(6 << 28);
+	ip->payload_len = rte_cpu_to_be_16(l3_len - sizeof(*ip) + FRAG_LEN);
+	ip->hop_limits = 64;
+	ip->src_addr[15] = 1;
+	ip->dst_addr[15] = 2;
+	if (frag) {
+		ip->proto = IPPROTO_FRAGMENT;
+		fh = (struct ipv6_extension_fragment *)(ip + 1);
+		fh->next_header = IPPROTO_UDP;
+		fh->frag_data = rte_cpu_to_be_16(RTE_IPV6_SET_FRAG_DATA(
+			last ? FRAG_LEN : 0, !last));
+		fh->id = rte_cpu_to_be_32(id);
+	} else
+		ip->proto = IPPROTO_UDP;
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = l3_len;
+	return m;
+}
+
+/*
+ * Builds one of the two fragments of an IPv4 datagram, whose ID is id,
+ * and reassembles it.
+ */
+static struct rte_mbuf *
+reassemble_frag(struct rte_ip_frag_tbl *tbl, uint16_t id, int last,
+		uint64_t tms, int *err)
+{
+	struct rte_mbuf *m;
+
+	m = build_frag(id, last, 1);
+	if (m == NULL) {
+		*err = 1;
+		return NULL;
+	}
+
+	*err = 0;
+	return rte_ipv4_frag_reassemble_packet(tbl, &dr, m, tms,
+		rte_pktmbuf_mtod_offset(m, struct ipv4_hdr *, m->l2_len));
+}
+
+/*
+ * Stores the first fragments of NB_PKTS datagrams, created at 0, 10, 20...
+ * and deletes them with rte_ip_frag_table_del_expired_entries().
+ */
+static int
+test_ipfrag_expiry(struct rte_ip_frag_tbl *tbl)
+{
+	struct rte_mbuf *m;
+	uint32_t i, n;
+	int err;
+
+	for (i = 0; i != NB_PKTS; i++) {
+		m = reassemble_frag(tbl, i, 0, i * 10, &err);
+		TEST_IPFRAG_ASSERT(m == NULL && err == 0);
+	}
+	TEST_IPFRAG_ASSERT(tbl->use_entries == NB_PKTS);
+	TEST_IPFRAG_ASSERT(dr.cnt == 0);
+
+	/* nothing has expired yet */
+	n = rte_ip_frag_table_del_expired_entries(tbl, &dr, MAX_CYCLES,
+			UINT32_MAX);
+	TEST_IPFRAG_ASSERT(n == 0);
+
+	/* the entries created at 0, 10, 20, 30 and 40 have expired */
+	n = rte_ip_frag_table_del_expired_entries(tbl, &dr,
+			MAX_CYCLES + 45, UINT32_MAX);
+	TEST_IPFRAG_ASSERT(n == 5);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == NB_PKTS - 5);
+	TEST_IPFRAG_ASSERT(dr.cnt == 5);
+	rte_ip_frag_free_death_row(&dr, 3);
+
+	/* no room on the death row for the mbufs of an entry */
+	dr.cnt = IP_FRAG_DEATH_ROW_MBUF_LEN - 1;
+	n = rte_ip_frag_table_del_expired_entries(tbl, &dr, UINT64_MAX / 2,
+			UINT32_MAX);
+	TEST_IPFRAG_ASSERT(n == 0);
+	dr.cnt = 0;
+
+	/* the work is bounded by max_nb_del */
+	n = rte_ip_frag_table_del_expired_entries(tbl, &dr, UINT64_MAX / 2,
+			2);
+	TEST_IPFRAG_ASSERT(n == 2);
+	n = rte_ip_frag_table_del_expired_entries(tbl, &dr, UINT64_MAX / 2,
+			UINT32_MAX);
+	TEST_IPFRAG_ASSERT(n == 1);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == 0);
+	TEST_IPFRAG_ASSERT(dr.cnt == 3);
+	rte_ip_frag_free_death_row(&dr, 3);
+
+	/* the table is still usable */
+	m = reassemble_frag(tbl, 1, 1, 1000, &err);
+	TEST_IPFRAG_ASSERT(m == NULL && err == 0);
+	m = reassemble_frag(tbl, 1, 0, 1001, &err);
+	TEST_IPFRAG_ASSERT(m != NULL);
+	TEST_IPFRAG_ASSERT(m->pkt_len == sizeof(struct ether_hdr) +
+			sizeof(struct ipv4_hdr) + 2 * FRAG_LEN);
+	rte_pktmbuf_free(m);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == 0);
+
+	return 0;
+}
+
+/*
+ * Reassembles a burst, which interleaves the fragments of NB_PKTS / 2
+ * datagrams, with the first fragment of one more datagram and an
+ * unfragmented packet, with rte_ipv4_frag_reassemble_bulk(). Then does
+ * the same with IPv6.
+ */
+static int
+test_ipfrag_bulk(struct rte_ip_frag_tbl *tbl)
+{
+	struct rte_mbuf *mbs[NB_PKTS + 2];
+	uint32_t i;
+	uint16_t n;
+	uint32_t len4, len6;
+
+	len4 = sizeof(struct ether_hdr) + sizeof(struct ipv4_hdr) +
+		2 * FRAG_LEN;
+	len6 = sizeof(struct ether_hdr) + sizeof(struct ipv6_hdr) +
+		2 * FRAG_LEN;
+
+	for (i = 0; i != NB_PKTS; i++) {
+		mbs[i] = build_frag(i / 2 + 100, (i % 2) ^ (i / 2 % 2), 1);
+		TEST_IPFRAG_ASSERT(mbs[i] != NULL);
+	}
+	mbs[i++] = build_frag(200, 0, 0);
+	mbs[i] = build_frag(201, 0, 1);
+	TEST_IPFRAG_ASSERT(mbs[i - 1] != NULL && mbs[i] != NULL);
+
+	/* reassemble in place */
+	TEST_IPFRAG_ASSERT(rte_ipv4_frag_reassemble_bulk(tbl, &dr, mbs,
+			NB_PKTS + 2, 2000, mbs, &n) == NB_PKTS + 2);
+	TEST_IPFRAG_ASSERT(n == NB_PKTS / 2 + 1);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == 1);
+	for (i = 0; i != NB_PKTS / 2; i++) {
+		TEST_IPFRAG_ASSERT(mbs[i]->pkt_len == len4);
+		TEST_IPFRAG_ASSERT(rte_be_to_cpu_16(rte_pktmbuf_mtod_offset(
+			mbs[i], struct ipv4_hdr *,
+			mbs[i]->l2_len)->packet_id) == i + 100);
+	}
+	TEST_IPFRAG_ASSERT(mbs[i]->pkt_len == len4 - FRAG_LEN);
+	for (i = 0; i != n; i++)
+		rte_pktmbuf_free(mbs[i]);
+
+	/* the last fragment of the pending datagram completes it */
+	mbs[0] = build_frag(201, 1, 1);
+	TEST_IPFRAG_ASSERT(mbs[0] != NULL);
+	TEST_IPFRAG_ASSERT(rte_ipv4_frag_reassemble_bulk(tbl, &dr, mbs, 1,
+			2001, mbs, &n) == 1);
+	TEST_IPFRAG_ASSERT(n == 1 && mbs[0]->pkt_len == len4);
+	rte_pktmbuf_free(mbs[0]);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == 0);
+
+	for (i = 0; i != NB_PKTS; i++) {
+		mbs[i] = build_frag6(i / 2 + 100, i % 2, 1);
+		TEST_IPFRAG_ASSERT(mbs[i] != NULL);
+	}
+	mbs[i] = build_frag6(200, 0, 0);
+	TEST_IPFRAG_ASSERT(mbs[i] != NULL);
+
+	TEST_IPFRAG_ASSERT(rte_ipv6_frag_reassemble_bulk(tbl, &dr, mbs,
+			NB_PKTS + 1, 3000, mbs, &n) == NB_PKTS + 1);
+	TEST_IPFRAG_ASSERT(n == NB_PKTS / 2 + 1);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == 0);
+	for (i = 0; i != n; i++) {
+		TEST_IPFRAG_ASSERT(mbs[i]->pkt_len == (i + 1 == n ?
+			len6 - FRAG_LEN : len6));
+		rte_pktmbuf_free(mbs[i]);
+	}
+
+	TEST_IPFRAG_ASSERT(dr.cnt == 0);
+	return 0;
+}
+
+/*
+ * Reassembles a burst of NB_BULK_FRAGS fragments, whose first fragments
+ * are all duplicated, so that each pair of fragments puts its two mbufs
+ * on the death row. The call must stop before the death row overflows,
+ * and the rest of the burst is reassembled once it is freed.
+ */
+static int
+test_ipfrag_bulk_dr(struct rte_ip_frag_tbl *tbl)
+{
+	struct rte_mbuf *mbs[NB_BULK_FRAGS];
+	uint16_t n, nb_out;
+	uint32_t i;
+
+	for (i = 0; i != NB_BULK_FRAGS; i++) {
+		mbs[i] = build_frag(i / 2 + 300, 0, 1);
+		TEST_IPFRAG_ASSERT(mbs[i] != NULL);
+	}
+
+	n = rte_ipv4_frag_reassemble_bulk(tbl, &dr, mbs, NB_BULK_FRAGS,
+			4000, mbs, &nb_out);
+	TEST_IPFRAG_ASSERT(nb_out == 0);
+	TEST_IPFRAG_ASSERT(n > IP_FRAG_DEATH_ROW_LEN && n < NB_BULK_FRAGS);
+	TEST_IPFRAG_ASSERT(dr.cnt + 1 >= n &&
+		dr.cnt <= IP_FRAG_DEATH_ROW_MBUF_LEN);
+	TEST_IPFRAG_ASSERT(dr.cnt + IP_MAX_FRAG_NUM + 1 >
+		IP_FRAG_DEATH_ROW_MBUF_LEN);
+	rte_ip_frag_free_death_row(&dr, 3);
+
+	for (i = n; i != NB_BULK_FRAGS; i += n) {
+		n = rte_ipv4_frag_reassemble_bulk(tbl, &dr, mbs + i,
+				NB_BULK_FRAGS - i, 4001, mbs, &nb_out);
+		TEST_IPFRAG_ASSERT(n != 0 && nb_out == 0);
+		rte_ip_frag_free_death_row(&dr, 3);
+	}
+
+	/* a pair may have been split, its first fragment is still there */
+	rte_ip_frag_table_del_expired_entries(tbl, &dr, UINT64_MAX / 2,
+			UINT32_MAX);
+	rte_ip_frag_free_death_row(&dr, 3);
+	TEST_IPFRAG_ASSERT(tbl->use_entries == 0);
+
+	return 0;
+}
+
+static int
+test_ipfrag(void)
+{
+	struct rte_ip_frag_tbl *tbl;
+	int ret;
+
+	pool = rte_pktmbuf_pool_create("ipfrag_test_pool", NUM_MBUFS,
+			MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE,
+			rte_socket_id());
+	TEST_IPFRAG_ASSERT(pool != NULL);
+
+	tbl = rte_ip_frag_table_create(BUCKET_NUM, BUCKET_ENTRIES,
+			MAX_ENTRIES, MAX_CYCLES, rte_socket_id());
+	if (tbl == NULL) {
+		rte_mempool_free(pool);
+		return -1;
+	}
+
+	ret = test_ipfrag_expiry(tbl);
+	if (ret == 0)
+		ret = test_ipfrag_bulk(tbl);
+	if (ret == 0)
+		ret = test_ipfrag_bulk_dr(tbl);
+	rte_ip_frag_free_death_row(&dr, 0);
+	rte_ip_frag_table_statistics_dump(stdout, tbl);
+	rte_ip_frag_table_destroy(tbl);
+
+	if (ret == 0 && rte_mempool_in_use_count(pool) != 0) {
+		printf("mbufs are leaked\n");
+		ret = -1;
+	}
+
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(ipfrag_autotest, test_ipfrag);
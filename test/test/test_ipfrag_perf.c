@@ -0,0 +1,231 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_ether.h>
+#include <rte_ip.h>
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_lcore.h>
+#include <rte_ip_frag.h>
+
+#include "test.h"
+
+#define TEST_IPFRAG_ASSERT(cond) do {                                         \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define MAX_DGRAMS 16384
+#define FRAGS_PER_DGRAM 2
+#define NB_FRAGS (MAX_DGRAMS * FRAGS_PER_DGRAM)
+#define MBUF_CACHE_SIZE 256
+#define NUM_MBUFS (NB_FRAGS + 2 * MBUF_CACHE_SIZE)
+#define MBUF_SIZE (RTE_PKTMBUF_HEADROOM + 128)
+#define FRAG_LEN 64
+#define BUCKET_ENTRIES 4
+#define BURST_SIZE 32
+#define ROUNDS 8
+#define PREFETCH_OFFSET 3
+
+/* Number of datagrams being reassembled at once */
+static const uint32_t dgram_nums[] = {16, 256, 1024, 4096, MAX_DGRAMS};
+
+static struct rte_mempool *pool;
+static struct rte_mbuf *frags[NB_FRAGS];
+static struct rte_mbuf *out[NB_FRAGS];
+static struct rte_ip_frag_death_row dr;
+
+/*
+ * Builds one of the two fragments of IPv4 datagram dgram in m.
+ */
+static int
+build_frag(struct rte_mbuf *m, uint32_t dgram, int last)
+{
+	struct ether_hdr *eth;
+	struct ipv4_hdr *ip;
+	uint16_t len;
+
+	len = sizeof(*eth) + sizeof(*ip) + FRAG_LEN;
+	eth = (struct ether_hdr *)rte_pktmbuf_append(m, len);
+	if (eth == NULL)
+		return -1;
+
+	memset(eth, 0, len);
+	eth->ether_type = rte_cpu_to_be_16(ETHER_TYPE_IPv4);
+
+	ip = (struct ipv4_hdr *)(eth + 1);
+	ip->version_ihl = 0x45;
+	ip->total_length = rte_cpu_to_be_16(sizeof(*ip) + FRAG_LEN);
+	ip->packet_id = rte_cpu_to_be_16(dgram);
+	ip->fragment_offset = rte_cpu_to_be_16(last ?
+		FRAG_LEN / IPV4_HDR_OFFSET_UNITS : IPV4_HDR_MF_FLAG);
+	ip->time_to_live = 64;
+	ip->next_proto_id = IPPROTO_UDP;
+	ip->src_addr = rte_cpu_to_be_32(IPv4(10, 0, dgram >> 8, dgram));
+	ip->dst_addr = rte_cpu_to_be_32(IPv4(10, 1, 0, 1));
+
+	m->l2_len = sizeof(*eth);
+	m->l3_len = sizeof(*ip);
+
+	return 0;
+}
+
+/*
+ * Builds the first fragments of nb_dgrams datagrams, followed by their
+ * last fragments, so that the table holds all the datagrams at once.
+ */
+static int
+build_frags(uint32_t nb_dgrams)
+{
+	uint32_t i;
+
+	TEST_IPFRAG_ASSERT(rte_pktmbuf_alloc_bulk(pool, frags,
+			nb_dgrams * FRAGS_PER_DGRAM) == 0);
+	for (i = 0; i != nb_dgrams * FRAGS_PER_DGRAM; i++)
+		TEST_IPFRAG_ASSERT(build_frag(frags[i], i % nb_dgrams,
+				i >= nb_dgrams) == 0);
+
+	return 0;
+}
+
+/*
+ * Reassembles the fragments one by one, freeing the death row after
+ * each burst, as an application loop does.
+ */
+static uint32_t
+reassemble_packets(struct rte_ip_frag_tbl *tbl, uint32_t nb_frags,
+	uint64_t tms)
+{
+	struct rte_mbuf *m;
+	uint32_t i, j, n, nb_out;
+
+	nb_out = 0;
+	for (i = 0; i < nb_frags; i += n) {
+		n = RTE_MIN(nb_frags - i, (uint32_t)BURST_SIZE);
+		for (j = 0; j != n; j++) {
+			m = rte_ipv4_frag_reassemble_packet(tbl, &dr,
+				frags[i + j], tms,
+				rte_pktmbuf_mtod_offset(frags[i + j],
+					struct ipv4_hdr *,
+					frags[i + j]->l2_len));
+			if (m != NULL)
+				out[nb_out++] = m;
+		}
+		rte_ip_frag_free_death_row(&dr, PREFETCH_OFFSET);
+	}
+
+	return nb_out;
+}
+
+/*
+ * Reassembles the same bursts with rte_ipv4_frag_reassemble_bulk().
+ */
+static uint32_t
+reassemble_bulk(struct rte_ip_frag_tbl *tbl, uint32_t nb_frags,
+	uint64_t tms)
+{
+	uint32_t i, j, n, nb_out;
+	uint16_t k, m;
+
+	nb_out = 0;
+	for (i = 0; i < nb_frags; i += n) {
+		n = RTE_MIN(nb_frags - i, (uint32_t)BURST_SIZE);
+		for (j = 0; j != n; j += k) {
+			k = rte_ipv4_frag_reassemble_bulk(tbl, &dr,
+				frags + i + j, n - j, tms, out + nb_out, &m);
+			nb_out += m;
+			rte_ip_frag_free_death_row(&dr, PREFETCH_OFFSET);
+		}
+	}
+
+	return nb_out;
+}
+
+/*
+ * Reassembles the fragments of nb_dgrams datagrams in bursts, ROUNDS
+ * times with each API, and prints the cycles per fragment of each.
+ */
+static int
+test_ipfrag_perf_dgrams(uint32_t nb_dgrams)
+{
+	struct rte_ip_frag_tbl *tbl;
+	uint64_t begin, cycles[2];
+	uint32_t i, nb_frags, nb_out, round, bulk;
+
+	tbl = rte_ip_frag_table_create(nb_dgrams, BUCKET_ENTRIES, nb_dgrams,
+			UINT64_MAX / 2, rte_socket_id());
+	TEST_IPFRAG_ASSERT(tbl != NULL);
+
+	nb_frags = nb_dgrams * FRAGS_PER_DGRAM;
+
+	for (bulk = 0; bulk != 2; bulk++) {
+		cycles[bulk] = 0;
+		for (round = 0; round != ROUNDS; round++) {
+			if (build_frags(nb_dgrams) < 0)
+				goto err;
+
+			begin = rte_rdtsc();
+			if (bulk)
+				nb_out = reassemble_bulk(tbl, nb_frags, round);
+			else
+				nb_out = reassemble_packets(tbl, nb_frags,
+					round);
+			cycles[bulk] += rte_rdtsc() - begin;
+
+			for (i = 0; i != nb_out; i++)
+				rte_pktmbuf_free(out[i]);
+			if (nb_out != nb_dgrams || dr.cnt != 0 ||
+					tbl->use_entries != 0) {
+				printf("%u datagrams: %u reassembled\n",
+					nb_dgrams, nb_out);
+				goto err;
+			}
+		}
+	}
+
+	printf("%8u %20.1f %20.1f\n", nb_dgrams,
+		(double)cycles[0] / (ROUNDS * nb_frags),
+		(double)cycles[1] / (ROUNDS * nb_frags));
+
+	rte_ip_frag_table_destroy(tbl);
+	return 0;
+
+err:
+	rte_ip_frag_free_death_row(&dr, 0);
+	rte_ip_frag_table_destroy(tbl);
+	return -1;
+}
+
+static int
+test_ipfrag_perf(void)
+{
+	uint32_t i;
+	int ret = 0;
+
+	pool = rte_pktmbuf_pool_create("ipfrag_perf_pool", NUM_MBUFS,
+			MBUF_CACHE_SIZE, 0, MBUF_SIZE, rte_socket_id());
+	TEST_IPFRAG_ASSERT(pool != NULL);
+
+	printf("\nIPv4 reassembly, cycles per fragment, bursts of %u\n",
+		BURST_SIZE);
+	printf("%8s %20s %20s\n", "dgrams", "per packet", "bulk");
+
+	for (i = 0; i != RTE_DIM(dgram_nums); i++) {
+		ret = test_ipfrag_perf_dgrams(dgram_nums[i]);
+		if (ret < 0)
+			break;
+	}
+
+	rte_mempool_free(pool);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(ipfrag_perf_autotest, test_ipfrag_perf);
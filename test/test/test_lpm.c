@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 #include <rte_ip.h>
 #include <rte_lpm.h>
@@ -40,6 +41,7 @@ static int32_t test15(void);
 static int32_t test16(void);
 static int32_t test17(void);
 static int32_t test18(void);
+static int32_t test19(void);
 
 rte_lpm_test tests[] = {
 /* Test Cases */
@@ -61,7 +63,8 @@ rte_lpm_test tests[] = {
 	test15,
 	test16,
 	test17,
-	test18
+	test18,
+	test19
 };
 
 #define NUM_LPM_TESTS (sizeof(tests)/sizeof(tests[0]))
@@ -1266,6 +1269,136 @@ test18(void)
 	return PASS;
 }
 
+/*
+ * Test for save and restore of a table
+ *  - add random rules, some of them using tbl8s
+ *  - save the table to a file and restore it in a new table
+ *  - check both tables return the same lookups and rules
+ *  - check the restored table can still be updated
+ *  - check restoring a missing, truncated, corrupted or existing table
+ *    fails
+ */
+int32_t
+test19(void)
+{
+	struct rte_lpm *lpm = NULL, *restored = NULL;
+	struct rte_lpm_config config;
+	char filename[64];
+	uint32_t ip, rule_ip[MAX_RULES], next_hop, restored_next_hop;
+	uint8_t rule_depth[MAX_RULES];
+	struct rte_lpm_tbl_entry entry;
+	int status, restored_status;
+	unsigned int i;
+	long size;
+	FILE *f;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	snprintf(filename, sizeof(filename), "/tmp/test_lpm_%d.snapshot",
+			getpid());
+
+	lpm = rte_lpm_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	for (i = 0; i < MAX_RULES; i++) {
+		rule_ip[i] = (uint32_t)lrand48();
+		rule_depth[i] = (uint8_t)(lrand48() % RTE_LPM_MAX_DEPTH) + 1;
+		TEST_LPM_ASSERT(rte_lpm_add(lpm, rule_ip[i], rule_depth[i],
+				i) == 0);
+	}
+
+	TEST_LPM_ASSERT(rte_lpm_save(lpm, filename) == 0);
+
+	restored = rte_lpm_restore("test19_restored", SOCKET_ID_ANY, filename);
+	TEST_LPM_ASSERT(restored != NULL);
+	TEST_LPM_ASSERT(restored->max_rules == lpm->max_rules &&
+			restored->number_tbl8s == lpm->number_tbl8s);
+
+	for (i = 0; i < 100000; i++) {
+		ip = (i & 1) ? rule_ip[i % MAX_RULES] ^ (uint32_t)(i >> 1) :
+				(uint32_t)lrand48();
+		status = rte_lpm_lookup(lpm, ip, &next_hop);
+		restored_status = rte_lpm_lookup(restored, ip,
+				&restored_next_hop);
+		TEST_LPM_ASSERT(status == restored_status);
+		TEST_LPM_ASSERT(status != 0 || next_hop == restored_next_hop);
+	}
+
+	for (i = 0; i < MAX_RULES; i++) {
+		status = rte_lpm_is_rule_present(lpm, rule_ip[i],
+				rule_depth[i], &next_hop);
+		restored_status = rte_lpm_is_rule_present(restored,
+				rule_ip[i], rule_depth[i], &restored_next_hop);
+		TEST_LPM_ASSERT(status == 1 && restored_status == 1 &&
+				next_hop == restored_next_hop);
+	}
+
+	/* The restored table keeps working after updates */
+	for (i = 0; i < MAX_RULES; i++)
+		rte_lpm_delete(restored, rule_ip[i], rule_depth[i]);
+	TEST_LPM_ASSERT(rte_lpm_add(restored, IPv4(10, 0, 0, 0), 8, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm_add(restored, IPv4(10, 1, 1, 1), 32, 2) == 0);
+	TEST_LPM_ASSERT(rte_lpm_lookup(restored, IPv4(10, 1, 1, 2),
+			&next_hop) == 0 && next_hop == 1);
+	TEST_LPM_ASSERT(rte_lpm_lookup(restored, IPv4(10, 1, 1, 1),
+			&next_hop) == 0 && next_hop == 2);
+	TEST_LPM_ASSERT(rte_lpm_lookup(restored, IPv4(11, 1, 1, 1),
+			&next_hop) == -ENOENT);
+
+	/* The name must not be in use */
+	TEST_LPM_ASSERT(rte_lpm_restore(__func__, SOCKET_ID_ANY,
+			filename) == NULL);
+
+	rte_lpm_free(restored);
+
+	/* Trailing data is rejected */
+	f = fopen(filename, "r+");
+	TEST_LPM_ASSERT(f != NULL);
+	TEST_LPM_ASSERT(fseek(f, 0, SEEK_END) == 0);
+	size = ftell(f);
+	TEST_LPM_ASSERT(fputc(0, f) != EOF);
+	fclose(f);
+	TEST_LPM_ASSERT(rte_lpm_restore("test19_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+
+	/* A group index out of the tbl8s is rejected */
+	memset(&entry, 0, sizeof(entry));
+	entry.next_hop = NUMBER_TBL8S;
+	entry.valid = 1;
+	entry.valid_group = 1;
+	entry.depth = 8;
+	f = fopen(filename, "r+");
+	TEST_LPM_ASSERT(f != NULL);
+	TEST_LPM_ASSERT(ftruncate(fileno(f), size) == 0);
+	TEST_LPM_ASSERT(fseek(f, size - sizeof(entry) *
+			(RTE_LPM_TBL24_NUM_ENTRIES + NUMBER_TBL8S *
+			RTE_LPM_TBL8_GROUP_NUM_ENTRIES), SEEK_SET) == 0);
+	TEST_LPM_ASSERT(fwrite(&entry, sizeof(entry), 1, f) == 1);
+	fclose(f);
+	TEST_LPM_ASSERT(rte_lpm_restore("test19_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+	TEST_LPM_ASSERT(rte_lpm_find_existing("test19_restored") == NULL);
+
+	/* A truncated file is rejected */
+	f = fopen(filename, "r+");
+	TEST_LPM_ASSERT(f != NULL);
+	TEST_LPM_ASSERT(ftruncate(fileno(f), 4096) == 0);
+	fclose(f);
+	TEST_LPM_ASSERT(rte_lpm_restore("test19_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+	TEST_LPM_ASSERT(rte_lpm_find_existing("test19_restored") == NULL);
+
+	unlink(filename);
+	TEST_LPM_ASSERT(rte_lpm_restore("test19_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+
+	rte_lpm_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
@@ -6,6 +6,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <rte_memory.h>
 #include <rte_lpm6.h>
@@ -51,6 +52,7 @@ static int32_t test25(void);
 static int32_t test26(void);
 static int32_t test27(void);
 static int32_t test28(void);
+static int32_t test29(void);
 
 rte_lpm6_test tests6[] = {
 /* Test Cases */
@@ -83,6 +85,7 @@ rte_lpm6_test tests6[] = {
 	test26,
 	test27,
 	test28,
+	test29,
 };
 
 #define NUM_LPM6_TESTS                (sizeof(tests6)/sizeof(tests6[0]))
@@ -1771,6 +1774,97 @@ test28(void)
 	return PASS;
 }
 
+/*
+ * Save the table of the large route table to a file, restore it in a
+ * new table, and check both tables return the same lookups. Check that
+ * restoring a file with trailing data, a truncated or a missing file
+ * fails.
+ */
+int32_t
+test29(void)
+{
+	struct rte_lpm6 *lpm = NULL, *restored = NULL;
+	struct rte_lpm6_config config;
+	char filename[64];
+	uint32_t i, next_hop, restored_next_hop;
+	int status, restored_status;
+	FILE *f;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	snprintf(filename, sizeof(filename), "/tmp/test_lpm6_%d.snapshot",
+			getpid());
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++)
+		TEST_LPM_ASSERT(rte_lpm6_add(lpm, large_route_table[i].ip,
+				large_route_table[i].depth,
+				large_route_table[i].next_hop) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm6_save(lpm, filename) == 0);
+
+	restored = rte_lpm6_restore("test29_restored", SOCKET_ID_ANY,
+			filename);
+	TEST_LPM_ASSERT(restored != NULL);
+
+	generate_large_ips_table(0);
+	for (i = 0; i < NUM_IPS_ENTRIES; i++) {
+		/* Change every other address, to look up misses too */
+		if (i & 1)
+			large_ips_table[i].ip[0] ^= (uint8_t)(i >> 1);
+		status = rte_lpm6_lookup(lpm, large_ips_table[i].ip,
+				&next_hop);
+		restored_status = rte_lpm6_lookup(restored,
+				large_ips_table[i].ip, &restored_next_hop);
+		TEST_LPM_ASSERT(status == restored_status);
+		TEST_LPM_ASSERT(status != 0 || next_hop == restored_next_hop);
+	}
+
+	/* The rules are restored too, and can be deleted */
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++) {
+		status = rte_lpm6_is_rule_present(restored,
+				large_route_table[i].ip,
+				large_route_table[i].depth, &next_hop);
+		TEST_LPM_ASSERT(status == 1);
+	}
+	TEST_LPM_ASSERT(rte_lpm6_delete(restored, large_route_table[0].ip,
+			large_route_table[0].depth) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_is_rule_present(restored,
+			large_route_table[0].ip, large_route_table[0].depth,
+			&next_hop) == 0);
+
+	rte_lpm6_free(restored);
+
+	/* Trailing data is rejected */
+	f = fopen(filename, "a");
+	TEST_LPM_ASSERT(f != NULL);
+	TEST_LPM_ASSERT(fputc(0, f) != EOF);
+	fclose(f);
+	TEST_LPM_ASSERT(rte_lpm6_restore("test29_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+
+	/* A truncated file is rejected */
+	f = fopen(filename, "r+");
+	TEST_LPM_ASSERT(f != NULL);
+	TEST_LPM_ASSERT(ftruncate(fileno(f), 4096) == 0);
+	fclose(f);
+	TEST_LPM_ASSERT(rte_lpm6_restore("test29_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+	TEST_LPM_ASSERT(rte_lpm6_find_existing("test29_restored") == NULL);
+
+	unlink(filename);
+	TEST_LPM_ASSERT(rte_lpm6_restore("test29_restored", SOCKET_ID_ANY,
+			filename) == NULL);
+
+	rte_lpm6_free(lpm);
+
+	return PASS;
+}
+
 /*
  * Do all unit tests.
  */
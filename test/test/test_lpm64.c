@@ -0,0 +1,325 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <rte_ip.h>
+#include <rte_lcore.h>
+#include <rte_launch.h>
+#include <rte_cycles.h>
+#include <rte_lpm64.h>
+
+#include "test.h"
+#include "test_xmmt_ops.h"
+
+#define TEST_LPM_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define MAX_RULES 256
+#define NUMBER_TBL8S 256
+#define PASS 0
+
+/* Next hops using the upper bits, such as pointers */
+#define NH(n) (UINT64_C(0x00ab000000000000) | (n))
+
+/*
+ * Check that rte_lpm64_create and rte_lpm64_add fail gracefully for
+ * incorrect user input arguments
+ */
+static int32_t
+test_lpm64_params(void)
+{
+	struct rte_lpm64 *lpm = NULL;
+	struct rte_lpm64_config config;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm64_create(NULL, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	config.max_rules = 0;
+	lpm = rte_lpm64_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	config.max_rules = MAX_RULES;
+	lpm = rte_lpm64_create(__func__, -2, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	lpm = rte_lpm64_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	TEST_LPM_ASSERT(rte_lpm64_find_existing(__func__) == lpm);
+
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 0, 0), 0, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 0, 0), 33, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 0, 0), 8,
+			RTE_LPM64_MAX_NEXT_HOP + 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm64_delete(lpm, IPv4(10, 0, 0, 0), 8) < 0);
+	TEST_LPM_ASSERT(rte_lpm64_reader_register(lpm,
+			RTE_LPM64_MAX_READERS) < 0);
+
+	rte_lpm64_free(lpm);
+	TEST_LPM_ASSERT(rte_lpm64_find_existing(__func__) == NULL);
+
+	return PASS;
+}
+
+/*
+ * Add, look up and delete routes of depths smaller and bigger than 24,
+ * with next hops wider than 32 bits, using all the lookup functions.
+ */
+static int32_t
+test_lpm64_add_lookup_delete(void)
+{
+	struct rte_lpm64 *lpm;
+	struct rte_lpm64_config config;
+	uint32_t ips[4];
+	uint64_t next_hop, next_hops[4], hop[4];
+	xmm_t ipx4;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm64_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 0, 0), 8, NH(1)) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 1, 1, 0), 24, NH(2)) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 1, 1, 128), 25,
+			NH(3)) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 1, 1, 129), 32,
+			RTE_LPM64_MAX_NEXT_HOP) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm64_is_rule_present(lpm, IPv4(10, 1, 1, 128), 25,
+			&next_hop) == 1 && next_hop == NH(3));
+	TEST_LPM_ASSERT(rte_lpm64_is_rule_present(lpm, IPv4(10, 1, 1, 128), 26,
+			&next_hop) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 2, 0, 1),
+			&next_hop) == 0 && next_hop == NH(1));
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 1),
+			&next_hop) == 0 && next_hop == NH(2));
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 130),
+			&next_hop) == 0 && next_hop == NH(3));
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 129),
+			&next_hop) == 0 && next_hop == RTE_LPM64_MAX_NEXT_HOP);
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(11, 0, 0, 1),
+			&next_hop) == -ENOENT);
+
+	ips[0] = IPv4(10, 2, 0, 1);
+	ips[1] = IPv4(10, 1, 1, 1);
+	ips[2] = IPv4(10, 1, 1, 130);
+	ips[3] = IPv4(11, 0, 0, 1);
+	rte_lpm64_lookup_bulk(lpm, ips, next_hops, 4);
+	TEST_LPM_ASSERT(next_hops[0] == (NH(1) | RTE_LPM64_LOOKUP_SUCCESS));
+	TEST_LPM_ASSERT(next_hops[1] == (NH(2) | RTE_LPM64_LOOKUP_SUCCESS));
+	TEST_LPM_ASSERT(next_hops[2] == (NH(3) | RTE_LPM64_LOOKUP_SUCCESS));
+	TEST_LPM_ASSERT(!(next_hops[3] & RTE_LPM64_LOOKUP_SUCCESS));
+
+	ipx4 = vect_set_epi32(ips[3], ips[2], ips[1], ips[0]);
+	rte_lpm64_lookupx4(lpm, ipx4, hop, UINT64_MAX);
+	TEST_LPM_ASSERT(hop[0] == NH(1) && hop[1] == NH(2) &&
+			hop[2] == NH(3) && hop[3] == UINT64_MAX);
+
+	/* The less specific routes are used after a deletion */
+	TEST_LPM_ASSERT(rte_lpm64_delete(lpm, IPv4(10, 1, 1, 128), 25) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 130),
+			&next_hop) == 0 && next_hop == NH(2));
+	TEST_LPM_ASSERT(rte_lpm64_delete(lpm, IPv4(10, 1, 1, 0), 24) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 130),
+			&next_hop) == 0 && next_hop == NH(1));
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 129),
+			&next_hop) == 0 && next_hop == RTE_LPM64_MAX_NEXT_HOP);
+	TEST_LPM_ASSERT(rte_lpm64_delete(lpm, IPv4(10, 1, 1, 129), 32) == 0);
+	TEST_LPM_ASSERT(!lpm->tbl24[IPv4(10, 1, 1, 0) >> 8].valid_group);
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 1, 1, 129),
+			&next_hop) == 0 && next_hop == NH(1));
+
+	rte_lpm64_delete_all(lpm);
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 2, 0, 1),
+			&next_hop) == -ENOENT);
+
+	rte_lpm64_free(lpm);
+	return PASS;
+}
+
+/*
+ * Check that a tbl8 group released by a deletion is not reused before
+ * the registered readers reported a quiescent state.
+ */
+static int32_t
+test_lpm64_tbl8_reclaim(void)
+{
+	struct rte_lpm64 *lpm;
+	struct rte_lpm64_config config;
+	uint64_t next_hop;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 1;
+	config.flags = 0;
+
+	lpm = rte_lpm64_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	TEST_LPM_ASSERT(rte_lpm64_reader_register(lpm, 0) == 0);
+
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 0, 1), 32, NH(1)) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 1, 1), 32,
+			NH(2)) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm64_delete(lpm, IPv4(10, 0, 0, 1), 32) == 0);
+
+	/* The reader may still read the group */
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 1, 1), 32,
+			NH(2)) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm64_reclaim(lpm) == 1);
+
+	/* Once it is done, the group is reused */
+	rte_lpm64_quiescent(lpm, 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 1, 1), 32, NH(2)) == 0);
+	TEST_LPM_ASSERT(rte_lpm64_lookup(lpm, IPv4(10, 0, 1, 1),
+			&next_hop) == 0 && next_hop == NH(2));
+
+	/* A reader not registered does not hold the groups */
+	TEST_LPM_ASSERT(rte_lpm64_delete(lpm, IPv4(10, 0, 1, 1), 32) == 0);
+	rte_lpm64_reader_unregister(lpm, 0);
+	TEST_LPM_ASSERT(rte_lpm64_add(lpm, IPv4(10, 0, 0, 1), 32, NH(1)) == 0);
+
+	rte_lpm64_free(lpm);
+	return PASS;
+}
+
+/*
+ * Readers look up addresses of persistent /24 routes on worker lcores,
+ * with lookupx4 and without any lock, while the main lcore keeps adding
+ * and deleting /32 routes in the same /24 prefixes, so that the tbl8
+ * groups are allocated and released all the time: a group reused too
+ * early would give the readers the next hops of another prefix.
+ */
+#define RW_PREFIXES 64
+#define RW_ROUNDS 200
+
+static struct rte_lpm64 *rw_lpm;
+static volatile int rw_stop;
+static uint64_t rw_errors[RTE_MAX_LCORE];
+static uint64_t rw_lookups[RTE_MAX_LCORE];
+
+static int
+test_lpm64_reader(__attribute__((unused)) void *arg)
+{
+	unsigned int lcore_id = rte_lcore_id();
+	uint64_t hop[4];
+	uint32_t i, ip;
+	xmm_t ipx4;
+
+	rte_lpm64_reader_register(rw_lpm, lcore_id);
+
+	while (!rw_stop) {
+		for (i = 0; i < RW_PREFIXES; i++) {
+			/* .2 is never added as a /32 route */
+			ip = IPv4(20, 0, i, 2);
+			ipx4 = vect_set_epi32(ip, ip, ip, ip);
+			rte_lpm64_lookupx4(rw_lpm, ipx4, hop, UINT64_MAX);
+			if (hop[0] != NH(i) || hop[3] != NH(i))
+				rw_errors[lcore_id]++;
+			rw_lookups[lcore_id] += 4;
+		}
+
+		/* No reference is held between two bursts */
+		rte_lpm64_quiescent(rw_lpm, lcore_id);
+	}
+
+	rte_lpm64_reader_unregister(rw_lpm, lcore_id);
+	return 0;
+}
+
+static int32_t
+test_lpm64_concurrent_update(void)
+{
+	struct rte_lpm64_config config;
+	unsigned int lcore_id, nb_readers = 0;
+	uint64_t errors = 0, lookups = 0;
+	uint32_t i, round;
+	int ret = PASS;
+
+	if (rte_lcore_count() < 2) {
+		printf("Not enough lcores for the concurrent update test\n");
+		return PASS;
+	}
+
+	config.max_rules = MAX_RULES;
+	/* Fewer groups than prefixes, so that they are reused */
+	config.number_tbl8s = RW_PREFIXES / 2;
+	config.flags = 0;
+
+	rw_lpm = rte_lpm64_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(rw_lpm != NULL);
+
+	for (i = 0; i < RW_PREFIXES; i++)
+		TEST_LPM_ASSERT(rte_lpm64_add(rw_lpm, IPv4(20, 0, i, 0), 24,
+				NH(i)) == 0);
+
+	rw_stop = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		rw_errors[lcore_id] = 0;
+		rw_lookups[lcore_id] = 0;
+		rte_eal_remote_launch(test_lpm64_reader, NULL, lcore_id);
+		nb_readers++;
+	}
+
+	for (round = 0; round < RW_ROUNDS; round++) {
+		for (i = 0; i < RW_PREFIXES; i++) {
+			/* Wait for the readers when out of tbl8 groups */
+			while (rte_lpm64_add(rw_lpm, IPv4(20, 0, i, 1), 32,
+					NH(round)) == -ENOSPC)
+				rte_pause();
+			if (i >= RW_PREFIXES / 4)
+				rte_lpm64_delete(rw_lpm,
+					IPv4(20, 0, i - RW_PREFIXES / 4, 1),
+					32);
+		}
+		for (i = RW_PREFIXES - RW_PREFIXES / 4; i < RW_PREFIXES; i++)
+			rte_lpm64_delete(rw_lpm, IPv4(20, 0, i, 1), 32);
+	}
+
+	rw_stop = 1;
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		errors += rw_errors[lcore_id];
+		lookups += rw_lookups[lcore_id];
+	}
+	printf("%u readers, %"PRIu64" lookups during %u route updates: "
+			"%"PRIu64" errors\n", nb_readers, lookups,
+			RW_ROUNDS * RW_PREFIXES * 2, errors);
+	if (errors != 0)
+		ret = -1;
+
+	rte_lpm64_free(rw_lpm);
+	return ret;
+}
+
+static int
+test_lpm64(void)
+{
+	if (test_lpm64_params() < 0)
+		return -1;
+	if (test_lpm64_add_lookup_delete() < 0)
+		return -1;
+	if (test_lpm64_tbl8_reclaim() < 0)
+		return -1;
+	if (test_lpm64_concurrent_update() < 0)
+		return -1;
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(lpm64_autotest, test_lpm64);
@@ -0,0 +1,413 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_memory.h>
+#include <rte_lpm6_trie.h>
+
+#include "test.h"
+#include "test_lpm6_data.h"
+
+#define TEST_LPM_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define MAX_RULES 4096
+#define NUMBER_TBL8S (1 << 14)
+#define PASS 0
+
+/*
+ * Check that rte_lpm6_trie_create and rte_lpm6_trie_add fail gracefully
+ * for incorrect user input arguments
+ */
+static int32_t
+test_lpm6_trie_params(void)
+{
+	struct rte_lpm6_trie *lpm = NULL;
+	struct rte_lpm6_config config;
+	uint8_t ip[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0};
+	uint32_t next_hop;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_trie_create(NULL, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	config.max_rules = 0;
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = RTE_LPM6_TRIE_TBL8_MAX_NUM_GROUPS + 1;
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	config.number_tbl8s = NUMBER_TBL8S;
+	lpm = rte_lpm6_trie_create(__func__, -2, &config);
+	TEST_LPM_ASSERT(lpm == NULL);
+
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	TEST_LPM_ASSERT(rte_lpm6_trie_find_existing(__func__) == lpm);
+	TEST_LPM_ASSERT(rte_lpm6_trie_create(__func__, SOCKET_ID_ANY,
+			&config) == NULL);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(NULL, ip, 32, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, NULL, 32, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 0, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 129, 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 32,
+			RTE_LPM6_TRIE_MAX_NEXT_HOP + 1) < 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip, 32) == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip, 32,
+			NULL) < 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip, 32,
+			&next_hop) == 0);
+
+	rte_lpm6_trie_free(lpm);
+	TEST_LPM_ASSERT(rte_lpm6_trie_find_existing(__func__) == NULL);
+
+	return PASS;
+}
+
+/*
+ * Add, look up and delete routes ending in tbl24 and in the different
+ * tbl8 levels, and check the less specific routes are used again after
+ * a deletion.
+ */
+static int32_t
+test_lpm6_trie_add_lookup_delete(void)
+{
+	struct rte_lpm6_trie *lpm;
+	struct rte_lpm6_config config;
+	uint8_t ip_16[] = {0x20, 0x01, 0, 0, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t ip_32[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t ip_48[] = {0x20, 0x01, 0x0d, 0xb8, 0x12, 0x34, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 0};
+	uint8_t ip_128[] = {0x20, 0x01, 0x0d, 0xb8, 0x12, 0x34, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t ips[5][RTE_LPM6_IPV6_ADDR_SIZE];
+	int32_t next_hops[5];
+	uint32_t next_hop;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip_16, 16, 1) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip_32, 32, 2) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip_48, 48, 3) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip_128, 128,
+			RTE_LPM6_TRIE_MAX_NEXT_HOP) == 0);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == NUMBER_TBL8S - 13);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip_48, 48,
+			&next_hop) == 1 && next_hop == 3);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip_48, 47,
+			&next_hop) == 0);
+
+	/* The host bits are ignored */
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip_128, 48,
+			&next_hop) == 1 && next_hop == 3);
+
+	memcpy(ips[0], ip_16, sizeof(ips[0]));
+	ips[0][2] = 0xff;
+	memcpy(ips[1], ip_32, sizeof(ips[1]));
+	ips[1][15] = 0xff;
+	memcpy(ips[2], ip_48, sizeof(ips[2]));
+	ips[2][15] = 0xff;
+	memcpy(ips[3], ip_128, sizeof(ips[3]));
+	memcpy(ips[4], ip_16, sizeof(ips[4]));
+	ips[4][1] = 0x02;
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[0], &next_hop) == 0 &&
+			next_hop == 1);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[1], &next_hop) == 0 &&
+			next_hop == 2);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[2], &next_hop) == 0 &&
+			next_hop == 3);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[3], &next_hop) == 0 &&
+			next_hop == RTE_LPM6_TRIE_MAX_NEXT_HOP);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[4],
+			&next_hop) == -ENOENT);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup_bulk(lpm, ips, next_hops,
+			5) == 0);
+	TEST_LPM_ASSERT(next_hops[0] == 1 && next_hops[1] == 2 &&
+			next_hops[2] == 3 &&
+			next_hops[3] == RTE_LPM6_TRIE_MAX_NEXT_HOP &&
+			next_hops[4] == -1);
+
+	/* Update of the next hop of an existing rule */
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip_48, 48, 4) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[2], &next_hop) == 0 &&
+			next_hop == 4);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[3], &next_hop) == 0 &&
+			next_hop == RTE_LPM6_TRIE_MAX_NEXT_HOP);
+
+	/* The less specific routes are used after a deletion */
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip_48, 48) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip_48, 48) == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[2], &next_hop) == 0 &&
+			next_hop == 2);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[3], &next_hop) == 0 &&
+			next_hop == RTE_LPM6_TRIE_MAX_NEXT_HOP);
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip_32, 32) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[1], &next_hop) == 0 &&
+			next_hop == 1);
+
+	/* The groups of the /128 route are released with it */
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip_128, 128) == 0);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == NUMBER_TBL8S);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[3], &next_hop) == 0 &&
+			next_hop == 1);
+
+	rte_lpm6_trie_delete_all(lpm);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ips[0],
+			&next_hop) == -ENOENT);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip_16, 16,
+			&next_hop) == 0);
+
+	rte_lpm6_trie_free(lpm);
+	return PASS;
+}
+
+/*
+ * Check that a rule is not added when the tbl8 groups are exhausted,
+ * and that the groups taken for it are released.
+ */
+static int32_t
+test_lpm6_trie_tbl8_exhaustion(void)
+{
+	struct rte_lpm6_trie *lpm;
+	struct rte_lpm6_config config;
+	uint8_t ip[] = {0x20, 0x01, 0x0d, 0xb8, 0x12, 0x34, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint32_t next_hop;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 4;
+	config.flags = 0;
+
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 128, 1) == -ENOSPC);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 4);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip, 128,
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ip, &next_hop) == -ENOENT);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 56, 1) == 0);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ip, &next_hop) == 0 &&
+			next_hop == 1);
+
+	rte_lpm6_trie_free(lpm);
+	return PASS;
+}
+
+/*
+ * Check that deleting a rule, or setting another next hop for it, whose
+ * group was merged with identical neighbour rules, fails and keeps the
+ * rule when no group is left to split it again, and that the delete
+ * succeeds once a group is released.
+ */
+static int32_t
+test_lpm6_trie_delete_exhaustion(void)
+{
+	struct rte_lpm6_trie *lpm;
+	struct rte_lpm6_config config;
+	uint8_t ip[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint8_t other_ip[] = {0x20, 0x02, 0x0d, 0xb8, 0, 0, 0, 0,
+			0, 0, 0, 0, 0, 0, 0, 1};
+	uint32_t i, next_hop;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = 1;
+	config.flags = 0;
+
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	/* all the /32 rules of a /24 prefix merge back into the tbl24 */
+	for (i = 0; i < 256; i++) {
+		ip[3] = i;
+		TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 32, 1) == 0);
+	}
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 1);
+
+	/* take the last group */
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, other_ip, 32, 2) == 0);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 0);
+
+	ip[3] = 0x80;
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip, 32) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip, 32,
+			&next_hop) == 1 && next_hop == 1);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ip, &next_hop) == 0 &&
+			next_hop == 1);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 0);
+
+	/* nor can it get another next hop, and it keeps the old one */
+	TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, ip, 32, 3) == -ENOSPC);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip, 32,
+			&next_hop) == 1 && next_hop == 1);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ip, &next_hop) == 0 &&
+			next_hop == 1);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 0);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, other_ip, 32) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_delete(lpm, ip, 32) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_is_rule_present(lpm, ip, 32,
+			&next_hop) == 0);
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ip, &next_hop) == -ENOENT);
+	ip[3] = 0x81;
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup(lpm, ip, &next_hop) == 0 &&
+			next_hop == 1);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == 0);
+
+	rte_lpm6_trie_free(lpm);
+	return PASS;
+}
+
+/*
+ * Returns 1 if two rules of the large route table have the same prefix.
+ */
+static int
+same_prefix(const struct rules_tbl_entry *r1,
+		const struct rules_tbl_entry *r2)
+{
+	return r1->depth == r2->depth &&
+		check_lpm6_rule((uint8_t *)(uintptr_t)r1->ip, r2->ip,
+				r1->depth) == 0;
+}
+
+/*
+ * Check the lookups of the addresses of the large IPs table, one by one
+ * and in bulk, against the longest prefix match of the rules.
+ */
+static int32_t
+check_large_ips(struct rte_lpm6_trie *lpm,
+		const struct rules_tbl_entry *rules, uint32_t nb_rules)
+{
+	static uint8_t ips[NUM_IPS_ENTRIES][RTE_LPM6_IPV6_ADDR_SIZE];
+	static int32_t next_hops[NUM_IPS_ENTRIES];
+	uint32_t i, next_hop;
+	uint8_t expected;
+	int ret;
+
+	for (i = 0; i < NUM_IPS_ENTRIES; i++)
+		memcpy(ips[i], large_ips_table[i].ip, RTE_LPM6_IPV6_ADDR_SIZE);
+
+	TEST_LPM_ASSERT(rte_lpm6_trie_lookup_bulk(lpm, ips, next_hops,
+			NUM_IPS_ENTRIES) == 0);
+
+	for (i = 0; i < NUM_IPS_ENTRIES; i++) {
+		ret = rte_lpm6_trie_lookup(lpm, ips[i], &next_hop);
+		if (get_next_hop(ips[i], &expected, rules, nb_rules) < 0) {
+			TEST_LPM_ASSERT(ret == -ENOENT);
+			TEST_LPM_ASSERT(next_hops[i] == -1);
+		} else {
+			TEST_LPM_ASSERT(ret == 0 && next_hop == expected);
+			TEST_LPM_ASSERT(next_hops[i] == expected);
+		}
+	}
+
+	return PASS;
+}
+
+/*
+ * Add the routes of the large route table, compare the lookups with
+ * the longest prefix match of the table, delete half of the routes,
+ * compare again, and check that all the groups are released once all
+ * the routes are deleted.
+ */
+static int32_t
+test_lpm6_trie_large_table(void)
+{
+	static struct rules_tbl_entry remaining[NUM_ROUTE_ENTRIES];
+	struct rte_lpm6_trie *lpm;
+	struct rte_lpm6_config config;
+	uint32_t i, j, nb_remaining = 0;
+	int deleted;
+
+	config.max_rules = MAX_RULES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	lpm = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i++)
+		TEST_LPM_ASSERT(rte_lpm6_trie_add(lpm, large_route_table[i].ip,
+				large_route_table[i].depth,
+				large_route_table[i].next_hop) == 0);
+
+	generate_large_ips_table(0);
+	if (check_large_ips(lpm, large_route_table, NUM_ROUTE_ENTRIES) < 0)
+		return -1;
+
+	/* Delete the odd rules, only once if they are duplicated */
+	for (i = 1; i < NUM_ROUTE_ENTRIES; i += 2)
+		rte_lpm6_trie_delete(lpm, large_route_table[i].ip,
+				large_route_table[i].depth);
+
+	for (i = 0; i < NUM_ROUTE_ENTRIES; i += 2) {
+		deleted = 0;
+		for (j = 1; j < NUM_ROUTE_ENTRIES; j += 2)
+			if (same_prefix(&large_route_table[i],
+					&large_route_table[j]))
+				deleted = 1;
+		if (!deleted)
+			remaining[nb_remaining++] = large_route_table[i];
+	}
+
+	if (check_large_ips(lpm, remaining, nb_remaining) < 0)
+		return -1;
+
+	for (i = 0; i < nb_remaining; i++)
+		rte_lpm6_trie_delete(lpm, remaining[i].ip, remaining[i].depth);
+	TEST_LPM_ASSERT(lpm->free_tbl8s == NUMBER_TBL8S);
+	for (i = 0; i < RTE_LPM6_TRIE_TBL24_NUM_ENTRIES; i++)
+		TEST_LPM_ASSERT(lpm->tbl24[i] == 0);
+
+	rte_lpm6_trie_free(lpm);
+	return PASS;
+}
+
+static int
+test_lpm6_trie(void)
+{
+	if (test_lpm6_trie_params() < 0)
+		return -1;
+	if (test_lpm6_trie_add_lookup_delete() < 0)
+		return -1;
+	if (test_lpm6_trie_tbl8_exhaustion() < 0)
+		return -1;
+	if (test_lpm6_trie_delete_exhaustion() < 0)
+		return -1;
+	if (test_lpm6_trie_large_table() < 0)
+		return -1;
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(lpm6_trie_autotest, test_lpm6_trie);
@@ -0,0 +1,248 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rte_cycles.h>
+#include <rte_random.h>
+#include <rte_memory.h>
+#include <rte_lpm6.h>
+#include <rte_lpm6_trie.h>
+
+#include "test.h"
+
+#define TEST_LPM_ASSERT(cond) do {                                            \
+	if (!(cond)) {                                                        \
+		printf("Error at line %d: \n", __LINE__);                     \
+		return -1;                                                    \
+	}                                                                     \
+} while (0)
+
+#define ITERATIONS (1 << 4)
+#define NUM_ROUTES (1 << 16)
+#define NUM_IPS (1 << 20)
+#define NUMBER_TBL8S (1 << 17)
+
+/*
+ * Share of the prefix lengths, in 1/1000, of a full IPv6 BGP table:
+ * mostly /48 and /32, most of the other ones between /29 and /44.
+ */
+static const struct {
+	uint8_t depth;
+	uint16_t share;
+} bgp_depths[] = {
+	{16, 1}, {19, 1}, {20, 2}, {22, 1}, {24, 4}, {28, 6}, {29, 30},
+	{30, 5}, {31, 3}, {32, 220}, {33, 10}, {34, 10}, {35, 8}, {36, 40},
+	{37, 5}, {38, 7}, {39, 5}, {40, 60}, {41, 3}, {42, 10}, {43, 3},
+	{44, 70}, {45, 5}, {46, 15}, {47, 15}, {48, 461},
+};
+
+/* Top 12 bits of the blocks allocated to the registries */
+static const uint16_t rir_blocks[] = {
+	0x200, 0x240, 0x260, 0x280, 0x2a0, 0x2c0,
+};
+
+struct route {
+	uint8_t ip[RTE_LPM6_IPV6_ADDR_SIZE];
+	uint8_t depth;
+};
+
+static struct route routes[NUM_ROUTES];
+static uint32_t allocs[NUM_ROUTES];
+static uint8_t ips[NUM_IPS][RTE_LPM6_IPV6_ADDR_SIZE];
+static int32_t next_hops[NUM_IPS];
+static int32_t trie_next_hops[NUM_IPS];
+
+static void
+mask_prefix(uint8_t *ip, uint8_t depth)
+{
+	int i;
+
+	for (i = depth / 8; i < RTE_LPM6_IPV6_ADDR_SIZE; i++) {
+		if (depth > i * 8)
+			ip[i] &= (uint8_t)(0xff << (8 - (depth - i * 8)));
+		else
+			ip[i] = 0;
+	}
+}
+
+static uint8_t
+random_depth(void)
+{
+	unsigned int i, n = rte_rand() % 1000;
+
+	for (i = 0; n >= bgp_depths[i].share; i++)
+		n -= bgp_depths[i].share;
+
+	return bgp_depths[i].depth;
+}
+
+/*
+ * Generates a table with the prefix length distribution of a full BGP
+ * table, in the blocks of the registries. Like the real ones, most of
+ * the long prefixes are more specifics of an allocation of the table.
+ */
+static void
+generate_bgp_table(void)
+{
+	uint32_t i, j, nb_allocs = 0;
+	uint16_t block;
+	uint8_t depth;
+
+	for (i = 0; i < NUM_ROUTES; i++) {
+		depth = random_depth();
+
+		for (j = 0; j < RTE_LPM6_IPV6_ADDR_SIZE; j++)
+			routes[i].ip[j] = rte_rand();
+
+		if (depth > 32 && nb_allocs != 0 && rte_rand() % 4 != 0) {
+			memcpy(routes[i].ip,
+				routes[allocs[rte_rand() % nb_allocs]].ip, 4);
+		} else {
+			block = rir_blocks[rte_rand() % RTE_DIM(rir_blocks)];
+			routes[i].ip[0] = block >> 4;
+			routes[i].ip[1] = (block << 4) | (routes[i].ip[1] & 0xf);
+		}
+
+		mask_prefix(routes[i].ip, depth);
+		routes[i].depth = depth;
+
+		if (depth >= 29 && depth <= 32)
+			allocs[nb_allocs++] = i;
+	}
+}
+
+/*
+ * Generates addresses in the routes of the table, with random host
+ * bits, as received by a router of the default free zone.
+ */
+static void
+generate_ips(void)
+{
+	uint32_t i, j;
+	const struct route *r;
+
+	for (i = 0; i < NUM_IPS; i++) {
+		r = &routes[rte_rand() % NUM_ROUTES];
+		for (j = 0; j < RTE_LPM6_IPV6_ADDR_SIZE; j++)
+			ips[i][j] = rte_rand();
+		for (j = 0; j < r->depth / 8; j++)
+			ips[i][j] = r->ip[j];
+		if (r->depth % 8)
+			ips[i][j] = r->ip[j] |
+				(ips[i][j] & (0xff >> (r->depth % 8)));
+	}
+}
+
+static int
+test_lpm6_trie_perf(void)
+{
+	struct rte_lpm6 *lpm;
+	struct rte_lpm6_trie *trie;
+	struct rte_lpm6_config config;
+	uint64_t begin, total_time;
+	uint32_t i, j, next_hop;
+	int32_t lpm_fails = 0, trie_fails = 0;
+
+	config.max_rules = NUM_ROUTES;
+	config.number_tbl8s = NUMBER_TBL8S;
+	config.flags = 0;
+
+	rte_srand(rte_rdtsc());
+
+	generate_bgp_table();
+	generate_ips();
+
+	lpm = rte_lpm6_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(lpm != NULL);
+	trie = rte_lpm6_trie_create(__func__, SOCKET_ID_ANY, &config);
+	TEST_LPM_ASSERT(trie != NULL);
+
+	printf("No. routes = %u, No. addresses = %u\n", NUM_ROUTES, NUM_IPS);
+
+	/* Measure add. */
+	begin = rte_rdtsc();
+	for (i = 0; i < NUM_ROUTES; i++)
+		TEST_LPM_ASSERT(rte_lpm6_add(lpm, routes[i].ip,
+				routes[i].depth, i) == 0);
+	total_time = rte_rdtsc() - begin;
+	printf("LPM6 Add: %g cycles\n", (double)total_time / NUM_ROUTES);
+
+	begin = rte_rdtsc();
+	for (i = 0; i < NUM_ROUTES; i++)
+		TEST_LPM_ASSERT(rte_lpm6_trie_add(trie, routes[i].ip,
+				routes[i].depth, i) == 0);
+	total_time = rte_rdtsc() - begin;
+	printf("LPM6 trie Add: %g cycles, %u tbl8s used\n",
+			(double)total_time / NUM_ROUTES,
+			trie->number_tbl8s - trie->free_tbl8s);
+
+	/* Measure single Lookup */
+	total_time = 0;
+	for (i = 0; i < ITERATIONS; i++) {
+		begin = rte_rdtsc();
+		for (j = 0; j < NUM_IPS; j++)
+			if (rte_lpm6_lookup(lpm, ips[j], &next_hop) != 0)
+				lpm_fails++;
+		total_time += rte_rdtsc() - begin;
+	}
+	printf("LPM6 Lookup: %.1f cycles (fails = %d)\n",
+			(double)total_time / ((double)ITERATIONS * NUM_IPS),
+			lpm_fails);
+
+	total_time = 0;
+	for (i = 0; i < ITERATIONS; i++) {
+		begin = rte_rdtsc();
+		for (j = 0; j < NUM_IPS; j++)
+			if (rte_lpm6_trie_lookup(trie, ips[j], &next_hop) != 0)
+				trie_fails++;
+		total_time += rte_rdtsc() - begin;
+	}
+	printf("LPM6 trie Lookup: %.1f cycles (fails = %d)\n",
+			(double)total_time / ((double)ITERATIONS * NUM_IPS),
+			trie_fails);
+
+	/* Measure bulk Lookup */
+	total_time = 0;
+	for (i = 0; i < ITERATIONS; i++) {
+		begin = rte_rdtsc();
+		rte_lpm6_lookup_bulk_func(lpm, ips, next_hops, NUM_IPS);
+		total_time += rte_rdtsc() - begin;
+	}
+	printf("LPM6 BULK Lookup: %.1f cycles\n",
+			(double)total_time / ((double)ITERATIONS * NUM_IPS));
+
+	total_time = 0;
+	for (i = 0; i < ITERATIONS; i++) {
+		begin = rte_rdtsc();
+		rte_lpm6_trie_lookup_bulk(trie, ips, trie_next_hops, NUM_IPS);
+		total_time += rte_rdtsc() - begin;
+	}
+	printf("LPM6 trie BULK Lookup: %.1f cycles\n",
+			(double)total_time / ((double)ITERATIONS * NUM_IPS));
+
+	/* Both tables must give the same results */
+	for (j = 0; j < NUM_IPS; j++)
+		TEST_LPM_ASSERT(next_hops[j] == trie_next_hops[j]);
+
+	/* Measure delete, LPM6 rebuilds its table at each deletion */
+	begin = rte_rdtsc();
+	for (i = 0; i < NUM_ROUTES; i++)
+		rte_lpm6_trie_delete(trie, routes[i].ip, routes[i].depth);
+	total_time = rte_rdtsc() - begin;
+	printf("LPM6 trie Delete: %g cycles\n",
+			(double)total_time / NUM_ROUTES);
+	TEST_LPM_ASSERT(trie->free_tbl8s == trie->number_tbl8s);
+
+	rte_lpm6_delete_all(lpm);
+	rte_lpm6_free(lpm);
+	rte_lpm6_trie_free(trie);
+
+	return 0;
+}
+
+REGISTER_TEST_COMMAND(lpm6_trie_perf_autotest, test_lpm6_trie_perf);
@@ -25,6 +25,8 @@
 #include <rte_ring.h>
 #include <rte_mempool.h>
 #include <rte_mbuf.h>
+#include <rte_malloc.h>
+#include <rte_errno.h>
 #include <rte_random.h>
 #include <rte_cycles.h>
 
@@ -41,6 +43,10 @@
 /* size of private data for mbuf in pktmbuf_pool2 */
 #define MBUF2_PRIV_SIZE         128
 
+/* number and size of the buffers of the pinned mbuf pool */
+#define EXT_BUF_NB_MBUF         63
+#define EXT_BUF_SIZE            512
+
 #define REFCNT_MAX_ITER         64
 #define REFCNT_MAX_TIMEOUT      10
 #define REFCNT_MAX_REF          (RTE_MAX_LCORE)
@@ -501,6 +507,131 @@ test_attach_from_different_pool(struct rte_mempool *pktmbuf_pool,
 		rte_pktmbuf_free(clone2);
 	return -1;
 }
+
+/*
+ * test a pool of mbufs with pinned external buffers: the buffers stay
+ * attached, and a pinned mbuf is returned to its pool only when all the
+ * mbufs attached to it are freed
+ */
+static int
+test_pktmbuf_ext_pinned_buffer(struct rte_mempool *pktmbuf_pool)
+{
+	struct rte_pktmbuf_extmem ext_mem[2];
+	struct rte_mempool *pinned_pool = NULL;
+	struct rte_mbuf *m[4] = { NULL };
+	struct rte_mbuf *clone = NULL;
+	char *ext_area = NULL, *data;
+	size_t area_len;
+	unsigned int i;
+
+	/* two areas, the first one has a remainder smaller than a buffer */
+	area_len = EXT_BUF_SIZE * (EXT_BUF_NB_MBUF + 1) + EXT_BUF_SIZE / 2;
+	ext_area = rte_malloc("test_ext_area", area_len, RTE_CACHE_LINE_SIZE);
+	if (ext_area == NULL)
+		GOTO_FAIL("cannot allocate external area\n");
+	ext_mem[0].buf_ptr = ext_area;
+	ext_mem[0].buf_iova = rte_malloc_virt2iova(ext_area);
+	ext_mem[0].buf_len = EXT_BUF_SIZE * 8 + EXT_BUF_SIZE / 2;
+	ext_mem[0].elt_size = EXT_BUF_SIZE;
+	ext_mem[1].buf_ptr = ext_area + ext_mem[0].buf_len;
+	ext_mem[1].buf_iova = ext_mem[0].buf_iova + ext_mem[0].buf_len;
+	ext_mem[1].buf_len = area_len - ext_mem[0].buf_len;
+	ext_mem[1].elt_size = EXT_BUF_SIZE;
+
+	/* not enough buffers */
+	pinned_pool = rte_pktmbuf_pool_create_extbuf("test_pinned_pool",
+		EXT_BUF_NB_MBUF + 2, 0, 0, EXT_BUF_SIZE, SOCKET_ID_ANY,
+		ext_mem, RTE_DIM(ext_mem));
+	if (pinned_pool != NULL || rte_errno != EINVAL)
+		GOTO_FAIL("pool with too small areas should fail\n");
+
+	pinned_pool = rte_pktmbuf_pool_create_extbuf("test_pinned_pool",
+		EXT_BUF_NB_MBUF, 0, 0, EXT_BUF_SIZE, SOCKET_ID_ANY,
+		ext_mem, RTE_DIM(ext_mem));
+	if (pinned_pool == NULL)
+		GOTO_FAIL("cannot create pool with pinned buffers\n");
+
+	/* the mbufs are attached to the external areas */
+	if (rte_pktmbuf_alloc_bulk(pinned_pool, m, RTE_DIM(m)) != 0)
+		GOTO_FAIL("cannot allocate pinned mbufs\n");
+	for (i = 0; i < RTE_DIM(m); i++) {
+		if (!RTE_MBUF_HAS_EXTBUF(m[i]) ||
+				!RTE_MBUF_HAS_PINNED_EXTBUF(m[i]))
+			GOTO_FAIL("mbuf %u is not pinned\n", i);
+		if ((char *)m[i]->buf_addr < ext_area ||
+				(char *)m[i]->buf_addr + m[i]->buf_len >
+				ext_area + area_len)
+			GOTO_FAIL("mbuf %u buffer not in external area\n", i);
+		if (m[i]->buf_len != EXT_BUF_SIZE ||
+				m[i]->data_off != RTE_PKTMBUF_HEADROOM ||
+				m[i]->buf_iova != ext_mem[0].buf_iova +
+				RTE_PTR_DIFF(m[i]->buf_addr, ext_area))
+			GOTO_FAIL("mbuf %u has a bad buffer\n", i);
+	}
+
+	/* detaching a pinned mbuf does nothing */
+	data = m[0]->buf_addr;
+	rte_pktmbuf_detach(m[0]);
+	if (m[0]->buf_addr != data || !RTE_MBUF_HAS_EXTBUF(m[0]))
+		GOTO_FAIL("pinned buffer was detached\n");
+
+	rte_pktmbuf_free_bulk(m, RTE_DIM(m));
+	memset(m, 0, sizeof(m));
+	if (rte_mempool_avail_count(pinned_pool) != EXT_BUF_NB_MBUF)
+		GOTO_FAIL("pinned mbufs not freed\n");
+
+	/* a clone from a regular pool holds the pinned mbuf */
+	m[0] = rte_pktmbuf_alloc(pinned_pool);
+	if (m[0] == NULL)
+		GOTO_FAIL("cannot allocate pinned mbuf\n");
+	if (!RTE_MBUF_HAS_EXTBUF(m[0]))
+		GOTO_FAIL("allocated mbuf is not pinned\n");
+	data = rte_pktmbuf_append(m[0], MBUF_TEST_DATA_LEN2);
+	if (data == NULL)
+		GOTO_FAIL("cannot append data\n");
+	memset(data, 0xcc, MBUF_TEST_DATA_LEN2);
+
+	clone = rte_pktmbuf_clone(m[0], pktmbuf_pool);
+	if (clone == NULL)
+		GOTO_FAIL("cannot clone pinned mbuf\n");
+	if (!RTE_MBUF_HAS_EXTBUF(clone) ||
+			rte_pktmbuf_mtod(clone, char *) != data ||
+			rte_mbuf_ext_refcnt_read(m[0]->shinfo) != 2)
+		GOTO_FAIL("clone is not attached to the pinned buffer\n");
+
+	rte_pktmbuf_free(m[0]);
+	m[0] = NULL;
+	if (rte_mempool_avail_count(pinned_pool) != EXT_BUF_NB_MBUF - 1)
+		GOTO_FAIL("pinned mbuf freed while still referenced\n");
+	if (*rte_pktmbuf_mtod(clone, char *) != (char)0xcc)
+		GOTO_FAIL("bad data in clone\n");
+
+	rte_pktmbuf_free(clone);
+	clone = NULL;
+	if (rte_mempool_avail_count(pinned_pool) != EXT_BUF_NB_MBUF)
+		GOTO_FAIL("pinned mbuf not freed with its last clone\n");
+
+	/* the recycled mbuf is still pinned and reset */
+	m[0] = rte_pktmbuf_alloc(pinned_pool);
+	if (m[0] == NULL || !RTE_MBUF_HAS_EXTBUF(m[0]) ||
+			m[0]->pkt_len != 0 ||
+			rte_mbuf_ext_refcnt_read(m[0]->shinfo) != 1)
+		GOTO_FAIL("bad recycled pinned mbuf\n");
+	rte_pktmbuf_free(m[0]);
+
+	rte_mempool_free(pinned_pool);
+	rte_free(ext_area);
+	return 0;
+
+fail:
+	rte_pktmbuf_free(clone);
+	for (i = 0; i < RTE_DIM(m); i++)
+		rte_pktmbuf_free(m[i]);
+	rte_mempool_free(pinned_pool);
+	rte_free(ext_area);
+	return -1;
+}
+
 #undef GOTO_FAIL
 
 /*
@@ -636,6 +767,116 @@ test_pktmbuf_free_segment(struct rte_mempool *pktmbuf_pool)
 	return ret;
 }
 
+/*
+ * test bulk allocation and bulk free of mbufs, with chained mbufs from
+ * two different pools
+ */
+static int
+test_pktmbuf_free_bulk(struct rte_mempool *pktmbuf_pool,
+	struct rte_mempool *pktmbuf_pool2)
+{
+	struct rte_mbuf *m[NB_MBUF / 2];
+	struct rte_mbuf *m2[NB_MBUF / 4];
+	struct rte_mbuf *pkts[NB_MBUF];
+	unsigned int i, seg, nb_pkts, avail, avail2;
+
+	avail = rte_mempool_avail_count(pktmbuf_pool);
+	avail2 = rte_mempool_avail_count(pktmbuf_pool2);
+
+	if (rte_pktmbuf_alloc_bulk(pktmbuf_pool, m, NB_MBUF / 2) != 0) {
+		printf("rte_pktmbuf_alloc_bulk() failed\n");
+		return -1;
+	}
+	if (rte_pktmbuf_alloc_bulk(pktmbuf_pool2, m2, NB_MBUF / 4) != 0) {
+		printf("rte_pktmbuf_alloc_bulk() failed (2)\n");
+		rte_pktmbuf_free_bulk(m, NB_MBUF / 2);
+		return -1;
+	}
+
+	/* check that the mbufs were reset */
+	for (i = 0; i < NB_MBUF / 2; i++) {
+		if (m[i]->data_off != RTE_PKTMBUF_HEADROOM ||
+				rte_mbuf_refcnt_read(m[i]) != 1 ||
+				m[i]->nb_segs != 1 ||
+				m[i]->port != MBUF_INVALID_PORT ||
+				m[i]->ol_flags != 0 ||
+				m[i]->packet_type != 0 ||
+				m[i]->pkt_len != 0 || m[i]->data_len != 0 ||
+				m[i]->vlan_tci != 0 ||
+				m[i]->vlan_tci_outer != 0 ||
+				m[i]->next != NULL || m[i]->tx_offload != 0) {
+			printf("mbuf %u not reset\n", i);
+			goto fail;
+		}
+	}
+	/* pktmbuf_pool2 has no data room, so no headroom either */
+	for (i = 0; i < NB_MBUF / 4; i++) {
+		if (m2[i]->data_off != 0 || m2[i]->nb_segs != 1) {
+			printf("mbuf %u of pool2 not reset\n", i);
+			goto fail;
+		}
+	}
+
+	/*
+	 * Build packets of 1 to 4 segments from the first half of m[], append
+	 * the mbufs of pktmbuf_pool2 to them, keep the second half of
+	 * m[] as single segment packets, and leave holes in the array.
+	 */
+	nb_pkts = 0;
+	for (i = 0, seg = 0; i < NB_MBUF / 4; i++) {
+		if (seg == 0) {
+			pkts[nb_pkts++] = m[i];
+		} else if (rte_pktmbuf_chain(pkts[nb_pkts - 1], m[i]) != 0) {
+			printf("rte_pktmbuf_chain() failed\n");
+			return -1;
+		}
+		if (++seg == nb_pkts % 4 + 1)
+			seg = 0;
+	}
+	for (i = 0; i < NB_MBUF / 4; i++) {
+		if (rte_pktmbuf_chain(pkts[i % nb_pkts], m2[i]) != 0) {
+			printf("rte_pktmbuf_chain() failed (2)\n");
+			return -1;
+		}
+	}
+	for (i = NB_MBUF / 4; i < NB_MBUF / 2; i++) {
+		pkts[nb_pkts++] = NULL;
+		pkts[nb_pkts++] = m[i];
+	}
+
+	/* a segment with an extra reference must not be freed */
+	rte_mbuf_refcnt_update(m2[0], 1);
+
+	rte_pktmbuf_free_bulk(pkts, nb_pkts);
+
+	if (rte_mempool_avail_count(pktmbuf_pool) != avail) {
+		printf("rte_pktmbuf_free_bulk() did not free all mbufs\n");
+		return -1;
+	}
+	if (rte_mempool_avail_count(pktmbuf_pool2) != avail2 - 1) {
+		printf("rte_pktmbuf_free_bulk() freed a referenced mbuf\n");
+		return -1;
+	}
+	if (rte_mbuf_refcnt_read(m2[0]) != 1) {
+		printf("bad refcnt of the referenced mbuf\n");
+		return -1;
+	}
+	m2[0]->next = NULL;
+	m2[0]->nb_segs = 1;
+	rte_pktmbuf_free_bulk(m2, 1);
+	if (rte_mempool_avail_count(pktmbuf_pool2) != avail2) {
+		printf("rte_pktmbuf_free_bulk() did not free all mbufs (2)\n");
+		return -1;
+	}
+
+	return 0;
+
+fail:
+	rte_pktmbuf_free_bulk(m, NB_MBUF / 2);
+	rte_pktmbuf_free_bulk(m2, NB_MBUF / 4);
+	return -1;
+}
+
 /*
  * Stress test for rte_mbuf atomic refcnt.
  * Implies that RTE_MBUF_REFCNT_ATOMIC is defined.
@@ -1102,6 +1343,18 @@ test_mbuf(void)
 		goto err;
 	}
 
+	/* test bulk alloc and bulk free of chained mbufs */
+	if (test_pktmbuf_free_bulk(pktmbuf_pool, pktmbuf_pool2) < 0) {
+		printf("test_pktmbuf_free_bulk() failed\n");
+		goto err;
+	}
+
+	/* test mbufs with pinned external buffers */
+	if (test_pktmbuf_ext_pinned_buffer(pktmbuf_pool) < 0) {
+		printf("test_pktmbuf_ext_pinned_buffer() failed\n");
+		goto err;
+	}
+
 	if (testclone_testupdate_testdetach(pktmbuf_pool) < 0) {
 		printf("testclone_and_testupdate() failed \n");
 		goto err;
@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ * Copyright(c) 2018 Intel Corporation
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rte_common.h>
+#include <rte_cycles.h>
+#include <rte_lcore.h>
+#include <rte_mempool.h>
+#include <rte_mbuf.h>
+
+#include "test.h"
+
+/*
+ * Mbuf performance
+ * ================
+ *
+ * Measures, using rdtsc, the cost per mbuf of:
+ *  * rte_pktmbuf_alloc() in a loop vs. rte_pktmbuf_alloc_bulk()
+ *  * rte_pktmbuf_free() in a loop vs. rte_pktmbuf_free_bulk(), for
+ *    single segment packets and for chained packets
+ *  * rte_pktmbuf_free_bulk() of packets whose segments alternate between
+ *    two mempools
+ */
+
+#define NB_MBUF 8192
+#define MBUF_CACHE_SIZE 256
+#define MAX_BURST 64
+#define ITERATIONS (1 << 14)
+
+/* number of segments of the chained packets */
+static const unsigned int seg_counts[] = {1, 2, 4};
+/* number of mbufs allocated or freed at once */
+static const unsigned int bulk_sizes[] = {8, 32, MAX_BURST};
+
+static struct rte_mempool *pool, *pool2;
+
+/* chain the n mbufs in packets of nb_segs segments */
+static unsigned int
+build_pkts(struct rte_mbuf **mbufs, unsigned int n, unsigned int nb_segs,
+	struct rte_mbuf **pkts)
+{
+	unsigned int i, nb_pkts = 0;
+
+	for (i = 0; i < n; i++) {
+		if (i % nb_segs == 0)
+			pkts[nb_pkts++] = mbufs[i];
+		else
+			rte_pktmbuf_chain(pkts[nb_pkts - 1], mbufs[i]);
+	}
+	return nb_pkts;
+}
+
+/* get n mbufs, from pool, or alternately from pool and pool2 */
+static int
+get_mbufs(struct rte_mbuf **mbufs, unsigned int n, int two_pools)
+{
+	struct rte_mbuf *mbufs2[MAX_BURST / 2];
+	unsigned int i;
+
+	if (!two_pools)
+		return rte_pktmbuf_alloc_bulk(pool, mbufs, n);
+
+	if (rte_pktmbuf_alloc_bulk(pool2, mbufs2, n / 2) != 0)
+		return -1;
+	if (rte_pktmbuf_alloc_bulk(pool, mbufs, n - n / 2) != 0) {
+		rte_pktmbuf_free_bulk(mbufs2, n / 2);
+		return -1;
+	}
+	for (i = n - 1; i > 0; i--)
+		mbufs[i] = (i % 2 != 0) ? mbufs2[i / 2] : mbufs[i / 2];
+	return 0;
+}
+
+static int
+test_alloc_perf(unsigned int bulk)
+{
+	struct rte_mbuf *mbufs[MAX_BURST];
+	uint64_t start, loop_cycles = 0, bulk_cycles = 0;
+	unsigned int i, j;
+
+	for (i = 0; i < ITERATIONS; i++) {
+		start = rte_rdtsc();
+		for (j = 0; j < bulk; j++) {
+			mbufs[j] = rte_pktmbuf_alloc(pool);
+			if (mbufs[j] == NULL)
+				return -1;
+		}
+		loop_cycles += rte_rdtsc() - start;
+		rte_pktmbuf_free_bulk(mbufs, bulk);
+
+		start = rte_rdtsc();
+		if (rte_pktmbuf_alloc_bulk(pool, mbufs, bulk) != 0)
+			return -1;
+		bulk_cycles += rte_rdtsc() - start;
+		rte_pktmbuf_free_bulk(mbufs, bulk);
+	}
+
+	printf("alloc, bulk of %u: loop %.2f, bulk %.2f cycles/mbuf\n", bulk,
+		(double)loop_cycles / (ITERATIONS * bulk),
+		(double)bulk_cycles / (ITERATIONS * bulk));
+	return 0;
+}
+
+static int
+test_free_perf(unsigned int bulk, unsigned int nb_segs, int two_pools)
+{
+	struct rte_mbuf *mbufs[MAX_BURST], *pkts[MAX_BURST];
+	uint64_t start, loop_cycles = 0, bulk_cycles = 0;
+	unsigned int i, j, nb_pkts;
+
+	for (i = 0; i < ITERATIONS * 2; i++) {
+		if (get_mbufs(mbufs, bulk, two_pools) != 0)
+			return -1;
+		nb_pkts = build_pkts(mbufs, bulk, nb_segs, pkts);
+
+		/* alternate between the two ways of freeing the packets */
+		start = rte_rdtsc();
+		if (i % 2 == 0) {
+			for (j = 0; j < nb_pkts; j++)
+				rte_pktmbuf_free(pkts[j]);
+			loop_cycles += rte_rdtsc() - start;
+		} else {
+			rte_pktmbuf_free_bulk(pkts, nb_pkts);
+			bulk_cycles += rte_rdtsc() - start;
+		}
+	}
+
+	printf("free, bulk of %u mbufs, %u segs/pkt%s: "
+		"loop %.2f, bulk %.2f cycles/mbuf\n",
+		bulk, nb_segs, two_pools ? ", 2 pools" : "",
+		(double)loop_cycles / (ITERATIONS * bulk),
+		(double)bulk_cycles / (ITERATIONS * bulk));
+	return 0;
+}
+
+static int
+test_mbuf_perf(void)
+{
+	unsigned int i, j;
+	int ret = -1;
+
+	pool = rte_pktmbuf_pool_create("test_mbuf_perf", NB_MBUF,
+		MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	pool2 = rte_pktmbuf_pool_create("test_mbuf_perf2", NB_MBUF,
+		MBUF_CACHE_SIZE, 0, RTE_MBUF_DEFAULT_BUF_SIZE, SOCKET_ID_ANY);
+	if (pool == NULL || pool2 == NULL) {
+		printf("cannot allocate mbuf pool\n");
+		goto err;
+	}
+
+	printf("\n### Allocation ###\n");
+	for (i = 0; i < RTE_DIM(bulk_sizes); i++)
+		if (test_alloc_perf(bulk_sizes[i]) < 0)
+			goto err;
+
+	printf("\n### Free ###\n");
+	for (i = 0; i < RTE_DIM(bulk_sizes); i++)
+		for (j = 0; j < RTE_DIM(seg_counts); j++)
+			if (test_free_perf(bulk_sizes[i], seg_counts[j], 0) < 0)
+				goto err;
+
+	printf("\n### Free, segments from two pools ###\n");
+	for (i = 0; i < RTE_DIM(bulk_sizes); i++)
+		for (j = 1; j < RTE_DIM(seg_counts); j++)
+			if (test_free_perf(bulk_sizes[i], seg_counts[j], 1) < 0)
+				goto err;
+
+	ret = 0;
+
+err:
+	if (ret < 0)
+		printf("mbuf allocation failed\n");
+	rte_mempool_free(pool);
+	rte_mempool_free(pool2);
+	return ret;
+}
+
+REGISTER_TEST_COMMAND(mbuf_perf_autotest, test_mbuf_perf);
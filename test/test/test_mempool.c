@@ -26,6 +26,9 @@
 #include <rte_spinlock.h>
 #include <rte_malloc.h>
 #include <rte_mbuf_pool_ops.h>
+#if defined(RTE_DRIVER_MEMPOOL_NUMA) || defined(RTE_LIBRTE_NUMA_MEMPOOL)
+#include <rte_mempool_numa.h>
+#endif
 
 #include "test.h"
 
@@ -447,6 +450,196 @@ test_mempool_same_name_twice_creation(void)
 	return 0;
 }
 
+#define ADAPTIVE_CACHE_SIZE 32
+#define ADAPTIVE_BURST 16
+#define ADAPTIVE_ROUNDS 64
+
+/*
+ * Get objects in bursts on the current lcore, keeping them, then put them
+ * back: the cache is refilled from the common pool every other call.
+ */
+static int
+test_mempool_cache_get_heavy(struct rte_mempool *mp,
+	struct rte_mempool_cache_stats *stats)
+{
+	struct rte_mempool_cache *cache;
+	void *objs[ADAPTIVE_BURST * ADAPTIVE_ROUNDS];
+	unsigned int i;
+	int ret = 0;
+
+	cache = rte_mempool_default_cache(mp, rte_lcore_id());
+	if (cache == NULL)
+		RET_ERR();
+	rte_mempool_cache_stats_reset(cache);
+
+	for (i = 0; i < ADAPTIVE_ROUNDS; i++) {
+		if (rte_mempool_get_bulk(mp, &objs[i * ADAPTIVE_BURST],
+				ADAPTIVE_BURST) < 0) {
+			printf("cannot get objects from %s\n", mp->name);
+			ret = -1;
+			break;
+		}
+	}
+	if (i != 0)
+		rte_mempool_put_bulk(mp, objs, i * ADAPTIVE_BURST);
+
+	rte_mempool_cache_stats_get(cache, stats);
+	printf("%s: cache size %u, calls %"PRIu64", backend get %"PRIu64
+		", backend put %"PRIu64", grow %"PRIu64", shrink %"PRIu64"\n",
+		mp->name, cache->size, stats->calls, stats->backend_get,
+		stats->backend_put, stats->grow, stats->shrink);
+
+	return ret;
+}
+
+/*
+ * An adaptive cache under a get-heavy load must grow, and call the common
+ * pool less often than a fixed-size cache.
+ */
+static int
+test_mempool_adaptive_cache(void)
+{
+	struct rte_mempool *mp_fixed = NULL, *mp_adaptive = NULL;
+	struct rte_mempool_cache_stats fixed_stats, adaptive_stats;
+	struct rte_mempool_cache *cache;
+	int ret = -1;
+
+	mp_fixed = rte_mempool_create("test_cache_fixed", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, ADAPTIVE_CACHE_SIZE, 0,
+		NULL, NULL, NULL, NULL,
+		SOCKET_ID_ANY, 0);
+	if (mp_fixed == NULL)
+		GOTO_ERR(ret, err);
+
+	mp_adaptive = rte_mempool_create("test_cache_adaptive", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, ADAPTIVE_CACHE_SIZE, 0,
+		NULL, NULL, NULL, NULL,
+		SOCKET_ID_ANY, MEMPOOL_F_CACHE_ADAPTIVE);
+	if (mp_adaptive == NULL)
+		GOTO_ERR(ret, err);
+
+	if (test_mempool_cache_get_heavy(mp_fixed, &fixed_stats) < 0)
+		GOTO_ERR(ret, err);
+	if (test_mempool_cache_get_heavy(mp_adaptive, &adaptive_stats) < 0)
+		GOTO_ERR(ret, err);
+
+	/* the fixed cache never changes */
+	cache = rte_mempool_default_cache(mp_fixed, rte_lcore_id());
+	if (cache->size != ADAPTIVE_CACHE_SIZE ||
+			fixed_stats.grow != 0 || fixed_stats.shrink != 0)
+		GOTO_ERR(ret, err);
+
+	cache = rte_mempool_default_cache(mp_adaptive, rte_lcore_id());
+	if (cache->size <= ADAPTIVE_CACHE_SIZE || adaptive_stats.grow == 0)
+		GOTO_ERR(ret, err);
+	if (cache->size > RTE_MEMPOOL_CACHE_MAX_SIZE ||
+			cache->flushthresh > RTE_MEMPOOL_CACHE_MAX_SIZE * 3)
+		GOTO_ERR(ret, err);
+
+	if (adaptive_stats.calls != fixed_stats.calls)
+		GOTO_ERR(ret, err);
+	if (adaptive_stats.backend_get + adaptive_stats.backend_put >=
+			fixed_stats.backend_get + fixed_stats.backend_put)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_full(mp_adaptive) != 1)
+		GOTO_ERR(ret, err);
+
+	rte_mempool_dump(stdout, mp_adaptive);
+
+	ret = 0;
+
+err:
+	rte_mempool_free(mp_fixed);
+	rte_mempool_free(mp_adaptive);
+	return ret;
+}
+
+#if defined(RTE_DRIVER_MEMPOOL_NUMA) || defined(RTE_LIBRTE_NUMA_MEMPOOL)
+/* test the mempool handler keeping objects per NUMA node */
+static int
+test_mempool_numa(void)
+{
+	struct rte_mempool *mp;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty("test_numa", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+
+	/* only for the numa handler */
+	if (rte_mempool_numa_populate(mp) != -EINVAL)
+		GOTO_ERR(ret, err);
+
+	if (rte_mempool_set_ops_byname(mp, "numa", NULL) < 0) {
+		printf("cannot set numa handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_numa_populate(mp) != (int)MEMPOOL_SIZE) {
+		printf("cannot populate numa mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_numa_populate(mp) != -EEXIST)
+		GOTO_ERR(ret, err);
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+
+	if (test_mempool_basic(mp, 0) < 0)
+		GOTO_ERR(ret, err);
+	if (test_mempool_basic(mp, 1) < 0)
+		GOTO_ERR(ret, err);
+	/* get all the objects of all the nodes */
+	if (test_mempool_basic_ex(mp) < 0)
+		GOTO_ERR(ret, err);
+
+	rte_mempool_dump(stdout, mp);
+
+	ret = 0;
+
+err:
+	rte_mempool_free(mp);
+	return ret;
+}
+#endif
+
+#ifdef RTE_ARCH_X86_64
+static int
+test_mempool_lf_stack(void)
+{
+	struct rte_mempool *mp;
+	int ret = -1;
+
+	mp = rte_mempool_create_empty("test_lf_stack", MEMPOOL_SIZE,
+		MEMPOOL_ELT_SIZE, RTE_MEMPOOL_CACHE_MAX_SIZE, 0,
+		SOCKET_ID_ANY, 0);
+	if (mp == NULL)
+		RET_ERR();
+	if (rte_mempool_set_ops_byname(mp, "lf_stack", NULL) < 0) {
+		printf("cannot set lf_stack handler\n");
+		GOTO_ERR(ret, err);
+	}
+	if (rte_mempool_populate_default(mp) < 0) {
+		printf("cannot populate lf_stack mempool\n");
+		GOTO_ERR(ret, err);
+	}
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+
+	if (test_mempool_basic(mp, 0) < 0)
+		GOTO_ERR(ret, err);
+	if (test_mempool_basic(mp, 1) < 0)
+		GOTO_ERR(ret, err);
+	if (test_mempool_basic_ex(mp) < 0)
+		GOTO_ERR(ret, err);
+
+	ret = 0;
+
+err:
+	rte_mempool_free(mp);
+	return ret;
+}
+#endif
+
 static void
 walk_cb(struct rte_mempool *mp, void *userdata __rte_unused)
 {
@@ -571,13 +764,28 @@ test_mempool(void)
 	if (test_mempool_same_name_twice_creation() < 0)
 		goto err;
 
+	if (test_mempool_adaptive_cache() < 0)
+		goto err;
+
 	/* test the stack handler */
 	if (test_mempool_basic(mp_stack, 1) < 0)
 		goto err;
 
+#ifdef RTE_ARCH_X86_64
+	/* test the lock-free stack handler */
+	if (test_mempool_lf_stack() < 0)
+		goto err;
+#endif
+
 	if (test_mempool_basic(default_pool, 1) < 0)
 		goto err;
 
+#if defined(RTE_DRIVER_MEMPOOL_NUMA) || defined(RTE_LIBRTE_NUMA_MEMPOOL)
+	/* test the numa handler */
+	if (test_mempool_numa() < 0)
+		goto err;
+#endif
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -61,6 +61,9 @@
  *
  *      - 32
  *      - 128
+ *
+ *    The spinlock-based and lock-free stack handlers are also compared
+ *    without cache, from 1 to 32 cores, with bulks of 1 and 32 objects.
  */
 
 #define N 65536
@@ -279,12 +282,66 @@ do_one_mempool_test(struct rte_mempool *mp, unsigned int cores)
 	return 0;
 }
 
+/* create a mempool without cache using the given handler */
+static struct rte_mempool *
+create_mempool_with_ops(const char *name, const char *ops_name)
+{
+	struct rte_mempool *mp;
+
+	mp = rte_mempool_create_empty(name, MEMPOOL_SIZE, MEMPOOL_ELT_SIZE,
+				      0, 0, SOCKET_ID_ANY, 0);
+	if (mp == NULL) {
+		printf("cannot allocate %s mempool\n", ops_name);
+		return NULL;
+	}
+
+	if (rte_mempool_set_ops_byname(mp, ops_name, NULL) < 0) {
+		printf("cannot set %s handler\n", ops_name);
+		goto fail;
+	}
+
+	if (rte_mempool_populate_default(mp) < 0) {
+		printf("cannot populate %s mempool\n", ops_name);
+		goto fail;
+	}
+
+	rte_mempool_obj_iter(mp, my_obj_init, NULL);
+	return mp;
+
+fail:
+	rte_mempool_free(mp);
+	return NULL;
+}
+
+/* for each power of 2 number of cores up to 32, launch the stack tests */
+static int
+do_stack_scaling_test(struct rte_mempool *mp)
+{
+	unsigned int bulk_tab[] = { 1, 32, 0 };
+	unsigned int *bulk_ptr;
+	unsigned int cores;
+
+	n_keep = 128;
+	for (cores = 1; cores <= 32 && cores <= rte_lcore_count();
+			cores *= 2) {
+		for (bulk_ptr = bulk_tab; *bulk_ptr; bulk_ptr++) {
+			n_get_bulk = *bulk_ptr;
+			n_put_bulk = *bulk_ptr;
+			if (launch_cores(mp, cores) < 0)
+				return -1;
+		}
+	}
+	return 0;
+}
+
 static int
 test_mempool_perf(void)
 {
 	struct rte_mempool *mp_cache = NULL;
 	struct rte_mempool *mp_nocache = NULL;
 	struct rte_mempool *default_pool = NULL;
+	struct rte_mempool *mp_stack = NULL;
+	struct rte_mempool *mp_lf_stack = NULL;
 	const char *default_pool_ops;
 	int ret = -1;
 
@@ -385,6 +442,27 @@ test_mempool_perf(void)
 	if (do_one_mempool_test(mp_nocache, rte_lcore_count()) < 0)
 		goto err;
 
+	/* stack handlers scaling, without cache */
+	use_external_cache = 0;
+	mp_stack = create_mempool_with_ops("perf_test_stack", "stack");
+	if (mp_stack == NULL)
+		goto err;
+
+	printf("start performance test for stack (without cache)\n");
+	if (do_stack_scaling_test(mp_stack) < 0)
+		goto err;
+
+#ifdef RTE_ARCH_X86_64
+	mp_lf_stack = create_mempool_with_ops("perf_test_lf_stack",
+					      "lf_stack");
+	if (mp_lf_stack == NULL)
+		goto err;
+
+	printf("start performance test for lf_stack (without cache)\n");
+	if (do_stack_scaling_test(mp_lf_stack) < 0)
+		goto err;
+#endif
+
 	rte_mempool_list_dump(stdout);
 
 	ret = 0;
@@ -393,6 +471,8 @@ test_mempool_perf(void)
 	rte_mempool_free(mp_cache);
 	rte_mempool_free(mp_nocache);
 	rte_mempool_free(default_pool);
+	rte_mempool_free(mp_stack);
+	rte_mempool_free(mp_lf_stack);
 	return ret;
 }
 
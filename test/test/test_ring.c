@@ -23,6 +23,8 @@
 #include <rte_branch_prediction.h>
 #include <rte_malloc.h>
 #include <rte_ring.h>
+#include <rte_ring_elem.h>
+#include <rte_ring_peek_zc.h>
 #include <rte_random.h>
 #include <rte_errno.h>
 #include <rte_hexdump.h>
@@ -47,6 +49,22 @@
  *      - Dequeue one object, two objects, MAX_BULK objects
  *      - Check that dequeued pointers are correct
  *
+ *    - Using a relaxed tail sync (RTS) ring:
+ *
+ *      - Fill and empty the ring with the generic functions
+ *      - Enqueue/dequeue bursts with the RTS functions
+ *      - Check the head/tail distance accessors and the invalid flags
+ *
+ *    - Using the zero-copy functions, in single and multi modes:
+ *
+ *      - Reserve slots across the ring wrap, commit all or part of them
+ *      - Peek at objects, release part of them, check the remaining ones
+ *
+ *    - Using rings of 4 to 32-byte elements, in all sync modes:
+ *
+ *      - Enqueue/dequeue bulks and bursts across the ring wrap
+ *      - Check that dequeued elements are correct
+ *
  * #. Performance tests.
  *
  * Tests done in test_ring_perf.c
@@ -807,6 +825,329 @@ test_ring_with_exact_size(void)
 	return ret;
 }
 
+static int
+test_ring_rts(void)
+{
+	struct rte_ring *r = NULL, *bad;
+	void **src = NULL, **dst = NULL;
+	unsigned int i, n, free_space, avail;
+	int ret = -1;
+
+	r = rte_ring_create("test_rts", RING_SIZE, SOCKET_ID_ANY,
+			RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ);
+	if (r == NULL) {
+		printf("%s: error, can't create RTS ring\n", __func__);
+		goto end;
+	}
+
+	src = malloc(RING_SIZE * 2 * sizeof(void *));
+	dst = malloc(RING_SIZE * 2 * sizeof(void *));
+	if (src == NULL || dst == NULL)
+		goto end;
+	for (i = 0; i < RING_SIZE * 2; i++)
+		src[i] = (void *)(unsigned long)i;
+	memset(dst, 0, RING_SIZE * 2 * sizeof(void *));
+
+	/* generic functions dispatch to the RTS ones */
+	if (test_ring_basic_full_empty(r, src, dst) != 0)
+		goto end;
+
+	/* burst functions */
+	n = rte_ring_mp_rts_enqueue_burst(r, src, MAX_BULK, &free_space);
+	if (n != MAX_BULK || free_space != RING_SIZE - 1 - MAX_BULK) {
+		printf("%s: error, RTS enqueue burst\n", __func__);
+		goto end;
+	}
+	n = rte_ring_mc_rts_dequeue_burst(r, dst, MAX_BULK * 2, &avail);
+	if (n != MAX_BULK || avail != 0 ||
+			memcmp(src, dst, MAX_BULK * sizeof(void *)) != 0) {
+		printf("%s: error, RTS dequeue burst\n", __func__);
+		goto end;
+	}
+	if (rte_ring_mp_rts_enqueue_bulk(r, src, RING_SIZE, NULL) != 0 ||
+			rte_ring_mc_rts_dequeue_bulk(r, dst, 1, NULL) != 0) {
+		printf("%s: error, RTS bulk of unavailable size\n", __func__);
+		goto end;
+	}
+
+	/* head/tail distance */
+	if (rte_ring_get_prod_htd_max(r) != (RING_SIZE - 1) / 8 ||
+			rte_ring_set_prod_htd_max(r, 1) != 0 ||
+			rte_ring_get_prod_htd_max(r) != 1 ||
+			rte_ring_set_cons_htd_max(r, 1) != 0 ||
+			rte_ring_get_cons_htd_max(r) != 1) {
+		printf("%s: error, RTS head/tail distance\n", __func__);
+		goto end;
+	}
+	if (rte_ring_enqueue_bulk(r, src, MAX_BULK, NULL) != MAX_BULK ||
+			rte_ring_dequeue_bulk(r, dst, MAX_BULK, NULL) !=
+				MAX_BULK) {
+		printf("%s: error, RTS bulk with small head/tail distance\n",
+				__func__);
+		goto end;
+	}
+
+	/* single and RTS sync modes are exclusive */
+	bad = rte_ring_create("test_rts_bad", RING_SIZE, SOCKET_ID_ANY,
+			RING_F_SP_ENQ | RING_F_MP_RTS_ENQ);
+	if (bad != NULL || rte_errno != EINVAL) {
+		printf("%s: error, created ring with invalid flags\n",
+				__func__);
+		rte_ring_free(bad);
+		goto end;
+	}
+	bad = rte_ring_create("test_rts_bad", RING_SIZE, SOCKET_ID_ANY,
+			RING_F_SC_DEQ | RING_F_MC_RTS_DEQ);
+	if (bad != NULL || rte_errno != EINVAL) {
+		printf("%s: error, created ring with invalid flags\n",
+				__func__);
+		rte_ring_free(bad);
+		goto end;
+	}
+
+	ret = 0;
+end:
+	rte_ring_free(r);
+	free(src);
+	free(dst);
+	return ret;
+}
+
+/* slot i of a zero-copy reservation */
+static void **
+test_zc_slot(const struct rte_ring_zc_data *zcd, unsigned int i)
+{
+	return i < zcd->n1 ? &zcd->ptr1[i] : &zcd->ptr2[i - zcd->n1];
+}
+
+static int
+test_ring_zc(unsigned int flags)
+{
+	struct rte_ring_zc_data zcd;
+	struct rte_ring *r;
+	void *obj[16];
+	unsigned int i, n, free_space, avail;
+	int ret = -1;
+
+	r = rte_ring_create("test_zc", RTE_DIM(obj), SOCKET_ID_ANY, flags);
+	if (r == NULL) {
+		printf("%s: error, can't create ring\n", __func__);
+		return -1;
+	}
+
+	/* move head and tail so that the reservations wrap */
+	if (rte_ring_enqueue_bulk(r, obj, 10, NULL) != 10 ||
+			rte_ring_dequeue_bulk(r, obj, 10, NULL) != 10)
+		goto end;
+
+	/* reserve and commit across the wrap */
+	n = rte_ring_enqueue_zc_bulk_start(r, 8, &zcd, &free_space);
+	if (n != 8 || free_space != 7 || zcd.n1 != 6 || zcd.ptr2 == NULL) {
+		printf("%s: error, zc enqueue bulk start\n", __func__);
+		goto end;
+	}
+	for (i = 0; i != n; i++)
+		*test_zc_slot(&zcd, i) = (void *)(uintptr_t)(i + 1);
+	rte_ring_enqueue_zc_finish(r, &zcd, n);
+
+	/* reserve what is left, commit part of it */
+	if (rte_ring_enqueue_zc_bulk_start(r, 8, &zcd, NULL) != 0) {
+		printf("%s: error, zc enqueue bulk start too big\n", __func__);
+		goto end;
+	}
+	n = rte_ring_enqueue_zc_burst_start(r, 16, &zcd, &free_space);
+	if (n != 7 || free_space != 0 || zcd.ptr2 != NULL) {
+		printf("%s: error, zc enqueue burst start\n", __func__);
+		goto end;
+	}
+	for (i = 0; i != 2; i++)
+		*test_zc_slot(&zcd, i) = (void *)(uintptr_t)(i + 9);
+	rte_ring_enqueue_zc_finish(r, &zcd, 2);
+	if (rte_ring_count(r) != 10) {
+		printf("%s: error, zc enqueue partial commit\n", __func__);
+		goto end;
+	}
+
+	/* peek at everything, release part of it */
+	n = rte_ring_dequeue_zc_burst_start(r, 32, &zcd, &avail);
+	if (n != 10 || avail != 0) {
+		printf("%s: error, zc dequeue burst start\n", __func__);
+		goto end;
+	}
+	for (i = 0; i != n; i++) {
+		if (*test_zc_slot(&zcd, i) != (void *)(uintptr_t)(i + 1)) {
+			printf("%s: error, zc dequeue bad object %u\n",
+					__func__, i);
+			goto end;
+		}
+	}
+	rte_ring_dequeue_zc_finish(r, &zcd, 3);
+	if (rte_ring_count(r) != 7) {
+		printf("%s: error, zc dequeue partial release\n", __func__);
+		goto end;
+	}
+
+	/* the objects not released are still there, in order */
+	if (rte_ring_dequeue_zc_bulk_start(r, 8, &zcd, NULL) != 0 ||
+			rte_ring_dequeue_bulk(r, obj, 7, NULL) != 7) {
+		printf("%s: error, zc dequeue bulk\n", __func__);
+		goto end;
+	}
+	for (i = 0; i != 7; i++) {
+		if (obj[i] != (void *)(uintptr_t)(i + 4)) {
+			printf("%s: error, bad object %u\n", __func__, i);
+			goto end;
+		}
+	}
+
+	ret = 0;
+end:
+	rte_ring_free(r);
+	return ret;
+}
+
+/* the zero-copy functions reserve nothing on the RTS sides */
+static int
+test_ring_zc_rts(void)
+{
+	struct rte_ring_zc_data zcd;
+	struct rte_ring *r;
+	void *obj[16];
+	int ret = -1;
+
+	r = rte_ring_create("test_zc_rts", RTE_DIM(obj), SOCKET_ID_ANY,
+			RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ);
+	if (r == NULL) {
+		printf("%s: error, can't create ring\n", __func__);
+		return -1;
+	}
+
+	if (rte_ring_enqueue_bulk(r, obj, 4, NULL) != 4)
+		goto end;
+
+	if (rte_ring_enqueue_zc_burst_start(r, 4, &zcd, NULL) != 0 ||
+			rte_ring_dequeue_zc_burst_start(r, 4, &zcd,
+				NULL) != 0 ||
+			rte_ring_count(r) != 4) {
+		printf("%s: error, zc start on RTS ring\n", __func__);
+		goto end;
+	}
+
+	ret = 0;
+end:
+	rte_ring_free(r);
+	return ret;
+}
+
+#define TEST_ELEM_RING_SIZE 64
+#define TEST_ELEM_MAX_SIZE 32
+
+static int
+test_ring_elem_one(unsigned int esize, unsigned int flags)
+{
+	uint8_t src[TEST_ELEM_RING_SIZE * TEST_ELEM_MAX_SIZE];
+	uint8_t dst[TEST_ELEM_RING_SIZE * TEST_ELEM_MAX_SIZE];
+	const unsigned int rsz = TEST_ELEM_RING_SIZE - 1;
+	struct rte_ring *r;
+	unsigned int i, n, shift, free_space, avail;
+	int ret = -1;
+
+	r = rte_ring_create_elem("test_elem", esize, TEST_ELEM_RING_SIZE,
+			SOCKET_ID_ANY, flags);
+	if (r == NULL) {
+		printf("%s: error, can't create ring of %u-byte elements\n",
+				__func__, esize);
+		return -1;
+	}
+
+	for (i = 0; i != sizeof(src); i++)
+		src[i] = (uint8_t)rte_rand();
+
+	for (shift = 0; shift < TEST_ELEM_RING_SIZE; shift += 13) {
+		memset(dst, 0, sizeof(dst));
+
+		/* move head and tail so that the copies wrap */
+		if (rte_ring_enqueue_bulk_elem(r, src, esize, shift,
+				NULL) != shift ||
+				rte_ring_dequeue_bulk_elem(r, dst, esize, shift,
+					NULL) != shift)
+			goto fail;
+
+		/* one element, then a bulk, then a burst filling the ring */
+		if (rte_ring_enqueue_elem(r, src, esize) != 0)
+			goto fail;
+		if (rte_ring_enqueue_bulk_elem(r, src + esize, esize, 7,
+				&free_space) != 7 || free_space != rsz - 8)
+			goto fail;
+		if (rte_ring_enqueue_bulk_elem(r, src, esize, rsz, NULL) != 0)
+			goto fail;
+		n = rte_ring_enqueue_burst_elem(r, src + 8 * esize, esize,
+				TEST_ELEM_RING_SIZE, &free_space);
+		if (n != rsz - 8 || free_space != 0 || !rte_ring_full(r))
+			goto fail;
+		if (rte_ring_enqueue_elem(r, src, esize) != -ENOBUFS)
+			goto fail;
+
+		/* the same, to dequeue */
+		if (rte_ring_dequeue_elem(r, dst, esize) != 0)
+			goto fail;
+		if (rte_ring_dequeue_bulk_elem(r, dst + esize, esize, 7,
+				&avail) != 7 || avail != rsz - 8)
+			goto fail;
+		if (rte_ring_dequeue_bulk_elem(r, dst, esize, rsz, NULL) != 0)
+			goto fail;
+		n = rte_ring_dequeue_burst_elem(r, dst + 8 * esize, esize,
+				TEST_ELEM_RING_SIZE, &avail);
+		if (n != rsz - 8 || avail != 0 || !rte_ring_empty(r))
+			goto fail;
+		if (rte_ring_dequeue_elem(r, dst, esize) != -ENOENT)
+			goto fail;
+
+		if (memcmp(src, dst, rsz * esize) != 0) {
+			printf("%s: error, bad elements\n", __func__);
+			rte_hexdump(stdout, "src", src, rsz * esize);
+			rte_hexdump(stdout, "dst", dst, rsz * esize);
+			goto fail;
+		}
+	}
+
+	ret = 0;
+	goto end;
+fail:
+	printf("%s: error, esize %u, flags %#x, shift %u\n",
+			__func__, esize, flags, shift);
+	rte_ring_dump(stdout, r);
+end:
+	rte_ring_free(r);
+	return ret;
+}
+
+static int
+test_ring_elem(void)
+{
+	static const unsigned int esizes[] = { 4, 8, 12, 16, 20, 32 };
+	static const unsigned int flags[] = {
+		0,
+		RING_F_SP_ENQ | RING_F_SC_DEQ,
+		RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ,
+	};
+	unsigned int i, j;
+
+	for (i = 0; i != RTE_DIM(esizes); i++)
+		for (j = 0; j != RTE_DIM(flags); j++)
+			if (test_ring_elem_one(esizes[i], flags[j]) != 0)
+				return -1;
+
+	/* element size must be a multiple of 4 */
+	if (rte_ring_get_memsize_elem(6, TEST_ELEM_RING_SIZE) != -EINVAL ||
+			rte_ring_create_elem("test_elem", 6,
+				TEST_ELEM_RING_SIZE, SOCKET_ID_ANY, 0) != NULL) {
+		printf("%s: error, accepted 6-byte elements\n", __func__);
+		return -1;
+	}
+	return 0;
+}
+
 static int
 test_ring(void)
 {
@@ -860,6 +1201,17 @@ test_ring(void)
 	if (test_ring_with_exact_size() < 0)
 		goto test_fail;
 
+	if (test_ring_rts() < 0)
+		goto test_fail;
+
+	if (test_ring_zc(0) < 0 ||
+			test_ring_zc(RING_F_SP_ENQ | RING_F_SC_DEQ) < 0 ||
+			test_ring_zc_rts() < 0)
+		goto test_fail;
+
+	if (test_ring_elem() < 0)
+		goto test_fail;
+
 	/* dump the ring status */
 	rte_ring_list_dump(stdout);
 
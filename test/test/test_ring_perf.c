@@ -4,11 +4,15 @@
 
 
 #include <stdio.h>
+#include <string.h>
 #include <inttypes.h>
 #include <rte_ring.h>
+#include <rte_ring_elem.h>
+#include <rte_ring_peek_zc.h>
 #include <rte_cycles.h>
 #include <rte_launch.h>
 #include <rte_pause.h>
+#include <rte_lcore.h>
 
 #include "test.h"
 
@@ -20,6 +24,10 @@
  *  * Empty ring dequeue
  *  * Enqueue/dequeue of bursts in 1 threads
  *  * Enqueue/dequeue of bursts in 2 threads
+ *  * Zero-copy enqueue/dequeue of bursts in 1 thread
+ *  * Enqueue/dequeue of bursts of 4 to 32-byte elements in 1 thread
+ *  * MP/MC vs. relaxed tail sync (RTS) enqueue/dequeue on 2 to 32 lcores,
+ *    with and without a preempted producer
  */
 
 #define RING_NAME "RING_PERF"
@@ -362,6 +370,275 @@ test_bulk_enqueue_dequeue(struct rte_ring *r)
 	}
 }
 
+/*
+ * Times zero-copy enqueue and dequeue on a single lcore, the objects being
+ * written to and read from the ring slots directly. Results are for
+ * comparison with the bulk enq+deq, which also copy the objects.
+ */
+static void
+test_zc_enqueue_dequeue(struct rte_ring *r)
+{
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	struct rte_ring_zc_data zcd;
+	unsigned sz, i, j, n;
+	uintptr_t sum = 0;
+
+	for (sz = 0; sz < sizeof(bulk_sizes)/sizeof(bulk_sizes[0]); sz++) {
+		const uint64_t start = rte_rdtsc();
+		for (i = 0; i < iterations; i++) {
+			n = rte_ring_enqueue_zc_bulk_start(r, bulk_sizes[sz],
+					&zcd, NULL);
+			for (j = 0; j < n && j < zcd.n1; j++)
+				zcd.ptr1[j] = (void *)(uintptr_t)j;
+			for (; j < n; j++)
+				zcd.ptr2[j - zcd.n1] = (void *)(uintptr_t)j;
+			if (n != 0)
+				rte_ring_enqueue_zc_finish(r, &zcd, n);
+
+			n = rte_ring_dequeue_zc_bulk_start(r, bulk_sizes[sz],
+					&zcd, NULL);
+			for (j = 0; j < n && j < zcd.n1; j++)
+				sum += (uintptr_t)zcd.ptr1[j];
+			for (; j < n; j++)
+				sum += (uintptr_t)zcd.ptr2[j - zcd.n1];
+			if (n != 0)
+				rte_ring_dequeue_zc_finish(r, &zcd, n);
+		}
+		const uint64_t end = rte_rdtsc();
+
+		double avg = ((double)(end-start) /
+				(iterations * bulk_sizes[sz]));
+
+		printf("%s zero-copy enq/dequeue (size: %u): %.2F\n",
+				r->prod.single ? "SP/SC" : "MP/MC",
+				bulk_sizes[sz], avg);
+	}
+	RTE_SET_USED(sum);
+}
+
+/*
+ * Times enqueue and dequeue of elements of various sizes on a single lcore.
+ * Results are per element, for comparison with the bulk enq+deq of
+ * pointers.
+ */
+static int
+test_elem_enqueue_dequeue(void)
+{
+	static const unsigned int esizes[] = { 4, 8, 16, 32 };
+	const unsigned iter_shift = 23;
+	const unsigned iterations = 1<<iter_shift;
+	uint8_t burst[MAX_BURST * 32] __rte_aligned(16) = {0};
+	struct rte_ring *r;
+	unsigned sz, e, i = 0;
+
+	for (e = 0; e < RTE_DIM(esizes); e++) {
+		const unsigned int esize = esizes[e];
+
+		r = rte_ring_create_elem(RING_NAME "_ELEM", esize, RING_SIZE,
+				rte_socket_id(), 0);
+		if (r == NULL)
+			return -1;
+
+		for (sz = 0; sz < RTE_DIM(bulk_sizes); sz++) {
+			const uint64_t sc_start = rte_rdtsc();
+			for (i = 0; i < iterations; i++) {
+				rte_ring_sp_enqueue_bulk_elem(r, burst, esize,
+						bulk_sizes[sz], NULL);
+				rte_ring_sc_dequeue_bulk_elem(r, burst, esize,
+						bulk_sizes[sz], NULL);
+			}
+			const uint64_t sc_end = rte_rdtsc();
+
+			const uint64_t mc_start = rte_rdtsc();
+			for (i = 0; i < iterations; i++) {
+				rte_ring_mp_enqueue_bulk_elem(r, burst, esize,
+						bulk_sizes[sz], NULL);
+				rte_ring_mc_dequeue_bulk_elem(r, burst, esize,
+						bulk_sizes[sz], NULL);
+			}
+			const uint64_t mc_end = rte_rdtsc();
+
+			printf("SP/SC bulk enq/dequeue (esize: %u, size: %u): %.2F\n",
+					esize, bulk_sizes[sz],
+					(double)(sc_end - sc_start) /
+					(iterations * bulk_sizes[sz]));
+			printf("MP/MC bulk enq/dequeue (esize: %u, size: %u): %.2F\n",
+					esize, bulk_sizes[sz],
+					(double)(mc_end - mc_start) /
+					(iterations * bulk_sizes[sz]));
+		}
+		rte_ring_free(r);
+	}
+	return 0;
+}
+
+/*
+ * Multi-lcore MP/MC vs. RTS test: all lcores dequeue a bulk from a half
+ * full ring and enqueue it back for MT_PERF_DURATION_MS. When preemption
+ * is simulated, every MT_PREEMPT_PERIOD-th enqueue sleeps for
+ * MT_PREEMPT_DELAY_US between the head move and the tail update, as an
+ * lcore descheduled in the middle of an enqueue would.
+ */
+#define MT_PERF_DURATION_MS 100
+#define MT_PREEMPT_PERIOD 1024
+#define MT_PREEMPT_DELAY_US 100
+#define MT_BULK_SIZE 8
+
+static const unsigned int mt_lcore_nums[] = { 2, 4, 8, 16, 32 };
+
+struct mt_params {
+	struct rte_ring *r;
+	unsigned int nb_lcores;
+	int preempt;
+	uint64_t nb_obj;   /* output value, objects enqueued + dequeued */
+	uint64_t cycles;   /* output value, duration of the test */
+} __rte_cache_aligned;
+
+static struct mt_params mt_param[RTE_MAX_LCORE];
+
+/* enqueue with a delay between the head move and the tail update */
+static unsigned int
+enqueue_bulk_preempted(struct rte_ring *r, void * const *obj_table,
+		unsigned int n)
+{
+	uint32_t prod_head, prod_next, free_entries;
+
+	if (r->prod.sync_type == RTE_RING_SYNC_MT_RTS) {
+		n = __rte_ring_rts_move_prod_head(r, n, RTE_RING_QUEUE_FIXED,
+				&prod_head, &free_entries);
+		if (n == 0)
+			return 0;
+		ENQUEUE_PTRS(r, &r[1], prod_head, obj_table, n, void *);
+		rte_delay_us(MT_PREEMPT_DELAY_US);
+		__rte_ring_rts_update_tail(&r->rts_prod);
+	} else {
+		n = __rte_ring_move_prod_head(r, __IS_MP, n,
+				RTE_RING_QUEUE_FIXED, &prod_head, &prod_next,
+				&free_entries);
+		if (n == 0)
+			return 0;
+		ENQUEUE_PTRS(r, &r[1], prod_head, obj_table, n, void *);
+		rte_delay_us(MT_PREEMPT_DELAY_US);
+		update_tail(&r->prod, prod_head, prod_next, __IS_MP, 1);
+	}
+	return n;
+}
+
+static int
+mt_enqueue_dequeue(void *p)
+{
+	struct mt_params *params = p;
+	struct rte_ring *r = params->r;
+	const uint64_t duration = rte_get_tsc_hz() * MT_PERF_DURATION_MS / 1000;
+	void *burst[MT_BULK_SIZE];
+	uint64_t start, end, nb_obj = 0;
+	unsigned int i = 0;
+
+	if (__sync_add_and_fetch(&lcore_count, 1) != params->nb_lcores)
+		while (lcore_count != params->nb_lcores)
+			rte_pause();
+
+	start = rte_rdtsc();
+	do {
+		if (rte_ring_dequeue_bulk(r, burst, MT_BULK_SIZE, NULL) == 0) {
+			rte_pause();
+		} else {
+			if (params->preempt && ++i % MT_PREEMPT_PERIOD == 0)
+				while (enqueue_bulk_preempted(r, burst,
+						MT_BULK_SIZE) == 0)
+					rte_pause();
+			else
+				while (rte_ring_enqueue_bulk(r, burst,
+						MT_BULK_SIZE, NULL) == 0)
+					rte_pause();
+			nb_obj += 2 * MT_BULK_SIZE;
+		}
+		end = rte_rdtsc();
+	} while (end - start < duration);
+
+	params->nb_obj = nb_obj;
+	params->cycles = end - start;
+	return 0;
+}
+
+/* run mt_enqueue_dequeue() on the first nb_lcores lcores */
+static int
+run_on_n_lcores(struct rte_ring *r, unsigned int nb_lcores, int preempt)
+{
+	void *obj[RING_SIZE / 2] = {NULL};
+	uint64_t nb_obj = 0, cycles = 0;
+	unsigned int lcore_id, n = 0;
+
+	if (rte_ring_enqueue_bulk(r, obj, RTE_DIM(obj), NULL) == 0)
+		return -1;
+
+	memset(mt_param, 0, sizeof(mt_param));
+	lcore_count = 0;
+	RTE_LCORE_FOREACH_SLAVE(lcore_id) {
+		if (++n == nb_lcores)
+			break;
+		mt_param[lcore_id].r = r;
+		mt_param[lcore_id].nb_lcores = nb_lcores;
+		mt_param[lcore_id].preempt = preempt;
+		rte_eal_remote_launch(mt_enqueue_dequeue,
+				&mt_param[lcore_id], lcore_id);
+	}
+	lcore_id = rte_get_master_lcore();
+	mt_param[lcore_id].r = r;
+	mt_param[lcore_id].nb_lcores = nb_lcores;
+	mt_param[lcore_id].preempt = preempt;
+	mt_enqueue_dequeue(&mt_param[lcore_id]);
+	rte_eal_mp_wait_lcore();
+
+	RTE_LCORE_FOREACH(lcore_id) {
+		nb_obj += mt_param[lcore_id].nb_obj;
+		cycles += mt_param[lcore_id].cycles;
+	}
+
+	printf("%s %s, %u lcores: %.2F cycles/obj\n",
+			r->prod.sync_type == RTE_RING_SYNC_MT_RTS ?
+				"RTS  " : "MP/MC",
+			preempt ? "with preemption   " : "without preemption",
+			nb_lcores, (double)cycles / RTE_MAX(nb_obj, 1ULL));
+
+	/* drain the ring for the next run */
+	while (rte_ring_dequeue_burst(r, obj, RTE_DIM(obj), NULL) != 0)
+		;
+	return 0;
+}
+
+static int
+test_mt_enqueue_dequeue(void)
+{
+	static const unsigned int flags[] = {
+		0, RING_F_MP_RTS_ENQ | RING_F_MC_RTS_DEQ };
+	struct rte_ring *r;
+	unsigned int i, j;
+	int preempt;
+
+	for (i = 0; i < RTE_DIM(flags); i++) {
+		r = rte_ring_create(RING_NAME "_MT", RING_SIZE,
+				rte_socket_id(), flags[i]);
+		if (r == NULL)
+			return -1;
+
+		for (preempt = 0; preempt <= 1; preempt++) {
+			for (j = 0; j < RTE_DIM(mt_lcore_nums) &&
+					mt_lcore_nums[j] <= rte_lcore_count();
+					j++) {
+				if (run_on_n_lcores(r, mt_lcore_nums[j],
+						preempt) != 0) {
+					rte_ring_free(r);
+					return -1;
+				}
+			}
+		}
+		rte_ring_free(r);
+	}
+	return 0;
+}
+
 static int
 test_ring_perf(void)
 {
@@ -381,6 +658,7 @@ test_ring_perf(void)
 
 	printf("\n### Testing using a single lcore ###\n");
 	test_bulk_enqueue_dequeue(r);
+	test_zc_enqueue_dequeue(r);
 
 	if (get_two_hyperthreads(&cores) == 0) {
 		printf("\n### Testing using two hyperthreads ###\n");
@@ -395,6 +673,16 @@ test_ring_perf(void)
 		run_on_core_pair(&cores, r, enqueue_bulk, dequeue_bulk);
 	}
 	rte_ring_free(r);
+
+	printf("\n### Testing elements of various sizes on a single lcore ###\n");
+	if (test_elem_enqueue_dequeue() != 0)
+		return -1;
+
+	if (rte_lcore_count() >= 2) {
+		printf("\n### Testing MP/MC vs. RTS on multiple lcores ###\n");
+		if (test_mt_enqueue_dequeue() != 0)
+			return -1;
+	}
 	return 0;
 }
 
@@ -83,6 +83,20 @@
  *      - At initialization, timer3 is loaded by the master core, on
  *        another core in "periodical" mode (time = 1 second).
  *      - It is stopped at t=25s by timer2.
+ *
+ * #. Timer wheel test.
+ *
+ *    The timer library is re-initialized with the hierarchical timing wheel
+ *    engine, and the stress tests 1 and 2 are run again against it. The
+ *    skiplist engine is restored at the end of the test.
+ *
+ * #. Expire burst test.
+ *
+ *    With each timer engine, a set of single and periodic timers is loaded
+ *    on the master core, then collected with rte_timer_expire_burst() once
+ *    expired. The test checks that bursts are bounded, that all timers
+ *    are returned exactly once without their callback being called, and
+ *    that single timers are stopped while periodic ones are pending again.
  */
 
 #include <stdio.h>
@@ -597,4 +611,176 @@ test_timer(void)
 	return TEST_SUCCESS;
 }
 
+static int
+test_timer_wheel(void)
+{
+	unsigned i;
+	int ret;
+
+	if (rte_lcore_count() < 2) {
+		printf("not enough lcores for this test\n");
+		return TEST_FAILED;
+	}
+
+	ret = rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_WHEEL, 0);
+	if (ret != 0) {
+		printf("Cannot init timer wheel engine: %d\n", ret);
+		return TEST_FAILED;
+	}
+
+	/* init timer */
+	for (i=0; i<NB_TIMER; i++) {
+		memset(&mytiminfo[i], 0, sizeof(struct mytimerinfo));
+		mytiminfo[i].id = i;
+		rte_timer_init(&mytiminfo[i].tim);
+	}
+
+	/* calculate the "end of test" time */
+	end_time = rte_get_timer_cycles() +
+		(rte_get_timer_hz() * TEST_DURATION_S);
+
+	printf("Start timer wheel stress tests\n");
+	rte_eal_mp_remote_launch(timer_stress_main_loop, NULL, CALL_MASTER);
+	rte_eal_mp_wait_lcore();
+
+	/* stop timer 0 used for stress test */
+	rte_timer_stop_sync(&mytiminfo[0].tim);
+
+	printf("\nStart timer wheel stress tests 2\n");
+	test_failed = 0;
+	rte_eal_mp_remote_launch(timer_stress2_main_loop, NULL, CALL_MASTER);
+	rte_eal_mp_wait_lcore();
+
+	/* restore the default engine */
+	rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_SKIPLIST, 0);
+
+	if (test_failed)
+		return TEST_FAILED;
+
+	return TEST_SUCCESS;
+}
+
+#define NB_BURST_TIMERS 1000
+#define NB_BURST_PERIODIC 10
+#define EXPIRE_BURST_SIZE 64
+
+/* callback for expire burst test, must never be called */
+static void
+timer_burst_cb(struct rte_timer *tim __rte_unused, void *arg __rte_unused)
+{
+	test_failed = 1;
+}
+
+static int
+timer_expire_burst_check(enum rte_timer_engine engine)
+{
+	struct rte_timer *timers, *expired[EXPIRE_BURST_SIZE];
+	unsigned lcore_id = rte_lcore_id();
+	uint64_t hz = rte_get_timer_hz();
+	uint64_t last_expire = 0;
+	unsigned i, nb_expired = 0;
+	uint8_t *seen;
+	int j, n, ret = -1;
+
+	timers = rte_malloc(NULL, sizeof(*timers) * NB_BURST_TIMERS, 0);
+	seen = rte_zmalloc(NULL, NB_BURST_TIMERS, 0);
+	if (timers == NULL || seen == NULL) {
+		printf("- Cannot allocate memory for timers\n");
+		goto out;
+	}
+
+	test_failed = 0;
+	for (i = 0; i < NB_BURST_TIMERS; i++) {
+		rte_timer_init(&timers[i]);
+		if (i < NB_BURST_PERIODIC)
+			rte_timer_reset(&timers[i], hz / 100, PERIODICAL,
+					lcore_id, timer_burst_cb, &seen[i]);
+		else
+			rte_timer_reset(&timers[i],
+					hz / 1000 + (i % 100) * hz / 10000,
+					SINGLE, lcore_id, timer_burst_cb,
+					&seen[i]);
+	}
+
+	/* wait long enough for timers to expire, not for a second period */
+	rte_delay_ms(15);
+
+	while ((n = rte_timer_expire_burst(expired, EXPIRE_BURST_SIZE)) > 0) {
+		for (j = 0; j < n; j++) {
+			struct rte_timer *tim = expired[j];
+			uint8_t *flag = tim->arg;
+
+			i = tim - timers;
+			if (i >= NB_BURST_TIMERS || flag != &seen[i] ||
+					*flag != 0) {
+				printf("- Unexpected or duplicated timer\n");
+				goto out;
+			}
+			*flag = 1;
+
+			if (rte_timer_pending(tim) != (i < NB_BURST_PERIODIC)) {
+				printf("- Timer %u in wrong state\n", i);
+				goto out;
+			}
+
+			/* the skiplist returns timers in expiry order */
+			if (engine == RTE_TIMER_ENGINE_SKIPLIST &&
+					i >= NB_BURST_PERIODIC) {
+				if (tim->expire < last_expire) {
+					printf("- Timers out of order\n");
+					goto out;
+				}
+				last_expire = tim->expire;
+			}
+		}
+		nb_expired += n;
+		last_expire = 0;
+	}
+
+	if (nb_expired != NB_BURST_TIMERS) {
+		printf("- Expected %d expired timers, got %u\n",
+				NB_BURST_TIMERS, nb_expired);
+		goto out;
+	}
+	if (test_failed) {
+		printf("- Timer callback was called\n");
+		goto out;
+	}
+	ret = 0;
+
+out:
+	if (timers != NULL)
+		for (i = 0; i < NB_BURST_TIMERS; i++)
+			rte_timer_stop_sync(&timers[i]);
+	rte_free(timers);
+	rte_free(seen);
+	return ret;
+}
+
+static int
+test_timer_expire_burst(void)
+{
+	int ret;
+
+	printf("Start expire burst test, skiplist engine\n");
+	rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_SKIPLIST, 0);
+	if (timer_expire_burst_check(RTE_TIMER_ENGINE_SKIPLIST) < 0)
+		return TEST_FAILED;
+
+	printf("Start expire burst test, timer wheel engine\n");
+	ret = rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_WHEEL, 0);
+	if (ret != 0) {
+		printf("Cannot init timer wheel engine: %d\n", ret);
+		return TEST_FAILED;
+	}
+	ret = timer_expire_burst_check(RTE_TIMER_ENGINE_WHEEL);
+
+	/* restore the default engine */
+	rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_SKIPLIST, 0);
+
+	return ret < 0 ? TEST_FAILED : TEST_SUCCESS;
+}
+
 REGISTER_TEST_COMMAND(timer_autotest, test_timer);
+REGISTER_TEST_COMMAND(timer_wheel_autotest, test_timer_wheel);
+REGISTER_TEST_COMMAND(timer_expire_burst_autotest, test_timer_expire_burst);
@@ -34,7 +34,7 @@ timer_cb(struct rte_timer *t __rte_unused, void *param __rte_unused)
 #endif
 
 static int
-test_timer_perf(void)
+timer_perf_run(void)
 {
 	unsigned iterations = 100;
 	unsigned i;
@@ -43,6 +43,10 @@ test_timer_perf(void)
 	unsigned lcore_id = rte_lcore_id();
 
 	tms = rte_malloc(NULL, sizeof(*tms) * MAX_ITERATIONS, 0);
+	if (tms == NULL) {
+		printf("Error: cannot allocate timers\n");
+		return -1;
+	}
 
 	for (i = 0; i < MAX_ITERATIONS; i++)
 		rte_timer_init(&tms[i]);
@@ -99,6 +103,7 @@ test_timer_perf(void)
 		rte_timer_manage();
 		if (outstanding_count != 0) {
 			printf("Error: outstanding callback count = %d\n", outstanding_count);
+			rte_free(tms);
 			return -1;
 		}
 
@@ -127,8 +132,33 @@ test_timer_perf(void)
 	printf("Time per rte_timer_manage with zero callbacks: %"PRIu64" cycles\n",
 			(end_tsc - start_tsc + iterations/2) / iterations);
 
+	rte_timer_stop_sync(&tms[0]);
 	rte_free(tms);
 	return 0;
 }
 
+static int
+test_timer_perf(void)
+{
+	int ret;
+
+	printf("=== Skiplist timer engine ===\n");
+	rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_SKIPLIST, 0);
+	if (timer_perf_run() < 0)
+		return -1;
+
+	printf("\n=== Timer wheel engine ===\n");
+	ret = rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_WHEEL, 0);
+	if (ret != 0) {
+		printf("Error: cannot init timer wheel engine: %d\n", ret);
+		return -1;
+	}
+	ret = timer_perf_run();
+
+	/* restore the default engine */
+	rte_timer_subsystem_init_engine(RTE_TIMER_ENGINE_SKIPLIST, 0);
+
+	return ret;
+}
+
 REGISTER_TEST_COMMAND(timer_perf_autotest, test_timer_perf);